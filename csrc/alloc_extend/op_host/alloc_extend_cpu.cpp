@@ -0,0 +1,103 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <ATen/Parallel.h>
+#include "defines.h"
+#include "torch_helper.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr int64_t ALLOC_EXTEND_CPU_GRAIN = 16;
+
+// same three parts as the AIV kernel: the tail of the last page, whole new pages, the head of the last new page
+static void AllocExtendRequest(int64_t preLen, int64_t seqLen, int64_t lastLoc, const int64_t *newPages,
+                               int64_t numNewPages, int64_t pageSize, int64_t *out)
+{
+    int64_t preLenAligned = (preLen + pageSize - 1) / pageSize * pageSize;
+    int64_t numPart1 = std::min(seqLen, preLenAligned) - preLen;
+    for (int64_t i = 0; i < numPart1; ++i) {
+        out[i] = lastLoc + 1 + i;
+    }
+    if (preLen + numPart1 == seqLen) {
+        return;
+    }
+
+    int64_t numPart2 = seqLen / pageSize * pageSize - preLenAligned;
+    int64_t *part2 = out + numPart1;
+    for (int64_t page = 0; page < numPart2 / pageSize; ++page) {
+        int64_t base = newPages[page] * pageSize;
+        int64_t *dst = part2 + page * pageSize;
+        for (int64_t i = 0; i < pageSize; ++i) {
+            dst[i] = base + i;
+        }
+    }
+    if (preLen + numPart1 + numPart2 == seqLen) {
+        return;
+    }
+
+    int64_t numPart3 = seqLen - seqLen / pageSize * pageSize;
+    int64_t base = newPages[numNewPages - 1] * pageSize;
+    int64_t *part3 = out + numPart1 + numPart2;
+    for (int64_t i = 0; i < numPart3; ++i) {
+        part3[i] = base + i;
+    }
+}
+
+HOST_API void alloc_extend_cpu(const at::Tensor &pre_lens, const at::Tensor &seq_lens, const at::Tensor &last_loc,
+                               const at::Tensor &free_pages, int64_t pages_size, at::Tensor &out_indices,
+                               at::Tensor &values)
+{
+    if (pre_lens.options().dtype() != at::kLong || seq_lens.options().dtype() != at::kLong ||
+        last_loc.options().dtype() != at::kLong || free_pages.options().dtype() != at::kLong ||
+        out_indices.options().dtype() != at::kLong) {
+        throw std::invalid_argument("Only support int64 input dtype");
+    }
+    TORCH_CHECK(pages_size > 0, "page size must be positive");
+    TORCH_CHECK(out_indices.is_contiguous() && values.numel() > 0, "out_indices must be contiguous, values non empty");
+    at::Tensor preLens = pre_lens.contiguous();
+    at::Tensor seqLens = seq_lens.contiguous();
+    at::Tensor lastLoc = last_loc.contiguous();
+    at::Tensor freePages = free_pages.contiguous();
+    const int64_t *prePtr = preLens.data_ptr<int64_t>();
+    const int64_t *seqPtr = seqLens.data_ptr<int64_t>();
+    const int64_t *lastPtr = lastLoc.data_ptr<int64_t>();
+    const int64_t *pagePtr = freePages.data_ptr<int64_t>();
+    int64_t *outPtr = out_indices.data_ptr<int64_t>();
+    int64_t batchSize = preLens.size(0);
+
+    // exclusive prefix sums of the extend lengths and of the new pages, the only serial part
+    std::vector<int64_t> tokenOffset(batchSize + 1, 0);
+    std::vector<int64_t> pageOffset(batchSize + 1, 0);
+    for (int64_t i = 0; i < batchSize; ++i) {
+        int64_t newPages = (seqPtr[i] + pages_size - 1) / pages_size - (prePtr[i] + pages_size - 1) / pages_size;
+        tokenOffset[i + 1] = tokenOffset[i] + seqPtr[i] - prePtr[i];
+        pageOffset[i + 1] = pageOffset[i] + newPages;
+    }
+    TORCH_CHECK(tokenOffset[batchSize] <= out_indices.numel(), "out_indices holds ", out_indices.numel(),
+                " tokens, ", tokenOffset[batchSize], " are extended");
+    TORCH_CHECK(pageOffset[batchSize] <= freePages.numel(), "only ", freePages.numel(), " free pages, ",
+                pageOffset[batchSize], " are needed");
+
+    at::parallel_for(0, batchSize, ALLOC_EXTEND_CPU_GRAIN, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            AllocExtendRequest(prePtr[i], seqPtr[i], lastPtr[i], pagePtr + pageOffset[i],
+                               pageOffset[i + 1] - pageOffset[i], pages_size, outPtr + tokenOffset[i]);
+        }
+    });
+    values.view(-1)[0].fill_(pageOffset[batchSize]);
+}
+
+}  // namespace npu_kernel
+}  // namespace sglang
@@ -0,0 +1,68 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <ATen/Parallel.h>
+#include "defines.h"
+#include "torch_helper.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr int64_t ASSIGN_CACHE_CPU_GRAIN = 8;
+
+HOST_API bool assign_cache_op_cpu(at::Tensor &dstTensor, const at::Tensor &srcTensor, const at::Tensor &dstStartIdx,
+                                  const at::Tensor &dstEndIdx, const at::Tensor &srcStartIdx,
+                                  const at::Tensor &srcEndIdx)
+{
+    // one row of dst per index, the index tensors may be longer than the batch (see test_inplace_assign_cache.py)
+    int64_t batchSize = dstTensor.size(0);
+    if (dstStartIdx.numel() < batchSize || dstEndIdx.numel() < batchSize || srcStartIdx.numel() < batchSize ||
+        srcEndIdx.numel() < batchSize) {
+        std::cerr << "[ERROR] index tensors are shorter than the batch of dstTensor" << std::endl;
+        return false;
+    }
+    TORCH_CHECK(dstTensor.is_contiguous() && srcTensor.is_contiguous(), "src and dst tensor must be contiguous");
+    TORCH_CHECK(dstTensor.scalar_type() == srcTensor.scalar_type(), "src and dst tensor must have the same dtype");
+
+    // like the AIV kernel, src is addressed as a flat buffer and only the src range decides the copy length
+    at::Tensor dstStart = dstStartIdx.to(at::kLong).contiguous();
+    at::Tensor srcStart = srcStartIdx.to(at::kLong).contiguous();
+    at::Tensor srcEnd = srcEndIdx.to(at::kLong).contiguous();
+    const int64_t *dstStartPtr = dstStart.data_ptr<int64_t>();
+    const int64_t *srcStartPtr = srcStart.data_ptr<int64_t>();
+    const int64_t *srcEndPtr = srcEnd.data_ptr<int64_t>();
+    auto *dstPtr = static_cast<uint8_t *>(dstTensor.data_ptr());
+    const auto *srcPtr = static_cast<const uint8_t *>(srcTensor.data_ptr());
+    int64_t rowSize = dstTensor.numel() / std::max<int64_t>(batchSize, 1);
+    int64_t srcNum = srcTensor.numel();
+    size_t elementSize = dstTensor.element_size();
+
+    for (int64_t i = 0; i < batchSize; ++i) {
+        int64_t length = srcEndPtr[i] - srcStartPtr[i];
+        TORCH_CHECK(length >= 0 && srcStartPtr[i] >= 0 && srcEndPtr[i] <= srcNum, "src range of row ", i,
+                    " is out of bounds");
+        TORCH_CHECK(dstStartPtr[i] >= 0 && dstStartPtr[i] + length <= rowSize, "dst range of row ", i,
+                    " is out of bounds");
+    }
+    at::parallel_for(0, batchSize, ASSIGN_CACHE_CPU_GRAIN, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            std::memcpy(dstPtr + (i * rowSize + dstStartPtr[i]) * elementSize, srcPtr + srcStartPtr[i] * elementSize,
+                        static_cast<size_t>(srcEndPtr[i] - srcStartPtr[i]) * elementSize);
+        }
+    });
+    return true;
+}
+
+}  // namespace npu_kernel
+}  // namespace sglang
@@ -7,6 +7,7 @@
 #include "defines.h"
 #include "torch_helper.h"
 #include "common_tiling.h"
+#include "tiling_cache.h"
 #include "aclrtlaunch_batch_matmul_transpose.h"
 
 namespace sglang {
@@ -28,9 +29,6 @@ std::unordered_map<c10::ScalarType, TensorDType> atType2tensorDType = {
     {at::ScalarType::BFloat16, TensorDType::TENSOR_DTYPE_BF16},
     {at::ScalarType::Half, TensorDType::TENSOR_DTYPE_FLOAT16}};
 
-// batch size -> memory index
-constexpr uint32_t MAX_CAPTURE_NUM = 1024;
-
 template <typename MapType>
 inline int GetModeVal(const MapType &mode_map, c10::optional<c10::string_view> mode_opt, c10::string_view default_mode,
                       const char *mode_name)
@@ -51,9 +49,6 @@ HOST_API void batch_matmul_transpose(const at::Tensor &tensor_a, const at::Tenso
     auto tensorBShape = tensor_b.sizes();
     auto tensorCShape = tensor_c.sizes();
     uint32_t n;
-    uint32_t block_dim;
-    HardwareInfo hwInfo;
-    std::map<c10::ScalarType, float> dTypeMap = {{at::ScalarType::Half, 2.0}, {at::ScalarType::BFloat16, 2.0}};
 
     at::ScalarType aType = tensor_a.scalar_type();
     at::ScalarType bType = tensor_b.scalar_type();
@@ -78,43 +73,36 @@ HOST_API void batch_matmul_transpose(const at::Tensor &tensor_a, const at::Tenso
     }
     TORCH_CHECK(tensorAShape[1] == tensorBShape[0], "tensor shape is wrong");
 
-    OpShape opShape = {.batchSize = static_cast<uint32_t>(tensorAShape[1]),
-                       .m = static_cast<uint32_t>(tensorAShape[0]),
-                       .k = static_cast<uint32_t>(tensorAShape[2]),
-                       .n = n};
-    PpMatmulTilingData matmulTilingData = {
-        .opShape = opShape,
-    };
-    auto dType = atType2tensorDType[aType];
-    MatMulInfo mmInfo = {.batchSize = opShape.batchSize,
-                         .m = opShape.m,
-                         .k = opShape.k,
-                         .n = opShape.n,
-                         .dtypeA = dType,
-                         .dtypeB = dType,
-                         .dtypeC = dType,
-                         .formatB = formatMode,
-                         .mmType = MatMul::MatMulType::MATMUL_EIN_SUM,
-                         .inDtype = dTypeMap[aType],
-                         .outDtype = dTypeMap[cType],
-                         .quantMode = quantMode};
-    GetPpMatmulTiling(mmInfo, hwInfo, block_dim, matmulTilingData);
-    host_utils::PpMatmulTilingCheck(matmulTilingData);
-
-    // tiling
-    int32_t batchIdx = opShape.m - 1;
-    uint32_t tilingSize = sizeof(PpMatmulTilingData);
-    static auto global_tiling_data = at::empty(
-        {tilingSize * MAX_CAPTURE_NUM}, at::TensorOptions().dtype(at::kByte).device(tensor_a.options().device()));
-    if (batchIdx >= 0 && batchIdx < MAX_CAPTURE_NUM) {
-        aclrtMemcpy(global_tiling_data.data_ptr<uint8_t>() + (tilingSize * batchIdx), tilingSize, &matmulTilingData,
-                    tilingSize, ACL_MEMCPY_HOST_TO_DEVICE);
-    } else {
-        // Handle the case where batchIdx is out of range
-        TORCH_CHECK(false, "batchIdx is out of range: ", batchIdx);
-    }
-    at::Tensor tiling_tensor =
-        at::from_blob(global_tiling_data.data_ptr<uint8_t>() + (tilingSize * batchIdx), tilingSize, at::kByte);
+    TilingCacheKey key("batch_matmul_transpose", aType, formatMode, quantMode, tensorAShape, n);
+    TilingCacheEntry tiling = TilingCache::Instance().GetOrCreate(key, [&](TilingCacheEntry &entry) {
+        OpShape opShape = {.batchSize = static_cast<uint32_t>(tensorAShape[1]),
+                           .m = static_cast<uint32_t>(tensorAShape[0]),
+                           .k = static_cast<uint32_t>(tensorAShape[2]),
+                           .n = n};
+        PpMatmulTilingData matmulTilingData = {
+            .opShape = opShape,
+        };
+        std::map<c10::ScalarType, float> dTypeMap = {{at::ScalarType::Half, 2.0}, {at::ScalarType::BFloat16, 2.0}};
+        auto dType = atType2tensorDType[aType];
+        MatMulInfo mmInfo = {.batchSize = opShape.batchSize,
+                             .m = opShape.m,
+                             .k = opShape.k,
+                             .n = opShape.n,
+                             .dtypeA = dType,
+                             .dtypeB = dType,
+                             .dtypeC = dType,
+                             .formatB = formatMode,
+                             .mmType = MatMul::MatMulType::MATMUL_EIN_SUM,
+                             .inDtype = dTypeMap[aType],
+                             .outDtype = dTypeMap[cType],
+                             .quantMode = quantMode};
+        HardwareInfo hwInfo;
+        GetPpMatmulTiling(mmInfo, hwInfo, entry.blockDim, matmulTilingData);
+        host_utils::PpMatmulTilingCheck(matmulTilingData);
+        return TilingCache::HostBuffer(matmulTilingData);
+    });
+    uint32_t block_dim = tiling.blockDim;
+    at::Tensor tiling_tensor = tiling.tiling;
 
     EXEC_KERNEL_CMD(batch_matmul_transpose, block_dim, tensor_a, tensor_b, tensor_c, tiling_tensor);
 }
@@ -1,5 +1,6 @@
 #include <map>
 #include "tiling_data.h"
+#include "tiling_tuning.h"
 #include "common.h"
 #include "common_tiling.h"
 
@@ -8,6 +9,7 @@ namespace pp_matmul {
 constexpr uint32_t L1_DESCALE_BUFFER_LEN_MAX = 6144;
 constexpr uint32_t CONST_3 = 3;
 constexpr uint32_t CONST_4 = 4;
+constexpr uint32_t CONST_8 = 8;
 constexpr uint32_t CONST_16 = 16;
 constexpr uint32_t CONST_32 = 32;
 constexpr uint32_t CONST_256 = 256;
@@ -38,8 +40,8 @@ HardwareInfo::HardwareInfo()
     l0aSize = platform.l0aSize;
     l0bSize = platform.l0bSize;
     l0cSize = platform.l0cSize;
-    hbmBandWidth = 1;
-    l2BandWidth = 5;  // 5x faster than hbm.
+    hbmBandWidth = platform.hbmBandWidth;
+    l2BandWidth = platform.l2BandWidth;
 }
 
 void PpMatmulTilingData::SetBaseShape(uint32_t batchSize, uint32_t m, uint32_t k, uint32_t n)
@@ -132,6 +134,103 @@ uint32_t PpMatmulTilingData::End(const MatMulInfo &mmInfo)
     return blockDim;
 }
 
+MatmulTuningKey GetPpMatmulTuningKey(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo)
+{
+    MatmulTuningKey key;
+    key.op = static_cast<uint32_t>(MatmulTuningOp::PP_MATMUL);
+    key.coreNum = hwInfo.coreNum;
+    key.batchSize = mmInfo.batchSize;
+    key.m = mmInfo.m;
+    key.k = mmInfo.k;
+    key.n = mmInfo.n;
+    key.dtype = (static_cast<uint32_t>(mmInfo.dtypeA) << CONST_16) | (static_cast<uint32_t>(mmInfo.dtypeC) << CONST_8) |
+                static_cast<uint32_t>(mmInfo.mmType);
+    key.flags = (mmInfo.transA ? MATMUL_TUNING_TRANS_A : 0) | (mmInfo.transB ? MATMUL_TUNING_TRANS_B : 0) |
+                (mmInfo.formatB == TensorFormat::TENSOR_FORMAT_NZ ? MATMUL_TUNING_FORMAT_NZ : 0) |
+                (mmInfo.isInt8 ? MATMUL_TUNING_DEQUANT : 0);
+    return key;
+}
+
+MatmulTuningLimits GetPpMatmulTuningLimits(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo)
+{
+    MatmulTuningLimits limits;
+    limits.coreNum = hwInfo.coreNum;
+    limits.l0cSize = hwInfo.l0cSize;
+    limits.l1AbSize = L1AB_PINGPONG_BUFFER_LEN - (mmInfo.isInt8 ? L1_DESCALE_BUFFER_LEN_MAX : 0);
+    limits.inDataSize = mmInfo.inDtype;
+    limits.kAlign = mmInfo.isInt8 ? BLOCK_SIZE_INT8_K : BLOCK_SIZE;
+    limits.maxM0 = CONST_256;
+    limits.maxN0 = CONST_256;
+    return limits;
+}
+
+std::vector<MatmulTuningValue> GetPpMatmulTuningCandidates(const MatmulTuningKey &key, const HardwareInfo &hwInfo)
+{
+    // inverse of GetPpMatmulTuningKey, fields that do not take part in the tiling keep their defaults
+    MatMulInfo mmInfo;
+    mmInfo.batchSize = key.batchSize;
+    mmInfo.m = key.m;
+    mmInfo.k = key.k;
+    mmInfo.n = key.n;
+    mmInfo.dtypeA = static_cast<TensorDType>(key.dtype >> CONST_16);
+    mmInfo.dtypeB = mmInfo.dtypeA;
+    mmInfo.dtypeC = static_cast<TensorDType>((key.dtype >> CONST_8) & 0xff);
+    mmInfo.mmType = static_cast<MmType>(key.dtype & 0xff);
+    mmInfo.transA = (key.flags & MATMUL_TUNING_TRANS_A) != 0;
+    mmInfo.transB = (key.flags & MATMUL_TUNING_TRANS_B) != 0;
+    mmInfo.formatB = (key.flags & MATMUL_TUNING_FORMAT_NZ) != 0 ? TensorFormat::TENSOR_FORMAT_NZ
+                                                                 : TensorFormat::TENSOR_FORMAT_ND;
+    mmInfo.isInt8 = (key.flags & MATMUL_TUNING_DEQUANT) != 0;
+    mmInfo.inDtype = mmInfo.isInt8 ? 1.0f : 2.0f;
+    mmInfo.biasFlag = mmInfo.mmType == MmType::MATMUL_WITH_BIAS;
+
+    std::vector<MatmulTuningValue> candidates;
+    for (const auto &value : EnumerateMatmulTuningCandidates(key, GetPpMatmulTuningLimits(mmInfo, hwInfo))) {
+        PpMatmulTilingData tilingData;
+        tilingData.SetBaseShape(key.batchSize, key.m, key.k, key.n);
+        uint32_t blockDim = 0;
+        if (ApplyPpMatmulTuning(mmInfo, hwInfo, value, blockDim, tilingData)) {
+            candidates.push_back(value);
+        }
+    }
+    return candidates;
+}
+
+bool ApplyPpMatmulTuning(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo, const MatmulTuningValue &value,
+                         uint32_t &blockDim, PpMatmulTilingData &tilingData)
+{
+    MatmulTuningLimits limits = GetPpMatmulTuningLimits(mmInfo, hwInfo);
+    if (!IsValidMatmulTuningValue(value, limits)) {
+        return false;
+    }
+    // same L1 accounting as End() for the layouts that pad the base blocks or keep the bias in L1
+    uint32_t shapeSum = value.m0 + value.n0;
+    if (mmInfo.isInt8 && (mmInfo.transA || !mmInfo.transB)) {
+        shapeSum = RoundUp<uint32_t>(value.m0, CONST_32) + RoundUp<uint32_t>(value.n0, CONST_32);
+    }
+    uint64_t l1AbSize = limits.l1AbSize;
+    if (mmInfo.mmType == MmType::MATMUL_WITH_BIAS) {
+        l1AbSize = L1AB_PINGPONG_BUFFER_LEN - value.n0 * sizeof(float);
+    }
+    if (static_cast<float>(shapeSum) * value.k0 * mmInfo.inDtype > static_cast<float>(l1AbSize)) {
+        return false;
+    }
+
+    tilingData.opShape.m0 = value.m0;
+    tilingData.opShape.n0 = value.n0;
+    tilingData.opShape.k0 = value.k0;
+    tilingData.mLoop = CeilDiv(tilingData.opShape.m, value.m0);
+    tilingData.nLoop = CeilDiv(tilingData.opShape.n, value.n0);
+    tilingData.kLoop = CeilDiv(tilingData.opShape.k, value.k0);
+    tilingData.coreLoop = tilingData.opShape.batchSize * tilingData.mLoop * tilingData.nLoop;
+    tilingData.blockDim = std::max(std::min(tilingData.coreLoop, hwInfo.coreNum), 1U);
+    tilingData.swizzlCount = std::min(value.swizzleCount, tilingData.blockDim);
+    tilingData.swizzlDirect = value.swizzleDirect;
+    tilingData.SetTilingKey(mmInfo, value.swizzleDirect, 0);
+    blockDim = tilingData.blockDim;
+    return true;
+}
+
 void GetPpMatmulTiling(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo, uint32_t &blockDim,
                        PpMatmulTilingData &tilingData)
 {
@@ -151,5 +250,11 @@ void GetPpMatmulTiling(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo, uin
     uint32_t direct = Swizzl<PpMatmulTilingData>(tilingData);
     blockDim = tilingData.End(mmInfo);
     tilingData.SetTilingKey(mmInfo, direct, 0);
+
+    // an offline tuned tiling of this exact shape wins over the heuristic
+    MatmulTuningValue tuned;
+    if (MatmulTuningDb::Instance().Find(GetPpMatmulTuningKey(mmInfo, hwInfo), tuned)) {
+        ApplyPpMatmulTuning(mmInfo, hwInfo, tuned, blockDim, tilingData);
+    }
 }
 }  // namespace pp_matmul
@@ -0,0 +1,23 @@
+#ifndef PP_MATMUL_TILING_TUNING
+#define PP_MATMUL_TILING_TUNING
+#include <cstdint>
+#include <vector>
+
+#include "matmul_tuning_db.h"
+#include "tiling_data.h"
+
+// Host only, tiling_data.h is shared with the kernel and must stay free of the tuning db.
+namespace pp_matmul {
+host_utils::MatmulTuningKey GetPpMatmulTuningKey(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo);
+host_utils::MatmulTuningLimits GetPpMatmulTuningLimits(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo);
+
+// Candidates worth measuring for a key traced from GetPpMatmulTiling.
+std::vector<host_utils::MatmulTuningValue> GetPpMatmulTuningCandidates(const host_utils::MatmulTuningKey &key,
+                                                                      const HardwareInfo &hwInfo);
+
+// Apply a tuned tiling, returns false and leaves the tiling untouched if it does not fit this kernel.
+bool ApplyPpMatmulTuning(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo,
+                         const host_utils::MatmulTuningValue &value, uint32_t &blockDim,
+                         PpMatmulTilingData &tilingData);
+}  // namespace pp_matmul
+#endif
@@ -12,38 +12,38 @@
 #include "tiling/platform/platform_ascendc.h"
 #include "aclrtlaunch_build_tree_efficient.h"
 #include "torch_helper.h"
+#include "tiling_cache.h"
+#include "workspace_arena.h"
 
 namespace sglang {
 namespace npu_kernel {
-constexpr uint32_t PADDING_BYTE = 32U;
-
-at::Tensor get_tiling(int32_t &block_dim, int32_t &workspace_size, int32_t batch_size, int32_t mask_size, int64_t topk,
-                      int64_t depth, int64_t draft_token_num, int64_t tree_mask_mode)
+TilingCacheEntry get_tiling(int32_t batch_size, int32_t mask_size, int64_t topk, int64_t depth,
+                            int64_t draft_token_num, int64_t tree_mask_mode)
 {
-    auto ascendc_platform = platform_ascendc::PlatformAscendCManager::GetInstance();
-    int32_t max_aiv_core = static_cast<int32_t>(ascendc_platform->GetCoreNumAiv());
-    block_dim = std::min(max_aiv_core, batch_size);
-    workspace_size = static_cast<int32_t>(ascendc_platform->GetLibApiWorkSpaceSize());
-
-    // align to 32 bytes
-    int32_t tiling_size = (sizeof(BuildTreeTilingData) + PADDING_BYTE - 1) / PADDING_BYTE * PADDING_BYTE;
-    auto tiling_buffer = at::empty({tiling_size}, at::TensorOptions().dtype(at::kByte).device(at::kCPU));
-
-    BuildTreeTilingData *tiling_data = reinterpret_cast<BuildTreeTilingData *>(tiling_buffer.data_ptr());
-    tiling_data->batch_size = batch_size;
-    tiling_data->mask_size = mask_size;
-    tiling_data->topk = topk;
-    tiling_data->depth = depth;
-    tiling_data->draft_token_num = draft_token_num;
-    tiling_data->tree_mask_mode = tree_mask_mode;
+    TilingCacheKey key("build_tree_efficient", batch_size, mask_size, topk, depth, draft_token_num, tree_mask_mode);
+    return TilingCache::Instance().GetOrCreate(key, [&](TilingCacheEntry &entry) {
+        auto ascendc_platform = platform_ascendc::PlatformAscendCManager::GetInstance();
+        int32_t max_aiv_core = static_cast<int32_t>(ascendc_platform->GetCoreNumAiv());
+        int32_t block_dim = std::min(max_aiv_core, batch_size);
+        entry.blockDim = static_cast<uint32_t>(block_dim);
+        entry.workspaceSize = static_cast<uint64_t>(ascendc_platform->GetLibApiWorkSpaceSize());
 
-    auto num_big_core = batch_size % block_dim;
-    tiling_data->big_core_num = num_big_core == 0 ? block_dim : num_big_core;
-    tiling_data->big_core_tile_num = (batch_size + block_dim - 1) / block_dim;
-    tiling_data->small_core_tile_num = batch_size / block_dim;
+        // align to 32 bytes
+        BuildTreeTilingData *tiling_data = nullptr;
+        auto tiling_buffer = TilingCache::AllocHostBuffer(tiling_data);
+        tiling_data->batch_size = batch_size;
+        tiling_data->mask_size = mask_size;
+        tiling_data->topk = topk;
+        tiling_data->depth = depth;
+        tiling_data->draft_token_num = draft_token_num;
+        tiling_data->tree_mask_mode = tree_mask_mode;
 
-    auto tiling_tensor = TorchNpuHelper::CopyTensorHostToDevice(tiling_buffer);
-    return tiling_tensor;
+        auto num_big_core = batch_size % block_dim;
+        tiling_data->big_core_num = num_big_core == 0 ? block_dim : num_big_core;
+        tiling_data->big_core_tile_num = (batch_size + block_dim - 1) / block_dim;
+        tiling_data->small_core_tile_num = batch_size / block_dim;
+        return tiling_buffer;
+    });
 }
 
 HOST_API void build_tree_efficient(const at::Tensor &parent_list, const at::Tensor &selected_index,
@@ -64,16 +64,14 @@ HOST_API void build_tree_efficient(const at::Tensor &parent_list, const at::Tens
             "Invalid input datetype. "
             "Support combo: int64, int64, int64, bool, int64, int64, int64, int64");
     }
-    int32_t block_dim;
-    int32_t workspace_size;
     int32_t batch_size = parent_list.sizes()[0];
     int32_t mask_size = tree_mask.size(0);
 
-    at::Tensor tiling_tensor =
-        get_tiling(block_dim, workspace_size, batch_size, mask_size, topk, depth, draft_token_num, tree_mask_mode);
+    TilingCacheEntry tiling = get_tiling(batch_size, mask_size, topk, depth, draft_token_num, tree_mask_mode);
+    uint32_t block_dim = tiling.blockDim;
+    at::Tensor tiling_tensor = tiling.tiling;
 
-    auto workspace_tensor =
-        at::empty({workspace_size}, at::TensorOptions().dtype(at::kByte).device(parent_list.options().device()));
+    auto workspace_tensor = WorkspaceArena::Instance().Borrow(parent_list.device(), tiling.workspaceSize);
     /* launch the kernel function via torch */
     EXEC_KERNEL_CMD(build_tree_efficient, block_dim, parent_list, selected_index, verified_seq_len, tree_mask,
                     positions, retrive_index, retrive_next_token, retrive_next_sibling, workspace_tensor,
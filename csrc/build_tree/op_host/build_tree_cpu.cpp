@@ -0,0 +1,172 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+#include <vector>
+
+#include <ATen/Parallel.h>
+#include "defines.h"
+#include "build_tree_tiling.h"
+#include "torch_helper.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr int64_t BUILD_TREE_CPU_GRAIN = 4;
+
+struct BuildTreeCpuParams {
+    const int64_t *parentList;      // [bs, topk * (depth - 1) + 1]
+    const int64_t *selectedIndex;   // [bs, draft_token_num - 1]
+    bool *treeMask;
+    int64_t *positions;             // [bs, draft_token_num]
+    int64_t *retriveIndex;          // [bs, draft_token_num]
+    int64_t *retriveNextToken;      // [bs, draft_token_num]
+    int64_t *retriveNextSibling;    // [bs, draft_token_num]
+    int64_t topk;
+    int64_t depth;
+    int64_t draftTokenNum;
+    int64_t treeMaskMode;
+};
+
+// position of the draft token whose selected index is tokenIdx, draftTokenNum - 1 if there is none
+static int64_t FindSelected(const int64_t *selected, int64_t draftTokenNum, int64_t tokenIdx)
+{
+    int64_t position = 0;
+    for (; position < draftTokenNum - 1; ++position) {
+        if (selected[position] == tokenIdx) {
+            break;
+        }
+    }
+    return position;
+}
+
+// one request of the AIV kernel, the searches stop at the end of the row instead of reading the next one
+static void BuildTreeRequest(const BuildTreeCpuParams &p, int64_t bs, int64_t seqLen, int64_t seqTreeIdx)
+{
+    int64_t draft = p.draftTokenNum;
+    const int64_t *parents = p.parentList + bs * (p.topk * (p.depth - 1) + 1);
+    const int64_t *selected = p.selectedIndex + bs * (draft - 1);
+    int64_t *positions = p.positions + bs * draft;
+    int64_t *retriveIndex = p.retriveIndex + bs * draft;
+    int64_t *nextToken = p.retriveNextToken + bs * draft;
+    int64_t *nextSibling = p.retriveNextSibling + bs * draft;
+    for (int64_t i = 0; i < draft; ++i) {
+        nextToken[i] = -1;
+        nextSibling[i] = -1;
+    }
+
+    for (int64_t tid = 0; tid < draft; ++tid) {
+        int64_t tokenTreeIdx = p.treeMaskMode == TreeMaskMode::FULL_MASK
+                                   ? seqTreeIdx + (seqLen + draft) * tid + seqLen
+                                   : draft * draft * bs + draft * tid;
+        bool *mask = p.treeMask + tokenTreeIdx;
+        mask[0] = true;
+        for (int64_t i = 1; i < draft; ++i) {
+            mask[i] = false;
+        }
+
+        if (tid == 0) {
+            positions[0] = seqLen;
+            for (int64_t i = draft - 1; i > 0; --i) {
+                retriveIndex[i] = bs * draft + i;
+                int64_t parentTbIdx = selected[i - 1] / p.topk;
+                int64_t parentPosition = 0;
+                if (parentTbIdx > 0) {
+                    parentPosition = FindSelected(selected, draft, parents[parentTbIdx]) + 1;
+                }
+                if (parentPosition == draft) {
+                    continue;
+                }
+                if (nextToken[parentPosition] != -1) {
+                    nextSibling[i] = nextToken[parentPosition];
+                }
+                nextToken[parentPosition] = i;
+            }
+            retriveIndex[0] = bs * draft;
+            continue;
+        }
+
+        int64_t position = 0;
+        int64_t curPosition = tid - 1;
+        while (curPosition < draft - 1) {
+            position += 1;
+            mask[1 + curPosition] = true;
+            int64_t parentTbIdx = selected[curPosition] / p.topk;
+            if (parentTbIdx == 0) {
+                break;
+            }
+            curPosition = FindSelected(selected, draft, parents[parentTbIdx]);
+        }
+        positions[tid] = position + seqLen;
+    }
+}
+
+HOST_API void build_tree_efficient_cpu(const at::Tensor &parent_list, const at::Tensor &selected_index,
+                                       const at::Tensor &verified_seq_len, const at::Tensor &tree_mask,
+                                       const at::Tensor &positions, const at::Tensor &retrive_index,
+                                       const at::Tensor &retrive_next_token, const at::Tensor &retrive_next_sibling,
+                                       int64_t topk, int64_t depth, int64_t draft_token_num, int64_t tree_mask_mode)
+{
+    if (QLEN_ONLY_BITPACKING == tree_mask_mode) {
+        throw std::runtime_error("Not implemented");
+    }
+
+    if (parent_list.options().dtype() != at::kLong || selected_index.options().dtype() != at::kLong ||
+        verified_seq_len.options().dtype() != at::kLong || tree_mask.options().dtype() != at::kBool ||
+        positions.options().dtype() != at::kLong || retrive_index.options().dtype() != at::kLong ||
+        retrive_next_token.options().dtype() != at::kLong || retrive_next_sibling.options().dtype() != at::kLong) {
+        throw std::invalid_argument(
+            "Invalid input datetype. "
+            "Support combo: int64, int64, int64, bool, int64, int64, int64, int64");
+    }
+    TORCH_CHECK(tree_mask.is_contiguous() && positions.is_contiguous() && retrive_index.is_contiguous() &&
+                    retrive_next_token.is_contiguous() && retrive_next_sibling.is_contiguous(),
+                "build_tree outputs must be contiguous");
+    TORCH_CHECK(topk > 0 && draft_token_num > 0, "topk and draft_token_num must be positive");
+    at::Tensor parentList = parent_list.contiguous();
+    at::Tensor selectedIndex = selected_index.contiguous();
+    at::Tensor verifiedSeqLen = verified_seq_len.contiguous();
+    int64_t batchSize = parentList.size(0);
+
+    BuildTreeCpuParams params{parentList.data_ptr<int64_t>(),
+                              selectedIndex.data_ptr<int64_t>(),
+                              tree_mask.data_ptr<bool>(),
+                              positions.data_ptr<int64_t>(),
+                              retrive_index.data_ptr<int64_t>(),
+                              retrive_next_token.data_ptr<int64_t>(),
+                              retrive_next_sibling.data_ptr<int64_t>(),
+                              topk,
+                              depth,
+                              draft_token_num,
+                              tree_mask_mode};
+
+    // start of each request in the full mask, [seq_lens_sum * draft + draft * draft * bs]
+    const int64_t *seqLenPtr = verifiedSeqLen.data_ptr<int64_t>();
+    std::vector<int64_t> seqTreeIdx(batchSize, 0);
+    int64_t seqLenSum = 0;
+    for (int64_t bs = 0; bs < batchSize; ++bs) {
+        seqTreeIdx[bs] = draft_token_num * draft_token_num * bs + seqLenSum * draft_token_num;
+        seqLenSum += seqLenPtr[bs];
+    }
+    int64_t maskSize = tree_mask_mode == TreeMaskMode::FULL_MASK
+                           ? seqLenSum * draft_token_num + draft_token_num * draft_token_num * batchSize
+                           : draft_token_num * draft_token_num * batchSize;
+    TORCH_CHECK(tree_mask.numel() >= maskSize, "tree_mask holds ", tree_mask.numel(), " entries, ", maskSize,
+                " are written");
+
+    at::parallel_for(0, batchSize, BUILD_TREE_CPU_GRAIN, [&](int64_t begin, int64_t end) {
+        for (int64_t bs = begin; bs < end; ++bs) {
+            BuildTreeRequest(params, bs, seqLenPtr[bs], seqTreeIdx[bs]);
+        }
+    });
+}
+
+}  // namespace npu_kernel
+}  // namespace sglang
@@ -12,6 +12,7 @@
 #include "defines.h"
 #include "common.h"
 #include "torch_helper.h"
+#include "tiling_cache.h"
 #include "tiling/platform/platform_ascendc.h"
 #include "tiling/cache_loc_assign.h"
 #include "aclrtlaunch_cache_loc_assign.h"
@@ -21,57 +22,58 @@ namespace npu_kernel {
 
 constexpr uint32_t MAX_STEP = 5;
 
-at::Tensor getTiling(const at::Tensor &reqPoolIndices, uint64_t rowSize, uint64_t poolSize, uint32_t &blockDim,
-                     bool isUpddate)
+TilingCacheEntry getTiling(const at::Tensor &reqPoolIndices, uint64_t rowSize, uint64_t poolSize, bool isUpddate)
 {
     auto batchSize = reqPoolIndices.sizes()[0];
-    auto ascendcPlatform = platform_ascendc::PlatformAscendCManager::GetInstance();
-    if (isUpddate) {
-        blockDim = 1;  // todo: support mulitcore calculate for update
-    } else {
-        blockDim = ascendcPlatform->GetCoreNumAiv();
-    }
-
-    auto tilingBuffer =
-        at::empty({sizeof(AssignCacheTillingData)}, at::TensorOptions().dtype(at::kByte).device(at::kCPU));
-    AssignCacheTillingData *tillingData = reinterpret_cast<AssignCacheTillingData *>(tilingBuffer.data_ptr());
-    tillingData->vcoreNum = blockDim;
-    tillingData->poolSize = poolSize;
-    tillingData->batchSize = batchSize;
-    tillingData->rowNumNoTail = batchSize / (tillingData->vcoreNum);
-    tillingData->tailNum = batchSize % (tillingData->vcoreNum);
-    tillingData->rowSize = rowSize;
-
-    if (reqPoolIndices.options().dtype() == at::kInt) {
-        tillingData->key = 1;
-        tillingData->reqInxBufferCount = host_utils::alinInt32Count(batchSize);
-        tillingData->reqInxBufferSize = tillingData->reqInxBufferCount * sizeof(int32_t);
-    } else if (reqPoolIndices.options().dtype() == at::kLong) {
-        tillingData->key = 2;
-        tillingData->reqInxBufferCount = host_utils::alinInt64Count(batchSize);
-        tillingData->reqInxBufferSize = tillingData->reqInxBufferCount * sizeof(int64_t);
-    }
-
-    tillingData->tokenCountAlignInt32 = host_utils::alinInt32Count(MAX_STEP);
-    tillingData->tokenColAlignInt32 = tillingData->tokenCountAlignInt32 * sizeof(int32_t);
-
-    tillingData->offsetCountAlignInt64 = host_utils::alinInt64Count(batchSize);
-    tillingData->offsetColAlignInt64 = tillingData->offsetCountAlignInt64 * sizeof(int64_t);
-
-    tillingData->cacheLocSize = batchSize * MAX_STEP;
-    tillingData->cacheLocCountAlignInt32 = host_utils::alinInt32Count(tillingData->cacheLocSize);
-    tillingData->cacheLocAlignInt32 = tillingData->cacheLocCountAlignInt32 * sizeof(int32_t);
-
-    uint64_t ubSize;
-    ascendcPlatform->GetCoreMemSize(platform_ascendc::CoreMemType::UB, ubSize);
-    uint64_t ubBufferSizeToUse = tillingData->tokenColAlignInt32 + 3 * tillingData->offsetColAlignInt64 +
-                                 3 * batchSize * sizeof(int32_t) + tillingData->cacheLocAlignInt32;
-    if (ubBufferSizeToUse > ubSize) {
-        throw std::invalid_argument("Batch size is too large, buffer is not enough to do calculate");
-    }
-
-    auto tilingTensor = TorchNpuHelper::CopyTensorHostToDevice(tilingBuffer);
-    return tilingTensor;
+    TilingCacheKey key("cache_loc_assign", reqPoolIndices.scalar_type(), batchSize, rowSize, poolSize, isUpddate);
+    return TilingCache::Instance().GetOrCreate(key, [&](TilingCacheEntry &entry) {
+        auto ascendcPlatform = platform_ascendc::PlatformAscendCManager::GetInstance();
+        uint32_t blockDim;
+        if (isUpddate) {
+            blockDim = 1;  // todo: support mulitcore calculate for update
+        } else {
+            blockDim = ascendcPlatform->GetCoreNumAiv();
+        }
+        entry.blockDim = blockDim;
+
+        AssignCacheTillingData *tillingData = nullptr;
+        auto tilingBuffer = TilingCache::AllocHostBuffer(tillingData);
+        tillingData->vcoreNum = blockDim;
+        tillingData->poolSize = poolSize;
+        tillingData->batchSize = batchSize;
+        tillingData->rowNumNoTail = batchSize / (tillingData->vcoreNum);
+        tillingData->tailNum = batchSize % (tillingData->vcoreNum);
+        tillingData->rowSize = rowSize;
+
+        if (reqPoolIndices.options().dtype() == at::kInt) {
+            tillingData->key = 1;
+            tillingData->reqInxBufferCount = host_utils::alinInt32Count(batchSize);
+            tillingData->reqInxBufferSize = tillingData->reqInxBufferCount * sizeof(int32_t);
+        } else if (reqPoolIndices.options().dtype() == at::kLong) {
+            tillingData->key = 2;
+            tillingData->reqInxBufferCount = host_utils::alinInt64Count(batchSize);
+            tillingData->reqInxBufferSize = tillingData->reqInxBufferCount * sizeof(int64_t);
+        }
+
+        tillingData->tokenCountAlignInt32 = host_utils::alinInt32Count(MAX_STEP);
+        tillingData->tokenColAlignInt32 = tillingData->tokenCountAlignInt32 * sizeof(int32_t);
+
+        tillingData->offsetCountAlignInt64 = host_utils::alinInt64Count(batchSize);
+        tillingData->offsetColAlignInt64 = tillingData->offsetCountAlignInt64 * sizeof(int64_t);
+
+        tillingData->cacheLocSize = batchSize * MAX_STEP;
+        tillingData->cacheLocCountAlignInt32 = host_utils::alinInt32Count(tillingData->cacheLocSize);
+        tillingData->cacheLocAlignInt32 = tillingData->cacheLocCountAlignInt32 * sizeof(int32_t);
+
+        uint64_t ubSize;
+        ascendcPlatform->GetCoreMemSize(platform_ascendc::CoreMemType::UB, ubSize);
+        uint64_t ubBufferSizeToUse = tillingData->tokenColAlignInt32 + 3 * tillingData->offsetColAlignInt64 +
+                                     3 * batchSize * sizeof(int32_t) + tillingData->cacheLocAlignInt32;
+        if (ubBufferSizeToUse > ubSize) {
+            throw std::invalid_argument("Batch size is too large, buffer is not enough to do calculate");
+        }
+        return tilingBuffer;
+    });
 }
 
 HOST_API void checkParams(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool, const at::Tensor &startOffset,
@@ -92,9 +94,10 @@ HOST_API at::Tensor cache_loc_assign(const at::Tensor &reqPoolIndices, const at:
                                      const at::Tensor &outCacheLoc)
 {
     checkParams(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc);
-    uint32_t blockDim;
     uint32_t cacheAssignMode = 0;
-    at::Tensor tilingTensor = getTiling(reqPoolIndices, tokenPool.sizes()[1], tokenPool.sizes()[0], blockDim, false);
+    TilingCacheEntry tiling = getTiling(reqPoolIndices, tokenPool.sizes()[1], tokenPool.sizes()[0], false);
+    uint32_t blockDim = tiling.blockDim;
+    at::Tensor tilingTensor = tiling.tiling;
 
     EXEC_KERNEL_CMD(cache_loc_assign, blockDim, reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc,
                     tilingTensor, cacheAssignMode);
@@ -106,9 +109,10 @@ HOST_API at::Tensor cache_loc_update(const at::Tensor &reqPoolIndices, const at:
                                      const at::Tensor &outCacheLoc)
 {
     checkParams(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc);
-    uint32_t blockDim;
     uint32_t cacheAssignMode = 1;
-    at::Tensor tilingTensor = getTiling(reqPoolIndices, tokenPool.sizes()[1], tokenPool.sizes()[0], blockDim, true);
+    TilingCacheEntry tiling = getTiling(reqPoolIndices, tokenPool.sizes()[1], tokenPool.sizes()[0], true);
+    uint32_t blockDim = tiling.blockDim;
+    at::Tensor tilingTensor = tiling.tiling;
 
     EXEC_KERNEL_CMD(cache_loc_assign, blockDim, reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc,
                     tilingTensor, cacheAssignMode);
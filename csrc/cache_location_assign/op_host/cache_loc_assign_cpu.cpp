@@ -0,0 +1,100 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <ATen/Parallel.h>
+#include "defines.h"
+#include "torch_helper.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr int64_t CACHE_LOC_CPU_GRAIN = 64;
+
+HOST_API void checkParams(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool, const at::Tensor &startOffset,
+                          const at::Tensor &endOffset, const at::Tensor &outCacheLoc);
+
+// row b of the request pool, columns [start[b], end[b]), is paired with the b-th slice of the packed cache locations
+template <typename IndexType>
+static void CacheLocCopy(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool, const at::Tensor &startOffset,
+                         const at::Tensor &endOffset, const at::Tensor &outCacheLoc, bool toPool)
+{
+    TORCH_CHECK(tokenPool.is_contiguous() && outCacheLoc.is_contiguous(),
+                "token pool and cache locations must be contiguous");
+    at::Tensor reqIndices = reqPoolIndices.contiguous();
+    at::Tensor starts = startOffset.contiguous();
+    at::Tensor ends = endOffset.contiguous();
+    const IndexType *reqPtr = reqIndices.data_ptr<IndexType>();
+    const int64_t *startPtr = starts.data_ptr<int64_t>();
+    const int64_t *endPtr = ends.data_ptr<int64_t>();
+    int32_t *poolPtr = tokenPool.data_ptr<int32_t>();
+    int32_t *locPtr = outCacheLoc.data_ptr<int32_t>();
+    int64_t batchSize = reqIndices.size(0);
+    int64_t poolSize = tokenPool.size(0);
+    int64_t rowSize = tokenPool.size(1);
+
+    std::vector<int64_t> locOffset(batchSize + 1, 0);
+    for (int64_t i = 0; i < batchSize; ++i) {
+        TORCH_CHECK(0 <= startPtr[i] && startPtr[i] <= endPtr[i] && endPtr[i] <= rowSize, "offsets [", startPtr[i],
+                    ", ", endPtr[i], ") of row ", i, " exceed the pool row size ", rowSize);
+        TORCH_CHECK(0 <= reqPtr[i] && reqPtr[i] < poolSize, "request index ", reqPtr[i], " exceeds the pool size ",
+                    poolSize);
+        locOffset[i + 1] = locOffset[i] + endPtr[i] - startPtr[i];
+    }
+    TORCH_CHECK(locOffset[batchSize] <= outCacheLoc.numel(), "out_cache_loc holds ", outCacheLoc.numel(),
+                " locations, ", locOffset[batchSize], " are referenced");
+
+    at::parallel_for(0, batchSize, CACHE_LOC_CPU_GRAIN, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            int32_t *row = poolPtr + static_cast<int64_t>(reqPtr[i]) * rowSize + startPtr[i];
+            int32_t *loc = locPtr + locOffset[i];
+            size_t bytes = static_cast<size_t>(endPtr[i] - startPtr[i]) * sizeof(int32_t);
+            if (toPool) {
+                std::memcpy(row, loc, bytes);
+            } else {
+                std::memcpy(loc, row, bytes);
+            }
+        }
+    });
+}
+
+static void CacheLocDispatch(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool,
+                             const at::Tensor &startOffset, const at::Tensor &endOffset, const at::Tensor &outCacheLoc,
+                             bool toPool)
+{
+    checkParams(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc);
+    if (reqPoolIndices.scalar_type() == at::kInt) {
+        CacheLocCopy<int32_t>(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc, toPool);
+    } else {
+        CacheLocCopy<int64_t>(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc, toPool);
+    }
+}
+
+HOST_API at::Tensor cache_loc_assign_cpu(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool,
+                                         const at::Tensor &startOffset, const at::Tensor &endOffset,
+                                         const at::Tensor &outCacheLoc)
+{
+    CacheLocDispatch(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc, true);
+    return tokenPool;
+}
+
+HOST_API at::Tensor cache_loc_update_cpu(const at::Tensor &reqPoolIndices, const at::Tensor &tokenPool,
+                                         const at::Tensor &startOffset, const at::Tensor &endOffset,
+                                         const at::Tensor &outCacheLoc)
+{
+    CacheLocDispatch(reqPoolIndices, tokenPool, startOffset, endOffset, outCacheLoc, false);
+    return outCacheLoc;
+}
+
+}  // namespace npu_kernel
+}  // namespace sglang
@@ -12,14 +12,13 @@
 #include "defines.h"
 #include "tiling/platform/platform_ascendc.h"
 #include "torch_helper.h"
+#include "tiling_cache.h"
 #include "catlass_matmul_tiling.h"
 #include "aclrtlaunch_catlass_matmul_basic.h"
 
 namespace sglang {
 namespace npu_kernel {
 
-constexpr uint32_t PADDING_BYTE = 32U;
-
 std::map<c10::ScalarType, DataFormatMode> dTypeMap = {{at::ScalarType::Half, DataFormatMode::FP16},
                                                       {at::ScalarType::BFloat16, DataFormatMode::BF16},
                                                       {at::ScalarType::Float, DataFormatMode::FP32}};
@@ -39,26 +38,23 @@ inline int GetModeVal(const MapType &mode_map, c10::optional<c10::string_view> m
     return it->second;
 }
 
-at::Tensor get_tiling(int32_t &m, int32_t &n, int32_t k, int64_t weight_format_mode, int64_t data_format_mode,
-                      uint32_t &blockDim)
+TilingCacheEntry get_tiling(int32_t &m, int32_t &n, int32_t k, int64_t weight_format_mode, int64_t data_format_mode)
 {
-    auto ascendc_platform = platform_ascendc::PlatformAscendCManager::GetInstance();
-    blockDim = static_cast<uint32_t>(ascendc_platform->GetCoreNumAiv());
-
-    // align to 32 bytes
-    int32_t tiling_size = (sizeof(KernelCatlassMatmulTilingData) + PADDING_BYTE - 1) / PADDING_BYTE * PADDING_BYTE;
-    auto tiling_buffer = at::empty({tiling_size}, at::TensorOptions().dtype(at::kByte).device(at::kCPU));
-
-    KernelCatlassMatmulTilingData *tiling_data =
-        reinterpret_cast<KernelCatlassMatmulTilingData *>(tiling_buffer.data_ptr());
-    tiling_data->m = m;
-    tiling_data->n = n;
-    tiling_data->k = k;
-    tiling_data->weight_format_mode = weight_format_mode;
-    tiling_data->data_format_mode = data_format_mode;
-
-    auto tiling_tensor = TorchNpuHelper::CopyTensorHostToDevice(tiling_buffer);
-    return tiling_tensor;
+    TilingCacheKey key("catlass_matmul_basic", m, n, k, weight_format_mode, data_format_mode);
+    return TilingCache::Instance().GetOrCreate(key, [&](TilingCacheEntry &entry) {
+        auto ascendc_platform = platform_ascendc::PlatformAscendCManager::GetInstance();
+        entry.blockDim = static_cast<uint32_t>(ascendc_platform->GetCoreNumAiv());
+
+        // align to 32 bytes
+        KernelCatlassMatmulTilingData *tiling_data = nullptr;
+        auto tiling_buffer = TilingCache::AllocHostBuffer(tiling_data);
+        tiling_data->m = m;
+        tiling_data->n = n;
+        tiling_data->k = k;
+        tiling_data->weight_format_mode = weight_format_mode;
+        tiling_data->data_format_mode = data_format_mode;
+        return tiling_buffer;
+    });
 }
 
 HOST_API void catlass_matmul_basic(const at::Tensor &input_a, const at::Tensor &input_b, at::Tensor &output_c,
@@ -81,8 +77,9 @@ HOST_API void catlass_matmul_basic(const at::Tensor &input_a, const at::Tensor &
     int32_t n = input_b.size(1);
     TORCH_CHECK(input_b.size(0) == k, "input k dim shape mismatch");
 
-    uint32_t blockDim;
-    auto tiling_tensor = get_tiling(m, n, k, formatMode, dTypeMap[aType], blockDim);
+    TilingCacheEntry tiling = get_tiling(m, n, k, formatMode, dTypeMap[aType]);
+    uint32_t blockDim = tiling.blockDim;
+    auto tiling_tensor = tiling.tiling;
 
     // launch the kernel function via torch
     auto workspace_tensor = at::empty({1}, at::TensorOptions().dtype(at::kByte).device(input_a.options().device()));
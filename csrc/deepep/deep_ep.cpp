@@ -12,15 +12,55 @@ constexpr int PADDING_SIZE = 1;
 constexpr size_t HCOMM_NAME_LEN = 128;
 constexpr uint32_t NO_SCALES = 0;
 constexpr uint32_t DYNAMIC_SCALES = 2;
+constexpr uint32_t DYNAMIC_POW2_SCALES = 3;
+constexpr int64_t NO_COMM_QUANT = 0;
+constexpr int64_t INT8_COMM_QUANT = 2;
 constexpr int LOCAL_RANK_SIZE = 8;
-constexpr int MAX_BATCH_SIZE = 4096;
-constexpr int EXPERT_DATA_SIZE = 1 + MAX_BATCH_SIZE;  // 4097
+// token stride of the per token tables that the A2 kernels keep in notify_send_data, it bounds the A2 batch size
+constexpr int A2_MAX_BATCH_SIZE = 4096;
 constexpr int A3_MAX_HCCS_PEERS = 384;
 constexpr int A2_MAX_HCCS_PEERS = 8;
 constexpr uint32_t MAX_ROUNDS = 256;
 constexpr uint32_t MIN_TOKENS_PER_ROUND = 32;
 constexpr uint32_t MAX_TOKENS_PER_ROUND = 8192;
 constexpr uint32_t MAX_TOTAL_TOKENS = 131072;
+// replicas of one logical expert, dispatch_layout keeps the whole replica table in UB
+constexpr int64_t MAX_EXPERT_REPLICAS = 8;
+
+// Keeps pooled when it already has the requested shape and options, so repeated calls do not go through the allocator.
+static at::Tensor reuse_or_empty(at::Tensor &pooled, at::IntArrayRef sizes, const at::TensorOptions &options)
+{
+    if (not pooled.defined() or pooled.sizes() != sizes or pooled.dtype() != options.dtype() or
+        pooled.device() != options.device()) {
+        pooled = at::empty(sizes, options);
+    }
+    return pooled;
+}
+
+// A call with return_recv_hook runs on the comm stream like an async one. Its event goes into the hook instead of
+// to the caller, so the receiving side is only ordered after the kernel once the hook is called.
+static std::function<void()> make_recv_hook(std::optional<EventHandle> &event, bool return_recv_hook)
+{
+    if (not return_recv_hook) {
+        return [] {};
+    }
+    EventHandle recv_event = event.value();
+    event.reset();
+    return [recv_event] { recv_event.current_stream_wait(); };
+}
+
+// Adds the tokens each local expert received in one dispatch to the caller's load statistics. It stays on the stream
+// of the dispatch, so the expert placement balancer needs neither a reduction over the routing nor a host copy.
+static void accumulate_expert_recv_stats(const std::optional<at::Tensor> &stats, const at::Tensor &recv_counts)
+{
+    if (not stats.has_value()) {
+        return;
+    }
+    EP_HOST_ASSERT(stats->scalar_type() == at::kInt);
+    EP_HOST_ASSERT(stats->dim() == 1 and stats->is_contiguous());
+    EP_HOST_ASSERT(stats->numel() == recv_counts.numel());
+    stats->add_(recv_counts);
+}
 
 Buffer::Buffer(int64_t rank, int64_t num_ranks, int64_t num_nvl_bytes, int64_t num_rdma_bytes, bool low_latency_mode,
                std::string moe_all_to_all_group_name)
@@ -29,7 +69,8 @@ Buffer::Buffer(int64_t rank, int64_t num_ranks, int64_t num_nvl_bytes, int64_t n
       num_nvl_bytes(num_nvl_bytes),
       num_rdma_bytes(num_rdma_bytes),
       low_latency_mode(low_latency_mode),
-      moe_all_to_all_group_name(moe_all_to_all_group_name)
+      moe_all_to_all_group_name(moe_all_to_all_group_name),
+      comm_stream(c10_npu::getNPUStreamFromPool(true))
 {
     rdma_rank = rank;
     EP_HOST_ASSERT(0 <= rank and rank < num_ranks);
@@ -49,6 +90,8 @@ Buffer::Buffer(int64_t rank, int64_t num_ranks, int64_t num_nvl_bytes, int64_t n
     const char *roundEnv = std::getenv("DEEPEP_NORMAL_LONG_SEQ_ROUND");
     const char *tokensEnv = std::getenv("DEEPEP_NORMAL_LONG_SEQ_PER_ROUND_TOKENS");
     this->combine_enable_long_seq = get_value_from_env("DEEPEP_NORMAL_COMBINE_ENABLE_LONG_SEQ", 0);
+    this->combine_comm_quant = get_value_from_env("DEEPEP_NORMAL_COMBINE_COMM_QUANT", 0);
+    this->is_token_in_rank_bitmap = get_value_from_env("DEEPEP_IS_TOKEN_IN_RANK_BITMAP", 0);
     bool roundSet = (roundEnv != nullptr);
     bool tokensSet = (tokensEnv != nullptr);
 
@@ -92,30 +135,41 @@ bool Buffer::is_available() const
     return available;
 }
 
-std::tuple<torch::Tensor, std::optional<torch::Tensor>, torch::Tensor, torch::Tensor, std::optional<EventHandle>>
+std::tuple<torch::Tensor, std::optional<torch::Tensor>, torch::Tensor, torch::Tensor, DispatchLayout,
+           std::optional<EventHandle>>
 Buffer::get_dispatch_layout(const torch::Tensor &topk_idx, int num_experts, std::optional<EventHandle> &previous_event,
-                            bool async, bool allocate_on_comm_stream)
+                            bool async, bool allocate_on_comm_stream,
+                            const std::optional<torch::Tensor> &expert_replica_table)
 {
     EP_HOST_ASSERT(topk_idx.dim() == 2);
     EP_HOST_ASSERT(topk_idx.is_contiguous());
     EP_HOST_ASSERT(num_experts > 0);
     EP_HOST_ASSERT(topk_idx.size(0) <= round * per_round_tokens);
+    if (expert_replica_table.has_value()) {
+        // [num_logical_experts, 1 + max_replicas], the replica count of each logical expert then its physical ids
+        EP_HOST_ASSERT(expert_replica_table->dim() == 2 and expert_replica_table->is_contiguous());
+        EP_HOST_ASSERT(expert_replica_table->scalar_type() == at::kInt);
+        const int64_t max_replicas = expert_replica_table->size(1) - 1;
+        EP_HOST_ASSERT(max_replicas >= 1 and max_replicas <= MAX_EXPERT_REPLICAS);
+        // counts and ids are not read back here, the layout kernel keeps any entry out of range unmapped
+    }
+    CommStreamScope stream_scope(comm_stream, previous_event, async, allocate_on_comm_stream);
 
-    this->new_topk_idx = topk_idx;
+    DispatchLayout layout;
+    at::Tensor new_topk_idx = topk_idx;
     // for padding
     if (topk_idx.size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - topk_idx.size(0);
+        layout.padding_cnt = PADDING_SIZE - topk_idx.size(0);
         std::vector<at::Tensor> topk_blocks;
         if (topk_idx.size(0) != 0) {
             topk_blocks.emplace_back(topk_idx);
         }
         int topk = static_cast<int>(topk_idx.size(1));
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < layout.padding_cnt; i++) {
             at::Tensor tmp_topk = torch::arange(0, topk, topk_idx.options()).reshape({1, topk});
             topk_blocks.emplace_back(tmp_topk);
         }
-        this->new_topk_idx = torch::cat(topk_blocks, 0);
+        new_topk_idx = torch::cat(topk_blocks, 0);
     }
 
     const int num_tokens = new_topk_idx.size(0);
@@ -127,11 +181,21 @@ Buffer::get_dispatch_layout(const torch::Tensor &topk_idx, int num_experts, std:
 
     auto num_tokens_per_expert = at::zeros({round, num_experts}, at::dtype(at::kInt).device(device));
     auto num_tokens_per_rank = at::zeros({num_ranks}, at::dtype(at::kInt).device(device));
-    auto is_token_in_rank = at::zeros({num_tokens, num_ranks}, at::dtype(at::kInt).device(device));
-    const int notify_send_data_size =
-        num_experts * EXPERT_DATA_SIZE + server_num + MAX_BATCH_SIZE * (1 + 2 * server_num + num_experts);
+    // in bitmap mode bit r % 32 of column r / 32 tells whether a token goes to rank r
+    const int64_t is_token_in_rank_bitmap = this->is_token_in_rank_bitmap ? 1 : 0;
+    const int is_token_in_rank_cols = this->is_token_in_rank_bitmap ? (num_ranks + 31) / 32 : num_ranks;
+    auto is_token_in_rank = at::zeros({num_tokens, is_token_in_rank_cols}, at::dtype(at::kInt).device(device));
+    // Within one server the layout only keeps a copy of the expert counts per core in notify send data, at most one
+    // core per token, and every copy is written with a 32 byte aligned length.
+    int notify_send_data_size = num_experts * num_tokens + 32 / static_cast<int>(sizeof(int32_t));
+    if (soc_version == op::SocVersion::ASCEND910B and num_rdma_ranks > 1) {
+        // across A2 servers notify_dispatch_a2 reads these tables with the same fixed stride on every server
+        EP_HOST_ASSERT(num_tokens <= A2_MAX_BATCH_SIZE);
+        notify_send_data_size = num_experts * (1 + A2_MAX_BATCH_SIZE) + server_num +
+                                A2_MAX_BATCH_SIZE * (1 + 2 * server_num + num_experts);
+    }
     /*
-    The notify send data is constructed by 7 parameters and the 7 parameters are ordered as follows:
+    Across A2 servers the notify send data is made of 7 parameters, ordered as follows:
     1. the number of the tokens that every expert received from this NPU.
        size:[numExpert]
     2. The number of tokens received by each server from this NPU (deduplicated).
@@ -149,25 +213,34 @@ Buffer::get_dispatch_layout(const torch::Tensor &topk_idx, int num_experts, std:
     */
     auto send_token_idx_small = at::zeros({num_tokens, num_topk}, at::dtype(at::kInt).device(device));
     auto notify_send_data = at::zeros({notify_send_data_size}, at::dtype(at::kInt).device(device));
-    EXEC_NPU_CMD(aclnnDispatchLayout, new_topk_idx, num_tokens, num_ranks, num_experts, num_topk, local_ranksize,
-                 per_round_tokens, num_tokens_per_rank, num_tokens_per_expert, is_token_in_rank, notify_send_data,
-                 send_token_idx_small);
+    // the layout kernel picks a replica of every logical expert round robin by token, num_experts counts replicas
+    std::optional<at::Tensor> physical_topk_idx = std::nullopt;
+    if (expert_replica_table.has_value()) {
+        physical_topk_idx = at::empty_like(new_topk_idx);
+    }
+    EXEC_NPU_CMD(aclnnDispatchLayout, new_topk_idx, expert_replica_table, num_tokens, num_ranks, num_experts, num_topk,
+                 local_ranksize, per_round_tokens, is_token_in_rank_bitmap, num_tokens_per_rank, num_tokens_per_expert,
+                 is_token_in_rank, notify_send_data, send_token_idx_small, physical_topk_idx);
 
-    this->notify_send_data = notify_send_data;
-    this->send_token_idx_small = send_token_idx_small;
-    this->notify_send_data_size = notify_send_data_size;
+    layout.topk_idx = physical_topk_idx.has_value() ? physical_topk_idx.value() : new_topk_idx;
+    layout.replica_mapped = physical_topk_idx.has_value();
+    layout.notify_send_data = notify_send_data;
+    layout.notify_send_data_size = notify_send_data_size;
+    layout.send_token_idx_small = send_token_idx_small;
 
     std::optional<torch::Tensor> num_tokens_per_rdma_rank = std::nullopt;
-    std::optional<EventHandle> output_event = std::nullopt;
+    std::optional<EventHandle> output_event =
+        stream_scope.Finish({topk_idx, new_topk_idx, layout.topk_idx, num_tokens_per_rank, num_tokens_per_expert,
+                             is_token_in_rank, notify_send_data, send_token_idx_small});
 
     auto num_tokens_per_expert_one_dim = num_tokens_per_expert.flatten();
     return std::make_tuple(num_tokens_per_rank, num_tokens_per_rdma_rank, num_tokens_per_expert_one_dim,
-                           is_token_in_rank, output_event);
+                           is_token_in_rank, layout, output_event);
 }
 
-torch::Tensor Buffer::get_notify_send_data()
+torch::Tensor Buffer::get_notify_send_data(const DispatchLayout &layout) const
 {
-    return this->notify_send_data;
+    return layout.notify_send_data;
 }
 
 int Buffer::get_num_rdma_ranks() const
@@ -181,22 +254,42 @@ int Buffer::get_rdma_rank() const
 }
 
 std::tuple<at::Tensor, std::optional<at::Tensor>, std::optional<at::Tensor>, std::optional<at::Tensor>,
-           std::vector<int>, at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor, std::optional<EventHandle>>
+           std::vector<int>, at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor, std::optional<at::Tensor>,
+           DispatchHandle, std::optional<EventHandle>>
 Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor> &x_scales,
                            const std::optional<at::Tensor> &topk_idx, const std::optional<at::Tensor> &topk_weights,
                            const std::optional<at::Tensor> &num_tokens_per_rank, const at::Tensor &is_token_in_rank,
                            const std::optional<at::Tensor> &num_tokens_per_expert, int cached_num_recv_tokens,
                            const std::optional<at::Tensor> &cached_rank_prefix_matrix,
                            const std::optional<at::Tensor> &cached_channel_prefix_matrix,
-                           const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats, int expert_alignment,
+                           const std::optional<DispatchHandle> &cached_handle,
+                           const std::optional<DispatchLayout> &layout,
+                           const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats,
+                           const std::optional<at::Tensor> &cumulative_local_expert_recv_stats, int expert_alignment,
                            int num_worst_tokens, const Config &config, std::optional<EventHandle> &previous_event,
                            bool async, bool allocate_on_comm_stream, bool use_quant)
 {
     // One channel use two blocks, even-numbered blocks for sending, odd-numbered blocks for receiving.
     EP_HOST_ASSERT(config.num_sms % 2 == 0);
     int num_channels = config.num_sms / 2;
+    CommStreamScope stream_scope(comm_stream, previous_event, async, allocate_on_comm_stream);
+
+    // A cached handle already holds the routing and the notify_dispatch results of an earlier dispatch, so the
+    // metadata exchange and its host reductions are skipped and only the tokens are sent again.
+    bool cached_mode = cached_handle.has_value();
+    DispatchHandle handle;
+    if (cached_mode) {
+        handle = cached_handle.value();
+        handle.ori_x = at::Tensor();
+        handle.padding_cnt = 0;
+    } else {
+        EP_HOST_ASSERT(layout.has_value());
+        handle.topk_idx = layout->topk_idx;
+        handle.replica_mapped = layout->replica_mapped;
+        handle.send_token_idx_small = layout->send_token_idx_small;
+    }
 
-    at::Tensor expert_ids = new_topk_idx.to(at::kInt);
+    at::Tensor expert_ids = handle.topk_idx.to(at::kInt);
     int64_t tp_size = 1;
     int64_t tp_rank = 0;
     int64_t quant_mode = use_quant ? DYNAMIC_SCALES : NO_SCALES;
@@ -211,37 +304,39 @@ Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor>
     at::Tensor new_x = x;
     // for padding
     if (topk_idx->size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - topk_idx->size(0);
+        handle.padding_cnt = PADDING_SIZE - topk_idx->size(0);
         std::vector<at::Tensor> x_blocks;
         if (topk_idx->size(0) != 0) {
             x_blocks.emplace_back(x);
         } else {
-            this->ori_x = x.clone();
+            handle.ori_x = x.clone();
         }
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < handle.padding_cnt; i++) {
             at::Tensor tmp_x = torch::ones({1, x.size(1)}, x.options()) * (i + 1) * 2;
             x_blocks.emplace_back(tmp_x);
         }
         new_x = torch::cat(x_blocks, 0);
     }
 
-    EP_HOST_ASSERT(num_tokens_per_rank.has_value());
-    EP_HOST_ASSERT(num_tokens_per_expert.has_value());
+    if (not cached_mode) {
+        EP_HOST_ASSERT(num_tokens_per_rank.has_value());
+        EP_HOST_ASSERT(num_tokens_per_expert.has_value());
 
-    // Type checks
-    EP_HOST_ASSERT(num_tokens_per_expert->scalar_type() == at::kInt);
-    EP_HOST_ASSERT(num_tokens_per_rank->scalar_type() == at::kInt);
+        // Type checks
+        EP_HOST_ASSERT(num_tokens_per_expert->scalar_type() == at::kInt);
+        EP_HOST_ASSERT(num_tokens_per_rank->scalar_type() == at::kInt);
 
-    // Shape and contiguous checks
+        // Shape and contiguous checks
+        EP_HOST_ASSERT(num_tokens_per_expert->dim() == 1 and num_tokens_per_expert->is_contiguous());
+        EP_HOST_ASSERT(num_tokens_per_expert->size(0) % num_ranks == 0);
+        EP_HOST_ASSERT(num_tokens_per_rank->dim() == 1 and num_tokens_per_rank->is_contiguous());
+        EP_HOST_ASSERT(num_tokens_per_rank->size(0) == num_ranks);
+    }
     EP_HOST_ASSERT(new_x.dim() == 2 and new_x.is_contiguous());
-    EP_HOST_ASSERT(num_tokens_per_expert->dim() == 1 and num_tokens_per_expert->is_contiguous());
-    EP_HOST_ASSERT(num_tokens_per_expert->size(0) % num_ranks == 0);
-    EP_HOST_ASSERT(num_tokens_per_rank->dim() == 1 and num_tokens_per_rank->is_contiguous());
-    EP_HOST_ASSERT(num_tokens_per_rank->size(0) == num_ranks);
 
     auto num_tokens = static_cast<int>(new_x.size(0)), hidden = static_cast<int>(new_x.size(1));
-    auto num_experts = static_cast<int64_t>(num_tokens_per_expert->size(0) / round);
+    auto num_experts = cached_mode ? static_cast<int64_t>(handle.recv_offset.size(1))
+                                   : static_cast<int64_t>(num_tokens_per_expert->size(0) / round);
     auto num_local_experts = static_cast<int>(num_experts / num_ranks);
 
     // Top-k checks
@@ -252,7 +347,7 @@ Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor>
         EP_HOST_ASSERT(num_experts > 0);
         EP_HOST_ASSERT(topk_idx->dim() == 2 and topk_idx->is_contiguous());
         EP_HOST_ASSERT(topk_weights->dim() == 2 and topk_weights->is_contiguous());
-        EP_HOST_ASSERT(num_tokens == new_topk_idx.size(0));
+        EP_HOST_ASSERT(num_tokens == handle.topk_idx.size(0));
         EP_HOST_ASSERT(num_topk == topk_weights->size(1));
         EP_HOST_ASSERT(topk_weights->scalar_type() == at::kFloat);
     }
@@ -279,13 +374,6 @@ Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor>
         dispatch_wait_recv_cost_stats_out = dispatch_wait_recv_cost_stats.value();
     }
 
-    int send_per_group = 3;  // (send_to_expert_num, send_to_expert_offset, send_rank_tokens)
-
-    auto send_data = torch::empty({round, num_experts * send_per_group}, at::dtype(at::kInt).device(x.device()));
-    int64_t send_count = send_per_group * num_local_experts * num_ranks * round;
-
-    auto send_data_offset = torch::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor recv_data = torch::empty({round, num_experts * send_per_group}, at::dtype(at::kInt).device(x.device()));
     // get ep name
     char hcom_ep_name[HCOMM_NAME_LEN];
     if (!moe_all_to_all_group_name.empty()) {
@@ -293,43 +381,95 @@ Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor>
     } else {
         HCCL_CHECK(HcclGetCommName(ep_comm, hcom_ep_name));
     }
-    at::Tensor total_recv_token = torch::empty({1}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor recv_offset = at::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor recv_count = at::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor max_bs = torch::empty({1}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor recv_tokens_per_expert =
-        torch::empty({round * num_local_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor expert_global_offset = at::empty({num_local_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor srcrank_in_expert_offset =
-        at::empty({num_local_experts * num_ranks}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor r_in_srcrank_offset =
-        at::empty({num_local_experts * num_ranks * round}, at::dtype(at::kInt).device(x.device()));
 
-    int64_t local_rank_size = num_ranks;
-    int64_t local_rank_id = rank % local_rank_size;
-    auto new_num_tokens_per_expert = num_tokens_per_expert.value();
-    std::vector<int> num_recv_tokens_per_expert_list;
-    // indicates the value type of the output num_recv_tokens_per_expert_list, with a range of [0, 1]
-    // 0 means the prefix sum of the number of tokens received by each expert;
-    // 1 means the number of tokens received by each expert (default)
-    int expert_token_nums_type = get_value_from_env("MOE_EXPERT_TOKEN_NUMS_TYPE", 1);
-    EP_HOST_ASSERT(expert_token_nums_type == 1 or expert_token_nums_type == 0);
-
-    EXEC_NPU_CMD(aclnnNotifyDispatch, send_data, new_num_tokens_per_expert, send_count, num_tokens,
-                 hcom_ep_name,  // commGroup
-                 num_ranks,     // rankSize
-                 rank,          // rankId
-                 local_rank_size, local_rank_id, round, per_round_tokens, send_data_offset, recv_data, recv_count,
-                 recv_offset, expert_global_offset, srcrank_in_expert_offset, r_in_srcrank_offset, total_recv_token,
-                 max_bs, recv_tokens_per_expert);
-    auto send_token_idx_small = this->send_token_idx_small;
+    // With num_worst_tokens the outputs are sized from that bound instead of the counts of notify_dispatch and the
+    // per expert counts stay on device, so the host never waits for the device and the call can be graph captured.
+    // The bound has to be the same on every rank and cover both the tokens of any rank and the rows received here.
+    bool worst_case_layout = num_worst_tokens > 0;
+    if (not cached_mode) {
+        int send_per_group = 3;  // (send_to_expert_num, send_to_expert_offset, send_rank_tokens)
+
+        auto send_data = torch::empty({round, num_experts * send_per_group}, at::dtype(at::kInt).device(x.device()));
+        int64_t send_count = send_per_group * num_local_experts * num_ranks * round;
+
+        handle.send_data_offset = torch::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
+        at::Tensor recv_data =
+            torch::empty({round, num_experts * send_per_group}, at::dtype(at::kInt).device(x.device()));
+        at::Tensor total_recv_token = torch::empty({1}, at::dtype(at::kInt).device(x.device()));
+        handle.recv_offset = at::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
+        handle.recv_count = at::empty({round, num_experts}, at::dtype(at::kInt).device(x.device()));
+        at::Tensor max_bs = torch::empty({1}, at::dtype(at::kInt).device(x.device()));
+        handle.recv_tokens_per_expert =
+            torch::empty({round * num_local_experts}, at::dtype(at::kInt).device(x.device()));
+        handle.expert_global_offset = at::empty({num_local_experts}, at::dtype(at::kInt).device(x.device()));
+        handle.srcrank_in_expert_offset =
+            at::empty({num_local_experts * num_ranks}, at::dtype(at::kInt).device(x.device()));
+        handle.r_in_srcrank_offset =
+            at::empty({num_local_experts * num_ranks * round}, at::dtype(at::kInt).device(x.device()));
+
+        int64_t local_rank_size = num_ranks;
+        int64_t local_rank_id = rank % local_rank_size;
+        auto new_num_tokens_per_expert = num_tokens_per_expert.value();
+        // indicates the value type of the output num_recv_tokens_per_expert_list, with a range of [0, 1]
+        // 0 means the prefix sum of the number of tokens received by each expert;
+        // 1 means the number of tokens received by each expert (default)
+        int expert_token_nums_type = get_value_from_env("MOE_EXPERT_TOKEN_NUMS_TYPE", 1);
+        EP_HOST_ASSERT(expert_token_nums_type == 1 or expert_token_nums_type == 0);
+
+        EXEC_NPU_CMD(aclnnNotifyDispatch, send_data, new_num_tokens_per_expert, send_count, num_tokens,
+                     hcom_ep_name,  // commGroup
+                     num_ranks,     // rankSize
+                     rank,          // rankId
+                     local_rank_size, local_rank_id, round, per_round_tokens, handle.send_data_offset, recv_data,
+                     handle.recv_count, handle.recv_offset, handle.expert_global_offset,
+                     handle.srcrank_in_expert_offset, handle.r_in_srcrank_offset, total_recv_token, max_bs,
+                     handle.recv_tokens_per_expert);
+
+        if (worst_case_layout) {
+            EP_HOST_ASSERT(num_tokens <= num_worst_tokens);
+            handle.real_max_bs = num_worst_tokens;
+            handle.num_recv_tokens = num_worst_tokens;
+            // 多轮处理为一维
+            auto round_recv_tokens =
+                handle.recv_tokens_per_expert.view({round, num_local_experts}).sum(0, false, at::kLong);
+            handle.num_recv_tokens_per_expert =
+                (expert_token_nums_type == 0) ? round_recv_tokens.cumsum(0) : round_recv_tokens;
+        } else {
+            handle.real_max_bs =
+                static_cast<int64_t>(std::max(max_bs.item<int>(), static_cast<int>(num_worst_tokens)));
+            handle.num_recv_tokens = total_recv_token.item<int>();
+
+            // notify_dispatch has finished once max_bs is on the host, so reducing the counts before the dispatch
+            // launch costs no extra wait
+            auto recv_token_per_exp_cpu = handle.recv_tokens_per_expert.to(at::kCPU);
+            auto recv_token_per_exp_ptr = recv_token_per_exp_cpu.data_ptr<int32_t>();
+
+            int token_cnt = 0;
+            // 多轮处理为一维
+            std::vector<int> round_recv_tokens_per_expert;
+            round_recv_tokens_per_expert.resize(num_local_experts);
+            for (int r = 0; r < round; r++) {
+                for (int local_e = 0; local_e < num_local_experts; ++local_e) {
+                    int current_tokens = static_cast<int>(recv_token_per_exp_ptr[r * num_local_experts + local_e]);
+                    token_cnt = round_recv_tokens_per_expert[local_e] + current_tokens;
+                    round_recv_tokens_per_expert[local_e] = token_cnt;
+                }
+            }
 
-    real_max_bs = static_cast<int64_t>(std::max(max_bs.item<int>(), static_cast<int>(num_worst_tokens)));
+            token_cnt = 0;
+            for (int local_e = 0; local_e < num_local_experts; ++local_e) {
+                int current_tokens = static_cast<int>(round_recv_tokens_per_expert[local_e]);
+                token_cnt = (expert_token_nums_type == 0) ? token_cnt + current_tokens : current_tokens;
+                handle.num_recv_tokens_per_expert_list.emplace_back(token_cnt);
+            }
+        }
+    }
 
     // dispatch算子内部按照 min(per_round_tokens, real_max_bs)来预留显存
-    int64_t global_bs = static_cast<int64_t>(std::min(static_cast<int64_t>(per_round_tokens), real_max_bs) * num_ranks);
+    int64_t global_bs =
+        static_cast<int64_t>(std::min(static_cast<int64_t>(per_round_tokens), handle.real_max_bs) * num_ranks);
 
-    int64_t trt = total_recv_token.item<int>();
+    int64_t trt = handle.num_recv_tokens;
     int num_recv_tokens = (trt == 0) ? 1 : trt;
     auto expandx_out = use_quant ? torch::empty({num_recv_tokens, hidden}, at::dtype(at::kChar).device(x.device()))
                                  : torch::empty({num_recv_tokens, hidden}, x.options());
@@ -339,46 +479,36 @@ Buffer::intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor>
         recv_topk_idx = at::empty({trt, num_topk}, topk_idx->options());
         recv_topk_weights = at::empty({trt, num_topk}, topk_weights->options());
     }
-    EXEC_NPU_CMD(aclnnCamMoeDispatchNormal, new_x, expert_ids, send_data_offset, send_token_idx_small, recv_offset,
-                 recv_count, expert_global_offset, srcrank_in_expert_offset, r_in_srcrank_offset, hcom_ep_name,
+    EXEC_NPU_CMD(aclnnCamMoeDispatchNormal, new_x, expert_ids, handle.send_data_offset, handle.send_token_idx_small,
+                 handle.recv_offset, handle.recv_count, handle.expert_global_offset, handle.srcrank_in_expert_offset,
+                 handle.r_in_srcrank_offset, hcom_ep_name,
                  num_ranks,  // rankSize
                  rank,       // rankId
-                 hcom_ep_name, tp_size, tp_rank, num_experts, quant_mode, real_max_bs, global_bs, round,
+                 hcom_ep_name, tp_size, tp_rank, num_experts, quant_mode, handle.real_max_bs, global_bs, round,
                  per_round_tokens, expandx_out, dynamic_scales_out, expand_idx_out, dispatch_wait_recv_cost_stats_out);
-    auto recv_token_per_exp_cpu = recv_tokens_per_expert.to(at::kCPU);
-    auto recv_token_per_exp_ptr = recv_token_per_exp_cpu.data_ptr<int32_t>();
-
-    int token_cnt = 0;
-    // 多轮处理为一维
-    std::vector<int> round_recv_tokens_per_expert;
-    round_recv_tokens_per_expert.resize(num_local_experts);
-    for (int r = 0; r < round; r++) {
-        for (int local_e = 0; local_e < num_local_experts; ++local_e) {
-            int current_tokens = static_cast<int>(recv_token_per_exp_ptr[r * num_local_experts + local_e]);
-            token_cnt = round_recv_tokens_per_expert[local_e] + current_tokens;
-            round_recv_tokens_per_expert[local_e] = token_cnt;
-        }
-    }
-
-    token_cnt = 0;
-    for (int local_e = 0; local_e < num_local_experts; ++local_e) {
-        int current_tokens = static_cast<int>(round_recv_tokens_per_expert[local_e]);
-        token_cnt = (expert_token_nums_type == 0) ? token_cnt + current_tokens : current_tokens;
-        num_recv_tokens_per_expert_list.emplace_back(token_cnt);
+    if (cumulative_local_expert_recv_stats.has_value()) {
+        accumulate_expert_recv_stats(cumulative_local_expert_recv_stats,
+                                     handle.recv_tokens_per_expert.view({round, num_local_experts}).sum(0));
     }
 
-    auto recv_count_one_dim = recv_count.sum(0, false).to(at::kInt);
+    auto recv_count_one_dim = handle.recv_count.sum(0, false).to(at::kInt);
+    event = stream_scope.Finish({x, new_x, topk_idx, topk_weights, num_tokens_per_rank, is_token_in_rank,
+                                 num_tokens_per_expert, dispatch_wait_recv_cost_stats,
+                                 cumulative_local_expert_recv_stats, expandx_out, dynamic_scales_out, expand_idx_out,
+                                 recv_count_one_dim, handle.send_token_idx_small, handle.num_recv_tokens_per_expert});
     // Return values
     return {expandx_out,
             dynamic_scales_out,
             recv_topk_idx,
             recv_topk_weights,
-            num_recv_tokens_per_expert_list,
+            handle.num_recv_tokens_per_expert_list,
             rank_prefix_matrix,
             channel_prefix_matrix,
             recv_channel_prefix_matrix,
             expand_idx_out,
             recv_count_one_dim,
+            handle.num_recv_tokens_per_expert,
+            handle,
             event};
 }
 
@@ -388,7 +518,7 @@ Buffer::notify_verify(const at::Tensor &x, const std::optional<at::Tensor> &x_sc
                       const std::optional<at::Tensor> &num_tokens_per_rank, const at::Tensor &is_token_in_rank,
                       const std::optional<at::Tensor> &num_tokens_per_expert, int cached_num_recv_tokens,
                       const std::optional<at::Tensor> &cached_rank_prefix_matrix,
-                      const std::optional<at::Tensor> &cached_channel_prefix_matrix,
+                      const std::optional<at::Tensor> &cached_channel_prefix_matrix, const DispatchLayout &layout,
                       const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats, int expert_alignment,
                       int num_worst_tokens, const Config &config, std::optional<EventHandle> &previous_event,
                       bool async, bool allocate_on_comm_stream, bool use_quant)
@@ -396,8 +526,10 @@ Buffer::notify_verify(const at::Tensor &x, const std::optional<at::Tensor> &x_sc
     // One channel use two blocks, even-numbered blocks for sending, odd-numbered blocks for receiving.
     EP_HOST_ASSERT(config.num_sms % 2 == 0);
     int num_channels = config.num_sms / 2;
+    // the results are returned without an event, so the verification always finishes on the compute stream
+    CommStreamScope stream_scope(comm_stream, previous_event, false, false);
 
-    at::Tensor expert_ids = new_topk_idx.to(at::kInt);
+    at::Tensor expert_ids = layout.topk_idx.to(at::kInt);
     int64_t tp_size = 1;
     int64_t tp_rank = 0;
     int64_t quant_mode = use_quant ? DYNAMIC_SCALES : NO_SCALES;
@@ -412,15 +544,12 @@ Buffer::notify_verify(const at::Tensor &x, const std::optional<at::Tensor> &x_sc
     at::Tensor new_x = x;
     // for padding
     if (topk_idx->size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - topk_idx->size(0);
+        int padding_cnt = PADDING_SIZE - topk_idx->size(0);
         std::vector<at::Tensor> x_blocks;
         if (topk_idx->size(0) != 0) {
             x_blocks.emplace_back(x);
-        } else {
-            this->ori_x = x.clone();
         }
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < padding_cnt; i++) {
             at::Tensor tmp_x = torch::ones({1, x.size(1)}, x.options()) * (i + 1) * 2;
             x_blocks.emplace_back(tmp_x);
         }
@@ -453,7 +582,7 @@ Buffer::notify_verify(const at::Tensor &x, const std::optional<at::Tensor> &x_sc
         EP_HOST_ASSERT(num_experts > 0);
         EP_HOST_ASSERT(topk_idx->dim() == 2 and topk_idx->is_contiguous());
         EP_HOST_ASSERT(topk_weights->dim() == 2 and topk_weights->is_contiguous());
-        EP_HOST_ASSERT(num_tokens == new_topk_idx.size(0));
+        EP_HOST_ASSERT(num_tokens == layout.topk_idx.size(0));
         EP_HOST_ASSERT(num_topk == topk_weights->size(1));
         EP_HOST_ASSERT(topk_weights->scalar_type() == at::kFloat);
     }
@@ -533,18 +662,41 @@ void Buffer::clean_low_latency_buffer(int num_max_dispatch_tokens_per_rank, int
     return;
 }
 
+LowLatencyOutputs &Buffer::next_low_latency_outputs(int64_t num_max_dispatch_tokens_per_rank, int64_t hidden,
+                                                    int64_t num_experts)
+{
+    auto key = std::make_tuple(num_max_dispatch_tokens_per_rank, hidden, num_experts);
+    if (key != low_latency_outputs_key) {
+        low_latency_outputs = {};
+        low_latency_outputs_key = key;
+    }
+    low_latency_outputs_idx ^= 1;
+    return low_latency_outputs[low_latency_outputs_idx];
+}
+
+at::Tensor Buffer::get_next_low_latency_combine_buffer(const DispatchHandle &dispatch_handle)
+{
+    EP_HOST_ASSERT(dispatch_handle.low_latency_slot >= 0);
+    LowLatencyOutputs &outputs = low_latency_outputs[dispatch_handle.low_latency_slot];
+    EP_HOST_ASSERT(outputs.packed_recv_x.defined());
+    // combine input has the rows of the dispatch output, in bf16
+    return reuse_or_empty(outputs.combine_x, outputs.packed_recv_x.sizes(),
+                          outputs.packed_recv_x.options().dtype(at::kBFloat16));
+}
+
 std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandle>>
 Buffer::intranode_combine(const torch::Tensor &x, const torch::Tensor &topk_idx,
                           const std::optional<torch::Tensor> &topk_weights, const torch::Tensor &src_idx,
-                          const torch::Tensor &send_head, const std::optional<at::Tensor> &combine_send_cost_stats)
+                          const torch::Tensor &send_head, const std::optional<at::Tensor> &combine_send_cost_stats,
+                          const DispatchHandle &dispatch_handle, std::optional<EventHandle> &previous_event, bool async,
+                          bool allocate_on_comm_stream)
 {
     EP_HOST_ASSERT(x.dim() == 2 and x.is_contiguous());
+    CommStreamScope stream_scope(comm_stream, previous_event, async, allocate_on_comm_stream);
     at::Tensor recv_x = x;
 
-    at::Tensor topk_idx_p = topk_idx;
-    if (this->is_padding) {
-        topk_idx_p = this->new_topk_idx;
-    }
+    const bool is_padding = dispatch_handle.padding_cnt > 0;
+    at::Tensor topk_idx_p = (is_padding or dispatch_handle.replica_mapped) ? dispatch_handle.topk_idx : topk_idx;
 
     auto topk_idx_int32 = topk_idx_p.to(at::kInt);
     at::Tensor expand_ids = topk_idx_int32;
@@ -557,14 +709,14 @@ Buffer::intranode_combine(const torch::Tensor &x, const torch::Tensor &topk_idx,
     at::Tensor expert_scales;
     // for padding
     if (topk_weights.has_value()) {
-        if (!this->is_padding) {
+        if (!is_padding) {
             expert_scales = topk_weights.value();
         } else {
             std::vector<at::Tensor> weight_blocks;
             if (topk_weights->size(0) != 0) {
                 weight_blocks.emplace_back(topk_weights.value());
             }
-            for (int i = 0; i < this->padding_cnt; i++) {
+            for (int i = 0; i < dispatch_handle.padding_cnt; i++) {
                 if (topk_weights.has_value()) {
                     at::Tensor tmp_weight = torch::arange(0, num_topk, topk_weights->options()).reshape({1, num_topk});
                     weight_blocks.emplace_back(tmp_weight);
@@ -605,17 +757,20 @@ Buffer::intranode_combine(const torch::Tensor &x, const torch::Tensor &topk_idx,
 
     int32_t round = this->combine_enable_long_seq ? this->round : 1;
     int32_t per_round_tokens = this->combine_enable_long_seq ? this->per_round_tokens : MAX_TOKENS_PER_ROUND;
+    int64_t comm_quant_mode = this->combine_comm_quant ? INT8_COMM_QUANT : NO_COMM_QUANT;
     EXEC_NPU_CMD(aclnnCamMoeCombineNormal, recv_x, token_src_info, ep_send_counts, expert_scales, tp_send_counts,
-                 hcom_ep_name, num_ranks, rank, hcom_ep_name, tp_world_size, tp_rankId, moe_expert_number, real_max_bs,
-                 round, per_round_tokens, combined_x, combine_send_cost_stats_out);
-
-    if (this->is_padding) {
-        if (this->padding_cnt == PADDING_SIZE) {
-            combined_x = this->ori_x;
+                 hcom_ep_name, num_ranks, rank, hcom_ep_name, tp_world_size, tp_rankId, moe_expert_number,
+                 dispatch_handle.real_max_bs, round, per_round_tokens, comm_quant_mode, combined_x,
+                 combine_send_cost_stats_out);
+    event = stream_scope.Finish({x, topk_idx_p, expand_ids, expert_scales, src_idx, send_head, combine_send_cost_stats,
+                                 combined_x});
+
+    if (is_padding) {
+        if (dispatch_handle.padding_cnt == PADDING_SIZE) {
+            combined_x = dispatch_handle.ori_x;
         } else {
-            combined_x = combined_x.slice(0, 0, PADDING_SIZE - this->padding_cnt);
+            combined_x = combined_x.slice(0, 0, PADDING_SIZE - dispatch_handle.padding_cnt);
         }
-        is_padding = false;
     }
 
     return {combined_x, recv_topk_weights, event};
@@ -623,30 +778,35 @@ Buffer::intranode_combine(const torch::Tensor &x, const torch::Tensor &topk_idx,
 
 std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<torch::Tensor>, std::optional<torch::Tensor>,
            std::vector<int>, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor,
-           std::optional<EventHandle>>
+           std::optional<torch::Tensor>, DispatchHandle, std::optional<EventHandle>>
 Buffer::internode_dispatch(
     const torch::Tensor &x, const std::optional<torch::Tensor> &x_scales, const std::optional<torch::Tensor> &topk_idx,
     const std::optional<torch::Tensor> &topk_weights, const std::optional<torch::Tensor> &num_tokens_per_rank,
     const std::optional<torch::Tensor> &num_tokens_per_rdma_rank, const torch::Tensor &is_token_in_rank,
-    const std::optional<torch::Tensor> &num_tokens_per_expert, const Config &config,
+    const std::optional<torch::Tensor> &num_tokens_per_expert, const DispatchLayout &layout,
+    const std::optional<torch::Tensor> &dispatch_wait_recv_cost_stats,
+    const std::optional<torch::Tensor> &cumulative_local_expert_recv_stats, int num_worst_tokens, const Config &config,
     std::optional<EventHandle> &previous_event, bool async, bool allocate_on_comm_stream, bool use_quant)
 {
     // One channel use two blocks, even-numbered blocks for sending, odd-numbered blocks for receiving.
     EP_HOST_ASSERT(config.num_sms % 2 == 0);
     int num_channels = config.num_sms / 2;
+    CommStreamScope stream_scope(comm_stream, previous_event, async, allocate_on_comm_stream);
+    DispatchHandle handle;
+    handle.topk_idx = layout.topk_idx;
+    handle.replica_mapped = layout.replica_mapped;
 
     at::Tensor new_x = x;
     // for padding
     if (topk_idx->size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - topk_idx->size(0);
+        handle.padding_cnt = PADDING_SIZE - topk_idx->size(0);
         std::vector<at::Tensor> x_blocks;
         if (topk_idx->size(0) != 0) {
             x_blocks.emplace_back(x);
         } else {
-            this->ori_x = x.clone();
+            handle.ori_x = x.clone();
         }
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < handle.padding_cnt; i++) {
             at::Tensor tmp_x = torch::zeros({1, x.size(1)}, x.options());
             x_blocks.emplace_back(tmp_x);
         }
@@ -678,7 +838,7 @@ Buffer::internode_dispatch(
         EP_HOST_ASSERT(num_experts > 0);
         EP_HOST_ASSERT(topk_idx->dim() == 2 and topk_idx->is_contiguous());
         EP_HOST_ASSERT(topk_weights->dim() == 2 and topk_weights->is_contiguous());
-        EP_HOST_ASSERT(num_tokens == new_topk_idx.size(0));
+        EP_HOST_ASSERT(num_tokens == layout.topk_idx.size(0));
         EP_HOST_ASSERT(num_topk == topk_weights->size(1));
         EP_HOST_ASSERT(topk_weights->scalar_type() == at::kFloat);
     }
@@ -687,14 +847,14 @@ Buffer::internode_dispatch(
     at::Tensor new_topk_weights;
     // for padding
     if (topk_weights.has_value()) {
-        if (!this->is_padding) {
+        if (handle.padding_cnt == 0) {
             new_topk_weights = topk_weights.value();
         } else {
             std::vector<at::Tensor> weight_blocks;
             if (topk_weights->size(0) != 0) {
                 weight_blocks.emplace_back(topk_weights.value());
             }
-            for (int i = 0; i < this->padding_cnt; i++) {
+            for (int i = 0; i < handle.padding_cnt; i++) {
                 at::Tensor tmp_weight = torch::arange(0, num_topk, topk_weights->options()).reshape({1, num_topk});
                 weight_blocks.emplace_back(tmp_weight);
             }
@@ -727,14 +887,20 @@ Buffer::internode_dispatch(
     int64_t expertTokenNumsType = 0;
 
     int64_t quant_mode = use_quant ? DYNAMIC_SCALES : NO_SCALES;
-    int64_t global_bs = static_cast<int64_t>(MAX_BATCH_SIZE * num_ranks);
-    at::Tensor expert_ids = new_topk_idx.to(at::kInt);
+    int64_t global_bs = static_cast<int64_t>(A2_MAX_BATCH_SIZE * num_ranks);
+    at::Tensor expert_ids = layout.topk_idx.to(at::kInt);
     at::Tensor xActiveMask = at::empty({1}, at::dtype(at::kInt).device(x.device()));
 
     auto expertTokenNums = at::zeros({1}, at::dtype(at::kLong).device(x.device()));
     auto epRecvCount = at::zeros({1}, at::dtype(at::kInt).device(x.device()));
     auto tpRecvCount = at::zeros({1}, at::dtype(at::kInt).device(x.device()));
     at::Tensor dispatch_wait_recv_cost_stats_out;
+    if (dispatch_wait_recv_cost_stats.has_value()) {
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->scalar_type() == torch::kInt32);
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->dim() == 1 and dispatch_wait_recv_cost_stats->is_contiguous());
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->size(0) == num_ranks);
+        dispatch_wait_recv_cost_stats_out = dispatch_wait_recv_cost_stats.value();
+    }
     auto recv_topk_idx = std::optional<at::Tensor>();
     auto recv_topk_weights = std::optional<at::Tensor>();
     // Wait streams
@@ -752,28 +918,28 @@ Buffer::internode_dispatch(
     EP_HOST_ASSERT(expert_token_nums_type == 1 or expert_token_nums_type == 0);
 
     // Corresponding to the output data and length of the layout
-    auto new_send_data = this->notify_send_data;
-    int send_count = this->notify_send_data_size;
+    auto new_send_data = layout.notify_send_data;
+    int send_count = layout.notify_send_data_size;
 
     auto send_data_offset = at::empty({num_experts}, at::dtype(at::kInt).device(x.device()));
     at::Tensor tmp_data =
         at::empty({send_count * num_ranks}, at::dtype(at::kInt).device(x.device()));  // 给notify算子用来临时存数的空间
     at::Tensor recv_data = at::empty({send_count * num_ranks}, at::dtype(at::kInt).device(x.device()));
     at::Tensor token_server_idx =
-        at::empty({MAX_BATCH_SIZE, server_num}, at::dtype(at::kInt).device(x.device()));  // offset_outer
+        at::empty({A2_MAX_BATCH_SIZE, server_num}, at::dtype(at::kInt).device(x.device()));  // offset_outer
     at::Tensor token_unique_per_server = at::empty({server_num}, at::dtype(at::kInt).device(x.device()));
     at::Tensor ep_rank_token_cnt =
         at::empty({num_experts, num_ranks}, at::dtype(at::kInt).device(x.device()));  // 包含全局的
     // The number of tokens received by each expert on this rank, not a prefix sum
     at::Tensor recv_tokens_per_expert = at::empty({num_local_experts}, at::dtype(at::kLong).device(x.device()));
     at::Tensor src_offset_rank_token_idx =
-        at::empty({num_experts, num_ranks, MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
+        at::empty({num_experts, num_ranks, A2_MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
     at::Tensor dst_offset_rank_token_idx =
-        at::empty({num_experts, num_ranks, MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
+        at::empty({num_experts, num_ranks, A2_MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
     // The offsetInner for the current rank and the peer rank
-    at::Tensor offset_inner = at::empty({2, MAX_BATCH_SIZE, num_experts}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor count_outer = at::empty({MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
-    at::Tensor expand_idx = at::empty({MAX_BATCH_SIZE, num_experts}, at::dtype(at::kInt).device(x.device()));
+    at::Tensor offset_inner = at::empty({2, A2_MAX_BATCH_SIZE, num_experts}, at::dtype(at::kInt).device(x.device()));
+    at::Tensor count_outer = at::empty({A2_MAX_BATCH_SIZE}, at::dtype(at::kInt).device(x.device()));
+    at::Tensor expand_idx = at::empty({A2_MAX_BATCH_SIZE, num_experts}, at::dtype(at::kInt).device(x.device()));
     at::Tensor total_recv_token = torch::empty({1}, at::dtype(at::kInt).device(x.device()));
 
     // get ep name
@@ -795,7 +961,10 @@ Buffer::internode_dispatch(
                  src_offset_rank_token_idx, dst_offset_rank_token_idx, offset_inner, count_outer, expand_idx,
                  total_recv_token);
 
-    int total_count = total_recv_token.item<int>();
+    // see intranode_dispatch, global_bs is already a fixed bound here
+    bool worst_case_layout = num_worst_tokens > 0;
+    EP_HOST_ASSERT(not worst_case_layout or num_tokens <= num_worst_tokens);
+    int total_count = worst_case_layout ? num_worst_tokens : total_recv_token.item<int>();
     int num_recv_tokens = (total_count == 0) ? 1 : total_count;
 
     auto expandx_out = use_quant ? at::empty({num_recv_tokens, hidden}, at::dtype(at::kChar).device(x.device()))
@@ -813,16 +982,28 @@ Buffer::internode_dispatch(
                  sharedExpertNum, sharedExpertRankNum, quant_mode, global_bs, expertTokenNumsType, expandx_out,
                  dynamic_scales_out, expand_idx, expertTokenNums, epRecvCount, expand_scales,
                  dispatch_wait_recv_cost_stats_out);
+    accumulate_expert_recv_stats(cumulative_local_expert_recv_stats, recv_tokens_per_expert);
 
-    auto recv_token_per_exp_cpu = recv_tokens_per_expert.to(at::kCPU);
-    auto recv_token_per_exp_ptr = recv_token_per_exp_cpu.data_ptr<int64_t>();
+    std::optional<at::Tensor> num_recv_tokens_per_expert;
+    if (worst_case_layout) {
+        num_recv_tokens_per_expert =
+            (expert_token_nums_type == 0) ? recv_tokens_per_expert.cumsum(0) : recv_tokens_per_expert;
+    } else {
+        auto recv_token_per_exp_cpu = recv_tokens_per_expert.to(at::kCPU);
+        auto recv_token_per_exp_ptr = recv_token_per_exp_cpu.data_ptr<int64_t>();
 
-    int token_cnt = 0;
-    for (int local_e = 0; local_e < num_local_experts; ++local_e) {
-        int current_tokens = static_cast<int>(recv_token_per_exp_ptr[local_e]);
-        token_cnt = (expert_token_nums_type == 0) ? token_cnt + current_tokens : current_tokens;
-        num_recv_tokens_per_expert_list.emplace_back(token_cnt);
+        int token_cnt = 0;
+        for (int local_e = 0; local_e < num_local_experts; ++local_e) {
+            int current_tokens = static_cast<int>(recv_token_per_exp_ptr[local_e]);
+            token_cnt = (expert_token_nums_type == 0) ? token_cnt + current_tokens : current_tokens;
+            num_recv_tokens_per_expert_list.emplace_back(token_cnt);
+        }
     }
+    event = stream_scope.Finish({x, new_x, x_scales, topk_idx, new_topk_weights, num_tokens_per_rank,
+                                 num_tokens_per_expert, dispatch_wait_recv_cost_stats,
+                                 cumulative_local_expert_recv_stats, is_token_in_rank, new_send_data, expandx_out,
+                                 dynamic_scales_out, expand_idx, ep_rank_token_cnt, offset_inner, token_server_idx,
+                                 count_outer, expand_scales, num_recv_tokens_per_expert});
 
     return {expandx_out,
             dynamic_scales_out,
@@ -835,21 +1016,24 @@ Buffer::internode_dispatch(
             token_server_idx,
             count_outer,
             expand_scales,
+            num_recv_tokens_per_expert,
+            handle,
             event};
 }
 
 std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandle>> Buffer::internode_combine(
     const torch::Tensor &x, const torch::Tensor &topk_idx, const std::optional<torch::Tensor> &topk_weights,
     const torch::Tensor &src_idx, const torch::Tensor &send_head, const torch::Tensor &offsetInner,
-    const torch::Tensor &offsetOuter, const torch::Tensor &countOuter, const torch::Tensor &expand_scales)
+    const torch::Tensor &offsetOuter, const torch::Tensor &countOuter, const torch::Tensor &expand_scales,
+    const std::optional<torch::Tensor> &combine_send_cost_stats, const DispatchHandle &dispatch_handle,
+    std::optional<EventHandle> &previous_event, bool async, bool allocate_on_comm_stream)
 {
     EP_HOST_ASSERT(x.dim() == 2 and x.is_contiguous());
+    CommStreamScope stream_scope(comm_stream, previous_event, async, allocate_on_comm_stream);
     at::Tensor recv_x = x;
 
-    at::Tensor topk_idx_p = topk_idx;
-    if (this->is_padding) {
-        topk_idx_p = this->new_topk_idx;
-    }
+    const bool is_padding = dispatch_handle.padding_cnt > 0;
+    at::Tensor topk_idx_p = (is_padding or dispatch_handle.replica_mapped) ? dispatch_handle.topk_idx : topk_idx;
 
     auto topk_idx_int32 = topk_idx_p.to(at::kInt);
     at::Tensor expert_ids = topk_idx_int32;
@@ -863,12 +1047,20 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandl
     const int num_topk = topk_idx_p.size(1);
     at::Tensor expert_scales = at::empty({1}, at::dtype(at::kFloat).device(x.device()));
 
+    at::Tensor combine_send_cost_stats_out;
+    if (combine_send_cost_stats.has_value()) {
+        EP_HOST_ASSERT(combine_send_cost_stats->scalar_type() == torch::kInt32);
+        EP_HOST_ASSERT(combine_send_cost_stats->dim() == 1 and combine_send_cost_stats->is_contiguous());
+        EP_HOST_ASSERT(combine_send_cost_stats->size(0) == num_ranks);
+        combine_send_cost_stats_out = combine_send_cost_stats.value();
+    }
+
     int64_t hidden = static_cast<int>(recv_x.size(1));
     at::Tensor tp_send_counts = at::empty({1}, at::dtype(at::kInt).device(device));
     int64_t tp_world_size = 1;
     int64_t tp_rankId = 0;
     int64_t moe_expert_number = send_head.size(0);
-    int64_t global_bs = static_cast<int64_t>(MAX_BATCH_SIZE * num_ranks);
+    int64_t global_bs = static_cast<int64_t>(A2_MAX_BATCH_SIZE * num_ranks);
 
     // get ep & tp name
     char hcom_ep_name[HCOMM_NAME_LEN];
@@ -879,7 +1071,7 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandl
     }
 
     // Combine data
-    auto combined_x = torch::empty({new_topk_idx.size(0), hidden}, x.options());
+    auto combined_x = torch::empty({dispatch_handle.topk_idx.size(0), hidden}, x.options());
     std::optional<torch::Tensor> recv_topk_weights;
     std::optional<EventHandle> event;
     at::Tensor x_active_mask, activation_scale, weight_scale, group_list;
@@ -892,54 +1084,60 @@ std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandl
                  tp_send_counts, x_active_mask, activation_scale, weight_scale, group_list, expand_scales, offsetInner,
                  offsetOuter, countOuter, hcom_ep_name, num_ranks, rank, moe_expert_number, hcom_ep_name, tp_world_size,
                  tp_rankId, expert_shared_type, shared_expert_num, shared_expert_rank_num, global_bs, out_dtype,
-                 comm_quant_mode, group_list_type, combined_x);
+                 comm_quant_mode, group_list_type, combined_x, combine_send_cost_stats_out);
+    event = stream_scope.Finish({x, expert_ids, src_idx, send_head, offsetInner, offsetOuter, countOuter, expand_scales,
+                                 combine_send_cost_stats, combined_x});
 
-    if (this->is_padding) {
-        if (this->padding_cnt == PADDING_SIZE) {
-            combined_x = this->ori_x;
+    if (is_padding) {
+        if (dispatch_handle.padding_cnt == PADDING_SIZE) {
+            combined_x = dispatch_handle.ori_x;
         } else {
-            combined_x = combined_x.slice(0, 0, PADDING_SIZE - this->padding_cnt);
+            combined_x = combined_x.slice(0, 0, PADDING_SIZE - dispatch_handle.padding_cnt);
         }
-        is_padding = false;
     }
     return {combined_x, recv_topk_weights, event};
 }
 
-std::tuple<at::Tensor, std::optional<at::Tensor>, at::Tensor, at::Tensor, at::Tensor, std::optional<EventHandle>,
-           std::optional<std::function<void()>>>
+std::tuple<at::Tensor, std::optional<at::Tensor>, at::Tensor, at::Tensor, at::Tensor, DispatchHandle,
+           std::optional<EventHandle>, std::optional<std::function<void()>>>
 Buffer::low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
                              const std::optional<at::Tensor> &cumulative_local_expert_recv_stats,
+                             const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats,
                              int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts, bool use_fp8,
                              bool round_scale, bool use_ue8m0, bool async, bool return_recv_hook)
 {
-    this->is_padding = false;
     EP_HOST_ASSERT(low_latency_mode);
+    EP_HOST_ASSERT(not(async and return_recv_hook));
+    EP_HOST_ASSERT(not round_scale or use_fp8);
+    EP_HOST_ASSERT(not use_ue8m0 or round_scale);
+    CommStreamScope stream_scope(comm_stream, std::nullopt, async or return_recv_hook, false);
+    DispatchHandle handle;
     at::Tensor new_x = x;
-    this->new_topk_idx = topk_idx;
+    at::Tensor new_topk_idx = topk_idx;
     if (topk_idx.size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - topk_idx.size(0);
+        handle.padding_cnt = PADDING_SIZE - topk_idx.size(0);
         std::vector<at::Tensor> x_blocks;
         std::vector<at::Tensor> topk_blocks;
         if (topk_idx.size(0) != 0) {
             x_blocks.emplace_back(x);
             topk_blocks.emplace_back(topk_idx);
         } else {
-            this->ori_x = x.clone();
+            handle.ori_x = x.clone();
         }
         int topk = static_cast<int>(new_topk_idx.size(1));
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < handle.padding_cnt; i++) {
             at::Tensor tmp_x = torch::ones({1, x.size(1)}, x.options());
             at::Tensor tmp_topk = torch::arange(0, topk, topk_idx.options()).reshape({1, topk});
             x_blocks.emplace_back(tmp_x);
             topk_blocks.emplace_back(tmp_topk);
         }
         new_x = torch::cat(x_blocks, 0);
-        this->new_topk_idx = torch::cat(topk_blocks, 0);
+        new_topk_idx = torch::cat(topk_blocks, 0);
     }
+    handle.topk_idx = new_topk_idx;
 
     auto num_tokens = static_cast<int>(new_x.size(0)), hidden = static_cast<int>(new_x.size(1));
-    auto num_scales = hidden / 128, num_topk = static_cast<int>(new_topk_idx.size(1));
+    auto num_topk = static_cast<int>(new_topk_idx.size(1));
     auto num_local_experts = num_experts / (num_ranks - shared_expert_rank_num);
 
     int64_t global_bs = std::max(new_topk_idx.size(0), num_max_dispatch_tokens_per_rank) * num_ranks;
@@ -952,22 +1150,14 @@ Buffer::low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
     }
     auto max_size = std::max(num_tokens * num_topk, num_max_tokens * 128);
 
-    // Allocate packed tensors
     auto device = new_x.device();
-    auto packed_recv_x =
-        at::empty({num_max_tokens, hidden}, new_x.options().dtype(use_fp8 ? at::kChar : at::kBFloat16));
-    auto packed_recv_x_scales = at::empty({num_max_tokens}, at::dtype(at::kFloat).device(device));
-    auto expandIdx = at::empty({max_size}, at::dtype(at::kInt).device(device));
-
     int32_t server_num = num_ranks / LOCAL_RANK_SIZE;
-    at::Tensor ep_recv_count =
-        at::empty({num_local_experts * num_ranks}, at::dtype(at::kInt).device(device));  // A2 non-layered / A3
-    auto tp_recv_count = at::empty({1}, at::dtype(at::kInt).device(device));
-    auto packed_recv_count = at::empty({num_local_experts}, at::dtype(at::kLong).device(device));
+    int64_t recv_count_tensor_size = num_local_experts * num_ranks;  // A2 non-layered / A3
     at::Tensor scales;
     at::Tensor active_mask;
     int enable_neg_one = get_value_from_env("MOE_ENABLE_TOPK_NEG_ONE", 0);
-    int64_t quant_mode = use_fp8 ? 2 : 0;
+    // the int8 tokens carry one scale each, quant mode 3 rounds it up to a power of two
+    int64_t quant_mode = use_fp8 ? (round_scale ? DYNAMIC_POW2_SCALES : DYNAMIC_SCALES) : NO_SCALES;
     int64_t tp_size = 1;
     int64_t tp_rank = 0;
     int64_t expert_shard_type = 0;
@@ -993,11 +1183,24 @@ Buffer::low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
         if (hcclIntraPcieEnable != nullptr && hcclIntraRoceEnable != nullptr && strcmp(hcclIntraPcieEnable, "1") == 0 &&
             strcmp(hcclIntraRoceEnable, "0") == 0) {  // A2 layered
             isLayered = true;
-            int64_t recv_count_tensor_size = num_experts + 2 * global_bs * num_topk * server_num;
-            ep_recv_count = at::empty({recv_count_tensor_size}, at::dtype(at::kInt).device(device));
+            recv_count_tensor_size = num_experts + 2 * global_bs * num_topk * server_num;
         }
     }
 
+    // Packed tensors come from the output pool
+    LowLatencyOutputs &outputs = next_low_latency_outputs(num_max_dispatch_tokens_per_rank, hidden, num_experts);
+    handle.low_latency_slot = low_latency_outputs_idx;
+    auto packed_recv_x = reuse_or_empty(outputs.packed_recv_x, {num_max_tokens, hidden},
+                                        new_x.options().dtype(use_fp8 ? at::kChar : at::kBFloat16));
+    auto packed_recv_x_scales =
+        reuse_or_empty(outputs.packed_recv_x_scales, {num_max_tokens}, at::dtype(at::kFloat).device(device));
+    auto expandIdx = reuse_or_empty(outputs.expand_idx, {max_size}, at::dtype(at::kInt).device(device));
+    auto ep_recv_count =
+        reuse_or_empty(outputs.ep_recv_count, {recv_count_tensor_size}, at::dtype(at::kInt).device(device));
+    auto tp_recv_count = reuse_or_empty(outputs.tp_recv_count, {1}, at::dtype(at::kInt).device(device));
+    auto packed_recv_count =
+        reuse_or_empty(outputs.packed_recv_count, {num_local_experts}, at::dtype(at::kLong).device(device));
+
     if (soc_version == op::SocVersion::ASCEND910B) {
         comm_alg = "fullmesh";
     } else {
@@ -1009,6 +1212,14 @@ Buffer::low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
         active_mask = (new_topk_idx >= 0).to(torch::kBool);
     }
 
+    at::Tensor dispatch_wait_recv_cost_stats_out;
+    if (dispatch_wait_recv_cost_stats.has_value()) {
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->scalar_type() == torch::kInt32);
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->dim() == 1 and dispatch_wait_recv_cost_stats->is_contiguous());
+        EP_HOST_ASSERT(dispatch_wait_recv_cost_stats->size(0) == num_ranks);
+        dispatch_wait_recv_cost_stats_out = dispatch_wait_recv_cost_stats.value();
+    }
+
     EXEC_NPU_CMD(aclnnMoeDistributeDispatchV2, new_x, new_topk_idx,
                  scales,        // smooth scales,
                  active_mask,   // active_mask
@@ -1029,33 +1240,50 @@ Buffer::low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
                  packed_recv_x_scales,  // dynamicScalesOut
                  expandIdx,
                  packed_recv_count,  // expertTokenNumsOut
-                 ep_recv_count, tp_recv_count);
+                 ep_recv_count, tp_recv_count, dispatch_wait_recv_cost_stats_out);
+    if (cumulative_local_expert_recv_stats.has_value()) {
+        // expertTokenNumsOut holds prefix sums when expert_token_nums_type is 0
+        auto zero = at::zeros({1}, packed_recv_count.options());
+        accumulate_expert_recv_stats(cumulative_local_expert_recv_stats,
+                                     expert_token_nums_type == 0 ? at::diff(packed_recv_count, 1, 0, zero)
+                                                                 : packed_recv_count);
+    }
+    // a power-of-two float scale is fully described by its biased exponent
+    auto recv_x_scales = use_ue8m0 ? packed_recv_x_scales.view(at::kInt).bitwise_right_shift(23).to(at::kByte)
+                                   : packed_recv_x_scales;
+    event = stream_scope.Finish({x, new_x, topk_idx, new_topk_idx, cumulative_local_expert_recv_stats, active_mask,
+                                 packed_recv_x, packed_recv_x_scales, recv_x_scales, expandIdx, packed_recv_count,
+                                 ep_recv_count, dispatch_wait_recv_cost_stats});
+
+    auto recv_hook = make_recv_hook(event, return_recv_hook);
 
     // Return values
-    return {packed_recv_x, packed_recv_x_scales,        packed_recv_count, expandIdx, ep_recv_count,
-            event,         std::function<void()>([] {})};
+    return {packed_recv_x, recv_x_scales, packed_recv_count, expandIdx, ep_recv_count, handle, event, recv_hook};
 }
 
 std::tuple<at::Tensor, std::optional<EventHandle>, std::optional<std::function<void()>>> Buffer::low_latency_combine(
     const at::Tensor &x, const at::Tensor &topk_idx, const at::Tensor &topk_weights, const at::Tensor &src_info,
-    const at::Tensor &layout_range, int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
+    const at::Tensor &layout_range, const std::optional<at::Tensor> &combine_send_cost_stats,
+    const DispatchHandle &dispatch_handle, int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
     const at::Tensor &packed_recv_count, bool zero_copy, bool async, bool return_recv_hook,
     const std::optional<at::Tensor> &out)
 {
+    EP_HOST_ASSERT(not(async and return_recv_hook));
+    CommStreamScope stream_scope(comm_stream, std::nullopt, async or return_recv_hook, false);
+    const bool is_padding = dispatch_handle.padding_cnt > 0;
     at::Tensor new_idx = topk_idx;
     at::Tensor new_scales = topk_weights;
-    if (this->is_padding) {
+    if (is_padding) {
         std::vector<at::Tensor> scales_blocks;
-        if (this->padding_cnt != PADDING_SIZE) {
+        if (dispatch_handle.padding_cnt != PADDING_SIZE) {
             scales_blocks.emplace_back(topk_weights);
         }
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < dispatch_handle.padding_cnt; i++) {
             at::Tensor tmp_scales = torch::zeros({1, topk_weights.size(1)}, topk_weights.options());
             scales_blocks.emplace_back(tmp_scales);
         }
-        new_idx = this->new_topk_idx;
-        this->new_scales = torch::cat(scales_blocks, 0);
-        new_scales = this->new_scales;
+        new_idx = dispatch_handle.topk_idx;
+        new_scales = torch::cat(scales_blocks, 0);
     }
     // Tensor checks
     EP_HOST_ASSERT(x.dim() == 2 and x.is_contiguous() and x.scalar_type() == at::kBFloat16);
@@ -1092,7 +1320,18 @@ std::tuple<at::Tensor, std::optional<EventHandle>, std::optional<std::function<v
     auto num_combined_tokens = static_cast<int>(new_scales.size(0));
     auto hidden = static_cast<int>(x.size(1));
     at::Tensor shared_expert_x{nullptr};
-    at::Tensor combined_x = at::empty({num_combined_tokens, hidden}, x.options());
+    if (zero_copy) {
+        // the combine reads x in place, zero_copy only checks that x is the pooled buffer of this dispatch
+        EP_HOST_ASSERT(dispatch_handle.low_latency_slot >= 0);
+        EP_HOST_ASSERT(x.data_ptr() == low_latency_outputs[dispatch_handle.low_latency_slot].combine_x.data_ptr());
+    }
+    if (out.has_value()) {
+        EP_HOST_ASSERT(out->dim() == 2 and out->is_contiguous() and out->scalar_type() == x.scalar_type());
+        EP_HOST_ASSERT(out->size(0) == num_combined_tokens - dispatch_handle.padding_cnt and out->size(1) == hidden);
+    }
+    // the kernel writes straight into out, unless the padded rows have to be dropped afterwards
+    at::Tensor combined_x =
+        (out.has_value() and not is_padding) ? out.value() : at::empty({num_combined_tokens, hidden}, x.options());
     std::optional<EventHandle> event;
     if (soc_version == op::SocVersion::ASCEND910B) {
         const char *hcclIntraPcieEnable = getenv("HCCL_INTRA_PCIE_ENABLE");
@@ -1111,23 +1350,37 @@ std::tuple<at::Tensor, std::optional<EventHandle>, std::optional<std::function<v
 
     if (enable_neg_one) {
         EP_HOST_ASSERT(isLayered == false);
-        x_active_mask = (new_topk_idx >= 0).to(torch::kBool);
+        x_active_mask = (new_idx >= 0).to(torch::kBool);
+    }
+
+    at::Tensor combine_send_cost_stats_out;
+    if (combine_send_cost_stats.has_value()) {
+        EP_HOST_ASSERT(combine_send_cost_stats->scalar_type() == torch::kInt32);
+        EP_HOST_ASSERT(combine_send_cost_stats->dim() == 1 and combine_send_cost_stats->is_contiguous());
+        EP_HOST_ASSERT(combine_send_cost_stats->size(0) == num_ranks);
+        combine_send_cost_stats_out = combine_send_cost_stats.value();
     }
 
     EXEC_NPU_CMD(aclnnMoeDistributeCombineV2, expand_x, expert_ids, expand_idx, ep_send_counts, expert_scales,
                  tp_send_counts, x_active_mask, activation_scale, weight_scale, group_list, expand_scales,
                  shared_expert_x, hcom_ep_name, num_ranks, rank, num_experts, hcom_tp_name, tp_world_size, tp_rankId,
                  expert_shared_type, shared_expert_num, shared_expert_rank_num, global_bs, out_dtype, comm_quant_mode,
-                 group_list_type, comm_alg, combined_x);
-    if (this->is_padding) {
-        if (this->padding_cnt == PADDING_SIZE) {
-            combined_x = this->ori_x;
+                 group_list_type, comm_alg, combined_x, combine_send_cost_stats_out);
+    event = stream_scope.Finish(
+        {x, new_idx, new_scales, src_info, layout_range, x_active_mask, combined_x, combine_send_cost_stats});
+    if (is_padding) {
+        if (dispatch_handle.padding_cnt == PADDING_SIZE) {
+            combined_x = dispatch_handle.ori_x;
         } else {
-            combined_x = combined_x.slice(0, 0, PADDING_SIZE - this->padding_cnt);
+            combined_x = combined_x.slice(0, 0, PADDING_SIZE - dispatch_handle.padding_cnt);
+        }
+        if (out.has_value()) {
+            out->copy_(combined_x);
+            combined_x = out.value();
         }
-        is_padding = false;
     }
-    return {combined_x, event, std::function<void()>([] {})};
+    auto recv_hook = make_recv_hook(event, return_recv_hook);
+    return {combined_x, event, recv_hook};
 }
 
 std::vector<at::Tensor> Buffer::fused_deep_moe(const at::Tensor &x, const at::Tensor &expert_ids,
@@ -1136,19 +1389,20 @@ std::vector<at::Tensor> Buffer::fused_deep_moe(const at::Tensor &x, const at::Te
                                                const at::Tensor &gmm2_weight, const at::Tensor &gmm2_weight_scale,
                                                const at::Tensor &expert_scales_optional,
                                                int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
-                                               int quant_mode)
+                                               int quant_mode,
+                                               const std::optional<at::Tensor> &combine_wait_recv_cost_stats)
 {
     EP_HOST_ASSERT(expert_ids.dim() == 2);
     EP_HOST_ASSERT(expert_scales_optional.dim() == 2);
 
-    this->is_padding = false;
     at::Tensor new_x = x;
-    this->new_topk_idx = expert_ids;
+    at::Tensor new_topk_idx = expert_ids;
+    at::Tensor ori_x;
+    int padding_cnt = 0;
     at::Tensor new_scales = expert_scales_optional;
 
     if (expert_ids.size(0) < PADDING_SIZE) {
-        this->is_padding = true;
-        this->padding_cnt = PADDING_SIZE - expert_ids.size(0);
+        padding_cnt = PADDING_SIZE - expert_ids.size(0);
 
         std::vector<at::Tensor> x_blocks;
         std::vector<at::Tensor> idx_blocks;
@@ -1157,25 +1411,25 @@ std::vector<at::Tensor> Buffer::fused_deep_moe(const at::Tensor &x, const at::Te
             x_blocks.emplace_back(x);
             idx_blocks.emplace_back(expert_ids);
         } else {
-            this->ori_x = x.clone();  // store the original input when the batch is completely empty
+            ori_x = x.clone();  // store the original input when the batch is completely empty
         }
 
         int topk = static_cast<int>(expert_ids.size(1));
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < padding_cnt; i++) {
             at::Tensor tmp_x = torch::ones({1, x.size(1)}, x.options());
             at::Tensor tmp_idx = torch::arange(0, topk, expert_ids.options()).reshape({1, topk});
             x_blocks.emplace_back(tmp_x);
             idx_blocks.emplace_back(tmp_idx);
         }
         new_x = torch::cat(x_blocks, 0);
-        this->new_topk_idx = torch::cat(idx_blocks, 0);
+        new_topk_idx = torch::cat(idx_blocks, 0);
 
         // padding expert_scales_optional
         std::vector<at::Tensor> scales_blocks;
-        if (this->padding_cnt != PADDING_SIZE) {
+        if (padding_cnt != PADDING_SIZE) {
             scales_blocks.emplace_back(expert_scales_optional);
         }
-        for (int i = 0; i < this->padding_cnt; i++) {
+        for (int i = 0; i < padding_cnt; i++) {
             at::Tensor tmp_scales = torch::zeros({1, expert_scales_optional.size(1)}, expert_scales_optional.options());
             scales_blocks.emplace_back(tmp_scales);
         }
@@ -1193,7 +1447,7 @@ std::vector<at::Tensor> Buffer::fused_deep_moe(const at::Tensor &x, const at::Te
 
     auto x_shape = x.sizes();
     int h = x_shape[1];
-    int bs = this->new_topk_idx.size(0);
+    int bs = new_topk_idx.size(0);
 
     at::Tensor output = at::empty({bs, h}, x.options());
 
@@ -1201,24 +1455,31 @@ std::vector<at::Tensor> Buffer::fused_deep_moe(const at::Tensor &x, const at::Te
     int64_t num_local_experts = is_shared_expert ? 1 : num_experts / (num_ranks - shared_expert_rank_num);
     at::Tensor ep_recv_count = at::empty({num_local_experts * num_ranks}, expert_ids.options());
 
+    at::Tensor combine_wait_recv_cost_stats_out;
+    if (combine_wait_recv_cost_stats.has_value()) {
+        EP_HOST_ASSERT(combine_wait_recv_cost_stats->scalar_type() == torch::kInt32);
+        EP_HOST_ASSERT(combine_wait_recv_cost_stats->dim() == 1 and combine_wait_recv_cost_stats->is_contiguous());
+        EP_HOST_ASSERT(combine_wait_recv_cost_stats->size(0) == num_ranks);
+        combine_wait_recv_cost_stats_out = combine_wait_recv_cost_stats.value();
+    }
+
     EXEC_NPU_CMD(aclnnFusedDeepMoe,
                  // input
-                 new_x, this->new_topk_idx, gmm1_permuted_weight, gmm1_permuted_weight_scale, gmm2_weight,
+                 new_x, new_topk_idx, gmm1_permuted_weight, gmm1_permuted_weight_scale, gmm2_weight,
                  gmm2_weight_scale, static_cast<const std::nullptr_t &>(nullptr), new_scales,
                  // attr
                  hcom_ep_name, num_ranks, rank, num_experts, shared_expert_num, shared_expert_rank_num, quant_mode,
                  global_bs,
                  // output
-                 output, ep_recv_count);
+                 output, ep_recv_count, combine_wait_recv_cost_stats_out);
 
     // ---------- unpadding ----------
-    if (this->is_padding) {
+    if (padding_cnt > 0) {
         if (expert_ids.size(0) == 0) {
-            output = this->ori_x;
+            output = ori_x;
         } else {
-            output = output.slice(0, 0, PADDING_SIZE - this->padding_cnt);
+            output = output.slice(0, 0, PADDING_SIZE - padding_cnt);
         }
-        this->is_padding = false;
     }
 
     return {output, ep_recv_count};
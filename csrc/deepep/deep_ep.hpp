@@ -2,6 +2,7 @@
 
 #include <torch/types.h>
 #include <torch/python.h>
+#include <array>
 #include <tuple>
 #include <vector>
 #include <optional>
@@ -14,6 +15,52 @@
 
 namespace deep_ep {
 
+// Routing of one get_dispatch_layout call, handed to Python as an opaque object that the dispatch of the same tokens
+// takes back, so any number of layouts can be outstanding on one Buffer.
+struct DispatchLayout {
+    at::Tensor topk_idx;  // padded to at least PADDING_SIZE tokens
+    int padding_cnt = 0;
+    bool replica_mapped = false;    // topk_idx holds the physical expert ids picked from the replica table
+    at::Tensor notify_send_data;    // only for internode notify
+    int notify_send_data_size = 0;  // only for internode notify
+    at::Tensor send_token_idx_small;
+};
+
+// Routing state one dispatch hands to its combine through the Python handle, so that the dispatches and combines of
+// several micro-batches can interleave on one Buffer.
+struct DispatchHandle {
+    at::Tensor topk_idx;  // padded to at least PADDING_SIZE tokens
+    int padding_cnt = 0;  // tokens appended by the padding, combine drops them again
+    bool replica_mapped = false;  // topk_idx holds physical expert ids, combine must use it instead of the caller's
+    at::Tensor ori_x;     // input of an empty batch, combine returns it as is
+    int64_t real_max_bs = 0;
+    int low_latency_slot = -1;  // LowLatencyOutputs a low_latency_dispatch wrote to
+
+    // intranode only, the notify_dispatch results that a dispatch with the same routing reuses
+    at::Tensor send_token_idx_small;
+    at::Tensor send_data_offset;
+    at::Tensor recv_offset;  // [round, num_experts]
+    at::Tensor recv_count;
+    at::Tensor expert_global_offset;
+    at::Tensor srcrank_in_expert_offset;
+    at::Tensor r_in_srcrank_offset;
+    at::Tensor recv_tokens_per_expert;  // [round * num_local_experts], not a prefix sum
+    int64_t num_recv_tokens = 0;
+    std::vector<int> num_recv_tokens_per_expert_list;
+    std::optional<at::Tensor> num_recv_tokens_per_expert;
+};
+
+// Persistent outputs of low_latency_dispatch, reallocated only when a shape changes.
+struct LowLatencyOutputs {
+    at::Tensor packed_recv_x;
+    at::Tensor packed_recv_x_scales;
+    at::Tensor expand_idx;
+    at::Tensor ep_recv_count;
+    at::Tensor tp_recv_count;
+    at::Tensor packed_recv_count;
+    at::Tensor combine_x;  // see get_next_low_latency_combine_buffer
+};
+
 struct Buffer {
     int64_t rank, rdma_rank, nvl_rank;
     int64_t num_ranks, num_rdma_ranks, num_nvl_ranks;
@@ -25,24 +72,28 @@ struct Buffer {
     int32_t round;
     int32_t per_round_tokens;
     bool combine_enable_long_seq = false;  // Whether to enable the Combine Ant Migration feature
+    bool combine_comm_quant = false;       // Whether normal combine sends tokens as per-token int8
+    bool is_token_in_rank_bitmap = false;  // Whether get_dispatch_layout packs is_token_in_rank as 32 ranks per int
 
     bool low_latency_mode = false;
-    bool is_padding = false;
-    int padding_cnt = 0;
-    at::Tensor ori_x;
-    at::Tensor new_topk_idx;
-    at::Tensor new_scales;
-    at::Tensor notify_send_data;  // only for internode notify
-    at::Tensor send_token_idx_small;
-    int notify_send_data_size;  // only for internode notify
 
     int64_t shared_expert_rank_num;
     int64_t shared_expert_num = 1;
-    int64_t real_max_bs;
 
 private:
     std::string moe_all_to_all_group_name;
 
+    // two sets used in turn, the outputs of a low_latency_dispatch stay valid until the one after the next
+    std::array<LowLatencyOutputs, 2> low_latency_outputs;
+    std::tuple<int64_t, int64_t, int64_t> low_latency_outputs_key{-1, -1, -1};
+    int low_latency_outputs_idx = 0;
+
+    LowLatencyOutputs &next_low_latency_outputs(int64_t num_max_dispatch_tokens_per_rank, int64_t hidden,
+                                                int64_t num_experts);
+
+    // async dispatch/combine run here, see CommStreamScope
+    c10_npu::NPUStream comm_stream;
+
     int device_id;
 
     HcclComm ep_comm;
@@ -61,21 +112,27 @@ public:
 
     int get_rdma_rank() const;
 
-    std::tuple<torch::Tensor, std::optional<torch::Tensor>, torch::Tensor, torch::Tensor, std::optional<EventHandle>>
+    std::tuple<torch::Tensor, std::optional<torch::Tensor>, torch::Tensor, torch::Tensor, DispatchLayout,
+               std::optional<EventHandle>>
     get_dispatch_layout(const torch::Tensor &topk_idx, int num_experts, std::optional<EventHandle> &previous_event,
-                        bool async, bool allocate_on_comm_stream);
+                        bool async, bool allocate_on_comm_stream,
+                        const std::optional<torch::Tensor> &expert_replica_table);
 
-    torch::Tensor get_notify_send_data();
+    torch::Tensor get_notify_send_data(const DispatchLayout &layout) const;
 
     std::tuple<at::Tensor, std::optional<at::Tensor>, std::optional<at::Tensor>, std::optional<at::Tensor>,
-               std::vector<int>, at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor, std::optional<EventHandle>>
+               std::vector<int>, at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor, std::optional<at::Tensor>,
+               DispatchHandle, std::optional<EventHandle>>
     intranode_dispatch(const at::Tensor &x, const std::optional<at::Tensor> &x_scales,
                        const std::optional<at::Tensor> &topk_idx, const std::optional<at::Tensor> &topk_weights,
                        const std::optional<at::Tensor> &num_tokens_per_rank, const at::Tensor &is_token_in_rank,
                        const std::optional<at::Tensor> &num_tokens_per_expert, int cached_num_recv_tokens,
                        const std::optional<at::Tensor> &cached_rank_prefix_matrix,
                        const std::optional<at::Tensor> &cached_channel_prefix_matrix,
-                       const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats, int expert_alignment,
+                       const std::optional<DispatchHandle> &cached_handle,
+                       const std::optional<DispatchLayout> &layout,
+                       const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats,
+                       const std::optional<at::Tensor> &cumulative_local_expert_recv_stats, int expert_alignment,
                        int num_worst_tokens, const Config &config, std::optional<EventHandle> &previous_event,
                        bool async, bool allocate_on_comm_stream, bool use_quant);
 
@@ -86,44 +143,55 @@ public:
                   const std::optional<at::Tensor> &num_tokens_per_rank, const at::Tensor &is_token_in_rank,
                   const std::optional<at::Tensor> &num_tokens_per_expert, int cached_num_recv_tokens,
                   const std::optional<at::Tensor> &cached_rank_prefix_matrix,
-                  const std::optional<at::Tensor> &cached_channel_prefix_matrix,
+                  const std::optional<at::Tensor> &cached_channel_prefix_matrix, const DispatchLayout &layout,
                   const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats, int expert_alignment,
                   int num_worst_tokens, const Config &config, std::optional<EventHandle> &previous_event, bool async,
                   bool allocate_on_comm_stream, bool use_quant);
 
     void clean_low_latency_buffer(int num_max_dispatch_tokens_per_rank, int hidden, int num_experts);
 
+    at::Tensor get_next_low_latency_combine_buffer(const DispatchHandle &dispatch_handle);
+
     std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandle>>
     intranode_combine(const torch::Tensor &x, const torch::Tensor &topk_idx,
                       const std::optional<torch::Tensor> &topk_weights, const torch::Tensor &src_idx,
-                      const torch::Tensor &send_head, const std::optional<at::Tensor> &combine_send_cost_stats);
+                      const torch::Tensor &send_head, const std::optional<at::Tensor> &combine_send_cost_stats,
+                      const DispatchHandle &dispatch_handle, std::optional<EventHandle> &previous_event, bool async,
+                      bool allocate_on_comm_stream);
 
     std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<torch::Tensor>, std::optional<torch::Tensor>,
                std::vector<int>, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor,
-               torch::Tensor, std::optional<EventHandle>>
+               torch::Tensor, std::optional<torch::Tensor>, DispatchHandle, std::optional<EventHandle>>
     internode_dispatch(const torch::Tensor &x, const std::optional<torch::Tensor> &x_scales,
                        const std::optional<torch::Tensor> &topk_idx, const std::optional<torch::Tensor> &topk_weights,
                        const std::optional<torch::Tensor> &num_tokens_per_rank,
                        const std::optional<torch::Tensor> &num_tokens_per_rdma_rank,
                        const torch::Tensor &is_token_in_rank, const std::optional<torch::Tensor> &num_tokens_per_expert,
+                       const DispatchLayout &layout,
+                       const std::optional<torch::Tensor> &dispatch_wait_recv_cost_stats,
+                       const std::optional<torch::Tensor> &cumulative_local_expert_recv_stats, int num_worst_tokens,
                        const Config &config, std::optional<EventHandle> &previous_event, bool async,
                        bool allocate_on_comm_stream, bool use_quant);
 
     std::tuple<torch::Tensor, std::optional<torch::Tensor>, std::optional<EventHandle>> internode_combine(
         const torch::Tensor &x, const torch::Tensor &topk_idx, const std::optional<torch::Tensor> &topk_weights,
         const torch::Tensor &src_idx, const torch::Tensor &send_head, const torch::Tensor &offsetInner,
-        const torch::Tensor &offsetOuter, const torch::Tensor &countOuter, const torch::Tensor &expand_scales);
+        const torch::Tensor &offsetOuter, const torch::Tensor &countOuter, const torch::Tensor &expand_scales,
+        const std::optional<torch::Tensor> &combine_send_cost_stats, const DispatchHandle &dispatch_handle,
+        std::optional<EventHandle> &previous_event, bool async, bool allocate_on_comm_stream);
 
-    std::tuple<at::Tensor, std::optional<at::Tensor>, at::Tensor, at::Tensor, at::Tensor, std::optional<EventHandle>,
-               std::optional<std::function<void()>>>
+    std::tuple<at::Tensor, std::optional<at::Tensor>, at::Tensor, at::Tensor, at::Tensor, DispatchHandle,
+               std::optional<EventHandle>, std::optional<std::function<void()>>>
     low_latency_dispatch(const at::Tensor &x, const at::Tensor &topk_idx,
                          const std::optional<at::Tensor> &cumulative_local_expert_recv_stats,
+                         const std::optional<at::Tensor> &dispatch_wait_recv_cost_stats,
                          int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts, bool use_fp8, bool round_scale,
                          bool use_ue8m0, bool async, bool return_recv_hook);
 
     std::tuple<at::Tensor, std::optional<EventHandle>, std::optional<std::function<void()>>> low_latency_combine(
         const at::Tensor &x, const at::Tensor &topk_idx, const at::Tensor &topk_weights, const at::Tensor &src_info,
-        const at::Tensor &layout_range, int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
+        const at::Tensor &layout_range, const std::optional<at::Tensor> &combine_send_cost_stats,
+        const DispatchHandle &dispatch_handle, int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
         const at::Tensor &packed_recv_count, bool zero_copy, bool async, bool return_recv_hook,
         const std::optional<at::Tensor> &out);
 
@@ -132,6 +200,7 @@ public:
                                            const at::Tensor &gmm1PermutedWeightScale, const at::Tensor &gmm2Weight,
                                            const at::Tensor &gmm2WeightScale, const at::Tensor &expertScalesOptional,
                                            int64_t num_max_dispatch_tokens_per_rank, int64_t num_experts,
-                                           int quant_mode);
+                                           int quant_mode,
+                                           const std::optional<at::Tensor> &combine_wait_recv_cost_stats);
 };
 }  // namespace deep_ep
@@ -1,16 +1,113 @@
 #pragma once
+#include <initializer_list>
 #include <memory>
+#include <optional>
+
+#include <ATen/Tensor.h>
+#include "torch_npu/csrc/core/npu/NPUCachingAllocator.h"
+#include "torch_npu/csrc/core/npu/NPUEvent.h"
+#include "torch_npu/csrc/core/npu/NPUStream.h"
+
+#include "exception.hpp"
 
 namespace deep_ep {
 
+// An aclrtEvent recorded on a stream, copies share the same event.
 struct EventHandle {
-    EventHandle() {}
+    std::shared_ptr<c10_npu::NPUEvent> event;
+
+    EventHandle() : EventHandle(c10_npu::getCurrentNPUStream()) {}
+
+    explicit EventHandle(const c10_npu::NPUStream &stream) : event(std::make_shared<c10_npu::NPUEvent>())
+    {
+        event->record(stream);
+    }
 
     EventHandle(const EventHandle &other) = default;
 
     void current_stream_wait() const
     {
-        return;
+        event->block(c10_npu::getCurrentNPUStream());
+    }
+};
+
+inline void stream_wait(const c10_npu::NPUStream &s_0, const c10_npu::NPUStream &s_1)
+{
+    EP_HOST_ASSERT(s_0.id() != s_1.id());
+    EventHandle(s_1).event->block(s_0);
+}
+
+inline void stream_wait(const c10_npu::NPUStream &s, const EventHandle &event)
+{
+    event.event->block(s);
+}
+
+/**
+ * @brief Moves the body of one Buffer call to the communication stream when it is asynchronous.
+ *
+ * EXEC_NPU_CMD launches on the current stream, so for an async call the comm stream becomes the current stream until
+ * the scope ends, after waiting for previous_event or for the compute stream. The tensors allocated in the call are
+ * therefore owned by the comm stream. A synchronous call stays on the compute stream and only waits for
+ * previous_event.
+ */
+class CommStreamScope
+{
+public:
+    CommStreamScope(const c10_npu::NPUStream &comm_stream, const std::optional<EventHandle> &previous_event, bool async,
+                    bool allocate_on_comm_stream)
+        : compute_stream_(c10_npu::getCurrentNPUStream()), comm_stream_(comm_stream), async_(async)
+    {
+        // same contract as the CUDA DeepEP, the caller hands over the ordering with the compute stream
+        EP_HOST_ASSERT(not allocate_on_comm_stream or (previous_event.has_value() and async));
+        if (not async_) {
+            if (previous_event.has_value()) {
+                stream_wait(compute_stream_, previous_event.value());
+            }
+            return;
+        }
+        if (previous_event.has_value()) {
+            stream_wait(comm_stream_, previous_event.value());
+        } else {
+            stream_wait(comm_stream_, compute_stream_);
+        }
+        c10_npu::setCurrentNPUStream(comm_stream_);
+    }
+
+    ~CommStreamScope()
+    {
+        if (async_) {
+            c10_npu::setCurrentNPUStream(compute_stream_);
+        }
     }
+
+    CommStreamScope(const CommStreamScope &) = delete;
+    CommStreamScope &operator=(const CommStreamScope &) = delete;
+
+    /**
+     * @brief Event of an async call, recorded after its last launch; std::nullopt for a synchronous call.
+     *
+     * The inputs and outputs of the call are recorded on both streams, so the caching allocator neither reuses an input
+     * freed on the compute stream while the comm stream still reads it, nor an output freed on the compute stream
+     * while the compute stream still uses it.
+     */
+    std::optional<EventHandle> Finish(std::initializer_list<std::optional<at::Tensor>> tensors) const
+    {
+        if (not async_) {
+            return std::nullopt;
+        }
+        for (const auto &tensor : tensors) {
+            if (not tensor.has_value() or not tensor->defined() or tensor->is_cpu()) {
+                continue;
+            }
+            c10_npu::NPUCachingAllocator::recordStream(tensor->storage().data_ptr(), comm_stream_);
+            c10_npu::NPUCachingAllocator::recordStream(tensor->storage().data_ptr(), compute_stream_);
+        }
+        return EventHandle(comm_stream_);
+    }
+
+private:
+    c10_npu::NPUStream compute_stream_;
+    c10_npu::NPUStream comm_stream_;
+    bool async_;
 };
 }  // namespace deep_ep
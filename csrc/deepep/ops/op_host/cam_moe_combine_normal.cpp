@@ -59,6 +59,7 @@ public:
         this->Attr("real_max_bs").AttrType(OPTIONAL).Int(0);
         this->Attr("round").AttrType(OPTIONAL).Int(4);
         this->Attr("per_round_tokens").AttrType(OPTIONAL).Int(1024);
+        this->Attr("comm_quant_mode").AttrType(OPTIONAL).Int(0);
 
         OpAICoreConfig aicore_config;
         aicore_config.DynamicCompileStaticFlag(true)
@@ -45,6 +45,7 @@ constexpr uint32_t ATTR_MOE_EXPERT_NUM_INDEX = 6;
 constexpr uint32_t ATTR_REAL_MAX_BS_INDEX = 7;
 constexpr uint32_t ATTR_MAX_ROUND_INDEX = 8;
 constexpr uint32_t ATTR_PER_ROUND_TOKENS_INDEX = 9;
+constexpr uint32_t ATTR_COMM_QUANT_MODE_INDEX = 10;
 
 constexpr uint32_t TWO_DIMS = 2U;
 constexpr uint32_t ONE_DIM = 1U;
@@ -98,6 +99,7 @@ static void PrintTilingDataInfo(const char *nodeName, CamMoeCombineNormalTilingD
     OP_LOGD(nodeName, "totalWinSize is %lu.", tilingData.camMoeCombineNormalInfo.totalWinSize);
     OP_LOGD(nodeName, "maxRound is %u.", tilingData.camMoeCombineNormalInfo.maxRound);
     OP_LOGD(nodeName, "perRoundTokens is %u.", tilingData.camMoeCombineNormalInfo.perRoundTokens);
+    OP_LOGD(nodeName, "commQuantMode is %u.", tilingData.camMoeCombineNormalInfo.commQuantMode);
 }
 
 static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, CamMoeCombineNormalTilingData &tilingData,
@@ -446,6 +448,16 @@ static bool CheckAttrs(gert::TilingContext *context, CamMoeCombineNormalTilingDa
     OP_TILING_CHECK(perRoundTokensPtr == nullptr, OP_LOGE(nodeName, "perRoundTokens is null."), return false);
     tilingData.camMoeCombineNormalInfo.maxRound = static_cast<uint32_t>(*maxRoundPtr);
     tilingData.camMoeCombineNormalInfo.perRoundTokens = static_cast<uint32_t>(*perRoundTokensPtr);
+
+    auto commQuantModePtr = attrs->GetAttrPointer<int64_t>(ATTR_COMM_QUANT_MODE_INDEX);
+    OP_TILING_CHECK(commQuantModePtr == nullptr, OP_LOGE(nodeName, "commQuantMode is null."), return false);
+    OP_TILING_CHECK(
+        (*commQuantModePtr != static_cast<CommQuantModeType::type>(CommQuantMode::NON_QUANT)) &&
+            (*commQuantModePtr != static_cast<CommQuantModeType::type>(CommQuantMode::INT8_QUANT)),
+        OP_LOGE(nodeName, "commQuantMode only support 0(NON_QUANT) or 2(INT8_QUANT), but got commQuantMode=%ld.",
+                *commQuantModePtr),
+        return false);
+    tilingData.camMoeCombineNormalInfo.commQuantMode = static_cast<uint32_t>(*commQuantModePtr);
     return true;
 }
 
@@ -11,6 +11,11 @@ public:
             .DataType({ge::DT_INT64})
             .Format({ge::FORMAT_ND})
             .UnknownShapeFormat({ge::FORMAT_ND});
+        this->Input("expertReplicaTable")
+            .ParamType(OPTIONAL)
+            .DataType({ge::DT_INT32})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
 
         this->Attr("num_tokens").Int();
         this->Attr("num_ranks").Int();
@@ -18,6 +23,7 @@ public:
         this->Attr("num_topk").Int();
         this->Attr("local_ranksize").Int();
         this->Attr("per_round_tokens").Int();
+        this->Attr("is_token_in_rank_bitmap").AttrType(OPTIONAL).Int(0);
 
         this->Output("numTokensPerRank")
             .ParamType(REQUIRED)
@@ -44,6 +50,11 @@ public:
             .DataType({ge::DT_INT32})
             .Format({ge::FORMAT_ND})
             .UnknownShapeFormat({ge::FORMAT_ND});
+        this->Output("physicalTopkIdx")
+            .ParamType(OPTIONAL)
+            .DataType({ge::DT_INT64})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
 
         OpAICoreConfig a3_config;
         a3_config.DynamicCompileStaticFlag(true)
@@ -17,6 +17,7 @@ constexpr uint32_t EXPAND_X_INDEX = 0;
 constexpr uint32_t EXPERT_IDS_INDEX = 1;
 constexpr uint32_t OUTPUT_X_INDEX = 0;
 constexpr uint32_t OUTPUT_REC_COUNT_INDEX = 1;
+constexpr uint32_t OUTPUT_WAIT_COST_INDEX = 2;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_RANK_SIZE_INDEX = 1;
@@ -78,6 +79,13 @@ static ge::graphStatus InferShape(gert::InferShapeContext *context)
         recvCountOutShape->SetDim(0, epRankSize * (moeExpertNum / (epRankSize - sharedExpertRankNum)));
     }
 
+    // the wait cost stats output is optional
+    gert::Shape *waitCostOutShape = context->GetOutputShape(OUTPUT_WAIT_COST_INDEX);
+    if (waitCostOutShape != nullptr) {
+        waitCostOutShape->SetDimNum(1);
+        waitCostOutShape->SetDim(0, epRankSize);
+    }
+
     return GRAPH_SUCCESS;
 }
 
@@ -86,6 +94,7 @@ static ge::graphStatus InferDataType(gert::InferDataTypeContext *context)
     const auto expandXDataType = context->GetInputDataType(EXPAND_X_INDEX);
     context->SetOutputDataType(OUTPUT_X_INDEX, expandXDataType);
     context->SetOutputDataType(OUTPUT_REC_COUNT_INDEX, ge::DT_INT32);
+    context->SetOutputDataType(OUTPUT_WAIT_COST_INDEX, ge::DT_INT32);
     return ge::GRAPH_SUCCESS;
 }
 
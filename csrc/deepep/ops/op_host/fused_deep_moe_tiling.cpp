@@ -61,6 +61,7 @@ constexpr uint32_t INPUT_GMM2_WEIGHT_INDEX = 4;
 constexpr uint32_t INPUT_GMM2_WEIGHT_SCALE_INDEX = 5;
 constexpr uint32_t INPUT_SMOOTH_SCALE_INDEX = 6;
 constexpr uint32_t INPUT_EXPERT_SCALE_INDEX = 7;
+constexpr uint32_t OUTPUT_WAIT_COST_INDEX = 2;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_RANK_SIZE_INDEX = 1;
@@ -327,6 +328,10 @@ static ge::graphStatus FusedDeepMoeTilingFuncImpl(gert::TilingContext *context)
     uint32_t aivNum = ascendcPlatform.GetCoreNumAiv();
     tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.aicNum = aicNum;
     tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.aivNum = aivNum;
+    tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.isEnableDiagnose =
+        (context->GetOutputShape(OUTPUT_WAIT_COST_INDEX) != nullptr);
+    OP_LOGD(nodeName, "FusedDeepMoe isEnableDiagnose = %d",
+            static_cast<int32_t>(tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.isEnableDiagnose));
 
     uint64_t maxWindowSize = Mc2TilingUtils::GetMaxWindowSize();
     uint64_t epRankSize = static_cast<uint64_t>(tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.epRankSize);
@@ -48,6 +48,7 @@ constexpr uint32_t CONST_EXPERT_ALPHA_1_INDEX = 14;
 constexpr uint32_t CONST_EXPERT_ALPHA_2_INDEX = 15;
 constexpr uint32_t CONST_EXPERT_V_INDEX = 16;
 constexpr uint32_t OUTPUT_X_INDEX = 0;
+constexpr uint32_t OUTPUT_SEND_COST_INDEX = 1;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -136,6 +137,7 @@ static void PrintTilingDataInfo(const char *nodeName, MoeDistributeCombineV2Tili
     OP_LOGD(nodeName, "totalUbSize is %lu.", tilingData.moeDistributeCombineV2Info.totalUbSize);
     OP_LOGD(nodeName, "totalWinSize is %lu.", tilingData.moeDistributeCombineV2Info.totalWinSize);
     OP_LOGD(nodeName, "hasElastic is %d.", tilingData.moeDistributeCombineV2Info.hasElasticInfo);
+    OP_LOGD(nodeName, "isEnableDiagnose is %d.", tilingData.moeDistributeCombineV2Info.isEnableDiagnose);
 }
 
 static ge::graphStatus GetAttrAndSetTilingData(const gert::TilingContext *context,
@@ -1119,6 +1121,8 @@ static ge::graphStatus MoeDistributeCombineA3TilingFuncImpl(gert::TilingContext
     const gert::StorageShape *elasticInfoStorageShape = context->GetOptionalInputShape(ELASTIC_INFO_INDEX);
     hasElasticInfo = (elasticInfoStorageShape != nullptr);
     tilingData->moeDistributeCombineV2Info.hasElasticInfo = hasElasticInfo;
+    tilingData->moeDistributeCombineV2Info.isEnableDiagnose =
+        (context->GetOutputShape(OUTPUT_SEND_COST_INDEX) != nullptr);
 
     // 检查输入输出的dim、format、dataType
     OP_TILING_CHECK(
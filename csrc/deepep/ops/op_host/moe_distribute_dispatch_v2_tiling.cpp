@@ -42,6 +42,7 @@ constexpr uint32_t OUTPUT_ASSIST_INFO_INDEX = 2U;
 constexpr uint32_t OUTPUT_EXPERT_TOKEN_NUMS_INDEX = 3U;
 constexpr uint32_t OUTPUT_EP_RECV_COUNTS_INDEX = 4U;
 constexpr uint32_t OUTPUT_TP_RECV_COUNTS_INDEX = 5U;
+constexpr uint32_t OUTPUT_WAIT_RECV_COST_INDEX = 6U;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -77,6 +78,7 @@ constexpr uint32_t OP_TYPE_ALL_GATHER = 6;
 constexpr uint32_t UNQUANT_MODE = 0;
 constexpr uint32_t STATIC_QUANT_MODE = 1;
 constexpr uint32_t DYNAMIC_QUANT_MODE = 2;
+constexpr uint32_t DYNAMIC_POW2_QUANT_MODE = 3;  // dynamic quant whose scales are rounded up to powers of two
 constexpr size_t MAX_GROUP_NAME_LENGTH = 128UL;
 constexpr int64_t MAX_SHARED_EXPERT_NUM = 4;
 constexpr int64_t MAX_EP_WORLD_SIZE = 768L;  // 384 * 2
@@ -123,6 +125,7 @@ static void PrintTilingDataInfo(const char *nodeName, MoeDistributeDispatchV2Til
     OP_LOGD(nodeName, "sharedExpertRankNum is %u.", tilingData.moeDistributeDispatchV2Info.sharedExpertRankNum);
     OP_LOGD(nodeName, "moeExpertNum is %u.", tilingData.moeDistributeDispatchV2Info.moeExpertNum);
     OP_LOGD(nodeName, "quantMode is %u.", tilingData.moeDistributeDispatchV2Info.quantMode);
+    OP_LOGD(nodeName, "isRoundScale is %d.", static_cast<int32_t>(tilingData.moeDistributeDispatchV2Info.isRoundScale));
     OP_LOGD(nodeName, "globalBs is %u.", tilingData.moeDistributeDispatchV2Info.globalBs);
     OP_LOGD(nodeName, "bs is %u.", tilingData.moeDistributeDispatchV2Info.bs);
     OP_LOGD(nodeName, "k is %u.", tilingData.moeDistributeDispatchV2Info.k);
@@ -131,6 +134,7 @@ static void PrintTilingDataInfo(const char *nodeName, MoeDistributeDispatchV2Til
     OP_LOGD(nodeName, "totalUbSize is %lu.", tilingData.moeDistributeDispatchV2Info.totalUbSize);
     OP_LOGD(nodeName, "totalWinSize is %lu.", tilingData.moeDistributeDispatchV2Info.totalWinSize);
     OP_LOGD(nodeName, "hasElastic is %d.", tilingData.moeDistributeDispatchV2Info.hasElasticInfo);
+    OP_LOGD(nodeName, "isEnableDiagnose is %d.", tilingData.moeDistributeDispatchV2Info.isEnableDiagnose);
     OP_LOGD(nodeName, "zeroComputeExpertNum is %d", tilingData.moeDistributeDispatchV2Info.zeroComputeExpertNum);
     OP_LOGD(nodeName, "cumSumUBMinValue is %d", tilingData.moeDistributeDispatchV2Info.cumSumUBMinValue);
 }
@@ -536,8 +540,9 @@ static ge::graphStatus CheckAndSetExpertInfo(const gert::TilingContext *context,
                             MOE_EXPERT_MAX_NUM, moeExpertNum),
                     return ge::GRAPH_FAILED);
     OP_TILING_CHECK(
-        (*quantModePtr < static_cast<int64_t>(NO_SCALES)) || (*quantModePtr > static_cast<int64_t>(DYNAMIC_SCALES)),
-        OP_LOGE(nodeName, "quantMode is invalid, only support [0, %u], but got quantMode=%ld.", DYNAMIC_SCALES,
+        (*quantModePtr < static_cast<int64_t>(NO_SCALES)) ||
+            (*quantModePtr > static_cast<int64_t>(DYNAMIC_POW2_QUANT_MODE)),
+        OP_LOGE(nodeName, "quantMode is invalid, only support [0, %u], but got quantMode=%ld.", DYNAMIC_POW2_QUANT_MODE,
                 *quantModePtr),
         return ge::GRAPH_FAILED);
     OP_TILING_CHECK((*expertTokenNumsTypePtr != 0) && (*expertTokenNumsTypePtr != 1),
@@ -554,7 +559,9 @@ static ge::graphStatus CheckAndSetExpertInfo(const gert::TilingContext *context,
         }
     }
     tilingData.moeDistributeDispatchV2Info.moeExpertNum = static_cast<uint32_t>(moeExpertNum);
-    tilingData.moeDistributeDispatchV2Info.quantMode = static_cast<uint32_t>(*quantModePtr);
+    tilingData.moeDistributeDispatchV2Info.isRoundScale = (*quantModePtr == DYNAMIC_POW2_QUANT_MODE);
+    tilingData.moeDistributeDispatchV2Info.quantMode =
+        tilingData.moeDistributeDispatchV2Info.isRoundScale ? DYNAMIC_SCALES : static_cast<uint32_t>(*quantModePtr);
     tilingData.moeDistributeDispatchV2Info.expertTokenNumsType = static_cast<uint32_t>(*expertTokenNumsTypePtr);
 
     return ge::GRAPH_SUCCESS;
@@ -1137,6 +1144,8 @@ static ge::graphStatus GetParamsAndSetTilingData(const gert::TilingContext *cont
     const gert::StorageShape *elasticInfoStorageShape = context->GetOptionalInputShape(ELASTIC_INFO_INDEX);
     hasElasticInfo = (elasticInfoStorageShape != nullptr);
     tilingData->moeDistributeDispatchV2Info.hasElasticInfo = hasElasticInfo;
+    tilingData->moeDistributeDispatchV2Info.isEnableDiagnose =
+        (context->GetOutputShape(OUTPUT_WAIT_RECV_COST_INDEX) != nullptr);
     uint32_t quantMode = tilingData->moeDistributeDispatchV2Info.quantMode;
 
     // 检查quantMode和scales是否匹配
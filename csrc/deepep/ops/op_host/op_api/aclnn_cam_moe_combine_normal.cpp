@@ -20,13 +20,14 @@ aclnnStatus aclnnCamMoeCombineNormalGetWorkspaceSize(const aclTensor *recvX, con
                                                      int64_t epWorldSize, int64_t epRankId, char *tpGroupNameOptional,
                                                      int64_t tpWorldSize, int64_t tpRankId, int64_t moeExpertNum,
                                                      int64_t realMaxBs, int32_t round, int32_t per_round_tokens,
-                                                     const aclTensor *out, const aclTensor *sendCostStats,
-                                                     uint64_t *workspaceSize, aclOpExecutor **executor)
+                                                     int64_t commQuantMode, const aclTensor *out,
+                                                     const aclTensor *sendCostStats, uint64_t *workspaceSize,
+                                                     aclOpExecutor **executor)
 {
     return aclnnInnerCamMoeCombineNormalGetWorkspaceSize(
         recvX, tokenSrcInfo, epRecvCounts, recvTopkWeights, tpRecvCountsOptional, epGroupName, epWorldSize, epRankId,
-        tpGroupNameOptional, tpWorldSize, tpRankId, moeExpertNum, realMaxBs, round, per_round_tokens, out,
-        sendCostStats, workspaceSize, executor);
+        tpGroupNameOptional, tpWorldSize, tpRankId, moeExpertNum, realMaxBs, round, per_round_tokens, commQuantMode,
+        out, sendCostStats, workspaceSize, executor);
 }
 
 aclnnStatus aclnnCamMoeCombineNormal(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor,
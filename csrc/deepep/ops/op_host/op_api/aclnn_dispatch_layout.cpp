@@ -14,16 +14,20 @@ extern "C" void __attribute__((weak)) NnopbaseSetHcclServerType(void *executor,
 extern "C" {
 #endif
 
-aclnnStatus aclnnDispatchLayoutGetWorkspaceSize(const aclTensor *topkIdx, int64_t numTokens, int64_t numRanks,
-                                                int64_t numExperts, int64_t numTopk, int64_t localRankSize,
-                                                int32_t perRoundTokens, const aclTensor *numTokensPerRank,
+aclnnStatus aclnnDispatchLayoutGetWorkspaceSize(const aclTensor *topkIdx, const aclTensor *expertReplicaTable,
+                                                int64_t numTokens, int64_t numRanks, int64_t numExperts,
+                                                int64_t numTopk, int64_t localRankSize, int32_t perRoundTokens,
+                                                int64_t isTokenInRankBitmap, const aclTensor *numTokensPerRank,
                                                 const aclTensor *numTokensPerExpert, const aclTensor *isTokenInRank,
                                                 const aclTensor *notifySendData, const aclTensor *sendTokenIdxSmall,
-                                                uint64_t *workspaceSize, aclOpExecutor **executor)
+                                                const aclTensor *physicalTopkIdx, uint64_t *workspaceSize,
+                                                aclOpExecutor **executor)
 {
-    return aclnnInnerDispatchLayoutGetWorkspaceSize(topkIdx, numTokens, numRanks, numExperts, numTopk, localRankSize,
-                                                    perRoundTokens, numTokensPerRank, numTokensPerExpert, isTokenInRank,
-                                                    notifySendData, sendTokenIdxSmall, workspaceSize, executor);
+    return aclnnInnerDispatchLayoutGetWorkspaceSize(topkIdx, expertReplicaTable, numTokens, numRanks, numExperts,
+                                                    numTopk, localRankSize, perRoundTokens, isTokenInRankBitmap,
+                                                    numTokensPerRank, numTokensPerExpert, isTokenInRank,
+                                                    notifySendData, sendTokenIdxSmall, physicalTopkIdx,
+                                                    workspaceSize, executor);
 }
 
 aclnnStatus aclnnDispatchLayout(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor, aclrtStream stream)
@@ -29,12 +29,13 @@ aclnnStatus aclnnFusedDeepMoeGetWorkspaceSize(
     const aclTensor *expertSmoothScalesOptional, const aclTensor *expertScalesOptional, char *groupEp,
     int64_t epRankSize, int64_t epRankId, int64_t moeExpertNum, int64_t shareExpertNum, int64_t shareExpertRankNum,
     int64_t quantMode, int64_t globalBs, const aclTensor *output, const aclTensor *outputRecvCount,
-    uint64_t *workspaceSize, aclOpExecutor **executor)
+    const aclTensor *waitRecvCostStatsOut, uint64_t *workspaceSize, aclOpExecutor **executor)
 {
     return aclnnInnerFusedDeepMoeGetWorkspaceSize(
         x, expertIds, gmm1PermutedWeight, gmm1PermutedWeightScale, gmm2Weight, gmm2WeightScale,
         expertSmoothScalesOptional, expertScalesOptional, groupEp, epRankSize, epRankId, moeExpertNum, shareExpertNum,
-        shareExpertRankNum, quantMode, globalBs, output, outputRecvCount, workspaceSize, executor);
+        shareExpertRankNum, quantMode, globalBs, output, outputRecvCount, waitRecvCostStatsOut, workspaceSize,
+        executor);
 }
 
 aclnnStatus aclnnFusedDeepMoe(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor, aclrtStream stream)
@@ -21,7 +21,8 @@ extern aclnnStatus aclnnInnerMoeDistributeDispatchV2GetWorkspaceSize(
     int64_t shareExpertRankNum, int64_t quantMode, int64_t globalBs, int64_t expertTokenNumsType, char *commAlg,
     int64_t zeroExpertNum, int64_t copyExpertNum, int64_t constExpertNum, const aclTensor *expandX,
     const aclTensor *dynamicScales, const aclTensor *assist_info_for_combine, const aclTensor *expertTokensNums,
-    const aclTensor *epRecvCounts, const aclTensor *tpRecvCounts, uint64_t *workspaceSize, aclOpExecutor **executor);
+    const aclTensor *epRecvCounts, const aclTensor *tpRecvCounts, const aclTensor *waitRecvCostStats,
+    uint64_t *workspaceSize, aclOpExecutor **executor);
 extern aclnnStatus aclnnInnerMoeDistributeDispatchV2(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor,
                                                      aclrtStream stream);
 
@@ -34,13 +35,13 @@ aclnnStatus aclnnMoeDistributeDispatchV2GetWorkspaceSize(
     int64_t sharedExpertRankNum, int64_t quantMode, int64_t globalBs, int64_t expertTokenNumsType, char *commAlg,
     const aclTensor *expandXOut, const aclTensor *dynamicScalesOut, const aclTensor *assistInfoForCombineOut,
     const aclTensor *expertTokenNumsOut, const aclTensor *epRecvCountsOut, const aclTensor *tpRecvCountsOut,
-    uint64_t *workspaceSize, aclOpExecutor **executor)
+    const aclTensor *waitRecvCostStatsOut, uint64_t *workspaceSize, aclOpExecutor **executor)
 {
     return aclnnInnerMoeDistributeDispatchV2GetWorkspaceSize(
         x, expertIds, scalesOptional, xActiveMaskOptional, nullptr, groupEp, epWorldSize, epRankId, moeExpertNum,
         groupTp, tpWorldSize, tpRankId, expertShardType, sharedExpertNum, sharedExpertRankNum, quantMode, globalBs,
         expertTokenNumsType, commAlg, 0, 0, 0, expandXOut, dynamicScalesOut, assistInfoForCombineOut,
-        expertTokenNumsOut, epRecvCountsOut, tpRecvCountsOut, workspaceSize, executor);
+        expertTokenNumsOut, epRecvCountsOut, tpRecvCountsOut, waitRecvCostStatsOut, workspaceSize, executor);
 }
 
 aclnnStatus aclnnMoeDistributeDispatchV2(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor,
@@ -43,6 +43,8 @@ extern "C" {
  计算输出，Tensor，必选输出，数据类型int32，仅支持1维，数据格式支持ND。表示从各卡接收的token数。
  * @param [out] tpRecvCountsOut:
  计算输出，Tensor，必选输出，数据类型int32，仅支持1维，数据格式支持ND。无tp通信域时输出为空。
+ * @param [out] waitRecvCostStatsOut:
+ 计算输出，Tensor，可选输出，数据类型int32，仅支持1维，shape为(epWorldSize,)，数据格式支持ND。累加本卡等待各源卡数据的耗时，单位us，传空时不统计。
  * @param [out] workspaceSize: 出参，返回需要在npu device侧申请的workspace大小。
  * @param [out] executor: 出参，返回op执行器，包含了算子计算流程。
  * @return aclnnStatus: 返回值，返回状态码
@@ -55,7 +57,7 @@ __attribute__((visibility("default"))) aclnnStatus aclnnMoeDistributeDispatchV2G
     int64_t sharedExpertRankNum, int64_t quantMode, int64_t globalBs, int64_t expertTokenNumsType, char *commAlg,
     const aclTensor *expandXOut, const aclTensor *dynamicScalesOut, const aclTensor *assistInfoForCombineOut,
     const aclTensor *expertTokenNumsOut, const aclTensor *epRecvCountsOut, const aclTensor *tpRecvCountsOut,
-    uint64_t *workspaceSize, aclOpExecutor **executor);
+    const aclTensor *waitRecvCostStatsOut, uint64_t *workspaceSize, aclOpExecutor **executor);
 
 /**
  * @brief aclnnMoeDistributeDispatchV2的第二段接口，用于执行计算。
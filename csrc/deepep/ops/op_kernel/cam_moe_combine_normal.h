@@ -20,6 +20,7 @@ constexpr uint64_t WIN_512_ALIGN = 512UL;
 constexpr uint32_t FLOAT_NUM_PER_ALIGN = 8U;
 constexpr uint8_t DOUBLE_BUFFER = 2;
 constexpr int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
+constexpr uint32_t INT8_COMM_QUANT = 2U;
 
 template <AscendC::HardEvent event>
 __aicore__ inline void SyncFunc()
@@ -56,6 +57,9 @@ private:
     __aicore__ inline void WaitBuffCopy(uint32_t tokenIndex);
     __aicore__ inline void SetStatusBySrcInfo(uint32_t srcRankId, uint32_t srcTokenId, uint32_t srcTopkId);
     __aicore__ inline void ReadBufferAndWeightedSum(uint32_t tokenIndex, uint32_t startTokenIndex);
+    __aicore__ inline void ReduceMaxInplace(const LocalTensor<float> &srcLocal, uint32_t count);
+    __aicore__ inline void QuantToken(LocalTensor<RecvXType> &tokenLocal, LocalTensor<int8_t> &quantLocal);
+    __aicore__ inline float DequantToken(GM_ADDR tokenAddr, LocalTensor<float> &tokenFloatLocal);
 
     __aicore__ GM_ADDR GetStateAddrByRankId(const int32_t rankId)
     {
@@ -107,9 +111,12 @@ private:
     uint32_t h256AlignFloatLen_{0};
     uint32_t h32AlignRecvXLen_{0};
     uint32_t h512AlignRecvXLen_{0};
+    uint32_t h32AlignInt8Len_{0};
+    uint32_t hQuantCommuLen_{0};  // int8 token followed by its float dequant scale
     uint32_t sendCostStatsBufSize_{0};
 
     bool isEnableDiagnose_{false};
+    bool isCommQuant_{false};
 
     TPipe *tpipe_{nullptr};
     TQue<QuePosition::VECIN, 1> weightedSumQueue_;
@@ -123,6 +130,7 @@ private:
     TBuf<> srcInfoBuf_;
     TBuf<> xOutBuf_;
     TBuf<> tempStateBuf_;
+    TBuf<> quantTokenBuf_;
 
     GlobalTensor<RecvXType> recvXGM_;
     GlobalTensor<SrcInfoType> tokenSrcInfoGM_;
@@ -178,6 +186,7 @@ CamMoeCombineNormal<TemplateMC2TypeFunc>::InitTilingData(const CamMoeCombineNorm
     epWorldSize_ = tilingData->camMoeCombineNormalInfo.epWorldSize;
     epRankId_ = tilingData->camMoeCombineNormalInfo.epRankId;
     isEnableDiagnose_ = tilingData->camMoeCombineNormalInfo.isEnableDiagnose;
+    isCommQuant_ = (tilingData->camMoeCombineNormalInfo.commQuantMode == INT8_COMM_QUANT);
 }
 
 template <TemplateMC2TypeClass>
@@ -189,6 +198,8 @@ __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::InitBuffLen()
     hRecvXTypeLen_ = axisH_ * sizeof(RecvXType);
     h32AlignRecvXLen_ = Ceil(hRecvXTypeLen_, UB_32_ALIGN) * UB_32_ALIGN;
     h512AlignRecvXLen_ = Ceil(hRecvXTypeLen_, WIN_512_ALIGN) * WIN_512_ALIGN;
+    h32AlignInt8Len_ = Ceil(axisH_ * static_cast<uint32_t>(sizeof(int8_t)), UB_32_ALIGN) * UB_32_ALIGN;
+    hQuantCommuLen_ = h32AlignInt8Len_ + static_cast<uint32_t>(sizeof(float));
     if (isEnableDiagnose_) {
         sendCostStatsBufSize_ = Ceil(epWorldSize_ * sizeof(int32_t), UB_32_ALIGN) * UB_32_ALIGN;
     }
@@ -231,6 +242,11 @@ __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::CopyBufferToSha
     tpipe_->InitBuffer(stateBuf_, UB_32_ALIGN);
     tpipe_->InitBuffer(localCopyQueue_, DOUBLE_BUFFER, h32AlignRecvXLen_);
     tpipe_->InitBuffer(srcInfoBuf_, blockLen);
+    if (isCommQuant_) {
+        tpipe_->InitBuffer(tokenFloatBuf_, h32AlignFloatLen_);
+        tpipe_->InitBuffer(weightedMulBuf_, h256AlignFloatLen_);
+        tpipe_->InitBuffer(quantTokenBuf_, h32AlignInt8Len_ + UB_32_ALIGN);
+    }
     LocalTensor<uint32_t> statusTensor = stateBuf_.Get<uint32_t>();
     Duplicate<uint32_t>(statusTensor, 0x3F800000, FLOAT_NUM_PER_ALIGN);
 
@@ -295,10 +311,102 @@ __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::CopyBufferToSha
     DataCopyPad(localCopyTensor, recvXGM_[tokenOffset], xOutCopyParams, copyPadExtParams);
     localCopyQueue_.EnQue(localCopyTensor);
     localCopyTensor = localCopyQueue_.DeQue<RecvXType>();
+    if (isCommQuant_) {
+        LocalTensor<int8_t> quantLocal = quantTokenBuf_.Get<int8_t>();
+        QuantToken(localCopyTensor, quantLocal);
+        localCopyQueue_.FreeTensor<RecvXType>(localCopyTensor);
+        GlobalTensor<int8_t> dstQuantWindow;
+        dstQuantWindow.SetGlobalBuffer((__gm__ int8_t *)dstGM);
+        DataCopyExtParams quantCopyParams{1U, hQuantCommuLen_, 0U, 0U, 0U};
+        SyncFunc<AscendC::HardEvent::V_MTE3>();
+        SyncFunc<AscendC::HardEvent::S_MTE3>();
+        DataCopyPad(dstQuantWindow, quantLocal, quantCopyParams);
+        return;
+    }
     DataCopyPad(dstWindow, localCopyTensor, xOutCopyParams);
     localCopyQueue_.FreeTensor<RecvXType>(localCopyTensor);
 }
 
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::ReduceMaxInplace(const LocalTensor<float> &srcLocal,
+                                                                                  uint32_t count)
+{
+    uint64_t repsFp32 = count >> 6;        // 6 is count / elemPerRefFp32
+    uint64_t offsetsFp32 = repsFp32 << 6;  // 6 is repsFp32 * elemPerRefFp32
+    uint64_t remsFp32 = count & 0x3f;      // 0x3f 63, count % elemPerRefFp32
+    const uint64_t elemPerRefFp32 = 64UL;  // 256 bit / sizeof(float)
+    if (likely(repsFp32 > 1)) {
+        // 8 is rep stride
+        Max(srcLocal, srcLocal[elemPerRefFp32], srcLocal, elemPerRefFp32, repsFp32 - 1, {1, 1, 1, 0, 8, 0});
+        PipeBarrier<PIPE_V>();
+    }
+    if (unlikely(remsFp32 > 0) && unlikely(offsetsFp32 > 0)) {
+        Max(srcLocal, srcLocal[offsetsFp32], srcLocal, remsFp32, 1, {1, 1, 1, 0, 8, 0});
+        PipeBarrier<PIPE_V>();
+    }
+    uint32_t mask = (repsFp32 > 0) ? elemPerRefFp32 : count;
+    // 8 is rep stride
+    WholeReduceMax(srcLocal, srcLocal, mask, 1, 8, 1, 8);
+}
+
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::QuantToken(LocalTensor<RecvXType> &tokenLocal,
+                                                                            LocalTensor<int8_t> &quantLocal)
+{
+    LocalTensor<float> floatLocalTemp = tokenFloatBuf_.Get<float>();
+    LocalTensor<float> floatLocalAbsTemp = weightedMulBuf_.Get<float>();
+
+    Cast(floatLocalTemp, tokenLocal, RoundMode::CAST_NONE, axisH_);
+    PipeBarrier<PIPE_V>();
+    Abs(floatLocalAbsTemp, floatLocalTemp, axisH_);
+    PipeBarrier<PIPE_V>();
+    ReduceMaxInplace(floatLocalAbsTemp, axisH_);
+
+    SyncFunc<AscendC::HardEvent::V_S>();
+    float dynamicScale = float(127.0) / (floatLocalAbsTemp.GetValue(0) + 1e-12f);
+    SyncFunc<AscendC::HardEvent::S_V>();
+    Muls(floatLocalTemp, floatLocalTemp, dynamicScale, axisH_);
+    PipeBarrier<PIPE_V>();
+
+    LocalTensor<half> halfLocalTemp = floatLocalTemp.ReinterpretCast<half>();
+    LocalTensor<int32_t> int32LocalTemp = floatLocalTemp.ReinterpretCast<int32_t>();
+    Cast(int32LocalTemp, floatLocalTemp, RoundMode::CAST_RINT, axisH_);
+    PipeBarrier<PIPE_V>();
+    SetDeqScale((half)1.000000e+00f);
+    PipeBarrier<PIPE_V>();
+    Cast(halfLocalTemp, int32LocalTemp, RoundMode::CAST_ROUND, axisH_);
+    PipeBarrier<PIPE_V>();
+    Cast(quantLocal, halfLocalTemp, RoundMode::CAST_TRUNC, axisH_);
+
+    LocalTensor<float> scaleLocal = quantLocal.ReinterpretCast<float>();
+    scaleLocal.SetValue(h32AlignInt8Len_ / sizeof(float), float(1.0) / dynamicScale);  // int8->float32
+}
+
+template <TemplateMC2TypeClass>
+__aicore__ inline float CamMoeCombineNormal<TemplateMC2TypeFunc>::DequantToken(GM_ADDR tokenAddr,
+                                                                               LocalTensor<float> &tokenFloatLocal)
+{
+    GlobalTensor<int8_t> quantTokenTensor;
+    quantTokenTensor.SetGlobalBuffer((__gm__ int8_t *)tokenAddr);
+    const DataCopyExtParams quantCopyParams{1U, hQuantCommuLen_, 0U, 0U, 0U};
+    const DataCopyPadExtParams<int8_t> copyPadExtParams{false, 0U, 0U, 0U};
+
+    LocalTensor<int8_t> quantLocal = weightedSumQueue_.AllocTensor<int8_t>();
+    DataCopyPad(quantLocal, quantTokenTensor, quantCopyParams, copyPadExtParams);
+    weightedSumQueue_.EnQue(quantLocal);
+    quantLocal = weightedSumQueue_.DeQue<int8_t>();
+    SyncFunc<AscendC::HardEvent::MTE2_S>();
+    float dequantScale = quantLocal.ReinterpretCast<float>().GetValue(h32AlignInt8Len_ / sizeof(float));
+
+    // int8 cannot be cast to float directly, go through half which holds every int8 value exactly
+    LocalTensor<half> halfLocalTemp = xOutBuf_.Get<half>();
+    Cast(halfLocalTemp, quantLocal, RoundMode::CAST_NONE, axisH_);
+    PipeBarrier<PIPE_V>();
+    Cast(tokenFloatLocal, halfLocalTemp, RoundMode::CAST_NONE, axisH_);
+    weightedSumQueue_.FreeTensor<int8_t>(quantLocal);
+    return dequantScale;
+}
+
 template <TemplateMC2TypeClass>
 __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::SetStatusBySrcInfo(uint32_t srcRankId,
                                                                                     uint32_t srcTokenId,
@@ -352,20 +460,24 @@ __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::ReadBufferAndWe
     for (uint32_t topkId = 0U; topkId < axisK_; topkId++) {
         float scale = topkWeightsLocal.GetValue((tokenIndex - startTokenIndex) * axisK_ + topkId);
         GM_ADDR localTokenAddr = localRankGM_ + (tokenIndex * axisK_ + topkId) * h512AlignRecvXLen_;
-        GlobalTensor<XType> localTokenTensor;
-        localTokenTensor.SetGlobalBuffer((__gm__ XType *)localTokenAddr);
-
-        LocalTensor<XType> tmpToken = weightedSumQueue_.AllocTensor<XType>();
-        const DataCopyPadExtParams<RecvXType> copyPadExtParams{false, 0U, 0U, 0U};
-        DataCopyPad(tmpToken, localTokenTensor, xOutCopyParams, copyPadExtParams);
-        weightedSumQueue_.EnQue(tmpToken);
-        tmpToken = weightedSumQueue_.DeQue<XType>();
-        Cast(tokenFloatLocal, tmpToken, AscendC::RoundMode::CAST_NONE, axisH_);
+        if (isCommQuant_) {
+            scale *= DequantToken(localTokenAddr, tokenFloatLocal);  // fold the dequant scale into the weight
+        } else {
+            GlobalTensor<XType> localTokenTensor;
+            localTokenTensor.SetGlobalBuffer((__gm__ XType *)localTokenAddr);
+
+            LocalTensor<XType> tmpToken = weightedSumQueue_.AllocTensor<XType>();
+            const DataCopyPadExtParams<RecvXType> copyPadExtParams{false, 0U, 0U, 0U};
+            DataCopyPad(tmpToken, localTokenTensor, xOutCopyParams, copyPadExtParams);
+            weightedSumQueue_.EnQue(tmpToken);
+            tmpToken = weightedSumQueue_.DeQue<XType>();
+            Cast(tokenFloatLocal, tmpToken, AscendC::RoundMode::CAST_NONE, axisH_);
+            weightedSumQueue_.FreeTensor<XType>(tmpToken);
+        }
         PipeBarrier<PIPE_V>();
         AscendC::Muls(weightedMulBufLocal, tokenFloatLocal, scale, axisH_);
         PipeBarrier<PIPE_V>();
         AscendC::Add(sumFloatBufLocal, sumFloatBufLocal, weightedMulBufLocal, axisH_);
-        weightedSumQueue_.FreeTensor<XType>(tmpToken);
     }
     PipeBarrier<PIPE_V>();
     LocalTensor<XType> xOutLocal = xOutBuf_.Get<XType>();
@@ -392,7 +504,8 @@ __aicore__ inline void CamMoeCombineNormal<TemplateMC2TypeFunc>::ReadBufferFromR
     tpipe_->InitBuffer(tokenFloatBuf_, h32AlignFloatLen_);
     tpipe_->InitBuffer(weightedMulBuf_, h256AlignFloatLen_);
     tpipe_->InitBuffer(sumFloatBuf_, h32AlignFloatLen_);
-    tpipe_->InitBuffer(weightedSumQueue_, DOUBLE_BUFFER, h32AlignRecvXLen_);
+    uint32_t recvTokenLen = isCommQuant_ ? (h32AlignInt8Len_ + UB_32_ALIGN) : h32AlignRecvXLen_;
+    tpipe_->InitBuffer(weightedSumQueue_, DOUBLE_BUFFER, recvTokenLen);
     tpipe_->InitBuffer(stateBuf_, (axisK_)*UB_32_ALIGN);
     tpipe_->InitBuffer(tempStateBuf_, (axisK_)*UB_32_ALIGN);
     tpipe_->InitBuffer(topkWeightsBuf_, tokenPerBlock * axisK_ * sizeof(float));
@@ -23,6 +23,7 @@ constexpr uint8_t DOUBLE_BUFFER = 2;
 constexpr int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 constexpr uint32_t STATE_OFFSET = 32U;
 constexpr uint32_t BATCH_SRC_INFO_CNT = 128U;
+constexpr uint32_t INT8_COMM_QUANT = 2U;
 
 template <AscendC::HardEvent event>
 __aicore__ inline void SyncFunc()
@@ -59,6 +60,9 @@ private:
     __aicore__ inline void WaitBuffCopy(uint32_t recvXTokenIdx);
     __aicore__ inline void SetStatusBySrcInfo(uint32_t srcRankId, uint32_t srcTokenId, uint32_t srcTopkId);
     __aicore__ inline void ReadBufferAndWeightedSum(uint32_t recvXTokenIdx, uint32_t roundRecvStartTokenIdx_);
+    __aicore__ inline void ReduceMaxInplace(const LocalTensor<float> &srcLocal, uint32_t count);
+    __aicore__ inline void QuantToken(LocalTensor<RecvXType> &tokenLocal, LocalTensor<int8_t> &quantLocal);
+    __aicore__ inline float DequantToken(GM_ADDR tokenAddr, LocalTensor<float> &tokenFloatLocal);
     __aicore__ inline void InitRoundSendData();
     __aicore__ inline void SetRoundStatus();
     __aicore__ inline void WaitRoundStatus();
@@ -124,6 +128,8 @@ private:
     uint32_t h256AlignFloatLen_{0};
     uint32_t h32AlignRecvXLen_{0};
     uint32_t h512AlignRecvXLen_{0};
+    uint32_t h32AlignInt8Len_{0};
+    uint32_t hQuantCommuLen_{0};  // int8 token followed by its float dequant scale
     uint32_t roundIndex_{0};
     uint32_t realMaxBs_{0};
     uint32_t perRoundTokens_{0};
@@ -147,6 +153,7 @@ private:
     uint32_t stateOffset_{0};
 
     bool isEnableDiagnose_{false};
+    bool isCommQuant_{false};
 
     TPipe *tpipe_{nullptr};
     TQue<QuePosition::VECIN, 1> weightedSumQueue_;
@@ -167,6 +174,7 @@ private:
     TBuf<> roundNeedSendCntBuf_;
     TBuf<> roundSendOffsetBuf_;
     TBuf<> tempRecvCountBuf_;
+    TBuf<> quantTokenBuf_;
 
     LocalTensor<uint32_t> setStateLT_;
     LocalTensor<uint32_t> roundNeedSendCntLT_;
@@ -228,6 +236,7 @@ CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::InitTilingData(const CamMoeC
     epWorldSize_ = tilingData->camMoeCombineNormalInfo.epWorldSize;
     epRankId_ = tilingData->camMoeCombineNormalInfo.epRankId;
     isEnableDiagnose_ = tilingData->camMoeCombineNormalInfo.isEnableDiagnose;
+    isCommQuant_ = (tilingData->camMoeCombineNormalInfo.commQuantMode == INT8_COMM_QUANT);
     realMaxBs_ = tilingData->camMoeCombineNormalInfo.realMaxBs;
     maxRound_ = tilingData->camMoeCombineNormalInfo.maxRound;
     perRoundTokens_ = tilingData->camMoeCombineNormalInfo.perRoundTokens;
@@ -242,6 +251,8 @@ __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::InitB
     hRecvXTypeLen_ = axisH_ * sizeof(RecvXType);
     h32AlignRecvXLen_ = Ceil(hRecvXTypeLen_, UB_32_ALIGN) * UB_32_ALIGN;
     h512AlignRecvXLen_ = Ceil(hRecvXTypeLen_, WIN_512_ALIGN) * WIN_512_ALIGN;
+    h32AlignInt8Len_ = Ceil(axisH_ * static_cast<uint32_t>(sizeof(int8_t)), UB_32_ALIGN) * UB_32_ALIGN;
+    hQuantCommuLen_ = h32AlignInt8Len_ + static_cast<uint32_t>(sizeof(float));
     if (isEnableDiagnose_) {
         sendCostStatsBufSize_ = Ceil(epWorldSize_ * sizeof(int32_t), UB_32_ALIGN) * UB_32_ALIGN;
     }
@@ -293,6 +304,10 @@ __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::InitR
 
     // 创建localCopyQueue_， 用于存放从GM拷贝到UB的token
     tpipe_->InitBuffer(localCopyQueue_, DOUBLE_BUFFER, h32AlignRecvXLen_);  // 28KB
+    if (isCommQuant_) {
+        // 量化后的token及其scale，量化计算复用接收侧的tokenFloatBuf_和weightedMulBuf_
+        tpipe_->InitBuffer(quantTokenBuf_, h32AlignInt8Len_ + UB_32_ALIGN);
+    }
     PipeBarrier<PIPE_ALL>();
 }
 
@@ -306,7 +321,8 @@ __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::InitR
     tpipe_->InitBuffer(tokenFloatBuf_, h32AlignFloatLen_);                                       // 28KB
     tpipe_->InitBuffer(weightedMulBuf_, h256AlignFloatLen_);                                     // 28KB
     tpipe_->InitBuffer(sumFloatBuf_, h32AlignFloatLen_);                                         // 28KB
-    tpipe_->InitBuffer(weightedSumQueue_, DOUBLE_BUFFER, h32AlignRecvXLen_);                     // 14KB
+    uint32_t recvTokenLen = isCommQuant_ ? (h32AlignInt8Len_ + UB_32_ALIGN) : h32AlignRecvXLen_;
+    tpipe_->InitBuffer(weightedSumQueue_, DOUBLE_BUFFER, recvTokenLen);                          // 14KB
     tpipe_->InitBuffer(waitStateBuf_, axisK_ * UB_32_ALIGN);                                     // 196B
     tpipe_->InitBuffer(waitTempStateBuf_, axisK_ * UB_32_ALIGN);                                 // 196B
     tpipe_->InitBuffer(setRoundStateBuf_, epWorldSize_ * FLOAT_NUM_PER_ALIGN * sizeof(float));   // 用于setRoundStatus
@@ -440,10 +456,102 @@ __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::CopyB
     DataCopyPad(localCopyTensor, recvXGM_[tokenOffset], xOutCopyParams, copyPadExtParams);
     localCopyQueue_.EnQue(localCopyTensor);
     localCopyTensor = localCopyQueue_.DeQue<RecvXType>();
+    if (isCommQuant_) {
+        LocalTensor<int8_t> quantLocal = quantTokenBuf_.Get<int8_t>();
+        QuantToken(localCopyTensor, quantLocal);
+        localCopyQueue_.FreeTensor<RecvXType>(localCopyTensor);
+        GlobalTensor<int8_t> dstQuantWindow;
+        dstQuantWindow.SetGlobalBuffer((__gm__ int8_t *)dstGM);
+        DataCopyExtParams quantCopyParams{1U, hQuantCommuLen_, 0U, 0U, 0U};
+        SyncFunc<AscendC::HardEvent::V_MTE3>();
+        SyncFunc<AscendC::HardEvent::S_MTE3>();
+        DataCopyPad(dstQuantWindow, quantLocal, quantCopyParams);
+        return;
+    }
     DataCopyPad(dstWindow, localCopyTensor, xOutCopyParams);
     localCopyQueue_.FreeTensor<RecvXType>(localCopyTensor);
 }
 
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::ReduceMaxInplace(
+    const LocalTensor<float> &srcLocal, uint32_t count)
+{
+    uint64_t repsFp32 = count >> 6;        // 6 is count / elemPerRefFp32
+    uint64_t offsetsFp32 = repsFp32 << 6;  // 6 is repsFp32 * elemPerRefFp32
+    uint64_t remsFp32 = count & 0x3f;      // 0x3f 63, count % elemPerRefFp32
+    const uint64_t elemPerRefFp32 = 64UL;  // 256 bit / sizeof(float)
+    if (likely(repsFp32 > 1)) {
+        // 8 is rep stride
+        Max(srcLocal, srcLocal[elemPerRefFp32], srcLocal, elemPerRefFp32, repsFp32 - 1, {1, 1, 1, 0, 8, 0});
+        PipeBarrier<PIPE_V>();
+    }
+    if (unlikely(remsFp32 > 0) && unlikely(offsetsFp32 > 0)) {
+        Max(srcLocal, srcLocal[offsetsFp32], srcLocal, remsFp32, 1, {1, 1, 1, 0, 8, 0});
+        PipeBarrier<PIPE_V>();
+    }
+    uint32_t mask = (repsFp32 > 0) ? elemPerRefFp32 : count;
+    // 8 is rep stride
+    WholeReduceMax(srcLocal, srcLocal, mask, 1, 8, 1, 8);
+}
+
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::QuantToken(
+    LocalTensor<RecvXType> &tokenLocal, LocalTensor<int8_t> &quantLocal)
+{
+    LocalTensor<float> floatLocalTemp = tokenFloatBuf_.Get<float>();
+    LocalTensor<float> floatLocalAbsTemp = weightedMulBuf_.Get<float>();
+
+    Cast(floatLocalTemp, tokenLocal, RoundMode::CAST_NONE, axisH_);
+    PipeBarrier<PIPE_V>();
+    Abs(floatLocalAbsTemp, floatLocalTemp, axisH_);
+    PipeBarrier<PIPE_V>();
+    ReduceMaxInplace(floatLocalAbsTemp, axisH_);
+
+    SyncFunc<AscendC::HardEvent::V_S>();
+    float dynamicScale = float(127.0) / (floatLocalAbsTemp.GetValue(0) + 1e-12f);
+    SyncFunc<AscendC::HardEvent::S_V>();
+    Muls(floatLocalTemp, floatLocalTemp, dynamicScale, axisH_);
+    PipeBarrier<PIPE_V>();
+
+    LocalTensor<half> halfLocalTemp = floatLocalTemp.ReinterpretCast<half>();
+    LocalTensor<int32_t> int32LocalTemp = floatLocalTemp.ReinterpretCast<int32_t>();
+    Cast(int32LocalTemp, floatLocalTemp, RoundMode::CAST_RINT, axisH_);
+    PipeBarrier<PIPE_V>();
+    SetDeqScale((half)1.000000e+00f);
+    PipeBarrier<PIPE_V>();
+    Cast(halfLocalTemp, int32LocalTemp, RoundMode::CAST_ROUND, axisH_);
+    PipeBarrier<PIPE_V>();
+    Cast(quantLocal, halfLocalTemp, RoundMode::CAST_TRUNC, axisH_);
+
+    LocalTensor<float> scaleLocal = quantLocal.ReinterpretCast<float>();
+    scaleLocal.SetValue(h32AlignInt8Len_ / sizeof(float), float(1.0) / dynamicScale);  // int8->float32
+}
+
+template <TemplateMC2TypeClass>
+__aicore__ inline float CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::DequantToken(
+    GM_ADDR tokenAddr, LocalTensor<float> &tokenFloatLocal)
+{
+    GlobalTensor<int8_t> quantTokenTensor;
+    quantTokenTensor.SetGlobalBuffer((__gm__ int8_t *)tokenAddr);
+    const DataCopyExtParams quantCopyParams{1U, hQuantCommuLen_, 0U, 0U, 0U};
+    const DataCopyPadExtParams<int8_t> copyPadExtParams{false, 0U, 0U, 0U};
+
+    LocalTensor<int8_t> quantLocal = weightedSumQueue_.AllocTensor<int8_t>();
+    DataCopyPad(quantLocal, quantTokenTensor, quantCopyParams, copyPadExtParams);
+    weightedSumQueue_.EnQue(quantLocal);
+    quantLocal = weightedSumQueue_.DeQue<int8_t>();
+    SyncFunc<AscendC::HardEvent::MTE2_S>();
+    float dequantScale = quantLocal.ReinterpretCast<float>().GetValue(h32AlignInt8Len_ / sizeof(float));
+
+    // int8 cannot be cast to float directly, go through half which holds every int8 value exactly
+    LocalTensor<half> halfLocalTemp = xOutBuf_.Get<half>();
+    Cast(halfLocalTemp, quantLocal, RoundMode::CAST_NONE, axisH_);
+    PipeBarrier<PIPE_V>();
+    Cast(tokenFloatLocal, halfLocalTemp, RoundMode::CAST_NONE, axisH_);
+    weightedSumQueue_.FreeTensor<int8_t>(quantLocal);
+    return dequantScale;
+}
+
 template <TemplateMC2TypeClass>
 __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::SetStatusBySrcInfo(uint32_t srcRankId,
                                                                                               uint32_t srcTokenId,
@@ -496,20 +604,24 @@ __aicore__ inline void CamMoeCombineNormalMultiRound<TemplateMC2TypeFunc>::ReadB
     for (uint32_t topkId = 0U; topkId < axisK_; topkId++) {
         float scale = topkWeightsLT_.GetValue(topkWeightTokenIdx * axisK_ + topkId);
         GM_ADDR localTokenAddr = localRankGM_ + (recvXTokenIdx * axisK_ + topkId) * h512AlignRecvXLen_;
-        GlobalTensor<XType> localTokenTensor;
-        localTokenTensor.SetGlobalBuffer((__gm__ XType *)localTokenAddr);
-
-        LocalTensor<XType> tmpToken = weightedSumQueue_.AllocTensor<XType>();
-        const DataCopyPadExtParams<RecvXType> copyPadExtParams{false, 0U, 0U, 0U};
-        DataCopyPad(tmpToken, localTokenTensor, xOutCopyParams, copyPadExtParams);
-        weightedSumQueue_.EnQue(tmpToken);
-        tmpToken = weightedSumQueue_.DeQue<XType>();
-        Cast(tokenFloatLocal, tmpToken, AscendC::RoundMode::CAST_NONE, axisH_);
+        if (isCommQuant_) {
+            scale *= DequantToken(localTokenAddr, tokenFloatLocal);  // fold the dequant scale into the weight
+        } else {
+            GlobalTensor<XType> localTokenTensor;
+            localTokenTensor.SetGlobalBuffer((__gm__ XType *)localTokenAddr);
+
+            LocalTensor<XType> tmpToken = weightedSumQueue_.AllocTensor<XType>();
+            const DataCopyPadExtParams<RecvXType> copyPadExtParams{false, 0U, 0U, 0U};
+            DataCopyPad(tmpToken, localTokenTensor, xOutCopyParams, copyPadExtParams);
+            weightedSumQueue_.EnQue(tmpToken);
+            tmpToken = weightedSumQueue_.DeQue<XType>();
+            Cast(tokenFloatLocal, tmpToken, AscendC::RoundMode::CAST_NONE, axisH_);
+            weightedSumQueue_.FreeTensor<XType>(tmpToken);
+        }
         PipeBarrier<PIPE_V>();
         AscendC::Muls(weightedMulBufLocal, tokenFloatLocal, scale, axisH_);
         PipeBarrier<PIPE_V>();
         AscendC::Add(sumFloatBufLocal, sumFloatBufLocal, weightedMulBufLocal, axisH_);
-        weightedSumQueue_.FreeTensor<XType>(tmpToken);
     }
     PipeBarrier<PIPE_V>();
     LocalTensor<XType> xOutLocal = xOutBuf_.Get<XType>();
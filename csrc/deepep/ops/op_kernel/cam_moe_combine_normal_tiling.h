@@ -15,6 +15,7 @@ struct CamMoeCombineNormalInfo {
     uint32_t realMaxBs;
     uint32_t perRoundTokens;
     uint32_t maxRound;
+    uint32_t commQuantMode;
     uint32_t bs;
     uint32_t k;
     uint32_t h;
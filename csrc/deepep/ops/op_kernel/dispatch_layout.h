@@ -9,6 +9,7 @@
 #include "sync_collectives.h"
 #include "moe_distribute_base.h"
 #include "dispatch_layout_tiling.h"
+#include "dispatch_layout_replica.h"
 namespace MoeDispatchLayout {
 
 constexpr uint32_t UB_32_ALIGN = 32U;
@@ -29,12 +30,16 @@ class DispatchLayout
 public:
     __aicore__ inline DispatchLayout(){};
 
-    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR numTokensPerRank, GM_ADDR numTokensPerExpert,
-                                GM_ADDR isTokenInRank, GM_ADDR notifySendData, GM_ADDR sendTokenIdxSmall,
-                                GM_ADDR workspace, TPipe *pipe, const DispatchLayoutTilingData *tilingData)
+    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR expertReplicaTable, GM_ADDR numTokensPerRank,
+                                GM_ADDR numTokensPerExpert, GM_ADDR isTokenInRank, GM_ADDR notifySendData,
+                                GM_ADDR sendTokenIdxSmall, GM_ADDR physicalTopkIdx, GM_ADDR workspace, TPipe *pipe,
+                                const DispatchLayoutTilingData *tilingData)
     {
+        replicaMap_.Init(expertReplicaTable, physicalTopkIdx, tilingData->dispatchLayoutInfo);
         numTokens_ = tilingData->dispatchLayoutInfo.numTokens;
         numRanks_ = tilingData->dispatchLayoutInfo.numRanks;
+        isTokenInRankBitmap_ = tilingData->dispatchLayoutInfo.isTokenInRankBitmap != 0;
+        isTokenInRankCols_ = isTokenInRankBitmap_ ? Ceil(numRanks_, IS_TOKEN_IN_RANK_BITS_PER_WORD) : numRanks_;
         numExperts_ = tilingData->dispatchLayoutInfo.numExperts;
         numTopk_ = tilingData->dispatchLayoutInfo.numTopk;
         perRoundTokens_ = tilingData->dispatchLayoutInfo.perRoundTokens;
@@ -51,7 +56,7 @@ public:
         topkIdx32AlignIntLen_ = Ceil(tempRoundTokens * numTopk_ * sizeof(int64_t), UB_32_ALIGN) * UB_32_ALIGN;
         numTokensPerRank32AlignIntLen_ = Ceil(numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
         numTokensPerExpert32AlignIntLen_ = Ceil(numExperts_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
-        isTokenInRank32AlignIntLen_ = Ceil(tempRoundTokens * numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
+        isTokenInRank32AlignIntLen_ = Ceil(tempRoundTokens * isTokenInRankCols_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
         sendTokenIdx32AlignIntLen_ = Ceil(tempTokens_ * numExperts_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
 
         tempExpertGM_.SetGlobalBuffer((__gm__ T *)notifySendData);
@@ -67,6 +72,9 @@ public:
         tpipe_->InitBuffer(isTokenInRankBuf_, isTokenInRank32AlignIntLen_);
         tpipe_->InitBuffer(seenRankBuf_, numRanks_ * sizeof(T));
         tpipe_->InitBuffer(sendTokenIdxSmallBuf_, topkIdx32AlignIntLen_);
+        if (replicaMap_.Enabled()) {
+            replicaMap_.Load(tpipe_);
+        }
 
         LocalTensor<int64_t> topkIdxTensor = topkIdxBuf_.AllocTensor<int64_t>();
         LocalTensor<T> numTokensPerRankTensor = numTokensPerRankBuf_.AllocTensor<T>();
@@ -97,14 +105,14 @@ public:
                 tempTokens_++;
             }
             topkIdx32AlignIntLen_ = Ceil(tempTokens_ * numTopk_ * sizeof(int64_t), UB_32_ALIGN) * UB_32_ALIGN;
-            isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
+            isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * isTokenInRankCols_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
 
             if (coreIdx_ < restNum) {
                 topkIdxOffset = coreIdx_ * tempTokens_ * numTopk_ * sizeof(int64_t);
-                isTokenOffset = coreIdx_ * tempTokens_ * numRanks_ * sizeof(T);
+                isTokenOffset = coreIdx_ * tempTokens_ * isTokenInRankCols_ * sizeof(T);
             } else {
                 topkIdxOffset = (restNum + coreIdx_ * tempTokens_) * numTopk_ * sizeof(int64_t);
-                isTokenOffset = (restNum + coreIdx_ * tempTokens_) * numRanks_ * sizeof(T);
+                isTokenOffset = (restNum + coreIdx_ * tempTokens_) * isTokenInRankCols_ * sizeof(T);
             }
 
             int64_t round_topkIdx_offset = r * perRoundTokens_ * numTopk_ * sizeof(int64_t);
@@ -116,17 +124,21 @@ public:
             numTokensPerExpertGM_.SetGlobalBuffer((__gm__ T *)numTokensPerExpert_ + numExperts_ * r);
             // tokens * rank;
             isTokenInRankGM_.SetGlobalBuffer(
-                (__gm__ T *)(isTokenInRank_ + r * perRoundTokens_ * numRanks_ * sizeof(T) + isTokenOffset));
+                (__gm__ T *)(isTokenInRank_ + r * perRoundTokens_ * isTokenInRankCols_ * sizeof(T) + isTokenOffset));
 
             const DataCopyExtParams dataCopyParams{1U, topkIdx32AlignIntLen_, 0U, 0U, 0U};
             const DataCopyPadExtParams<int64_t> padParams{false, 0U, 0U, 0U};
             SyncFunc<AscendC::HardEvent::S_MTE2>();
             DataCopyPad(topkIdxTensor, topkIdxGM_, dataCopyParams, padParams);
             SyncFunc<AscendC::HardEvent::MTE2_S>();
+            if (replicaMap_.Enabled()) {
+                uint32_t firstToken = r * perRoundTokens_ + topkIdxOffset / (numTopk_ * sizeof(int64_t));
+                replicaMap_.Map(topkIdxTensor, firstToken, tempTokens_);
+            }
 
             SyncFunc<AscendC::HardEvent::MTE3_V>();
             Duplicate<T>(numTokensPerRankTensor, 0, numRanks_);
-            Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * numRanks_);
+            Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * isTokenInRankCols_);
             Duplicate<T>(numTokensPerExpertTensor, 0, numTokensPerExpert32AlignIntLen_ / sizeof(T));
             SyncFunc<AscendC::HardEvent::V_S>();
             SyncFunc<AscendC::HardEvent::V_MTE3>();
@@ -147,14 +159,14 @@ public:
                     int rank_id = expert_idx / experts_per_rank;
                     if (!seenRankTensor.GetValue(rank_id)) {
                         uint32_t per_rank_num = numTokensPerRankTensor.GetValue(rank_id) + 1;
-                        isTokenInRankTensor.SetValue(i * numRanks_ + rank_id, 1);
+                        MarkTokenInRank(isTokenInRankTensor, i, rank_id);
                         seenRankTensor.SetValue(rank_id, 1);
                         numTokensPerRankTensor.SetValue(rank_id, per_rank_num);
                     }
                 }
             }
 
-            uint32_t sendSize = tempTokens_ * numRanks_ * sizeof(T);
+            uint32_t sendSize = tempTokens_ * isTokenInRankCols_ * sizeof(T);
             const DataCopyExtParams isTokenInRankDataCopyParams{1U, sendSize, 0U, 0U, 0U};
             SyncFunc<AscendC::HardEvent::S_MTE3>();
             DataCopyPad(isTokenInRankGM_, isTokenInRankTensor, isTokenInRankDataCopyParams);
@@ -194,6 +206,19 @@ public:
     }
 
 private:
+    // sets the flag of rank rankId for token tokenIdx, one T per rank or one bit per rank in bitmap mode
+    __aicore__ inline void MarkTokenInRank(LocalTensor<T> &isTokenInRankTensor, uint32_t tokenIdx, uint32_t rankId)
+    {
+        if (!isTokenInRankBitmap_) {
+            isTokenInRankTensor.SetValue(tokenIdx * numRanks_ + rankId, 1);
+            return;
+        }
+        uint32_t wordIdx = tokenIdx * isTokenInRankCols_ + rankId / IS_TOKEN_IN_RANK_BITS_PER_WORD;
+        uint32_t word = static_cast<uint32_t>(isTokenInRankTensor.GetValue(wordIdx));
+        word |= 1U << (rankId % IS_TOKEN_IN_RANK_BITS_PER_WORD);
+        isTokenInRankTensor.SetValue(wordIdx, static_cast<T>(word));
+    }
+
     GlobalTensor<int64_t> topkIdxGM_;
     GlobalTensor<T> numTokensPerRankGM_;
     GlobalTensor<T> numTokensPerExpertGM_;
@@ -207,10 +232,13 @@ private:
     TBuf<> isTokenInRankBuf_;
     TBuf<> seenRankBuf_;
     TBuf<> sendTokenIdxSmallBuf_;
+    MoeDispatchLayoutReplica::ExpertReplicaMap replicaMap_;
 
     TPipe *tpipe_{nullptr};
     uint32_t numTokens_{0};
     uint32_t numRanks_{0};
+    uint32_t isTokenInRankCols_{0};
+    bool isTokenInRankBitmap_{false};
     uint32_t numExperts_{0};
     uint32_t numTopk_{0};
     uint32_t coreIdx_{0};
@@ -9,6 +9,7 @@
 #include "sync_collectives.h"
 #include "moe_distribute_base.h"
 #include "dispatch_layout_tiling.h"
+#include "dispatch_layout_replica.h"
 
 namespace MoeDispatchLayoutA2 {
 
@@ -32,12 +33,16 @@ class DispatchLayoutA2
 public:
     __aicore__ inline DispatchLayoutA2(){};
 
-    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR numTokensPerRank, GM_ADDR numTokensPerExpert,
-                                GM_ADDR isTokenInRank, GM_ADDR notifySendData, GM_ADDR sendTokenIdxSmall,
-                                GM_ADDR workspace, TPipe *pipe, const DispatchLayoutTilingData *tilingData)
+    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR expertReplicaTable, GM_ADDR numTokensPerRank,
+                                GM_ADDR numTokensPerExpert, GM_ADDR isTokenInRank, GM_ADDR notifySendData,
+                                GM_ADDR sendTokenIdxSmall, GM_ADDR physicalTopkIdx, GM_ADDR workspace, TPipe *pipe,
+                                const DispatchLayoutTilingData *tilingData)
     {
+        replicaMap_.Init(expertReplicaTable, physicalTopkIdx, tilingData->dispatchLayoutInfo);
         numTokens_ = tilingData->dispatchLayoutInfo.numTokens;
         numRanks_ = tilingData->dispatchLayoutInfo.numRanks;
+        isTokenInRankBitmap_ = tilingData->dispatchLayoutInfo.isTokenInRankBitmap != 0;
+        isTokenInRankCols_ = isTokenInRankBitmap_ ? Ceil(numRanks_, IS_TOKEN_IN_RANK_BITS_PER_WORD) : numRanks_;
         numExperts_ = tilingData->dispatchLayoutInfo.numExperts;
         numTopk_ = tilingData->dispatchLayoutInfo.numTopk;
         localRankSize_ = tilingData->dispatchLayoutInfo.localRankSize;
@@ -63,7 +68,7 @@ public:
             topkIdx32AlignIntLen_ = Ceil(tempTokens_ * numTopk_ * sizeof(int64_t), UB_32_ALIGN) * UB_32_ALIGN;
             numTokensPerRank32AlignIntLen_ = Ceil(numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
             numTokensPerExpert32AlignIntLen_ = Ceil(numExperts_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
-            isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
+            isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * isTokenInRankCols_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
             localTokenServerUniqCount32AlignIntLen_ = Ceil(serverNum_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
             localTokenServerTotalCount32AlignIntLen_ =
                 Ceil(tempTokens_ * serverNum_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
@@ -75,17 +80,18 @@ public:
 
             if (coreIdx_ < restNum) {
                 topkIdxOffset = coreIdx_ * tempTokens_ * numTopk_ * sizeof(int64_t);
-                isTokenOffset = coreIdx_ * tempTokens_ * numRanks_ * sizeof(T);
+                isTokenOffset = coreIdx_ * tempTokens_ * isTokenInRankCols_ * sizeof(T);
                 serverOffsetOffset = coreIdx_ * tempTokens_ * serverNum_ * sizeof(T);
                 serverNumOffset = coreIdx_ * tempTokens_ * sizeof(T);
                 sendTokenIdxOffset = coreIdx_ * tempTokens_ * numExperts_ * sizeof(T);
             } else {
                 topkIdxOffset = (restNum + coreIdx_ * tempTokens_) * numTopk_ * sizeof(int64_t);
-                isTokenOffset = (restNum + coreIdx_ * tempTokens_) * numRanks_ * sizeof(T);
+                isTokenOffset = (restNum + coreIdx_ * tempTokens_) * isTokenInRankCols_ * sizeof(T);
                 serverOffsetOffset = (restNum + coreIdx_ * tempTokens_) * serverNum_ * sizeof(T);
                 serverNumOffset = (restNum + coreIdx_ * tempTokens_) * sizeof(T);
                 sendTokenIdxOffset = (restNum + coreIdx_ * tempTokens_) * numExperts_ * sizeof(T);
             }
+            firstToken_ = topkIdxOffset / (numTopk_ * sizeof(int64_t));
 
             topkIdxGM_.SetGlobalBuffer((__gm__ int64_t *)(topkIdx + topkIdxOffset));
             numTokensPerRankGM_.SetGlobalBuffer((__gm__ T *)numTokensPerRank);
@@ -143,6 +149,9 @@ private:
         tpipe_->InitBuffer(countExpertBuf_, numExperts_ * sizeof(T));
         tpipe_->InitBuffer(intermediateExpertBuf_, numExperts_ * sizeof(T));
         tpipe_->InitBuffer(intermediateServerBuf_, serverNum_ * sizeof(T));
+        if (replicaMap_.Enabled()) {
+            replicaMap_.Load(tpipe_);
+        }
 
         LocalTensor<int64_t> topkIdxTensor = topkIdxBuf_.AllocTensor<int64_t>();
         LocalTensor<T> sendTokenIdxSmallTensor = sendTokenIdxSmallBuf_.AllocTensor<T>();
@@ -170,7 +179,7 @@ private:
         Duplicate<T>(numTokensPerRankTensor, 0, numRanks_);
         Duplicate<T>(numTokensPerExpertTensor, 0, numTokensPerExpert32AlignIntLen_ / sizeof(T));
         Duplicate<T>(prefixCountPerExpertTensor, 0, numTokensPerExpert32AlignIntLen_ / sizeof(T));
-        Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * numRanks_);
+        Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * isTokenInRankCols_);
         Duplicate<T>(localTokenServerOffsetTensor, 0, localTokenServerOffset32AlignIntLen_ / sizeof(T));
         Duplicate<T>(sendTokenIdxTensor, 0, sendTokenIdx32AlignIntLen_ / sizeof(T));
         Duplicate<T>(tempServerTensor, 0, serverNum_);
@@ -182,6 +191,9 @@ private:
         Duplicate<T>(localTokenServerNumTensor, 0, tempTokens_);
         SyncFunc<AscendC::HardEvent::MTE2_S>();
         SyncFunc<AscendC::HardEvent::V_S>();
+        if (replicaMap_.Enabled()) {
+            replicaMap_.Map(topkIdxTensor, firstToken_, tempTokens_);
+        }
         int experts_per_rank = numExperts_ / numRanks_;
         for (int i = 0; i < tempTokens_; ++i) {
             SyncFunc<AscendC::HardEvent::S_V>();
@@ -207,14 +219,14 @@ private:
                 sendTokenIdxTensor.SetValue(i * numExperts_ + expert_idx, 1);
                 if (!seenRankTensor.GetValue(rank_id)) {
                     uint32_t per_rank_num = numTokensPerRankTensor.GetValue(rank_id) + 1;
-                    isTokenInRankTensor.SetValue(i * numRanks_ + rank_id, 1);
+                    MarkTokenInRank(isTokenInRankTensor, i, rank_id);
                     seenRankTensor.SetValue(rank_id, 1);
                     numTokensPerRankTensor.SetValue(rank_id, per_rank_num);
                 }
             }
         }
         SyncFunc<AscendC::HardEvent::S_MTE3>();
-        uint32_t sendSize = tempTokens_ * numRanks_ * sizeof(T);
+        uint32_t sendSize = tempTokens_ * isTokenInRankCols_ * sizeof(T);
         const DataCopyExtParams isTokenInRankDataCopyParams{1U, sendSize, 0U, 0U, 0U};
         DataCopyPad(isTokenInRankGM_, isTokenInRankTensor, isTokenInRankDataCopyParams);
         sendSize = tempTokens_ * sizeof(T);
@@ -326,6 +338,19 @@ private:
         }
     }
 
+    // sets the flag of rank rankId for token tokenIdx, one T per rank or one bit per rank in bitmap mode
+    __aicore__ inline void MarkTokenInRank(LocalTensor<T> &isTokenInRankTensor, uint32_t tokenIdx, uint32_t rankId)
+    {
+        if (!isTokenInRankBitmap_) {
+            isTokenInRankTensor.SetValue(tokenIdx * numRanks_ + rankId, 1);
+            return;
+        }
+        uint32_t wordIdx = tokenIdx * isTokenInRankCols_ + rankId / IS_TOKEN_IN_RANK_BITS_PER_WORD;
+        uint32_t word = static_cast<uint32_t>(isTokenInRankTensor.GetValue(wordIdx));
+        word |= 1U << (rankId % IS_TOKEN_IN_RANK_BITS_PER_WORD);
+        isTokenInRankTensor.SetValue(wordIdx, static_cast<T>(word));
+    }
+
     GlobalTensor<int64_t> topkIdxGM_;
     GlobalTensor<T> numTokensPerRankGM_;
     GlobalTensor<T> numTokensPerExpertGM_;
@@ -343,6 +368,7 @@ private:
 
     TBuf<> topkIdxBuf_;
     TBuf<> sendTokenIdxSmallBuf_;
+    MoeDispatchLayoutReplica::ExpertReplicaMap replicaMap_;
     TBuf<> numTokensPerRankBuf_;
     TBuf<> numTokensPerExpertBuf_;
     TBuf<> prefixCountPerExpertBuf_;
@@ -365,6 +391,8 @@ private:
     TPipe *tpipe_{nullptr};
     uint32_t numTokens_{0};
     uint32_t numRanks_{0};
+    uint32_t isTokenInRankCols_{0};
+    bool isTokenInRankBitmap_{false};
     uint32_t numExperts_{0};
     uint32_t numTopk_{0};
     uint32_t localRankSize_{0};
@@ -372,6 +400,7 @@ private:
     uint32_t coreIdx_{0};
     uint32_t aivNum_{0};
     uint32_t tempTokens_{0};
+    uint32_t firstToken_{0};
     uint32_t rank_{0};
 
     uint32_t topkIdx32AlignIntLen_{0};
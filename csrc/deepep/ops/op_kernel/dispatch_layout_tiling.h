@@ -3,6 +3,9 @@
 
 #include "kernel_tiling/kernel_tiling.h"
 
+// ranks packed into one int32 word of isTokenInRank when isTokenInRankBitmap is set
+constexpr uint32_t IS_TOKEN_IN_RANK_BITS_PER_WORD = 32;
+
 struct DispatchLayoutInfo {
     uint32_t numTokens;
     uint32_t numRanks;
@@ -10,6 +13,9 @@ struct DispatchLayoutInfo {
     uint32_t numTopk;
     uint32_t localRankSize;
     uint32_t perRoundTokens;
+    uint32_t isTokenInRankBitmap;
+    uint32_t numLogicalExperts;  // rows of the expert replica table, 0 when topk_idx already holds physical ids
+    uint32_t replicaTableCols;   // replica count plus the max replicas of one logical expert
     uint64_t totalUbSize;
 };
 
@@ -29,6 +29,7 @@ struct FusedDeepMoeInfo {
     uint64_t totalUbSize;
     uint64_t totalWinSize;
     uint64_t gmm1HLen;
+    bool isEnableDiagnose;  // whether record the wait cost per peer rank in combine or not
 };
 
 struct FusedDeepMoeTilingData {
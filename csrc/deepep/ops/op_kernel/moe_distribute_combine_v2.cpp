@@ -11,14 +11,14 @@ __aicore__ inline void ExecMoeDistributeCombineV2(GM_ADDR expandX, GM_ADDR exper
                                                   GM_ADDR epSendCount, GM_ADDR tpSendCount, GM_ADDR scales,
                                                   GM_ADDR xActiveMask, GM_ADDR sharedExpertX, GM_ADDR elasticInfo,
                                                   GM_ADDR oriX, GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2,
-                                                  GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM,
-                                                  GM_ADDR tilingGM, TPipe *pipePtr)
+                                                  GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut,
+                                                  GM_ADDR workspaceGM, GM_ADDR tilingGM, TPipe *pipePtr)
 {
     GET_TILING_DATA_WITH_STRUCT(MoeDistributeCombineV2TilingData, tilingData, tilingGM);
     MoeDistributeCombineV2<TemplateMC2TypeFunc> op;
     op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, workspaceGM, pipePtr,
-            &tilingData);
+            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM,
+            pipePtr, &tilingData);
     op.Process();
 }
 }  // namespace
@@ -39,7 +39,8 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR assistInfoForCombine, GM_ADDR epSendCount, GM_ADDR scales,
     GM_ADDR tpSendCount, GM_ADDR xActiveMask, GM_ADDR activationScale, GM_ADDR weightScale, GM_ADDR groupList,
     GM_ADDR expandScales, GM_ADDR sharedExpertX, GM_ADDR elasticInfo, GM_ADDR oriX, GM_ADDR constExpertAlpha1,
-    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM, GM_ADDR tilingGM)
+    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM,
+    GM_ADDR tilingGM)
 
 {
     REGISTER_TILING_DEFAULT(MoeDistributeCombineV2TilingData);
@@ -49,22 +50,26 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
     if (TILING_KEY_IS(10100)) {  // tp=2 IsInt8Quant=0
         ExecMoeDistributeCombineV2<DTYPE_EXPAND_X, DTYPE_X, int32_t, true, false>(
             expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, workspaceGM, tilingGM, &pipe);
+            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM,
+            tilingGM, &pipe);
     }
     if (TILING_KEY_IS(10000)) {  // tp=1 IsInt8Quant=0
         ExecMoeDistributeCombineV2<DTYPE_EXPAND_X, DTYPE_X, int32_t, false, false>(
             expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, workspaceGM, tilingGM, &pipe);
+            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM,
+            tilingGM, &pipe);
     }
     if (TILING_KEY_IS(10120)) {  // tp=2 IsInt8Quant=1
         ExecMoeDistributeCombineV2<DTYPE_EXPAND_X, DTYPE_X, int32_t, true, true>(
             expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, workspaceGM, tilingGM, &pipe);
+            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM,
+            tilingGM, &pipe);
     }
     if (TILING_KEY_IS(10020)) {  // tp=1 IsInt8Quant=1
         ExecMoeDistributeCombineV2<DTYPE_EXPAND_X, DTYPE_X, int32_t, false, true>(
             expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, workspaceGM, tilingGM, &pipe);
+            elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM,
+            tilingGM, &pipe);
     }
 #endif
 }
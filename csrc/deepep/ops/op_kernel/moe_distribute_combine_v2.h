@@ -51,8 +51,8 @@ public:
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount,
                                 GM_ADDR tpSendCount, GM_ADDR expertScales, GM_ADDR xActiveMask, GM_ADDR sharedExpertX,
                                 GM_ADDR elasticInfo, GM_ADDR oriX, GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2,
-                                GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe,
-                                const MoeDistributeCombineV2TilingData *tilingData);
+                                GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM,
+                                TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData);
     __aicore__ inline void Process();
 
 private:
@@ -60,7 +60,7 @@ private:
                                               GM_ADDR epSendCount, GM_ADDR expertScales, GM_ADDR xActiveMask,
                                               GM_ADDR sharedExpertX, GM_ADDR elasticInfo, GM_ADDR oriX,
                                               GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2,
-                                              GM_ADDR constExpertV, GM_ADDR XOut);
+                                              GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut);
     __aicore__ inline void InitAttrs(const MoeDistributeCombineV2TilingData *tilingData);
     __aicore__ inline void InitTilingAttrs(const MoeDistributeCombineV2TilingData *tilingData);
     __aicore__ inline void InitElasticInfo(uint32_t &sharedExpertRankNum);
@@ -145,6 +145,7 @@ private:
     GlobalTensor<ExpandXType> constExpertAlpha2GM_;
     GlobalTensor<ExpandXType> constExpertVGM_;
     GlobalTensor<uint32_t> selfDataStatusGMTensor_;
+    GlobalTensor<int32_t> sendCostStatsGT_;
 
     GM_ADDR epWindowGM_;
     GM_ADDR tpWindowGM_;
@@ -236,6 +237,7 @@ private:
     TBuf<> stateResetBuf_;
     TBuf<> expertMaskBuf_;
     TBuf<> elasticInfoBuf_;
+    TBuf<> sendCostStatsBuf_;
     bool isInputTokenMaskFlag_ = false;
     bool isInputExpertMaskFlag_ = false;
     bool hasSharedExpertX_ = false;
@@ -243,6 +245,7 @@ private:
     bool isScalingDownFlag_ = false;
     bool isShareExpertRankFlag_ = false;
     bool enableSpecialExpert_ = false;
+    bool isEnableDiagnose_ = false;
 
     // int8量化
     TBuf<> xAbsBuf_;
@@ -332,7 +335,7 @@ template <TemplateMC2TypeClass>
 __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::InitInputAndOutput(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount, GM_ADDR expertScales,
     GM_ADDR xActiveMask, GM_ADDR sharedExpertX, GM_ADDR elasticInfo, GM_ADDR oriX, GM_ADDR constExpertAlpha1,
-    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut)
+    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut)
 {
     expandXGM_.SetGlobalBuffer((__gm__ ExpandXType *)expandX);
     expertIdsGM_.SetGlobalBuffer((__gm__ ExpandIdxType *)expertIds);
@@ -348,6 +351,9 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::InitInputAnd
     constExpertVGM_.SetGlobalBuffer((__gm__ ExpandXType *)constExpertV);
 
     expandOutGlobal_.SetGlobalBuffer((__gm__ XType *)XOut);
+    if (sendCostStatsOut != nullptr) {
+        sendCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)sendCostStatsOut);
+    }
 }
 
 template <TemplateMC2TypeClass>
@@ -391,6 +397,7 @@ MoeDistributeCombineV2<TemplateMC2TypeFunc>::InitTilingAttrs(const MoeDistribute
     constExpertNum_ = tilingData->moeDistributeCombineV2Info.constExpertNum;
     moeExpertNum_ = tilingData->moeDistributeCombineV2Info.moeExpertNum;
     enableSpecialExpert_ = (constExpertNum_ + zeroExpertNum_ + copyExpertNum_ > 0U);
+    isEnableDiagnose_ = tilingData->moeDistributeCombineV2Info.isEnableDiagnose;
 }
 
 template <TemplateMC2TypeClass>
@@ -445,8 +452,8 @@ template <TemplateMC2TypeClass>
 __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::Init(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount, GM_ADDR tpSendCount,
     GM_ADDR expertScales, GM_ADDR xActiveMask, GM_ADDR sharedExpertX, GM_ADDR elasticInfo, GM_ADDR oriX,
-    GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM,
-    TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData)
+    GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut,
+    GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData)
 {
     tpipe_ = pipe;
 
@@ -455,7 +462,8 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::Init(
     maskCalcWorkspaceGM_ = workspaceGM + coreIdx_ * MASK_CALC_NEED_WORKSPACE;
 
     InitInputAndOutput(expandX, expertIds, expandIdx, epSendCount, expertScales, xActiveMask, sharedExpertX,
-                       elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut);
+                       elasticInfo, oriX, constExpertAlpha1, constExpertAlpha2, constExpertV, XOut,
+                       sendCostStatsOut);
     InitAttrs(tilingData);
 
     // 检查hcclwinsize是否越界
@@ -841,6 +849,14 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::ExpertAlltoA
     DataCopyPad(expandIdxLocal, expandIdxGM_[startTokenId_ * EXPAND_IDX_INFO], bskParams, copyPadParams);
     LocalTensor<float> statusTensor = readStateBuf_.AllocTensor<float>();
     Duplicate<float>(statusTensor, (float)1, FLOAT_PER_UB_ALIGN);
+    LocalTensor<int32_t> sendCostStatsTensor;
+    uint32_t sendCostStatsBufSize = Ceil(epWorldSizeOriginal_ * sizeof(int32_t), UB_ALIGN) * UB_ALIGN;
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(sendCostStatsBuf_, sendCostStatsBufSize);
+        sendCostStatsTensor = sendCostStatsBuf_.Get<int32_t>();
+        Duplicate<int32_t>(sendCostStatsTensor, 0, sendCostStatsBufSize / sizeof(int32_t));
+        SyncFunc<AscendC::HardEvent::V_S>();
+    }
 
     SyncFunc<AscendC::HardEvent::MTE2_S>();
     for (uint32_t loop = 0; loop < sendCntNum_; loop++) {
@@ -853,6 +869,7 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::ExpertAlltoA
         if (isScalingDownFlag_) {
             toRankId = elasticInfoTensor_.GetValue(ELASTIC_INFO_OFFSET + epWorldSizeOriginal_ + rankIdExpandIdx);
         }
+        int64_t sendStartCycle = GetSystemCycle();
         ExpertAlltoAllDispatchInnerCopyAdd(toRankId, tokenId, topkId, tkIndex);
         PipeBarrier<PIPE_MTE3>();
         GM_ADDR stateGM = GetWinStateAddrByRankId(toRankId, EP_DOMAIN) + tokenId * flagRcvCount_ * stateOffset_ +
@@ -860,6 +877,22 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeFunc>::ExpertAlltoA
         GlobalTensor<float> stateGMTensor;
         stateGMTensor.SetGlobalBuffer((__gm__ float *)stateGM);
         DataCopy<float>(stateGMTensor, statusTensor, FLOAT_PER_UB_ALIGN);  // 8是数据大小，按32对齐拷贝
+
+        if (isEnableDiagnose_) {
+            SyncFunc<AscendC::HardEvent::MTE3_S>();
+            int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - sendStartCycle) / CYCLES_PER_US);  // us
+            int32_t preTime = sendCostStatsTensor.GetValue(rankIdExpandIdx);
+            sendCostStatsTensor.SetValue(rankIdExpandIdx, preTime + durationTime);
+        }
+    }
+
+    if (isEnableDiagnose_) {
+        SyncFunc<AscendC::HardEvent::S_MTE3>();
+        AscendC::SetAtomicAdd<int32_t>();
+        DataCopyExtParams statsCopyOutParams = {1U, static_cast<uint32_t>(epWorldSizeOriginal_ * sizeof(int32_t)), 0U,
+                                                0U, 0U};
+        DataCopyPad<int32_t>(sendCostStatsGT_, sendCostStatsTensor, statsCopyOutParams);
+        AscendC::SetAtomicNone();
     }
 }
 
@@ -25,7 +25,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
                                                                  GM_ADDR expandXOut, GM_ADDR dynamicScalesOut,
                                                                  GM_ADDR assistInfoOut, GM_ADDR expertTokenNumsOut,
                                                                  GM_ADDR epSendCountsOut, GM_ADDR tpSendCountsOut,
-                                                                 GM_ADDR workspaceGM, GM_ADDR tilingGM)
+                                                                 GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM,
+                                                                 GM_ADDR tilingGM)
 {
     REGISTER_TILING_DEFAULT(MoeDistributeDispatchV2TilingData);
     TPipe pipe;
@@ -34,7 +35,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, false, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -42,7 +44,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, false, false, true> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -51,7 +54,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, true, false, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -59,7 +63,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -67,7 +72,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, true, false> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -75,7 +81,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, true, false, false, true> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -83,7 +90,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, false, true> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
@@ -91,7 +99,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, true, true> op;
         op.Init(x, expertIds, scales, xActiveMask, elasticInfo, expandXOut, dynamicScalesOut, assistInfoOut,
-                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, &tilingData);
+                expertTokenNumsOut, epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe,
+                &tilingData);
         op.Process();
         return;
     }
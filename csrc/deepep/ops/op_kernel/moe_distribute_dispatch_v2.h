@@ -53,7 +53,8 @@ public:
     __aicore__ inline void Init(GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR elasticInfo,
                                 GM_ADDR expandXOut, GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut,
                                 GM_ADDR expertTokenNumsOut, GM_ADDR sendCountsOut, GM_ADDR tpSendCountsOut,
-                                GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeDispatchV2TilingData *tilingData);
+                                GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+                                const MoeDistributeDispatchV2TilingData *tilingData);
     __aicore__ inline void Process();
 
 private:
@@ -64,6 +65,9 @@ private:
     __aicore__ inline void TokenActiveMaskCal();
     __aicore__ inline void ExpertActiveMaskCal();
     __aicore__ inline void TimeOutDetection();
+    __aicore__ inline uint32_t GetStatusSrcRank(uint32_t statusIndex);
+    __aicore__ inline void RecordWaitCost(int64_t systemCycleStart);
+    __aicore__ inline void CopyOutWaitCost();
     __aicore__ inline void WaitDispatchClearStatus();
     __aicore__ inline void CalValidBSCnt(LocalTensor<bool> maskStrideTensor);
     __aicore__ inline void CalValidExpIdx(LocalTensor<bool> maskInputTensor);
@@ -138,6 +142,7 @@ private:
     GlobalTensor<int32_t> elasticInfoGMTensor_;
     GlobalTensor<uint32_t> selfDataStatusGMTensor_;
     GlobalTensor<uint32_t> selfhcclDataStatusTensor_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
 
     LocalTensor<ExpandXOutType> xTmpTensor_;
     LocalTensor<int32_t> tpTmpTensor_;
@@ -157,6 +162,7 @@ private:
     LocalTensor<int32_t> validBsIndexTensor_;
     LocalTensor<int32_t> elasticInfoTensor_;
     LocalTensor<uint32_t> dataStateLocalTensor_;
+    LocalTensor<int32_t> waitCostTensor_;
 
     TBuf<> expertIdsBuf_;
     TBuf<> statusBuf_;
@@ -177,6 +183,7 @@ private:
     TBuf<> validBsIndexTBuf_;
     TBuf<> elasticInfoBuf_;
     TBuf<> gatherMaskTBuf_;
+    TBuf<> waitCostBuf_;
     TQueBind<QuePosition::VECIN, QuePosition::VECOUT, 1> xQueue_;  // 非量化使用，量化场景接收也可使用
     TQue<QuePosition::VECIN, 1> xInQueue_;                         // 量化使用，量化前的输入
     TQue<QuePosition::VECOUT, 1> xOutQueue_;                       // 量化使用，量化后的输出
@@ -242,6 +249,8 @@ private:
     bool hasElasticInfoFlag_ = false;
     bool isScalingDownFlag_ = false;
     bool isShareExpertRankFlag_ = false;
+    bool isEnableDiagnose_ = false;
+    bool isRoundScale_ = false;
     float sumTarget_;
     uint64_t totalWinSize_{0};
     uint32_t gatherCount_{0};
@@ -295,7 +304,8 @@ template <TemplateMC2TypeClass>
 __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::Init(
     GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR elasticInfo, GM_ADDR expandXOut,
     GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut, GM_ADDR sendCountsOut,
-    GM_ADDR tpSendCountsOut, GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeDispatchV2TilingData *tilingData)
+    GM_ADDR tpSendCountsOut, GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+    const MoeDistributeDispatchV2TilingData *tilingData)
 {
     tpipe_ = pipe;
     aivId_ = GetBlockIdx();
@@ -347,6 +357,7 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::Init(
     tpRankId_ = tilingData->moeDistributeDispatchV2Info.tpRankId;
     tpGatherRankId_ = ((tpRankId_ == 0) ? 1 : 0);
     isTokenMaskFlag_ = tilingData->moeDistributeDispatchV2Info.isTokenMask;
+    isRoundScale_ = tilingData->moeDistributeDispatchV2Info.isRoundScale;
     isExpertMaskFlag_ = tilingData->moeDistributeDispatchV2Info.isExpertMask;
     axisK_ = tilingData->moeDistributeDispatchV2Info.k;
     aivNum_ = tilingData->moeDistributeDispatchV2Info.aivNum;
@@ -361,6 +372,10 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::Init(
     sendCountsOutGM_ = sendCountsOut;  // 无GlobalTensor
     sendTpCountOutGM_ = tpSendCountsOut;
     recvCntWorkspaceGM_ = workspaceGM;
+    isEnableDiagnose_ = tilingData->moeDistributeDispatchV2Info.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStatsOut);
+    }
 
     hOutSize_ = axisH_ * sizeof(ExpandXOutType);
     hOutSizeAlign_ = Ceil(hOutSize_, UB_ALIGN) * UB_ALIGN;  // scale起始放置偏移
@@ -1022,6 +1037,9 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::QuantProces
 
         SyncFunc<AscendC::HardEvent::V_S>();
         dynamicScale = float(127.0) / floatLocalAbsTemp.GetValue(0);
+        if (isRoundScale_) {
+            dynamicScale = RoundDownToPow2(dynamicScale);
+        }
         SyncFunc<AscendC::HardEvent::S_V>();
         Muls(floatLocalTemp, floatLocalTemp, dynamicScale, axisH_);
         PipeBarrier<PIPE_V>();
@@ -1104,6 +1122,9 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::BufferInit(
     tpipe_->InitBuffer(sumContinueBuf_, aivNum_ * sizeof(float));  // 48 * 4B
     tpipe_->InitBuffer(scalarBuf_, UB_ALIGN * 3);                  // 96B
     tpipe_->InitBuffer(xQueue_, BUFFER_NUM, hOutAlignUbSize_);     // 7k*2 + 32 + 12
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(waitCostBuf_, waitStatusBufSize);  // 与状态位一一对应，每个32B
+    }
 }
 
 template <TemplateMC2TypeClass>
@@ -1112,11 +1133,7 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::TimeOutDete
     uint32_t toRankId;
     GlobalTensor<float> timeoutCheckGMTensor;
     for (uint32_t index = startStatusIndex_; index < startStatusIndex_ + recStatusNumPerCore_; index++) {
-        if (isScalingDownFlag_) {
-            toRankId = elasticInfoTensor_.GetValue(ELASTIC_INFO_OFFSET + epWorldSizeOriginal_ + index % epWorldSize_);
-        } else {
-            toRankId = index % epWorldSize_;
-        }
+        toRankId = GetStatusSrcRank(index);
         GM_ADDR timeoutCheckGM =
             (__gm__ uint8_t *)(GetWindStateAddrByRankId(COMM_EP_IDX, toRankId) + STATE_CHECK_OFFSET);
         timeoutCheckGMTensor.SetGlobalBuffer((__gm__ float *)(timeoutCheckGM));
@@ -1124,6 +1141,44 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::TimeOutDete
     }
 }
 
+template <TemplateMC2TypeClass>
+__aicore__ inline uint32_t MoeDistributeDispatchV2<TemplateMC2TypeFunc>::GetStatusSrcRank(uint32_t statusIndex)
+{
+    if (isScalingDownFlag_) {
+        return elasticInfoTensor_.GetValue(ELASTIC_INFO_OFFSET + epWorldSizeOriginal_ + statusIndex % epWorldSize_);
+    }
+    return statusIndex % epWorldSize_;
+}
+
+// Keeps the wait time of every status of this core the first time it is seen set
+template <TemplateMC2TypeClass>
+__aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::RecordWaitCost(int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLES_PER_US);  // us
+    for (uint32_t i = 0; i < recStatusNumPerCore_; i++) {
+        uint32_t offset = i * UB_ALIGN / sizeof(int32_t);
+        if (waitCostTensor_.GetValue(offset) < 0 && statusFp32Tensor_.GetValue(offset) == sumTarget_) {
+            waitCostTensor_.SetValue(offset, durationTime);
+        }
+    }
+    SyncFunc<AscendC::HardEvent::S_MTE2>();  // 下一轮读状态会覆盖statusFp32Tensor_
+}
+
+// Adds the wait time of every status to the slot of its source rank, several cores can add to the same slot
+template <TemplateMC2TypeClass>
+__aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::CopyOutWaitCost()
+{
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    for (uint32_t i = 0; i < recStatusNumPerCore_; i++) {
+        DataCopyPad<int32_t>(waitRecvCostStatsGT_[GetStatusSrcRank(startStatusIndex_ + i)],
+                             waitCostTensor_[i * UB_ALIGN / sizeof(int32_t)], costCopyOutParams);
+    }
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeClass>
 __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::WaitDispatchClearStatus()
 {
@@ -1162,6 +1217,11 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::WaitDispatc
     if (isScalingDownFlag_) {
         InitElasticInfo(true);
     }
+    if (isEnableDiagnose_) {
+        waitCostTensor_ = waitCostBuf_.Get<int32_t>();
+        Duplicate<int32_t>(waitCostTensor_, -1, recStatusNumPerCore_ * UB_ALIGN / sizeof(int32_t));
+        SyncFunc<AscendC::HardEvent::V_S>();
+    }
     uint64_t timeoutCheckStart = static_cast<uint64_t>(GetSystemCycle());
     uint64_t timeoutCheckEnd, timeoutCheckDuration;
     SyncFunc<AscendC::HardEvent::S_V>();
@@ -1172,12 +1232,18 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeFunc>::WaitDispatc
         ReduceSum(statusSumOutTensor, statusFp32Tensor_, gatherMaskOutTensor, mask, recStatusNumPerCore_, 1);
         SyncFunc<AscendC::HardEvent::V_S>();
         sumOfFlag = statusSumOutTensor.GetValue(0);
+        if (isEnableDiagnose_) {
+            RecordWaitCost(static_cast<int64_t>(timeoutCheckStart));
+        }
         timeoutCheckEnd = static_cast<uint64_t>(GetSystemCycle());
         timeoutCheckDuration = (timeoutCheckEnd - timeoutCheckStart) / CYCLES_PER_US;
         if (timeoutCheckDuration > TIMEOUT_DETECTION_THRESHOLD) {
             TimeOutDetection();
         }
     }
+    if (isEnableDiagnose_) {
+        CopyOutWaitCost();
+    }
     // 清状态
     WaitDispatchClearStatus();
 
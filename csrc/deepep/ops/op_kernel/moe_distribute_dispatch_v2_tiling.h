@@ -19,7 +19,8 @@ struct MoeDistributeDispatchV2Info {
     bool isTokenMask;              // input active mask 1dims or not
     bool isExpertMask;             // input active mask 2dims or not
     bool hasElasticInfo;           // has elasticinfo or not
-    bool reserved3;                // reserved
+    bool isEnableDiagnose;         // whether record the wait cost per source rank or not
+    bool isRoundScale;             // round dynamic quant scales up to powers of two
     uint64_t totalUbSize;          // epWorldSize
     uint64_t totalWinSize;
     uint32_t expertTokenNumsType;  // expert token nums type, support 0: cumsum mode, 1: count mode
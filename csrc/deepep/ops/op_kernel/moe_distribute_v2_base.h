@@ -58,5 +58,17 @@ __aicore__ inline uint32_t InitWinState(GlobalTensor<uint32_t> selfDataStatusGMT
     }
     return dataState;
 }
+
+// Rounds a positive quant multiplier down to a power of two by clearing its mantissa, so that the dequant scale
+// 1 / multiplier is a power of two (representable as UE8M0) and the quantized values still fit in [-127, 127].
+__aicore__ inline float RoundDownToPow2(float multiplier)
+{
+    union {
+        float f;
+        uint32_t u;
+    } bits = {multiplier};
+    bits.u &= 0xFF800000U;
+    return bits.f;
+}
 }  // namespace MoeDistributeV2Base
 #endif  // MOE_DISTRIBUTE_V2_BASE_H
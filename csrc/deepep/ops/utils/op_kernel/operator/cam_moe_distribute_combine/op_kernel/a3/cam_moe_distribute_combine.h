@@ -30,6 +30,7 @@ constexpr uint64_t WIN_STATE_OFFSET = 512 * 1024;
 constexpr uint64_t STATE_WIN_OFFSET = 900 * 1024;
 constexpr uint16_t SEND_SYNC_EVENT_ID = 9;
 constexpr uint16_t RECV_SYNC_EVENT_ID = 10;
+constexpr int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
 template <AscendC::HardEvent event>
 __aicore__ inline void SyncFunc()
@@ -61,8 +62,8 @@ class CamMoeDistributeCombine
 public:
     __aicore__ inline CamMoeDistributeCombine(){};
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount,
-                                GM_ADDR tpSendCount, GM_ADDR scales, GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe,
-                                const FusedDeepMoeTilingData *tilingData);
+                                GM_ADDR tpSendCount, GM_ADDR scales, GM_ADDR XOut, GM_ADDR waitRecvCostStats,
+                                GM_ADDR workspaceGM, TPipe *pipe, const FusedDeepMoeTilingData *tilingData);
     __aicore__ inline void Process();
     __aicore__ inline void AllToAllSend();
     __aicore__ inline void ReducePermute();
@@ -92,6 +93,8 @@ private:
     __aicore__ inline void SplitCoreCal();
     __aicore__ inline void SetStatus();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void RecordWaitCost(int64_t systemCycleStart, LocalTensor<float> &statusTensor);
+    __aicore__ inline void CopyOutWaitCost();
     __aicore__ GM_ADDR GetWinAddrByRankId(const int32_t rankId, const uint8_t domain, const uint8_t expertLocalId = 0U)
     {
         if (domain == EP_DOMAIN) {
@@ -151,6 +154,7 @@ private:
     GlobalTensor<float> tpStatusSpaceGlobalTensor_;
     GlobalTensor<ExpandXType> tpRankWindow_;
     GlobalTensor<ExpandXType> rowTmpGlobal_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
     GM_ADDR workspaceGM_;
     GM_ADDR epWindowGM_;
     GM_ADDR epStatusSpaceGm_;
@@ -164,6 +168,7 @@ private:
     LocalTensor<float> winTpSendCountFloatTensor_;
     LocalTensor<float> gmTpSendCountFloatTensor_;
     LocalTensor<ExpandIdxType> epSendCountLocal_;
+    LocalTensor<int32_t> waitCostTensor_;
 
     CombineCalcInfo calcInfo_;
     uint32_t axisBS_{0};
@@ -223,15 +228,17 @@ private:
     TBuf<> gatherMaskOutBuf_;  // gather mask output buf
     TBuf<> gatherTmpBuf_;
     TBuf<> statusSumOutBuf_;
+    TBuf<> waitCostBuf_;
     float sumTarget_{0.0};
     int32_t epStateValue_;
     bool isShardExpert_{false};
+    bool isEnableDiagnose_{false};
 };
 
 template <TemplateMC2TypeClass>
 __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::Init(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount, GM_ADDR tpSendCount, GM_ADDR scales,
-    GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe, const FusedDeepMoeTilingData *tilingData)
+    GM_ADDR XOut, GM_ADDR waitRecvCostStats, GM_ADDR workspaceGM, TPipe *pipe, const FusedDeepMoeTilingData *tilingData)
 {
     tpipe_ = pipe;
     coreIdx_ = GetBlockIdx();
@@ -282,6 +289,10 @@ __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::Init(
     tpWorldSize_ = 1;
     tpRankId_ = 0;
     totalWinSize_ = tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.totalWinSize;
+    isEnableDiagnose_ = tilingData->disGmmDeqSwigluQuantGmmDeqComInfo.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStats);
+    }
     stateOffset_ = (moeSendNum_ > 512) ? (STATE_OFFSET / 2) : STATE_OFFSET;
     expertPerSizeOnWin_ =
         static_cast<uint64_t>(axisMaxBs_) * static_cast<uint64_t>(axisH_) * static_cast<uint64_t>(sizeof(ExpandXType));
@@ -394,6 +405,9 @@ __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::AlltoAllBuf
     tpipe_->InitBuffer(gatherMaskOutBuf_, epWorldSize_ * sizeof(float));
     tpipe_->InitBuffer(gatherTmpBuf_, sizeof(uint32_t));  // 4
     tpipe_->InitBuffer(statusSumOutBuf_, sizeof(float));  // 4
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(waitCostBuf_, sendRankNum_ * UB_ALIGN);  // 与状态位一一对应，每个32B
+    }
 }
 
 template <TemplateMC2TypeClass>
@@ -622,6 +636,12 @@ __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::WaitDispatc
         float minTarget = (sumTarget_ * sendRankNum_) - (float)0.5;
         float maxTarget = (sumTarget_ * sendRankNum_) + (float)0.5;
         SumParams sumParams{1, sendRankNum_, sendRankNum_};
+        if (isEnableDiagnose_) {
+            waitCostTensor_ = waitCostBuf_.Get<int32_t>();
+            Duplicate<int32_t>(waitCostTensor_, -1, sendRankNum_ * UB_ALIGN / sizeof(int32_t));
+            SyncFunc<AscendC::HardEvent::V_S>();
+        }
+        int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
         SyncFunc<AscendC::HardEvent::S_V>();
         while ((sumOfFlag < minTarget) || (sumOfFlag > maxTarget)) {
             DataCopy<float>(statusTensor, epStatusSpaceGlobalTensor_[startRankId_ * stateOffset_ / sizeof(float)],
@@ -633,6 +653,12 @@ __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::WaitDispatc
             Sum(statusSumOutTensor, gatherMaskOutTensor, sumParams);
             SyncFunc<AscendC::HardEvent::V_S>();
             sumOfFlag = statusSumOutTensor.GetValue(0);
+            if (isEnableDiagnose_) {
+                RecordWaitCost(systemCycleStart, statusTensor);
+            }
+        }
+        if (isEnableDiagnose_) {
+            CopyOutWaitCost();
         }
     }
 
@@ -644,6 +670,36 @@ __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::WaitDispatc
     }
 }
 
+// Keeps the wait time of every rank of this core the first time its status is seen set
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::RecordWaitCost(int64_t systemCycleStart,
+                                                                                    LocalTensor<float> &statusTensor)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    for (uint32_t i = 0; i < sendRankNum_; i++) {
+        uint32_t offset = i * UB_ALIGN / sizeof(int32_t);
+        if (waitCostTensor_.GetValue(offset) < 0 && statusTensor.GetValue(offset) == sumTarget_) {
+            waitCostTensor_.SetValue(offset, durationTime);
+        }
+    }
+    SyncFunc<AscendC::HardEvent::S_MTE2>();  // 下一轮读状态会覆盖statusTensor
+}
+
+// Adds the wait time of every rank of this core to its slot of the stats
+template <TemplateMC2TypeClass>
+__aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::CopyOutWaitCost()
+{
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    for (uint32_t i = 0; i < sendRankNum_; i++) {
+        DataCopyPad<int32_t>(waitRecvCostStatsGT_[startRankId_ + i], waitCostTensor_[i * UB_ALIGN / sizeof(int32_t)],
+                             costCopyOutParams);
+    }
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeClass>
 __aicore__ inline void CamMoeDistributeCombine<TemplateMC2TypeFunc>::LocalWindowCopy()
 {
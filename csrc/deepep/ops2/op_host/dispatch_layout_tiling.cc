@@ -29,11 +29,13 @@
 using namespace ge;
 namespace {
 constexpr uint32_t INPUT_TOPK_IDX_INDEX = 0;
+constexpr uint32_t INPUT_EXPERT_REPLICA_TABLE_INDEX = 1;
 
 constexpr uint32_t OUTPUT_NUM_TOKEN_PER_RANK_INDEX = 0;
 constexpr uint32_t OUTPUT_NUM_TOKEN_PER_EXPERT_INDEX = 1;
 constexpr uint32_t OUTPUT_IS_TOKEN_IN_RANK_INDEX = 2;
 constexpr uint32_t OUTPUT_NOTIFY_SEND_DATA_INDEX = 3;
+constexpr uint32_t OUTPUT_PHYSICAL_TOPK_IDX_INDEX = 5;
 
 constexpr uint32_t ATTR_NUM_TOKENS_INDEX = 0;
 constexpr uint32_t ATTR_NUM_RANKS_INDEX = 1;
@@ -41,9 +43,12 @@ constexpr uint32_t ATTR_NUM_EXPERTS_INDEX = 2;
 constexpr uint32_t ATTR_NUM_TOPK_INDEX = 3;
 constexpr uint32_t ATTR_LOCAL_RANKSIZE_INDEX = 4;
 constexpr uint32_t ATTR_PER_ROUND_TOKENS_INDEX = 5;
+constexpr uint32_t ATTR_IS_TOKEN_IN_RANK_BITMAP_INDEX = 6;
 const int64_t MAX_COMM_WORLD_SIZE = 384;
 const int64_t MAX_MOE_EXPERTS_NUM = 512;
 const int64_t MAX_LOCAL_RANKSIZE = 8;
+// the replica table is kept in UB for the whole kernel
+const int64_t MAX_EXPERT_REPLICAS = 8;
 
 constexpr uint32_t SYSTEM_NEED_WORKSPACE = 16 * 1024 * 1024;
 constexpr uint32_t KERNEL_USE_WORKSPACE = 1 * 1024 * 1024;
@@ -65,6 +70,9 @@ static void PrintTilingDataInfo(const char *nodeName, DispatchLayoutTilingData &
     OP_LOGD(nodeName, "numTopk is %u.", tilingData.dispatchLayoutInfo.numTopk);
     OP_LOGD(nodeName, "localRankSize is %u.", tilingData.dispatchLayoutInfo.localRankSize);
     OP_LOGD(nodeName, "perRoundTokens is %u.", tilingData.dispatchLayoutInfo.perRoundTokens);
+    OP_LOGD(nodeName, "isTokenInRankBitmap is %u.", tilingData.dispatchLayoutInfo.isTokenInRankBitmap);
+    OP_LOGD(nodeName, "numLogicalExperts is %u.", tilingData.dispatchLayoutInfo.numLogicalExperts);
+    OP_LOGD(nodeName, "replicaTableCols is %u.", tilingData.dispatchLayoutInfo.replicaTableCols);
     OP_LOGD(nodeName, "totalUbSize is %lu.", tilingData.dispatchLayoutInfo.totalUbSize);
 }
 
@@ -97,6 +105,8 @@ static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, con
     auto numTopkPtr = attrs->GetAttrPointer<int64_t>(static_cast<int>(ATTR_NUM_TOPK_INDEX));
     auto localRankSizePtr = attrs->GetAttrPointer<int64_t>(static_cast<int>(ATTR_LOCAL_RANKSIZE_INDEX));
     auto perRoundTokensPtr = attrs->GetAttrPointer<int64_t>(static_cast<int>(ATTR_PER_ROUND_TOKENS_INDEX));
+    auto isTokenInRankBitmapPtr =
+        attrs->GetAttrPointer<int64_t>(static_cast<int>(ATTR_IS_TOKEN_IN_RANK_BITMAP_INDEX));
 
     OP_TILING_CHECK(numTokensPtr == nullptr, OP_LOGE(nodeName, "numTokensPtr is null."), return ge::GRAPH_FAILED);
     OP_TILING_CHECK(numRanksPtr == nullptr, OP_LOGE(nodeName, "numRanksPtr is null."), return ge::GRAPH_FAILED);
@@ -106,6 +116,12 @@ static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, con
                     return ge::GRAPH_FAILED);
     OP_TILING_CHECK(perRoundTokensPtr == nullptr, OP_LOGE(nodeName, "perRoundTokensPtr is null."),
                     return ge::GRAPH_FAILED);
+    OP_TILING_CHECK(isTokenInRankBitmapPtr == nullptr, OP_LOGE(nodeName, "isTokenInRankBitmapPtr is null."),
+                    return ge::GRAPH_FAILED);
+    OP_TILING_CHECK((*isTokenInRankBitmapPtr != 0) && (*isTokenInRankBitmapPtr != 1),
+                    OP_LOGE(nodeName, "isTokenInRankBitmap is invalid, only support 0 or 1, but got %ld.",
+                            *isTokenInRankBitmapPtr),
+                    return ge::GRAPH_FAILED);
 
     OP_TILING_CHECK((*numRanksPtr <= 0) || (*numRanksPtr > MAX_COMM_WORLD_SIZE),
                     OP_LOGE(nodeName, "rankSize is invalid, only support (0, %ld], but got rankSize=%ld.",
@@ -130,6 +146,7 @@ static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, con
     tilingData.dispatchLayoutInfo.numTopk = static_cast<uint32_t>(*numTopkPtr);
     tilingData.dispatchLayoutInfo.localRankSize = static_cast<uint32_t>(*localRankSizePtr);
     tilingData.dispatchLayoutInfo.perRoundTokens = static_cast<uint32_t>(*perRoundTokensPtr);
+    tilingData.dispatchLayoutInfo.isTokenInRankBitmap = static_cast<uint32_t>(*isTokenInRankBitmapPtr);
 
     if (CheckIfA2MultiMachine(context, tilingData)) {
         OP_TILING_CHECK(
@@ -216,6 +233,57 @@ static ge::graphStatus TilingCheckTensor(gert::TilingContext *context, const cha
     return ge::GRAPH_SUCCESS;
 }
 
+// expertReplicaTable is [numLogicalExperts, 1 + maxReplicas], without it topkIdx already holds physical expert ids
+static ge::graphStatus SetExpertReplicaInfo(gert::TilingContext *context, const char *nodeName,
+                                            DispatchLayoutTilingData &tilingData)
+{
+    tilingData.dispatchLayoutInfo.numLogicalExperts = 0;
+    tilingData.dispatchLayoutInfo.replicaTableCols = 0;
+    const gert::StorageShape *tableStorageShape = context->GetOptionalInputShape(INPUT_EXPERT_REPLICA_TABLE_INDEX);
+    if (tableStorageShape == nullptr) {
+        return ge::GRAPH_SUCCESS;
+    }
+    auto tableDesc = context->GetOptionalInputDesc(INPUT_EXPERT_REPLICA_TABLE_INDEX);
+    OP_TILING_CHECK(tableDesc == nullptr, OP_LOGE(nodeName, "expertReplicaTable desc is null."),
+                    return ge::GRAPH_FAILED);
+    OP_TILING_CHECK((tableDesc->GetDataType() != ge::DT_INT32),
+                    OP_LOGE(nodeName, "expertReplicaTable datatype is invalid, datatype should be int, but is %d.",
+                            static_cast<ge::DataType>(tableDesc->GetDataType())),
+                    return ge::GRAPH_FAILED);
+    const gert::Shape &tableShape = tableStorageShape->GetStorageShape();
+    OP_TILING_CHECK((tableShape.GetDimNum() != TWO_DIMS),
+                    OP_LOGE(nodeName, "expertReplicaTable must be 2-dimension, but get %lu dim.",
+                            tableShape.GetDimNum()),
+                    return ge::GRAPH_FAILED);
+    int64_t numLogicalExperts = tableShape.GetDim(0);
+    int64_t tableCols = tableShape.GetDim(1);
+    OP_TILING_CHECK((numLogicalExperts <= 0) || (numLogicalExperts > MAX_MOE_EXPERTS_NUM),
+                    OP_LOGE(nodeName, "numLogicalExperts is invalid, only support (0, %ld], but got %ld.",
+                            MAX_MOE_EXPERTS_NUM, numLogicalExperts),
+                    return ge::GRAPH_FAILED);
+    OP_TILING_CHECK((tableCols < 2) || (tableCols > MAX_EXPERT_REPLICAS + 1),
+                    OP_LOGE(nodeName, "expertReplicaTable cols is invalid, only support [2, %ld], but got %ld.",
+                            MAX_EXPERT_REPLICAS + 1, tableCols),
+                    return ge::GRAPH_FAILED);
+
+    const gert::StorageShape *physicalStorageShape = context->GetOutputShape(OUTPUT_PHYSICAL_TOPK_IDX_INDEX);
+    auto physicalDesc = context->GetOutputDesc(OUTPUT_PHYSICAL_TOPK_IDX_INDEX);
+    OP_TILING_CHECK((physicalStorageShape == nullptr) || (physicalDesc == nullptr),
+                    OP_LOGE(nodeName, "physicalTopkIdx is required with expertReplicaTable."),
+                    return ge::GRAPH_FAILED);
+    OP_TILING_CHECK((physicalDesc->GetDataType() != ge::DT_INT64),
+                    OP_LOGE(nodeName, "physicalTopkIdx datatype is invalid, datatype should be int64, but is %d.",
+                            static_cast<ge::DataType>(physicalDesc->GetDataType())),
+                    return ge::GRAPH_FAILED);
+    OP_TILING_CHECK((physicalStorageShape->GetStorageShape() !=
+                     context->GetInputShape(INPUT_TOPK_IDX_INDEX)->GetStorageShape()),
+                    OP_LOGE(nodeName, "physicalTopkIdx must have the shape of topkIdx."), return ge::GRAPH_FAILED);
+
+    tilingData.dispatchLayoutInfo.numLogicalExperts = static_cast<uint32_t>(numLogicalExperts);
+    tilingData.dispatchLayoutInfo.replicaTableCols = static_cast<uint32_t>(tableCols);
+    return ge::GRAPH_SUCCESS;
+}
+
 static ge::graphStatus DispatchLayoutTilingFuncImpl(gert::TilingContext *context)
 {
     const char *nodeName = context->GetNodeName();
@@ -229,6 +297,9 @@ static ge::graphStatus DispatchLayoutTilingFuncImpl(gert::TilingContext *context
     OP_TILING_CHECK(TilingCheckTensor(context, nodeName) != ge::GRAPH_SUCCESS,
                     OP_LOGE(nodeName, "Tiling check param failed."), return ge::GRAPH_FAILED);
 
+    OP_TILING_CHECK(SetExpertReplicaInfo(context, nodeName, *tilingData) != ge::GRAPH_SUCCESS,
+                    OP_LOGE(nodeName, "Tiling set expert replica info failed."), return ge::GRAPH_FAILED);
+
     OP_TILING_CHECK(SetWorkSpace(context, nodeName) != ge::GRAPH_SUCCESS,
                     OP_LOGE(nodeName, "Tiling set workspace failed."), return ge::GRAPH_FAILED);
 
@@ -69,6 +69,7 @@ constexpr uint32_t OUTPUT_EXPAND_IDX_INDEX = 2;
 constexpr uint32_t OUTPUT_EXPERT_TOKEN_NUMS_INDEX = 3;
 constexpr uint32_t OUTPUT_EP_RECV_COUNTS_INDEX = 4;
 constexpr uint32_t OUTPUT_TP_RECV_COUNTS_INDEX = 5;
+constexpr uint32_t OUTPUT_WAIT_RECV_COST_INDEX = 6;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -1084,6 +1085,7 @@ static ge::graphStatus MoeDistributeDispatchA2TilingFuncImpl(gert::TilingContext
     OP_LOGI(nodeName, "MoeDistributeDispatchA2 get tilingData.");
     CamMoeDistributeDispatchA2Info &info = tilingData->moeDistributeDispatchInfo;
     OP_LOGI(nodeName, "MoeDistributeDispatchA2 get tilingData info.");
+    info.isEnableDiagnose = (context.GetOutputShape(OUTPUT_WAIT_RECV_COST_INDEX) != nullptr);
 
     OP_TILING_CHECK(
         MoeDistributeDispatchA2CheckShapeAndSetTiling(context, info) != ge::GRAPH_SUCCESS,
@@ -40,6 +40,7 @@ constexpr uint32_t EXPERT_SCALES_INDEX = 4;
 constexpr uint32_t TP_SEND_COUNTS_INDEX = 5;
 constexpr uint32_t X_ACTIVE_MASK_INDEX = 6;
 constexpr uint32_t OUTPUT_X_INDEX = 0;
+constexpr uint32_t OUTPUT_SEND_COST_INDEX = 1;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -245,6 +246,7 @@ static ge::graphStatus MoeDistributeCombineA2TilingFuncImpl(gert::TilingContext
               return ge::GRAPH_FAILED);
     OPS_LOG_I(nodeName, "MoeDistributeCombineA2 get tilingData.");
     MoeDistributeCombineA2Info &info = tilingData->moeDistributeCombineInfo;
+    info.isEnableDiagnose = (context->GetOutputShape(OUTPUT_SEND_COST_INDEX) != nullptr);
 
     bool isLayered = MoeDistributeCombineA2IsLayered();
     OPS_CHECK(
@@ -69,6 +69,7 @@ constexpr uint32_t CONST_EXPERT_ALPHA_1_INDEX = 14;
 constexpr uint32_t CONST_EXPERT_ALPHA_2_INDEX = 15;
 constexpr uint32_t CONST_EXPERT_V_INDEX = 16;
 constexpr uint32_t OUTPUT_X_INDEX = 0;
+constexpr uint32_t OUTPUT_SEND_COST_INDEX = 1;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -781,6 +782,8 @@ static bool CheckTensorShape(const gert::TilingContext *context, MoeDistributeCo
     // 校验sharedExpertX的维度
     const gert::StorageShape *sharedExpertXShape = context->GetOptionalInputShape(SHARED_EXPERT_X_INDEX);
     tilingData.moeDistributeCombineV2Info.hasSharedExpertX = (sharedExpertXShape != nullptr);
+    tilingData.moeDistributeCombineV2Info.isEnableDiagnose =
+        (context->GetOutputShape(OUTPUT_SEND_COST_INDEX) != nullptr);
     if (sharedExpertXShape != nullptr) {
         int64_t sharedExpertXDim0 = sharedExpertXShape->GetStorageShape().GetDim(0);
         int64_t sharedExpertXDim1 = sharedExpertXShape->GetStorageShape().GetDim(1);
@@ -887,6 +890,8 @@ static void PrintTilingDataInfo(const char *nodeName, MoeDistributeCombineV2Tili
     OP_LOGD(nodeName, "aivNum is %u.", tilingData.moeDistributeCombineV2Info.aivNum);
     OP_LOGD(nodeName, "totalUbSize is %lu.", tilingData.moeDistributeCombineV2Info.totalUbSize);
     OP_LOGD(nodeName, "totalWinSize is %lu.", tilingData.moeDistributeCombineV2Info.totalWinSize);
+    OP_LOGD(nodeName, "isEnableDiagnose is %d.",
+            static_cast<int32_t>(tilingData.moeDistributeCombineV2Info.isEnableDiagnose));
 }
 
 static ge::graphStatus MoeDistributeCombineA2SingleTilingFuncImpl(gert::TilingContext *context)
@@ -1255,6 +1260,7 @@ static ge::graphStatus MoeDistributeCombineA2CheckShapeAndSetTiling(gert::Tiling
 
     info.isTokenMask = ((isActiveMask) && (xActiveMaskStorageShape->GetStorageShape().GetDimNum() == ONE_DIM));
     info.isExpertMask = ((isActiveMask) && (xActiveMaskStorageShape->GetStorageShape().GetDimNum() == TWO_DIMS));
+    info.isEnableDiagnose = (context->GetOutputShape(OUTPUT_SEND_COST_INDEX) != nullptr);
     info.bs = bs;
     info.k = k;
     info.h = h;
@@ -1264,6 +1270,7 @@ static ge::graphStatus MoeDistributeCombineA2CheckShapeAndSetTiling(gert::Tiling
     OP_LOGD(K_INNER_DEBUG, "hiddenSize is %u", h);
     OP_LOGD(K_INNER_DEBUG, "isTokenMask is %d", static_cast<int32_t>(info.isTokenMask));
     OP_LOGD(K_INNER_DEBUG, "isExpertMask is %d", static_cast<int32_t>(info.isExpertMask));
+    OP_LOGD(K_INNER_DEBUG, "isEnableDiagnose is %d", static_cast<int32_t>(info.isEnableDiagnose));
 
     return ge::GRAPH_SUCCESS;
 }
@@ -61,6 +61,7 @@ constexpr uint32_t OUTPUT_ASSIST_INFO_INDEX = 2U;
 constexpr uint32_t OUTPUT_EXPERT_TOKEN_NUMS_INDEX = 3U;
 constexpr uint32_t OUTPUT_EP_RECV_COUNTS_INDEX = 4U;
 constexpr uint32_t OUTPUT_TP_RECV_COUNTS_INDEX = 5U;
+constexpr uint32_t OUTPUT_WAIT_RECV_COST_INDEX = 6U;
 
 constexpr uint32_t ATTR_GROUP_EP_INDEX = 0;
 constexpr uint32_t ATTR_EP_WORLD_SIZE_INDEX = 1;
@@ -96,6 +97,7 @@ constexpr uint32_t OP_TYPE_ALL_GATHER = 6;
 constexpr uint32_t UNQUANT_MODE = 0;
 constexpr uint32_t STATIC_QUANT_MODE = 1;
 constexpr uint32_t DYNAMIC_QUANT_MODE = 2;
+constexpr uint32_t DYNAMIC_POW2_QUANT_MODE = 3;  // dynamic quant whose scales are rounded up to powers of two
 constexpr size_t MAX_GROUP_NAME_LENGTH = 128UL;
 constexpr int64_t MAX_SHARED_EXPERT_NUM = 4;
 constexpr int64_t MAX_EP_WORLD_SIZE = 768L;  // 384 * 2
@@ -255,8 +257,9 @@ static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, con
                             MOE_EXPERT_MAX_NUM, moeExpertNum),
                     return ge::GRAPH_FAILED);
     OP_TILING_CHECK(
-        (*quantModePtr < static_cast<int64_t>(NO_SCALES)) || (*quantModePtr > static_cast<int64_t>(DYNAMIC_SCALES)),
-        OP_LOGE(nodeName, "quantMode is invalid, only support [0, %u], but got quantMode=%ld.", DYNAMIC_SCALES,
+        (*quantModePtr < static_cast<int64_t>(NO_SCALES)) ||
+            (*quantModePtr > static_cast<int64_t>(DYNAMIC_POW2_QUANT_MODE)),
+        OP_LOGE(nodeName, "quantMode is invalid, only support [0, %u], but got quantMode=%ld.", DYNAMIC_POW2_QUANT_MODE,
                 *quantModePtr),
         return ge::GRAPH_FAILED);
     OP_TILING_CHECK((*expertTokenNumsTypePtr != 0) && (*expertTokenNumsTypePtr != 1),
@@ -278,8 +281,12 @@ static ge::graphStatus GetAttrAndSetTilingData(gert::TilingContext *context, con
         }
     }
     tilingData.moeDistributeDispatchV2Info.moeExpertNum = static_cast<uint32_t>(moeExpertNum);
-    tilingData.moeDistributeDispatchV2Info.quantMode = static_cast<uint32_t>(*quantModePtr);
+    tilingData.moeDistributeDispatchV2Info.isRoundScale = (*quantModePtr == DYNAMIC_POW2_QUANT_MODE);
+    tilingData.moeDistributeDispatchV2Info.quantMode =
+        tilingData.moeDistributeDispatchV2Info.isRoundScale ? DYNAMIC_SCALES : static_cast<uint32_t>(*quantModePtr);
     tilingData.moeDistributeDispatchV2Info.expertTokenNumsType = static_cast<uint32_t>(*expertTokenNumsTypePtr);
+    tilingData.moeDistributeDispatchV2Info.isEnableDiagnose =
+        (context->GetOutputShape(OUTPUT_WAIT_RECV_COST_INDEX) != nullptr);
 
     return ge::GRAPH_SUCCESS;
 }
@@ -889,6 +896,9 @@ static void PrintTilingDataInfo(const char *nodeName, MoeDistributeDispatchV2Til
     OP_LOGD(nodeName, "sharedExpertRankNum is %u.", tilingData.moeDistributeDispatchV2Info.sharedExpertRankNum);
     OP_LOGD(nodeName, "moeExpertNum is %u.", tilingData.moeDistributeDispatchV2Info.moeExpertNum);
     OP_LOGD(nodeName, "quantMode is %u.", tilingData.moeDistributeDispatchV2Info.quantMode);
+    OP_LOGD(nodeName, "isRoundScale is %d.", static_cast<int32_t>(tilingData.moeDistributeDispatchV2Info.isRoundScale));
+    OP_LOGD(nodeName, "isEnableDiagnose is %d.",
+            static_cast<int32_t>(tilingData.moeDistributeDispatchV2Info.isEnableDiagnose));
     OP_LOGD(nodeName, "globalBs is %u.", tilingData.moeDistributeDispatchV2Info.globalBs);
     OP_LOGD(nodeName, "bs is %u.", tilingData.moeDistributeDispatchV2Info.bs);
     OP_LOGD(nodeName, "k is %u.", tilingData.moeDistributeDispatchV2Info.k);
@@ -1053,7 +1063,8 @@ static ge::graphStatus MoeDistributeDispatchA2CheckAttrAndSetTiling(gert::Tiling
                     return GRAPH_FAILED);
     OP_TILING_CHECK(sharedExpertRankNumPtr == nullptr, OP_LOGE(K_INNER_DEBUG, "sharedExpertRankNum is null."),
                     return GRAPH_FAILED);
-    OP_TILING_CHECK(quantModePtr == nullptr || (*quantModePtr != UNQUANT_MODE && *quantModePtr != DYNAMIC_QUANT_MODE),
+    OP_TILING_CHECK(quantModePtr == nullptr || (*quantModePtr != UNQUANT_MODE && *quantModePtr != DYNAMIC_QUANT_MODE &&
+                                                *quantModePtr != DYNAMIC_POW2_QUANT_MODE),
                     OP_LOGE(K_INNER_DEBUG, "quantMode is invalid."), return GRAPH_FAILED);
     OP_TILING_CHECK(globalBsPtr == nullptr, OP_LOGE(K_INNER_DEBUG, "globalBs is null."), return GRAPH_FAILED);
     OP_TILING_CHECK(expertTokenNumsTypePtr == nullptr || *expertTokenNumsTypePtr < 0 || *expertTokenNumsTypePtr > 1,
@@ -1088,7 +1099,8 @@ static ge::graphStatus MoeDistributeDispatchA2CheckAttrAndSetTiling(gert::Tiling
     info.expertSharedType = static_cast<uint32_t>(0);
     info.sharedExpertRankNum = static_cast<uint32_t>(0);
     info.moeExpertNum = *moeExpertNumPtr;
-    info.quantMode = *quantModePtr;
+    info.isRoundScale = (*quantModePtr == DYNAMIC_POW2_QUANT_MODE);
+    info.quantMode = info.isRoundScale ? DYNAMIC_QUANT_MODE : *quantModePtr;
     if (*globalBsPtr == 0) {
         info.globalBs = *epWorldSizePtr * bs;
     } else {
@@ -1096,7 +1108,10 @@ static ge::graphStatus MoeDistributeDispatchA2CheckAttrAndSetTiling(gert::Tiling
     }
     info.expertTokenNumsType = *expertTokenNumsTypePtr;
     info.zeroComputeExpertNum = static_cast<int32_t>(zeroComputeExpertNum);
+    info.isEnableDiagnose = (context->GetOutputShape(OUTPUT_WAIT_RECV_COST_INDEX) != nullptr);
     OP_LOGD(K_INNER_DEBUG, "quantMode=%d", info.quantMode);
+    OP_LOGD(K_INNER_DEBUG, "isRoundScale=%d", static_cast<int32_t>(info.isRoundScale));
+    OP_LOGD(K_INNER_DEBUG, "isEnableDiagnose=%d", static_cast<int32_t>(info.isEnableDiagnose));
     OP_LOGD(K_INNER_DEBUG, "globalBs=%d", info.globalBs);
     OP_LOGD(K_INNER_DEBUG, "expertTokenNumsType=%d", info.expertTokenNumsType);
     OP_LOGD(K_INNER_DEBUG, "expertSharedType=%d", info.expertSharedType);
@@ -1252,16 +1267,16 @@ static ge::graphStatus MoeDistributeDispatchA2CheckCommAlg(gert::TilingContext *
     }
 }
 
-static uint64_t MoeDistributeDispatchA2CalcTilingKey(gert::TilingContext *context, const bool isLayered)
+static uint64_t MoeDistributeDispatchA2CalcTilingKey(gert::TilingContext *context,
+                                                     const MoeDistributeDispatchV2Info &info, const bool isLayered)
 {
     uint64_t tilingKey = TILING_KEY_BASE_A2 + INIT_TILINGKEY_A2;
     if (isLayered) {
         tilingKey += TILING_KEY_LAYERED_COMM_A2;
     }
 
-    auto attrs = context->GetAttrs();
-    auto quantModePtr = attrs->GetAttrPointer<int>(ATTR_QUANT_MODE_INDEX);
-    tilingKey += static_cast<uint64_t>(*quantModePtr);
+    // power-of-two scales share the dynamic quant kernels, they only differ in tiling data
+    tilingKey += static_cast<uint64_t>(info.quantMode);
 
     const gert::StorageShape *scalesStorageShape = context->GetOptionalInputShape(SCALES_INDEX);
     bool isScales = (scalesStorageShape != nullptr);
@@ -1321,7 +1336,7 @@ static ge::graphStatus MoeDistributeDispatchA2TilingFuncImpl(gert::TilingContext
     context->SetBlockDim(blockDim);
     context->SetAicpuBlockDim(mc2tiling::AICPU_BLOCK_DIM_A2);
 
-    uint64_t tilingKey = MoeDistributeDispatchA2CalcTilingKey(context, isLayered);
+    uint64_t tilingKey = MoeDistributeDispatchA2CalcTilingKey(context, info, isLayered);
     context->SetTilingKey(tilingKey);
     // 2. workspace
     size_t *workSpaces = context->GetWorkspaceSizes(1);
@@ -21,6 +21,7 @@ extern "C" {
  * tpRankId : optional
  * moeExpertNum : optional
  * globalBs : optional
+ * commQuantMode : optional, 0 for no quant, 2 for int8 per-token quant
  * out : required
  * workspaceSize : size of workspace(output).
  * executor : executor context(output).
@@ -29,8 +30,8 @@ __attribute__((visibility("default"))) aclnnStatus aclnnCamMoeCombineNormalGetWo
     const aclTensor *recvX, const aclTensor *tokenSrcInfo, const aclTensor *epRecvCounts,
     const aclTensor *recvTopkWeights, const aclTensor *tpRecvCountsOptional, char *epGroupName, int64_t epWorldSize,
     int64_t epRankId, char *tpGroupNameOptional, int64_t tpWorldSize, int64_t tpRankId, int64_t moeExpertNum,
-    int64_t realMaxBs, int32_t round, int32_t per_round_tokens, const aclTensor *out, const aclTensor *sendCostStats,
-    uint64_t *workspaceSize, aclOpExecutor **executor);
+    int64_t realMaxBs, int32_t round, int32_t per_round_tokens, int64_t commQuantMode, const aclTensor *out,
+    const aclTensor *sendCostStats, uint64_t *workspaceSize, aclOpExecutor **executor);
 
 /* function: aclnnMoeCombine
  * workspace : workspace memory addr(input).
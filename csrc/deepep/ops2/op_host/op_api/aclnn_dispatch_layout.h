@@ -9,24 +9,30 @@ extern "C" {
 
 /* function: aclnnDispatchLayoutGetWorkspaceSize
  * topkIdx : required
+ * expertReplicaTable : optional, [numLogicalExperts, 1 + maxReplicas] int32, the replica count of each logical
+ *     expert followed by its physical expert ids, topkIdx then holds logical ids
  * numTokens : required
  * numRanks : required
  * numExperts : required
  * numTopk : required
  * localRankSize : required
  * perRoundTokens : required
+ * isTokenInRankBitmap : optional, 1 packs isTokenInRank as [numTokens, ceil(numRanks / 32)] int32 bit words
  * numTokensPerRank : required
  * numTokensPerExpert : required
  * isTokenInRank : required
  * notifySendData : required
+ * sendTokenIdxSmall : required
+ * physicalTopkIdx : optional, required with expertReplicaTable, topkIdx mapped to physical expert ids
  * workspaceSize : size of workspace(output).
  * executor : executor context(output).
  */
 __attribute__((visibility("default"))) aclnnStatus aclnnDispatchLayoutGetWorkspaceSize(
-    const aclTensor *topkIdx, int64_t numTokens, int64_t numRanks, int64_t numExperts, int64_t numTopk,
-    int64_t localRankSize, int32_t perRoundTokens, const aclTensor *numTokensPerRank,
-    const aclTensor *numTokensPerExpert, const aclTensor *isTokenInRank, const aclTensor *notifySendData,
-    const aclTensor *sendTokenIdxSmall, uint64_t *workspaceSize, aclOpExecutor **executor);
+    const aclTensor *topkIdx, const aclTensor *expertReplicaTable, int64_t numTokens, int64_t numRanks,
+    int64_t numExperts, int64_t numTopk, int64_t localRankSize, int32_t perRoundTokens, int64_t isTokenInRankBitmap,
+    const aclTensor *numTokensPerRank, const aclTensor *numTokensPerExpert, const aclTensor *isTokenInRank,
+    const aclTensor *notifySendData, const aclTensor *sendTokenIdxSmall, const aclTensor *physicalTopkIdx,
+    uint64_t *workspaceSize, aclOpExecutor **executor);
 
 /* function: aclnnDispatchLayout
  * workspace : workspace memory addr(input).
@@ -60,6 +60,8 @@ extern "C" {
  * @param [in] groupListType: 计算可选输入，int。groupList格式。预留参数，暂未使用，传0即可。
  * @param [in] commAlg: 计算可选输入，str。 通信算法类型。预留参数，暂未使用。
  * @param [out] xOut: 计算输出，Tensor，必选输出，数据类型支持float16, bfloat16，仅支持2维，数据格式支持ND。
+ * @param [out] sendCostStatsOut:
+ 计算输出，Tensor，可选输出，数据类型int32，仅支持1维，shape为(epWorldSize,)，数据格式支持ND。累加本卡等待各对端卡数据的耗时（单机场景为向各对端卡发送数据的耗时），单位us，传空时不统计。
  * @param [out] workspaceSize: 出参，返回需要在npu device侧申请的workspace大小。
  * @param [out] executor: 出参，返回op执行器，包含了算子计算流程。
  * @return aclnnStatus: 返回值，返回状态码
@@ -73,7 +75,7 @@ __attribute__((visibility("default"))) aclnnStatus aclnnMoeDistributeCombineV2Ge
     const aclTensor *sharedExpertXOptional, char *groupEp, int64_t epWorldSize, int64_t epRankId, int64_t moeExpertNum,
     char *groupTp, int64_t tpWorldSize, int64_t tpRankId, int64_t expertShardType, int64_t sharedExpertNum,
     int64_t sharedExpertRankNum, int64_t globalBs, int64_t outDtype, int64_t commQuantMode, int64_t groupListType,
-    char *commAlg, aclTensor *xOut, uint64_t *workspaceSize, aclOpExecutor **executor);
+    char *commAlg, aclTensor *xOut, aclTensor *sendCostStatsOut, uint64_t *workspaceSize, aclOpExecutor **executor);
 
 /**
  * @brief aclnnMoeDistributeCombine的第二段接口，用于执行计算。
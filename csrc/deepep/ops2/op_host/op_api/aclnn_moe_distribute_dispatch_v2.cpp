@@ -39,14 +39,14 @@ aclnnStatus aclnnMoeDistributeDispatchV2GetWorkspaceSize(
     char *groupTp, int64_t tpWorldSize, int64_t tpRankId, int64_t expertShardType, int64_t sharedExpertNum,
     int64_t sharedExpertRankNum, int64_t quantMode, int64_t globalBs, int64_t expertTokenNumsType, char *commAlg,
     aclTensor *expandXOut, aclTensor *dynamicScalesOut, aclTensor *assistInfoForCombineOut,
-    aclTensor *expertTokenNumsOut, aclTensor *epRecvCountsOut, aclTensor *tpRecvCountsOut, uint64_t *workspaceSize,
-    aclOpExecutor **executor)
+    aclTensor *expertTokenNumsOut, aclTensor *epRecvCountsOut, aclTensor *tpRecvCountsOut,
+    aclTensor *waitRecvCostStatsOut, uint64_t *workspaceSize, aclOpExecutor **executor)
 {
     return aclnnInnerMoeDistributeDispatchV2GetWorkspaceSize(
         x, expertIds, scalesOptional, xActiveMaskOptional, nullptr, groupEp, epWorldSize, epRankId, moeExpertNum, "",
         tpWorldSize, tpRankId, expertShardType, sharedExpertNum, sharedExpertRankNum, quantMode, globalBs,
         expertTokenNumsType, commAlg, 0, 0, 0, expandXOut, dynamicScalesOut, assistInfoForCombineOut,
-        expertTokenNumsOut, epRecvCountsOut, tpRecvCountsOut, workspaceSize, executor);
+        expertTokenNumsOut, epRecvCountsOut, tpRecvCountsOut, waitRecvCostStatsOut, workspaceSize, executor);
 }
 
 aclnnStatus aclnnMoeDistributeDispatchV2(void *workspace, uint64_t workspaceSize, aclOpExecutor *executor,
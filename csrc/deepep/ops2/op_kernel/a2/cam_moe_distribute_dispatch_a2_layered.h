@@ -37,6 +37,7 @@ constexpr uint32_t BITS32_PER_BLOCK = 8U;
 constexpr static uint32_t BW_ITEM_SIZE = 32;
 constexpr uint32_t FLAG_VALUE = 0xFFFFFFFF;
 constexpr uint32_t BS_UPPER = 4096;
+constexpr int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
 #define TemplateMC2TypeA2layeredClass \
     typename XType, typename ExpandXOutType, bool StaticQuant, bool DynamicQuant, bool IsSmoothScaleExist
@@ -63,8 +64,8 @@ public:
                                 GM_ADDR tokenServerIdx, GM_ADDR tokenServerCnt, GM_ADDR epRankTokenCnt,
                                 GM_ADDR srcOffsetRankTokenIdx, GM_ADDR dstOffsetRankTokenIdx, GM_ADDR expandXOut,
                                 GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut,
-                                GM_ADDR epRecvCountsOut, GM_ADDR expandScales, GM_ADDR workspaceGM, TPipe *pipe,
-                                GM_ADDR tilingGM);
+                                GM_ADDR epRecvCountsOut, GM_ADDR expandScales, GM_ADDR waitRecvCostStatsOut,
+                                GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM);
     __aicore__ inline void Process();
     template <AscendC::HardEvent event>
     __aicore__ inline void SyncFunc()
@@ -86,6 +87,7 @@ private:
     __aicore__ inline void DispatchBetweenServer();
     __aicore__ inline void ConstructDataAndFlagBatchWriteInfo();
     __aicore__ inline void WaitIpcFlag(uint64_t flagVal = 1ULL);
+    __aicore__ inline void RecordWaitCost(uint32_t srcRankId, int64_t systemCycleStart);
     __aicore__ inline void SetIpcFlag(uint64_t flagVal = 1ULL);
     __aicore__ inline void WriteRdmaCntInfo();
     __aicore__ inline void CleanUp();
@@ -112,6 +114,7 @@ private:
     GlobalTensor<int32_t> epRankTokenCntGMTensor_;
     GlobalTensor<int32_t> srcOffsetRankTokenIdxGMTensor_;
     GlobalTensor<int32_t> dstOffsetRankTokenIdxGMTensor_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
 
     LocalTensor<int32_t> expertCountTensor_;
     LocalTensor<uint64_t> batchWriteU64Tensor_;
@@ -170,6 +173,7 @@ private:
     uint32_t serverNum{0};
     uint32_t expertTokenNumsType_{0};
     uint32_t shareMemOffset_{0};
+    bool isEnableDiagnose_{false};
     // TokenStruck相关
     uint32_t tokenGapInStruct_{0};
     uint32_t infoGapInStruct_{0};
@@ -199,7 +203,7 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
     GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR expertScales, GM_ADDR tokenServerIdx, GM_ADDR tokenServerCnt,
     GM_ADDR epRankTokenCnt, GM_ADDR srcOffsetRankTokenIdx, GM_ADDR dstOffsetRankTokenIdx, GM_ADDR expandXOut,
     GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut, GM_ADDR epRecvCountsOut,
-    GM_ADDR expandScales, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
+    GM_ADDR expandScales, GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
 {
     tpipe_ = pipe;
     REGISTER_TILING_DEFAULT(CamMoeDistributeDispatchA2TilingData);
@@ -232,6 +236,10 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
     halfWinSize_ = totalWinSize_ / 2;
     WIN_SIZE = halfWinSize_ - STATUS_SIZE_LAYERED;
     expertTokenNumsType_ = tilingData.moeDistributeDispatchInfo.expertTokenNumsType;
+    isEnableDiagnose_ = tilingData.moeDistributeDispatchInfo.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStatsOut);
+    }
 
     // struce相关信息初始化计算
     tokenStructLen_ =
@@ -680,6 +688,9 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
     uint32_t localRankId = rankId_ % SERVER_RANK_SIZE;
     GlobalTensor<uint64_t> flagIpcGt;
     flagIpcGt.SetGlobalBuffer((__gm__ uint64_t *)(shareAddrs[localRankId]) + destRankIdx * B64_PER_BLOCK);
+    // only the first flag waits for data, the second one is the closing barrier
+    bool recordWaitCost = isEnableDiagnose_ && flagVal == IPC_FLAG_STEP_1;
+    int64_t systemCycleStart = recordWaitCost ? GetSystemCycle() : 0;
     PipeBarrier<PIPE_ALL>();
     do {
         DataCopy(localWait, flagIpcGt, B64_PER_BLOCK);
@@ -690,6 +701,26 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
             break;
         }
     } while (isSync);
+    if (recordWaitCost) {
+        // core aivId_ waits for the rank with local index aivId_ on this server
+        RecordWaitCost(rankId_ / SERVER_RANK_SIZE * SERVER_RANK_SIZE + destRankIdx, systemCycleStart);
+    }
+}
+
+// Adds the time waited for srcRankId to its slot of the stats, every core waits for a different rank
+template <TemplateMC2TypeA2layeredClass>
+__aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layeredFunc>::RecordWaitCost(
+    uint32_t srcRankId, int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    LocalTensor<int32_t> costLt = tBuf.GetWithOffset<int32_t>(B32_PER_BLOCK, 0);
+    costLt.SetValue(0, durationTime);
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    DataCopyPad<int32_t>(waitRecvCostStatsGT_[srcRankId], costLt, costCopyOutParams);
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
 }
 
 template <TemplateMC2TypeA2layeredClass>
@@ -713,6 +744,7 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
         return;  // 不等待本server
     }
     uint32_t waitFlagIdx = aivId_;
+    int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
     PipeBarrier<PIPE_ALL>();
     LocalTensor<int32_t> statusTensor = statusBuf_.Get<int32_t>();
     while (true) {
@@ -723,6 +755,10 @@ __aicore__ inline void CamMoeDistributeDispatchA2Layered<TemplateMC2TypeA2layere
             break;
         }
     }
+    if (isEnableDiagnose_) {
+        // the data of server waitFlagIdx comes over RDMA from the rank with the same local index
+        RecordWaitCost(waitFlagIdx * SERVER_RANK_SIZE + rankId_ % SERVER_RANK_SIZE, systemCycleStart);
+    }
 }
 
 // 每个专家从不同的server块取数据
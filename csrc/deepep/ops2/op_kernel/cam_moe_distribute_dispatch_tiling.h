@@ -24,7 +24,7 @@ struct CamMoeDistributeDispatchA2Info {
     uint32_t h;                    // h
     uint32_t aivNum;               // aivNum
     bool isQuant;                  // whether quant or not
-    bool reserved1;                // reserved
+    bool isEnableDiagnose;         // whether record the wait cost per source rank or not
     bool reserved2;                // reserved
     bool reserved3;                // reserved
     uint64_t totalUbSize;          // epWorldSize
@@ -55,6 +55,7 @@ inline __aicore__ T CeilDiv(const T dividend, const T divisor)
     return (dividend + divisor - 1) / divisor;
 }
 
+// Communication arguments, the rank sized tables are GM pointers owned by the caller
 struct CommArgs {
     int rank = 0;  // attr rank_id, global rank
     int localRank = -1;
@@ -62,18 +63,17 @@ struct CommArgs {
     int localRankSize = -1;  // This parameter refers to the number of cards interconnected in fullmesh
     uint32_t extraFlag = 0;  // 32 bit map, the specific meaning of each bit is above in this file
     int testFlag = 0;
-    GM_ADDR peerMems[CAM_MAX_RANK_SIZE] =
-        {};  // Buffer obtained from initialization, all allreduce is the same parameter
+    __gm__ GM_ADDR *peerMems = nullptr;  // rankSize buffers obtained from initialization, same for all allreduce
     /**
      * @param sendCountMatrix One-dimensional array with a size of rankSize*rankSize
      * eg: The value of sendCountMatrix[1] corresponds to the [0][1] of the two-dimensional array, indicating the number
      * of data that card 0 needs to send to card 1
      */
-    int64_t sendCountMatrix[CAM_MAX_RANK_SIZE * CAM_MAX_RANK_SIZE] = {};  // for all2allvc
-    int64_t sendCounts[CAM_MAX_RANK_SIZE] = {};                           // for all2allv
-    int64_t sdispls[CAM_MAX_RANK_SIZE] = {};                              // for all2allv
-    int64_t recvCounts[CAM_MAX_RANK_SIZE] = {};                           // for all2allv
-    int64_t rdispls[CAM_MAX_RANK_SIZE] = {};                              // for all2allv
+    __gm__ int32_t *sendCountMatrix = nullptr;  // for all2allvc
+    __gm__ int64_t *sendCounts = nullptr;       // rankSize entries, for all2allv
+    __gm__ int64_t *sdispls = nullptr;          // rankSize entries, for all2allv
+    __gm__ int64_t *recvCounts = nullptr;       // rankSize entries, for all2allv
+    __gm__ int64_t *rdispls = nullptr;          // rankSize entries, for all2allv
     int64_t batchSize;
     int64_t hiddenSize;
     int64_t topk;
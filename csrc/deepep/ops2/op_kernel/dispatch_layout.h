@@ -9,6 +9,7 @@
 #include "sync_collectives.h"
 #include "moe_distribute_base.h"
 #include "dispatch_layout_tiling.h"
+#include "dispatch_layout_replica.h"
 namespace MoeDispatchLayout {
 
 constexpr uint32_t UB_32_ALIGN = 32U;
@@ -29,12 +30,16 @@ class DispatchLayout
 public:
     __aicore__ inline DispatchLayout(){};
 
-    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR numTokensPerRank, GM_ADDR numTokensPerExpert,
-                                GM_ADDR isTokenInRank, GM_ADDR notifySendData, GM_ADDR sendTokenIdxSmall,
-                                GM_ADDR workspace, TPipe *pipe, const DispatchLayoutTilingData *tilingData)
+    __aicore__ inline void Init(GM_ADDR topkIdx, GM_ADDR expertReplicaTable, GM_ADDR numTokensPerRank,
+                                GM_ADDR numTokensPerExpert, GM_ADDR isTokenInRank, GM_ADDR notifySendData,
+                                GM_ADDR sendTokenIdxSmall, GM_ADDR physicalTopkIdx, GM_ADDR workspace, TPipe *pipe,
+                                const DispatchLayoutTilingData *tilingData)
     {
+        replicaMap_.Init(expertReplicaTable, physicalTopkIdx, tilingData->dispatchLayoutInfo);
         numTokens_ = tilingData->dispatchLayoutInfo.numTokens;
         numRanks_ = tilingData->dispatchLayoutInfo.numRanks;
+        isTokenInRankBitmap_ = tilingData->dispatchLayoutInfo.isTokenInRankBitmap != 0;
+        isTokenInRankCols_ = isTokenInRankBitmap_ ? Ceil(numRanks_, IS_TOKEN_IN_RANK_BITS_PER_WORD) : numRanks_;
         numExperts_ = tilingData->dispatchLayoutInfo.numExperts;
         numTopk_ = tilingData->dispatchLayoutInfo.numTopk;
         tpipe_ = pipe;
@@ -56,15 +61,16 @@ public:
         topkIdx32AlignIntLen_ = Ceil(tempTokens_ * numTopk_ * sizeof(int64_t), UB_32_ALIGN) * UB_32_ALIGN;
         numTokensPerRank32AlignIntLen_ = Ceil(numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
         numTokensPerExpert32AlignIntLen_ = Ceil(numExperts_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
-        isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * numRanks_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
+        isTokenInRank32AlignIntLen_ = Ceil(tempTokens_ * isTokenInRankCols_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
         sendTokenIdx32AlignIntLen_ = Ceil(tempTokens_ * numExperts_ * sizeof(T), UB_32_ALIGN) * UB_32_ALIGN;
         if (coreIdx_ < restNum) {
             topkIdxOffset = coreIdx_ * tempTokens_ * numTopk_ * sizeof(int64_t);
-            isTokenOffset = coreIdx_ * tempTokens_ * numRanks_ * sizeof(T);
+            isTokenOffset = coreIdx_ * tempTokens_ * isTokenInRankCols_ * sizeof(T);
         } else {
             topkIdxOffset = (restNum + coreIdx_ * tempTokens_) * numTopk_ * sizeof(int64_t);
-            isTokenOffset = (restNum + coreIdx_ * tempTokens_) * numRanks_ * sizeof(T);
+            isTokenOffset = (restNum + coreIdx_ * tempTokens_) * isTokenInRankCols_ * sizeof(T);
         }
+        firstToken_ = topkIdxOffset / (numTopk_ * sizeof(int64_t));
         tempExpertGM_.SetGlobalBuffer((__gm__ T *)notifySendData);
         topkIdxGM_.SetGlobalBuffer((__gm__ int64_t *)(topkIdx + topkIdxOffset));
         numTokensPerRankGM_.SetGlobalBuffer((__gm__ T *)numTokensPerRank);
@@ -86,12 +92,18 @@ public:
         tpipe_->InitBuffer(isTokenInRankBuf_, isTokenInRank32AlignIntLen_);
         tpipe_->InitBuffer(seenRankBuf_, numRanks_ * sizeof(T));
         tpipe_->InitBuffer(sendTokenIdxSmallBuf_, topkIdx32AlignIntLen_);
+        if (replicaMap_.Enabled()) {
+            replicaMap_.Load(tpipe_);
+        }
 
         LocalTensor<int64_t> topkIdxTensor = topkIdxBuf_.AllocTensor<int64_t>();
         const DataCopyExtParams dataCopyParams{1U, topkIdx32AlignIntLen_, 0U, 0U, 0U};
         const DataCopyPadExtParams<int64_t> padParams{false, 0U, 0U, 0U};
         DataCopyPad(topkIdxTensor, topkIdxGM_, dataCopyParams, padParams);
         SyncFunc<AscendC::HardEvent::MTE2_S>();
+        if (replicaMap_.Enabled()) {
+            replicaMap_.Map(topkIdxTensor, firstToken_, tempTokens_);
+        }
         LocalTensor<T> numTokensPerRankTensor = numTokensPerRankBuf_.AllocTensor<T>();
         LocalTensor<T> numTokensPerExpertTensor = numTokensPerExpertBuf_.AllocTensor<T>();
         LocalTensor<T> isTokenInRankTensor = isTokenInRankBuf_.AllocTensor<T>();
@@ -99,7 +111,7 @@ public:
         LocalTensor<T> sendTokenIdxSmallTensor = sendTokenIdxSmallBuf_.AllocTensor<T>();
         Duplicate<T>(numTokensPerRankTensor, 0, numRanks_);
         Duplicate<T>(numTokensPerExpertTensor, 0, numTokensPerExpert32AlignIntLen_ / sizeof(T));
-        Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * numRanks_);
+        Duplicate<T>(isTokenInRankTensor, 0, tempTokens_ * isTokenInRankCols_);
         SyncFunc<AscendC::HardEvent::V_S>();
 
         int experts_per_rank = numExperts_ / numRanks_;
@@ -114,14 +126,14 @@ public:
                 int rank_id = expert_idx / experts_per_rank;
                 if (!seenRankTensor.GetValue(rank_id)) {
                     uint32_t per_rank_num = numTokensPerRankTensor.GetValue(rank_id) + 1;
-                    isTokenInRankTensor.SetValue(i * numRanks_ + rank_id, 1);
+                    MarkTokenInRank(isTokenInRankTensor, i, rank_id);
                     seenRankTensor.SetValue(rank_id, 1);
                     numTokensPerRankTensor.SetValue(rank_id, per_rank_num);
                 }
             }
         }
 
-        uint32_t sendSize = tempTokens_ * numRanks_ * sizeof(T);
+        uint32_t sendSize = tempTokens_ * isTokenInRankCols_ * sizeof(T);
         const DataCopyExtParams isTokenInRankDataCopyParams{1U, sendSize, 0U, 0U, 0U};
         DataCopyPad(isTokenInRankGM_, isTokenInRankTensor, isTokenInRankDataCopyParams);
         AscendC::SetAtomicAdd<T>();
@@ -159,6 +171,19 @@ public:
     }
 
 private:
+    // sets the flag of rank rankId for token tokenIdx, one T per rank or one bit per rank in bitmap mode
+    __aicore__ inline void MarkTokenInRank(LocalTensor<T> &isTokenInRankTensor, uint32_t tokenIdx, uint32_t rankId)
+    {
+        if (!isTokenInRankBitmap_) {
+            isTokenInRankTensor.SetValue(tokenIdx * numRanks_ + rankId, 1);
+            return;
+        }
+        uint32_t wordIdx = tokenIdx * isTokenInRankCols_ + rankId / IS_TOKEN_IN_RANK_BITS_PER_WORD;
+        uint32_t word = static_cast<uint32_t>(isTokenInRankTensor.GetValue(wordIdx));
+        word |= 1U << (rankId % IS_TOKEN_IN_RANK_BITS_PER_WORD);
+        isTokenInRankTensor.SetValue(wordIdx, static_cast<T>(word));
+    }
+
     GlobalTensor<int64_t> topkIdxGM_;
     GlobalTensor<T> numTokensPerRankGM_;
     GlobalTensor<T> numTokensPerExpertGM_;
@@ -172,15 +197,19 @@ private:
     TBuf<> isTokenInRankBuf_;
     TBuf<> seenRankBuf_;
     TBuf<> sendTokenIdxSmallBuf_;
+    MoeDispatchLayoutReplica::ExpertReplicaMap replicaMap_;
 
     TPipe *tpipe_{nullptr};
     uint32_t numTokens_{0};
     uint32_t numRanks_{0};
+    uint32_t isTokenInRankCols_{0};
+    bool isTokenInRankBitmap_{false};
     uint32_t numExperts_{0};
     uint32_t numTopk_{0};
     uint32_t coreIdx_{0};
     uint32_t aivNum_{0};
     uint32_t tempTokens_{0};
+    uint32_t firstToken_{0};
 
     uint32_t topkIdx32AlignIntLen_{0};
     uint32_t numTokensPerRank32AlignIntLen_{0};
@@ -0,0 +1,100 @@
+#ifndef DISPATCH_LAYOUT_REPLICA_H
+#define DISPATCH_LAYOUT_REPLICA_H
+
+#include "kernel_operator.h"
+
+#include "dispatch_layout_tiling.h"
+
+namespace MoeDispatchLayoutReplica {
+
+constexpr uint32_t REPLICA_UB_32_ALIGN = 32U;
+
+using namespace AscendC;
+
+// Maps the logical expert ids of topk_idx to physical expert ids inside dispatch_layout. Row e of the replica table
+// is the replica count of logical expert e followed by the physical expert ids of its replicas, token t of the batch
+// takes replica t % count, so the tokens of a hot expert are spread round robin over its replicas.
+class ExpertReplicaMap
+{
+public:
+    __aicore__ inline ExpertReplicaMap(){};
+
+    __aicore__ inline void Init(GM_ADDR expertReplicaTable, GM_ADDR physicalTopkIdx, const DispatchLayoutInfo &info)
+    {
+        numLogicalExperts_ = info.numLogicalExperts;
+        tableCols_ = info.replicaTableCols;
+        numTopk_ = info.numTopk;
+        numExperts_ = info.numExperts;
+        if (numLogicalExperts_ == 0) {
+            return;
+        }
+        tableGM_.SetGlobalBuffer((__gm__ int32_t *)expertReplicaTable);
+        physicalTopkIdx_ = physicalTopkIdx;
+    }
+
+    __aicore__ inline bool Enabled() const
+    {
+        return numLogicalExperts_ != 0;
+    }
+
+    // loads the table into UB, call after the kernel has reset the pipe and set up its own buffers
+    __aicore__ inline void Load(TPipe *pipe)
+    {
+        uint32_t tableBytes = numLogicalExperts_ * tableCols_ * sizeof(int32_t);
+        pipe->InitBuffer(tableBuf_, Ceil(tableBytes, REPLICA_UB_32_ALIGN) * REPLICA_UB_32_ALIGN);
+        table_ = tableBuf_.Get<int32_t>();
+        const DataCopyExtParams copyParams{1U, tableBytes, 0U, 0U, 0U};
+        const DataCopyPadExtParams<int32_t> padParams{false, 0U, 0U, 0U};
+        DataCopyPad(table_, tableGM_, copyParams, padParams);
+        int32_t eventID = static_cast<int32_t>(GetTPipePtr()->FetchEventID(AscendC::HardEvent::MTE2_S));
+        AscendC::SetFlag<AscendC::HardEvent::MTE2_S>(eventID);
+        AscendC::WaitFlag<AscendC::HardEvent::MTE2_S>(eventID);
+    }
+
+    // Maps tokenNum tokens of topkIdx in place, firstToken is the index of the first of them in the batch. The mapped
+    // ids are written to the same tokens of the physical topk_idx output. Ids out of the table, experts without a
+    // replica and replicas that are not a physical expert are kept as they are, the host does not read the table.
+    __aicore__ inline void Map(LocalTensor<int64_t> &topkIdx, uint32_t firstToken, uint32_t tokenNum)
+    {
+        for (uint32_t i = 0; i < tokenNum; ++i) {
+            for (uint32_t j = 0; j < numTopk_; ++j) {
+                int64_t logical = topkIdx.GetValue(i * numTopk_ + j);
+                if (logical < 0 || logical >= numLogicalExperts_) {
+                    continue;
+                }
+                int32_t count = table_.GetValue(logical * tableCols_);
+                if (count <= 0 || static_cast<uint32_t>(count) >= tableCols_) {
+                    continue;
+                }
+                uint32_t replica = (firstToken + i) % static_cast<uint32_t>(count);
+                int32_t physical = table_.GetValue(logical * tableCols_ + 1 + replica);
+                if (physical < 0 || static_cast<uint32_t>(physical) >= numExperts_) {
+                    continue;
+                }
+                topkIdx.SetValue(i * numTopk_ + j, static_cast<int64_t>(physical));
+            }
+        }
+        int32_t eventID = static_cast<int32_t>(GetTPipePtr()->FetchEventID(AscendC::HardEvent::S_MTE3));
+        AscendC::SetFlag<AscendC::HardEvent::S_MTE3>(eventID);
+        AscendC::WaitFlag<AscendC::HardEvent::S_MTE3>(eventID);
+        physicalTopkIdxGM_.SetGlobalBuffer((__gm__ int64_t *)physicalTopkIdx_ + firstToken * numTopk_);
+        const DataCopyExtParams copyParams{1U, static_cast<uint32_t>(tokenNum * numTopk_ * sizeof(int64_t)), 0U, 0U,
+                                           0U};
+        DataCopyPad(physicalTopkIdxGM_, topkIdx, copyParams);
+    }
+
+private:
+    GlobalTensor<int32_t> tableGM_;
+    GlobalTensor<int64_t> physicalTopkIdxGM_;
+    TBuf<> tableBuf_;
+    LocalTensor<int32_t> table_;
+
+    GM_ADDR physicalTopkIdx_{nullptr};
+    uint32_t numLogicalExperts_{0};
+    uint32_t tableCols_{0};
+    uint32_t numTopk_{0};
+    uint32_t numExperts_{0};
+};
+}  // namespace MoeDispatchLayoutReplica
+
+#endif  // DISPATCH_LAYOUT_REPLICA_H
@@ -75,7 +75,7 @@ extern "C" __global__ __aicore__ void dispatch_normal_a2(
         CamMoeDistributeDispatchA2Layered<bfloat16_t, bfloat16_t, false, false, false> op;
         op.Init(x, expertIds, scales, expertScales, tokenServerIdx, tokenServerCnt, epRankTokenCnt,
                 srcOffsetRankTokenIdx, dstOffsetRankTokenIdx, recvX, dynamicScalesOut, expandIdxOut, expertTokenNumsOut,
-                epRecvCountOut, expandScalesOut, workspace, &pipe, tiling);
+                epRecvCountOut, expandScalesOut, dispatchWaitRecvCostStatsOut, workspace, &pipe, tiling);
         op.Process();
     } else if (TILING_KEY_IS(2000000000)) {
         // NotifyDispatchA2<int> opKernel(rank, rankSize, extraFlag);
@@ -84,7 +84,7 @@ extern "C" __global__ __aicore__ void dispatch_normal_a2(
         CamMoeDistributeDispatchA2Layered<bfloat16_t, bfloat16_t, false, false, false> op;
         op.Init(x, expertIds, scales, expertScales, tokenServerIdx, tokenServerCnt, epRankTokenCnt,
                 srcOffsetRankTokenIdx, dstOffsetRankTokenIdx, recvX, dynamicScalesOut, expandIdxOut, expertTokenNumsOut,
-                epRecvCountOut, expandScalesOut, workspace, &pipe, tiling);
+                epRecvCountOut, expandScalesOut, dispatchWaitRecvCostStatsOut, workspace, &pipe, tiling);
         op.Process();
     } else if (TILING_KEY_IS(2000001000)) {
         // NotifyDispatchA2<int> opKernel(rank, rankSize, extraFlag);
@@ -93,7 +93,7 @@ extern "C" __global__ __aicore__ void dispatch_normal_a2(
         CamMoeDistributeDispatchA2Layered<bfloat16_t, bfloat16_t, false, false, false> op;
         op.Init(x, expertIds, scales, expertScales, tokenServerIdx, tokenServerCnt, epRankTokenCnt,
                 srcOffsetRankTokenIdx, dstOffsetRankTokenIdx, recvX, dynamicScalesOut, expandIdxOut, expertTokenNumsOut,
-                epRecvCountOut, expandScalesOut, workspace, &pipe, tiling);
+                epRecvCountOut, expandScalesOut, dispatchWaitRecvCostStatsOut, workspace, &pipe, tiling);
         op.Process();
     }
 }
@@ -368,4 +368,16 @@ __aicore__ inline DataplaneMode GetDataplaneMode(GM_ADDR contextGM0)
     return dataplaneMode;
 }
 
+// Rounds a positive quant multiplier down to a power of two by clearing its mantissa, so that the dequant scale
+// 1 / multiplier is a power of two (representable as UE8M0) and the quantized values still fit in [-127, 127].
+__aicore__ inline float RoundDownToPow2(float multiplier)
+{
+    union {
+        float f;
+        uint32_t u;
+    } bits = {multiplier};
+    bits.u &= 0xFF800000U;
+    return bits.f;
+}
+
 #endif  // MOE_DISTRIBUTE_BASE_H
@@ -35,6 +35,7 @@ public:
     constexpr static uint32_t EXTRA_TOKEN_INFO_NUM = 4U;  // 专家信息 权重信息 量化Scale 到达标志位
     constexpr static uint64_t MB_SIZE = 1024UL * 1024UL;
     constexpr static uint32_t MAX_BS = 4096;  // 每卡支持的最大bs
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
     template <AscendC::HardEvent event>
     __aicore__ inline void SyncFunc()
@@ -56,8 +57,9 @@ public:
     __aicore__ inline MoeDistributeCombineA2Layered(){};
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expandIdx, GM_ADDR sendCount, GM_ADDR offsetInner,
                                 GM_ADDR offsetOuter, GM_ADDR countOuter, GM_ADDR scales, GM_ADDR XOut,
-                                GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineA2TilingData *tilingData,
-                                __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling);
+                                GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+                                const MoeDistributeCombineA2TilingData *tilingData, __gm__ void *mc2InitTiling,
+                                __gm__ void *mc2CcTiling);
     __aicore__ inline void Process();
 
 private:
@@ -67,6 +69,7 @@ private:
     __aicore__ inline void SumToWindow();
     __aicore__ inline void SetStatus();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void RecordWaitCost(uint32_t srcRankId, int64_t systemCycleStart);
     __aicore__ inline void AlltoAllServerDispatch();
     __aicore__ inline void SumToServer();
     __aicore__ inline void Preload();
@@ -127,6 +130,7 @@ private:
     GlobalTensor<int32_t> offsetOuterGlobal_;
     GlobalTensor<int32_t> countOuterGlobal_;
     GlobalTensor<int32_t> recvCountInnerGlobal_;
+    GlobalTensor<int32_t> sendCostStatsGT_;
     TBuf<> offsetReduceBuf_;
     TBuf<> countReduceBuf_;
     // tiling侧已确保数据上限，相乘不会越界，因此统一采用uint32_t进行处理
@@ -189,6 +193,7 @@ private:
     uint32_t resLen{0};
     uint32_t offsetIndex{0};
     uint32_t maxLocalBs{0};
+    bool isEnableDiagnose_{false};
     LocalTensor<int32_t> offsetReduceLocal_;
     LocalTensor<int32_t> countReduceLocal_;
 };
@@ -196,8 +201,8 @@ private:
 template <TemplateMC2TypeA2layeredClass>
 __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFunc>::Init(
     GM_ADDR expandX, GM_ADDR expandIdx, GM_ADDR sendCount, GM_ADDR offsetInner, GM_ADDR offsetOuter, GM_ADDR countOuter,
-    GM_ADDR scales, GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineA2TilingData *tilingData,
-    __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling)
+    GM_ADDR scales, GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+    const MoeDistributeCombineA2TilingData *tilingData, __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling)
 {
     tpipe_ = pipe;
     expandXGM_ = expandX;
@@ -214,6 +219,10 @@ __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFun
     aivNum_ = tilingData->moeDistributeCombineInfo.aivNum;
     moeExpertNum_ = tilingData->moeDistributeCombineInfo.moeExpertNum;
     worldSize_ = tilingData->moeDistributeCombineInfo.epWorldSize;
+    isEnableDiagnose_ = tilingData->moeDistributeCombineInfo.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        sendCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)sendCostStatsOut);
+    }
 
     auto contextGM = AscendC::GetHcclContext<HCCL_GROUP_ID_0>();
     winContext_ = (__gm__ HcclOpResParam *)contextGM;
@@ -420,6 +429,7 @@ __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFun
         LocalTensor<int64_t> InUb = statusBuf_.AllocTensor<int64_t>();
         for (uint32_t i = 0U; i < SERVER_RANK_SIZE; i++) {
             uint32_t waitFlagAddr = coreIdx_ * SERVER_RANK_SIZE + i;
+            int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
             while (true) {
                 DataCopy(InUb, shareFlagGlobal_[waitFlagAddr * 4], 4);
                 PipeBarrier<PIPE_ALL>();
@@ -427,6 +437,10 @@ __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFun
                     break;
                 }
             }
+            if (isEnableDiagnose_) {
+                // the flag i is set by the rank with local index i on this server
+                RecordWaitCost(rankId_ / SERVER_RANK_SIZE * SERVER_RANK_SIZE + i, systemCycleStart);
+            }
         }
         InUb.SetValue(0, 0);
         PipeBarrier<PIPE_ALL>();
@@ -649,6 +663,7 @@ __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFun
         LocalTensor<int32_t> statusTensor = statusBuf_.Get<int32_t>();
         uint32_t readNum = 1U;
         DataCopyParams intriParams{static_cast<uint16_t>(readNum), 1, 15, 0};  // srcStride为15个block
+        int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
         while (true) {
             DataCopy(statusTensor, statusSpaceGlobal_[(coreIdx_)*STATE_OFFSET / sizeof(int32_t)], intriParams);
             PipeBarrier<PIPE_ALL>();
@@ -658,11 +673,30 @@ __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFun
                 break;
             }
         }
+        if (isEnableDiagnose_) {
+            RecordWaitCost(targetRank, systemCycleStart);
+        }
     }
 
     SyncAll<true>();
 }
 
+// Adds the time waited for srcRankId to its slot of the stats, several cores can add to the same slot
+template <TemplateMC2TypeA2layeredClass>
+__aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFunc>::RecordWaitCost(
+    uint32_t srcRankId, int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    LocalTensor<int32_t> costLt = statusSumOutBuf_.Get<int32_t>();
+    costLt.SetValue(0, durationTime);
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    DataCopyPad<int32_t>(sendCostStatsGT_[srcRankId], costLt, costCopyOutParams);
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeA2layeredClass>
 __aicore__ inline void MoeDistributeCombineA2Layered<TemplateMC2TypeA2layeredFunc>::Preload()
 {
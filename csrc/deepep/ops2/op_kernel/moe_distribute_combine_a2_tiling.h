@@ -19,7 +19,7 @@ struct MoeDistributeCombineA2Info {
     uint32_t aivNum;               // aivNum
     uint64_t totalUbSize;          // epWorldSize
     uint32_t hcclBufferSize;       // HCCL windows, unit:B
-    uint32_t rsd;
+    uint32_t isEnableDiagnose;     // whether record the wait cost per peer rank or not
 };
 
 struct MoeDistributeCombineA2TilingData {
@@ -38,7 +38,8 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR assistInfoForCombine, GM_ADDR epSendCount, GM_ADDR scales,
     GM_ADDR tpSendCount, GM_ADDR xActiveMask, GM_ADDR activationScale, GM_ADDR weightScale, GM_ADDR groupList,
     GM_ADDR expandScales, GM_ADDR sharedExpertX, GM_ADDR elasticInfo, GM_ADDR oriX, GM_ADDR constExpertAlpha1,
-    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM, GM_ADDR tilingGM)
+    GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM,
+    GM_ADDR tilingGM)
 
 {
     REGISTER_TILING_DEFAULT(MoeDistributeCombineV2TilingData);
@@ -53,7 +54,8 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
         __gm__ void *mc2CcTiling = (__gm__ void *)(&(tiling->mc2CcTiling));
         MoeDistributeCombineV2<DTYPE_EXPAND_X, int32_t> op;
         op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, scales, xActiveMask, oriX, constExpertAlpha1,
-                constExpertAlpha2, constExpertV, XOut, workspaceGM, &pipe, &tilingData, mc2InitTiling, mc2CcTiling);
+                constExpertAlpha2, constExpertV, XOut, sendCostStatsOut, workspaceGM, &pipe, &tilingData,
+                mc2InitTiling, mc2CcTiling);
         op.Process();
     } else if (TILING_KEY_IS(3000)) {
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeCombineV2TilingData, tilingData, tilingGM);
@@ -64,8 +66,8 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
         DataplaneMode dataplaneMode = GetDataplaneMode(contextGM0);
         if (dataplaneMode == DataplaneMode::AIV) {
             MoeDistributeCombineV2Layered<DTYPE_EXPAND_X, int32_t, DTYPE_EXPAND_X> op;
-            op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, scales, XOut, workspaceGM, &pipe,
-                    &tilingData, mc2InitTiling, mc2CcTiling, contextGM0);
+            op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, scales, XOut, sendCostStatsOut, workspaceGM,
+                    &pipe, &tilingData, mc2InitTiling, mc2CcTiling, contextGM0);
             op.Process();
         } else {
             assert(false, "The driver version is too low and does not support layered mode.\n");
@@ -80,8 +82,8 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
         DataplaneMode dataplaneMode = GetDataplaneMode(contextGM0);
         if (dataplaneMode == DataplaneMode::AIV) {
             MoeDistributeCombineV2Layered<DTYPE_EXPAND_X, int32_t, int8_t> op;
-            op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, scales, XOut, workspaceGM, &pipe,
-                    &tilingData, mc2InitTiling, mc2CcTiling, contextGM0);
+            op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, scales, XOut, sendCostStatsOut, workspaceGM,
+                    &pipe, &tilingData, mc2InitTiling, mc2CcTiling, contextGM0);
             op.Process();
         } else {
             assert(false, "The driver version is too low. It should not be lower than 25.0.rc1.1.\n");
@@ -91,7 +93,7 @@ extern "C" __global__ __aicore__ void moe_distribute_combine_v2(
 
         MoeDistributeCombineV2Single<DTYPE_EXPAND_X, DTYPE_X, int32_t, false, false, false> op;
         op.Init(expandX, expertIds, assistInfoForCombine, epSendCount, tpSendCount, scales, xActiveMask, sharedExpertX,
-                XOut, workspaceGM, &pipe, tilingGM);
+                XOut, sendCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     }
 #endif
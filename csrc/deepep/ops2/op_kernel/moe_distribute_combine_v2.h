@@ -92,12 +92,15 @@ template <TemplateMC2TypeA2Class>
 class MoeDistributeCombineV2
 {
 public:
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
+
     __aicore__ inline MoeDistributeCombineV2(){};
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR sendCount,
                                 GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR oriX, GM_ADDR constExpertAlpha1,
-                                GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut, GM_ADDR workspaceGM,
-                                TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData,
-                                __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling);
+                                GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut,
+                                GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+                                const MoeDistributeCombineV2TilingData *tilingData, __gm__ void *mc2InitTiling,
+                                __gm__ void *mc2CcTiling);
     __aicore__ inline void Process();
 
 private:
@@ -107,6 +110,7 @@ private:
     __aicore__ inline void SplitCoreCal();
     __aicore__ inline void Preload();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void CopyOutWaitCost();
     __aicore__ inline void TokenActiveMaskCal();
     __aicore__ inline void ProcessMoeAndCopyExpert(uint32_t tokenIdx, uint32_t topKIdx);
     __aicore__ inline void ProcessConstantExpert(uint32_t tokenIdx, uint32_t topKIdx);
@@ -127,6 +131,7 @@ private:
     GlobalTensor<uint32_t> workspaceGlobal32_;  // 存储batchWriteInfo结构体信息
     GlobalTensor<uint32_t> flagGlobal_;
     GlobalTensor<bool> xActiveMaskGlobal_;  // xActiveMask int8 代替 bool
+    GlobalTensor<int32_t> sendCostStatsGT_;
     GlobalTensor<ExpandXType>
         oriXGlobal_;  // 表示未经过FFN的token数据，在使能copyExpert或使能constExpert的场景下需要本输入数据
     GlobalTensor<ExpandXType> constExpertAlpha1Global_;  // 在使能constExpert的场景下需要输入的计算系数alpha1
@@ -143,6 +148,7 @@ private:
     LocalTensor<bool> expertMaskTensor_;
     LocalTensor<ExpandXType> tmpUb_;
     LocalTensor<uint32_t> statusTensor_;
+    LocalTensor<int32_t> waitCostTensor_;
     GM_ADDR windowInGM_;
     GM_ADDR windowOutGM_;
     GM_ADDR expandXGM_;
@@ -187,6 +193,7 @@ private:
 
     bool isInputTokenMaskFlag_ = false;
     bool isInputExpertMaskFlag_ = false;
+    bool isEnableDiagnose_ = false;
     TQueBind<QuePosition::VECIN, QuePosition::VECOUT, BUFFER_NUM> moeQueue_;
     TBuf<> expertIdsBuf_;
     TBuf<> expandScalesBuf_;
@@ -195,6 +202,7 @@ private:
     TBuf<> indexCountsBuf_;
     TBuf<> tokenBuf_;
     TBuf<> batchWriteItemBuf_;
+    TBuf<> waitCostBuf_;
     // 二维expertMaske
     TBuf<> expertMaskBuf_;
 
@@ -210,8 +218,8 @@ template <TemplateMC2TypeA2Class>
 __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::Init(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR sendCount, GM_ADDR scales, GM_ADDR xActiveMask,
     GM_ADDR oriX, GM_ADDR constExpertAlpha1, GM_ADDR constExpertAlpha2, GM_ADDR constExpertV, GM_ADDR XOut,
-    GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData, __gm__ void *mc2InitTiling,
-    __gm__ void *mc2CcTiling)
+    GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData,
+    __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling)
 {
     tpipe_ = pipe;
     expandXGM_ = expandX;
@@ -233,6 +241,10 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::Init(
     worldSize_ = tilingData->moeDistributeCombineV2Info.epWorldSize;
     isInputTokenMaskFlag_ = tilingData->moeDistributeCombineV2Info.isTokenMask;
     isInputExpertMaskFlag_ = tilingData->moeDistributeCombineV2Info.isExpertMask;
+    isEnableDiagnose_ = tilingData->moeDistributeCombineV2Info.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        sendCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)sendCostStatsOut);
+    }
     auto contextGM = AscendC::GetHcclContext<HCCL_GROUP_ID_0>();
     winContext_ = (__gm__ HcclOpResParam *)contextGM;
     hccl_.Init(contextGM, mc2InitTiling);
@@ -535,6 +547,14 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::WaitDispat
         SyncAll<true>();
         return;
     }
+    int64_t systemCycleStart = 0;
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(waitCostBuf_, sendRankNum_ * UB_ALIGN);  // 每张卡占32B
+        waitCostTensor_ = waitCostBuf_.Get<int32_t>();
+        Duplicate<int32_t>(waitCostTensor_, -1, sendRankNum_ * B32_PER_BLOCK);
+        SyncFunc<AscendC::HardEvent::V_S>();
+        systemCycleStart = GetSystemCycle();
+    }
     SyncFunc<AscendC::HardEvent::MTE2_S>();
     for (uint32_t waitFlagNum = 0; waitFlagNum < sendRankNum_;) {
         waitFlagNum = 0;
@@ -548,9 +568,17 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::WaitDispat
             uint32_t flag = flagGlobal_(0);
             if (flag == FLAG_VALUE) {
                 waitFlagNum++;
+                uint32_t costOffset = (rankId - startRankId_) * B32_PER_BLOCK;
+                if (isEnableDiagnose_ && waitCostTensor_.GetValue(costOffset) < 0) {
+                    waitCostTensor_.SetValue(
+                        costOffset, static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME));
+                }
             }
         }
     }
+    if (isEnableDiagnose_) {
+        CopyOutWaitCost();
+    }
     for (uint32_t rankId = startRankId_; rankId < endRankId_; ++rankId) {
         uint32_t tokenIdx = (rankId + 1) * localMoeExpertNum_ - 1;
         GM_ADDR wAddr = windowInGM_ + rankSizeOnWin_ * rankId + SKIP_OFFSET +
@@ -561,6 +589,21 @@ __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::WaitDispat
     SyncAll<true>();
 }
 
+// Adds the time until the data of every rank of this core arrived to the slot of that rank
+template <TemplateMC2TypeA2Class>
+__aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::CopyOutWaitCost()
+{
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    for (uint32_t rankId = startRankId_; rankId < endRankId_; ++rankId) {
+        DataCopyPad<int32_t>(sendCostStatsGT_[rankId], waitCostTensor_[(rankId - startRankId_) * B32_PER_BLOCK],
+                             costCopyOutParams);
+    }
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeA2Class>
 __aicore__ inline void MoeDistributeCombineV2<TemplateMC2TypeA2Func>::Process()
 {
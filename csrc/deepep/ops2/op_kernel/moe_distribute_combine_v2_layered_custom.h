@@ -77,6 +77,7 @@ public:
     constexpr static uint32_t NOTIFY_DATA_SIZE = 400U * 1024U * 1024U;
     constexpr static uint64_t RDMA_TOKEN_END_FLAG = 321ULL;
     constexpr static uint32_t MAX_BS_NUM = 512U;  // 适配bs=512
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
     constexpr static uint32_t FLAG_SINGLE_CNT = 4;
     constexpr static uint32_t FLAG_TOTAL_SIZE = MAX_BS_NUM * SERVER_RANK_SIZE * FLAG_SINGLE_CNT > IPC_DATA_OFFSET
                                                     ? IPC_DATA_OFFSET
@@ -106,9 +107,9 @@ public:
 
     __aicore__ inline MoeDistributeCombineV2Layered(){};
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR sendCount,
-                                GM_ADDR scales, GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe,
-                                const MoeDistributeCombineV2TilingData *tilingData, __gm__ void *mc2InitTiling,
-                                __gm__ void *mc2CcTiling, GM_ADDR contextGM);
+                                GM_ADDR scales, GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM,
+                                TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData,
+                                __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling, GM_ADDR contextGM);
     __aicore__ inline void Process();
     __aicore__ inline void AIVRDMAPostSend(GM_ADDR srcDmaAddr, GM_ADDR destDmaAddr, uint64_t destRankId,
                                            uint64_t messageLen, __gm__ HcclAiRMAInfo *QpInfo);
@@ -120,6 +121,7 @@ private:
     __aicore__ inline void WaitIPC();
     __aicore__ inline void SumToWindow();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void RecordWaitCost(uint32_t srcRankId, int64_t systemCycleStart);
     __aicore__ inline void AlltoAllServerDispatch();
     __aicore__ inline void SumToServer();
     __aicore__ inline void Preload();
@@ -133,6 +135,7 @@ private:
     GlobalTensor<ExpandIdxType> bkCountGlobal_;
     GlobalTensor<float> expandScalesGlobal_;
     GlobalTensor<ExpandXType> expandOutGlobal_;
+    GlobalTensor<int32_t> sendCostStatsGT_;
 
     GlobalTensor<ExpandXType> localOutWindow_;
     GlobalTensor<ExpandXTransType> localInWindow_;
@@ -222,6 +225,7 @@ private:
     TBuf<TPosition::VECOUT> rdmaInBuf_;
     TBuf<TPosition::VECOUT> rdmaInBuf2_;
     TBuf<> statusBuf_;
+    bool isEnableDiagnose_{false};
 
     int32_t sumTarget_{0};
     int32_t stateValue_{0};
@@ -346,8 +350,8 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
 template <TemplateMC2TypeA2layeredClass>
 __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFunc>::Init(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR sendCount, GM_ADDR scales, GM_ADDR XOut,
-    GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData, __gm__ void *mc2InitTiling,
-    __gm__ void *mc2CcTiling, GM_ADDR contextGM)
+    GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe, const MoeDistributeCombineV2TilingData *tilingData,
+    __gm__ void *mc2InitTiling, __gm__ void *mc2CcTiling, GM_ADDR contextGM)
 {
     tpipe_ = pipe;
     expandXGM_ = expandX;
@@ -363,6 +367,10 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
     aivNum_ = tilingData->moeDistributeCombineV2Info.aivNum;
     moeExpertNum_ = tilingData->moeDistributeCombineV2Info.moeExpertNum;
     worldSize_ = tilingData->moeDistributeCombineV2Info.epWorldSize;
+    isEnableDiagnose_ = tilingData->moeDistributeCombineV2Info.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        sendCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)sendCostStatsOut);
+    }
 
     globalBs = tilingData->moeDistributeCombineV2Info.globalBs;
     if (globalBs >= MAX_BS_NUM) {
@@ -609,6 +617,7 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
     if (coreIdx_ < SERVER_RANK_SIZE) {
         LocalTensor<uint64_t> inUb = statusBuf_.Get<uint64_t>();
         uint32_t waitFlagOffset = coreIdx_ % SERVER_RANK_SIZE;
+        int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
         while (true) {
             DataCopy(inUb, shareFlagGlobal_[waitFlagOffset * FLAG_SINGLE_CNT], FLAG_SINGLE_CNT);
             PipeBarrier<PIPE_ALL>();
@@ -616,6 +625,10 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
                 break;
             }
         }
+        if (isEnableDiagnose_) {
+            // the flag waitFlagOffset is set by the rank with that local index on this server
+            RecordWaitCost(rankId_ / SERVER_RANK_SIZE * SERVER_RANK_SIZE + waitFlagOffset, systemCycleStart);
+        }
         inUb(0) = 0;
         PipeBarrier<PIPE_ALL>();
         DataCopy(shareFlagGlobal_[waitFlagOffset * FLAG_SINGLE_CNT], inUb,
@@ -920,6 +933,7 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
         LocalTensor<int32_t> statusTensor = statusBuf_.Get<int32_t>();
         uint32_t readNum = 1U;
         DataCopyParams intriParams{static_cast<uint16_t>(readNum), 1, 15, 0};  // srcStride为15个block
+        int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
         while (true) {
             DataCopy(statusTensor, statusSpaceGlobal_[(coreIdx_)*STATE_OFFSET / sizeof(int32_t)], intriParams);
             PipeBarrier<PIPE_ALL>();
@@ -928,11 +942,30 @@ __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFun
                 break;
             }
         }
+        if (isEnableDiagnose_) {
+            RecordWaitCost(targetRank, systemCycleStart);
+        }
     }
     PipeBarrier<PIPE_ALL>();
     SyncAll<true>();
 }
 
+// Adds the time waited for srcRankId to its slot of the stats, the waits only use the first block of statusBuf_
+template <TemplateMC2TypeA2layeredClass>
+__aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFunc>::RecordWaitCost(
+    uint32_t srcRankId, int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    LocalTensor<int32_t> costLt = statusBuf_.GetWithOffset<int32_t>(B32_PER_BLOCK, UB_ALIGN);
+    costLt.SetValue(0, durationTime);
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    DataCopyPad<int32_t>(sendCostStatsGT_[srcRankId], costLt, costCopyOutParams);
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeA2layeredClass>
 __aicore__ inline void MoeDistributeCombineV2Layered<TemplateMC2TypeA2layeredFunc>::Preload()
 {
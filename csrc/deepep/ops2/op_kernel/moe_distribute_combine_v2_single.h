@@ -53,6 +53,7 @@ public:
     constexpr static uint64_t SCALE_EXPAND_IDX_BUFFER = 44UL;  // scale32B + 3*4expandIdx
     constexpr static uint64_t DOUBLE_DATA_BUFFER = 2UL;
     constexpr static uint64_t MAX_OUT_DTYPE_SIZE = 2UL;
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
     template <AscendC::HardEvent event>
     __aicore__ inline void SyncFunc()
@@ -66,7 +67,8 @@ public:
     __aicore__ inline MoeDistributeCombineV2Single(){};
     __aicore__ inline void Init(GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount,
                                 GM_ADDR tpSendCount, GM_ADDR expertScales, GM_ADDR xActiveMask, GM_ADDR sharedExpertX,
-                                GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM);
+                                GM_ADDR XOut, GM_ADDR sendCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe,
+                                GM_ADDR tilingGM);
     __aicore__ inline void Process();
 
 private:
@@ -116,6 +118,7 @@ private:
     GlobalTensor<float> expertScalesGM_;
     GlobalTensor<XType> sharedExpertXGM_;
     GlobalTensor<XType> expandOutGlobal_;
+    GlobalTensor<int32_t> sendCostStatsGT_;
     GlobalTensor<XType> rankWindow_;  // 用于存对端window的变量
     GlobalTensor<XType> tpRankWindow_;
     GlobalTensor<XType> rowTmpGlobal_;
@@ -195,9 +198,11 @@ private:
     TBuf<> vaildBsIndexTBuf_;
     TBuf<> xActMaskSumTBuf_;
     TBuf<> stateBuf_;
+    TBuf<> sendCostStatsBuf_;
     bool isInputTokenMaskFlag_ = false;
     bool isInputExpertMaskFlag_ = false;
     bool hasSharedExpertX_ = false;
+    bool isEnableDiagnose_ = false;
 
     // int8量化
     TBuf<> xAbsBuf_;
@@ -330,6 +335,7 @@ MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>::InitAttrs(const MoeDi
     isInputTokenMaskFlag_ = tilingData.moeDistributeCombineV2Info.isTokenMask;
     isInputExpertMaskFlag_ = tilingData.moeDistributeCombineV2Info.isExpertMask;
     hasSharedExpertX_ = tilingData.moeDistributeCombineV2Info.hasSharedExpertX;
+    isEnableDiagnose_ = tilingData.moeDistributeCombineV2Info.isEnableDiagnose;
 
     stateOffset_ = STATE_OFFSET;
     uint32_t hFloatSize = axisH_ * static_cast<uint32_t>(sizeof(float));
@@ -358,8 +364,8 @@ __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>
 template <TemplateMC2TypeA2SingleClass>
 __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>::Init(
     GM_ADDR expandX, GM_ADDR expertIds, GM_ADDR expandIdx, GM_ADDR epSendCount, GM_ADDR tpSendCount,
-    GM_ADDR expertScales, GM_ADDR xActiveMask, GM_ADDR sharedExpertX, GM_ADDR XOut, GM_ADDR workspaceGM, TPipe *pipe,
-    GM_ADDR tilingGM)
+    GM_ADDR expertScales, GM_ADDR xActiveMask, GM_ADDR sharedExpertX, GM_ADDR XOut, GM_ADDR sendCostStatsOut,
+    GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
 {
     CAM_PRINT("[Combine_Init] enter init, IsNeedReduceScatter:%d, IsShareExpert:%d, IsInt8Quant:%d...\n",
               IsNeedReduceScatter, IsShareExpert, IsInt8Quant);
@@ -380,6 +386,9 @@ __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>
     InitDataStatus();
 
     InitInputAndOutput(expandX, expertIds, expandIdx, epSendCount, expertScales, xActiveMask, sharedExpertX, XOut);
+    if (isEnableDiagnose_) {
+        sendCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)sendCostStatsOut);
+    }
 
     // 检查hcclwinsize是否越界
     auto realWinSize = epWinContext_->winSize;
@@ -627,6 +636,14 @@ __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>
     DataCopyPad(expandIdxLocal, expandIdxGM_[startTokenId_ * EXPAND_IDX_INFO], bskParams, copyPadParams);
     LocalTensor<float> statusTensor = readStateBuf_.AllocTensor<float>();
     Duplicate<float>(statusTensor, (float)1, FLOAT_PER_UB_ALIGN);
+    LocalTensor<int32_t> sendCostStatsTensor;
+    uint32_t sendCostStatsBufSize = Ceil(epWorldSize_ * sizeof(int32_t), UB_ALIGN) * UB_ALIGN;
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(sendCostStatsBuf_, sendCostStatsBufSize);
+        sendCostStatsTensor = sendCostStatsBuf_.Get<int32_t>();
+        Duplicate<int32_t>(sendCostStatsTensor, 0, sendCostStatsBufSize / sizeof(int32_t));
+        SyncFunc<AscendC::HardEvent::V_S>();
+    }
 
     SyncFunc<AscendC::HardEvent::MTE2_S>();
     for (uint32_t loop = 0; loop < sendCntNum_; loop++) {
@@ -636,6 +653,7 @@ __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>
         uint32_t tokenId = static_cast<uint32_t>(expandIdxLocal(baseOffset + 1));  // 位置1是token_id
         uint32_t topkId = static_cast<uint32_t>(expandIdxLocal(baseOffset + 2));   // 位置2是topk_id
 
+        int64_t sendStartCycle = isEnableDiagnose_ ? GetSystemCycle() : 0;
         ExpertAlltoAllDispatchInnerCopyAdd(toRankId, tokenId, topkId, tkIndex);
         PipeBarrier<PIPE_ALL>();
         GM_ADDR stateGM = GetWinStateAddrByRankId(toRankId, EP_DOMAIN) + tokenId * flagRcvCount_ * stateOffset_ +
@@ -643,6 +661,21 @@ __aicore__ inline void MoeDistributeCombineV2Single<TemplateMC2TypeA2SingleFunc>
         GlobalTensor<float> stateGMTensor;
         stateGMTensor.SetGlobalBuffer((__gm__ float *)stateGM);
         DataCopy<float>(stateGMTensor, statusTensor, FLOAT_PER_UB_ALIGN);  // 8是数据大小，按32对齐拷贝
+
+        if (isEnableDiagnose_) {
+            SyncFunc<AscendC::HardEvent::MTE3_S>();
+            int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - sendStartCycle) / CYCLE_TO_TIME);  // us
+            int32_t preTime = sendCostStatsTensor.GetValue(toRankId);
+            sendCostStatsTensor.SetValue(toRankId, preTime + durationTime);
+        }
+    }
+
+    if (isEnableDiagnose_) {
+        SyncFunc<AscendC::HardEvent::S_MTE3>();
+        AscendC::SetAtomicAdd<int32_t>();
+        DataCopyExtParams statsCopyOutParams = {1U, static_cast<uint32_t>(epWorldSize_ * sizeof(int32_t)), 0U, 0U, 0U};
+        DataCopyPad<int32_t>(sendCostStatsGT_, sendCostStatsTensor, statsCopyOutParams);
+        AscendC::SetAtomicNone();
     }
 }
 
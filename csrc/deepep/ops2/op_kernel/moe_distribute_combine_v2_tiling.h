@@ -47,7 +47,8 @@ struct MoeDistributeCombineV2Info {
     bool isTokenMask;              // input active mask 1dims or not
     bool isExpertMask;             // input active mask 2dims or not
     bool hasSharedExpertX;         // input shared expert x or not
-    int8_t reserved[7];            // Pad 7 int8 for memory alignment
+    bool isEnableDiagnose;         // whether record the cost per peer rank or not
+    int8_t reserved[6];            // Pad 6 int8 for memory alignment
 };
 
 struct MoeDistributeCombineV2TilingData {
@@ -40,7 +40,8 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
                                                                  GM_ADDR expandXOut, GM_ADDR dynamicScalesOut,
                                                                  GM_ADDR assistInfoOut, GM_ADDR expertTokenNumsOut,
                                                                  GM_ADDR epSendCountsOut, GM_ADDR tpSendCountsOut,
-                                                                 GM_ADDR workspaceGM, GM_ADDR tilingGM)
+                                                                 GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM,
+                                                                 GM_ADDR tilingGM)
 {
     REGISTER_TILING_DEFAULT(MoeDistributeDispatchV2TilingData);
     REGISTER_TILING_FOR_TILINGKEY("TILING_KEY_VAR >= 2000000000", MoeDistributeDispatchV2TilingData);
@@ -50,7 +51,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                epSendCountsOut, workspaceGM, &pipe, tilingGM);
+                epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     } else if (TILING_KEY_IS(2100001000)) {
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
@@ -59,7 +60,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         if (dataplaneMode == DataplaneMode::AIV) {
             MoeDistributeDispatchV2Layered<DTYPE_X, DTYPE_EXPAND_X, false, false, false> op;
             op.Init(x, expertIds, scales, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                    epSendCountsOut, workspaceGM, &pipe, tilingGM, contextGM0);
+                    epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM, contextGM0);
             op.Process();
         } else {
             assert(false, "The driver version is too low and does not support layered mode.\n");
@@ -69,7 +70,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2Single<DTYPE_X, DTYPE_EXPAND_X, false, false, false, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, tilingGM);
+                epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     }
 #elif (ORIG_DTYPE_EXPAND_X == DT_INT8)
@@ -77,13 +78,13 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, false> op;
         op.Init(x, expertIds, scales, xActiveMask, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                epSendCountsOut, workspaceGM, &pipe, tilingGM);
+                epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     } else if (TILING_KEY_IS(2000001012)) {
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2<DTYPE_X, DTYPE_EXPAND_X, false, true, true> op;
         op.Init(x, expertIds, scales, xActiveMask, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                epSendCountsOut, workspaceGM, &pipe, tilingGM);
+                epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     } else if (TILING_KEY_IS(2100001002)) {
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
@@ -92,7 +93,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         if (dataplaneMode == DataplaneMode::AIV) {
             MoeDistributeDispatchV2Layered<DTYPE_X, DTYPE_EXPAND_X, false, true, false> op;
             op.Init(x, expertIds, scales, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                    epSendCountsOut, workspaceGM, &pipe, tilingGM, contextGM0);
+                    epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM, contextGM0);
             op.Process();
         } else {
             assert(false, "The driver version is too low and does not support layered mode.\n");
@@ -104,7 +105,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         if (dataplaneMode == DataplaneMode::AIV) {
             MoeDistributeDispatchV2Layered<DTYPE_X, DTYPE_EXPAND_X, false, true, true> op;
             op.Init(x, expertIds, scales, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                    epSendCountsOut, workspaceGM, &pipe, tilingGM, contextGM0);
+                    epSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM, contextGM0);
             op.Process();
         } else {
             assert(false, "The driver version is too low and does not support layered mode.\n");
@@ -113,7 +114,7 @@ extern "C" __global__ __aicore__ void moe_distribute_dispatch_v2(GM_ADDR x, GM_A
         GET_TILING_DATA_WITH_STRUCT(MoeDistributeDispatchV2TilingData, tilingData, tilingGM);
         MoeDistributeDispatchV2Single<DTYPE_X, DTYPE_EXPAND_X, false, true, false, false, false> op;
         op.Init(x, expertIds, scales, xActiveMask, expandXOut, dynamicScalesOut, assistInfoOut, expertTokenNumsOut,
-                epSendCountsOut, tpSendCountsOut, workspaceGM, &pipe, tilingGM);
+                epSendCountsOut, tpSendCountsOut, waitRecvCostStatsOut, workspaceGM, &pipe, tilingGM);
         op.Process();
     }
 #endif
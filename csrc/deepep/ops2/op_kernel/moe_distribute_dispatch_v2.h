@@ -74,12 +74,14 @@ private:
     constexpr static int32_t BITS_PER_BYTE = 8;
     constexpr static uint32_t REPEAT_BYTES = 256;
     constexpr static uint32_t BITS16_PER_BLOCK = UB_ALIGN / sizeof(int16_t);
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
 public:
     __aicore__ inline MoeDistributeDispatchV2(){};
     __aicore__ inline void Init(GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR expandXOut,
                                 GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut,
-                                GM_ADDR epRecvCountsOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM);
+                                GM_ADDR epRecvCountsOut, GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM,
+                                TPipe *pipe, GM_ADDR tilingGM);
     __aicore__ inline void Process();
 
 private:
@@ -88,6 +90,7 @@ private:
     __aicore__ inline void LocalWindowCopy();
     __aicore__ inline void GetStatusCumSum();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void RecordWaitCost(uint32_t srcRankId, int64_t systemCycleStart);
     __aicore__ inline void ConstructBatchWriteInfo();
     __aicore__ inline void ReorderTokens();
     __aicore__ inline void ReorderTokensPipeSet();
@@ -113,6 +116,7 @@ private:
     GlobalTensor<int32_t> sendStatusTensor_;
     GlobalTensor<uint32_t> bufferChosenGlobal_;
     GlobalTensor<int8_t> xActiveMaskGMTensor_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
 
     LocalTensor<ExpandXOutType> xTmpTensor_;
     LocalTensor<XType> xInTensor_;
@@ -181,6 +185,8 @@ private:
     bool isTokenMaskFlag_ = false;
     bool isExpertMaskFlag_ = false;
     bool isQuant_ = false;
+    bool isRoundScale_ = false;
+    bool isEnableDiagnose_ = false;
     Hccl<HCCL_SERVER_TYPE_AICPU> hccl_;
     __gm__ HcclOpResParam *winContext_{nullptr};
 };
@@ -188,8 +194,8 @@ private:
 template <TemplateMC2TypeA2Class>
 __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::Init(
     GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR expandXOut, GM_ADDR dynamicScalesOut,
-    GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut, GM_ADDR epRecvCountsOut, GM_ADDR workspaceGM, TPipe *pipe,
-    GM_ADDR tilingGM)
+    GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut, GM_ADDR epRecvCountsOut, GM_ADDR waitRecvCostStatsOut,
+    GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
 {
     tpipe_ = pipe;
     REGISTER_TILING_DEFAULT(MoeDistributeDispatchV2TilingData);
@@ -214,6 +220,8 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::Init(
     worldSize_ = tilingData.moeDistributeDispatchV2Info.epWorldSize;
     expertTokenNumsType_ = tilingData.moeDistributeDispatchV2Info.expertTokenNumsType;
     isTokenMaskFlag_ = tilingData.moeDistributeDispatchV2Info.isTokenMask;
+    isRoundScale_ = tilingData.moeDistributeDispatchV2Info.isRoundScale;
+    isEnableDiagnose_ = tilingData.moeDistributeDispatchV2Info.isEnableDiagnose;
     isExpertMaskFlag_ = tilingData.moeDistributeDispatchV2Info.isExpertMask;
     zeroComputeExpertNum_ = tilingData.moeDistributeDispatchV2Info.zeroComputeExpertNum;
     totalSize_ = winContext_->winSize / 2;  // 2G / 2 = 1G
@@ -246,6 +254,9 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::Init(
     expandIdxOutGM_ = expandIdxOut;
     expertTokenNumsOutGM_ = expertTokenNumsOut;
     epRecvCountsGM_ = epRecvCountsOut;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStatsOut);
+    }
 
     isQuant_ = StaticQuant | DynamicQuant;
     hSize_ = axisH_ * sizeof(XType);
@@ -369,6 +380,9 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::QuantProc
 
         SyncFunc<AscendC::HardEvent::V_S>();
         dynamicScale = float(127.0) / rowMaxTensor_.GetValue(0);
+        if (isRoundScale_) {
+            dynamicScale = RoundDownToPow2(dynamicScale);
+        }
         SyncFunc<AscendC::HardEvent::S_V>();
         Muls(floatLocalTemp, floatLocalTemp, dynamicScale, axisH_);
         PipeBarrier<PIPE_V>();
@@ -820,6 +834,7 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::WaitDispa
     for (uint32_t rankId = startRankId; rankId < endRankId; rankId++) {
         int32_t statusFlag = 0;
         int32_t dataFlag = 0;
+        int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
         while (statusFlag != FLAG_VALUE) {
             DataCopy(statusTensor_[rankId * STATUS_ENTRY_COUNT],
                      windowInstatusTensor_[rankId * dataSizePerRank_ / sizeof(int32_t)], STATUS_ENTRY_COUNT);
@@ -842,10 +857,29 @@ __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::WaitDispa
             PipeBarrier<PIPE_MTE2>();
         }
         windowInstatusTensor_(dataFlagOffset) = 0;
+        if (isEnableDiagnose_) {
+            RecordWaitCost(rankId, systemCycleStart);
+        }
     }
     SyncAll<true>();
 }
 
+// Adds the time waited for the status and data of srcRankId to its slot of the stats
+template <TemplateMC2TypeA2Class>
+__aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::RecordWaitCost(uint32_t srcRankId,
+                                                                                     int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    LocalTensor<int32_t> costLt = tBuf_.GetWithOffset<int32_t>(BITS32_PER_BLOCK, baseBuffOffset_ + UB_ALIGN);
+    costLt.SetValue(0, durationTime);
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    DataCopyPad<int32_t>(waitRecvCostStatsGT_[srcRankId], costLt, costCopyOutParams);
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeA2Class>
 __aicore__ inline void MoeDistributeDispatchV2<TemplateMC2TypeA2Func>::GetStatusCumSum()
 {
@@ -171,6 +171,7 @@ private:
     uint32_t halfWinSize_{0};
     uint32_t serverNum{0};
     uint32_t expertTokenNumsType_{0};
+    bool isRoundScale_{false};
     uint32_t shareMemOffset_{0};
     uint32_t tokenUbSize_{0};
 
@@ -240,6 +241,7 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
     halfWinSize_ = totalWinSize_ / 2;
     WIN_SIZE = halfWinSize_ - STATUS_SIZE_LAYERED;
     expertTokenNumsType_ = tilingData.moeDistributeDispatchV2Info.expertTokenNumsType;
+    isRoundScale_ = tilingData.moeDistributeDispatchV2Info.isRoundScale;
     aivId_ = GetBlockIdx();
     expertIdsCnt_ = axisBS_ * axisK_;
     serverNum = worldSize_ / SERVER_RANK_SIZE;
@@ -893,6 +895,9 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
             SyncFunc<AscendC::HardEvent::V_S>();
             float maxVal = maxLt(resValOffset);
             dynamicScale = float(quantMax) / float(maxVal);
+            if (isRoundScale_) {
+                dynamicScale = RoundDownToPow2(dynamicScale);
+            }
             SyncFunc<AscendC::HardEvent::S_V>();
             Muls(tokenCastLt[i * axisH_], tokenCastLt[i * axisH_], dynamicScale, axisH_);
             PipeBarrier<PIPE_V>();
@@ -58,6 +58,7 @@ public:
     constexpr static uint32_t FINISH_STATUS = 0;
     constexpr static uint32_t WAIT_STATUS = 1;
     constexpr static uint32_t ARRIVAL_STATUS = 2;
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
     constexpr static uint32_t SKIP_STATUS = 3;
     constexpr static uint32_t EXTRA_TOKEN_INFO_NUM = 4U;  // 专家信息 权重信息 量化Scale 到达标志位
     constexpr static uint32_t NOTIFY_DATA_SIZE = 400U * 1024U * 1024U;
@@ -84,8 +85,8 @@ public:
     __aicore__ inline MoeDistributeDispatchV2Layered(){};
     __aicore__ inline void Init(GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR expandXOut,
                                 GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut,
-                                GM_ADDR epRecvCountsOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM,
-                                GM_ADDR contextGM0);
+                                GM_ADDR epRecvCountsOut, GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM,
+                                TPipe *pipe, GM_ADDR tilingGM, GM_ADDR contextGM0);
     __aicore__ inline void Process();
 
 private:
@@ -96,6 +97,7 @@ private:
     __aicore__ inline void Win2Ipc();
     __aicore__ inline void Ipc2Out();
     __aicore__ inline void WaitIpcFlag(int32_t flagVal = 1);
+    __aicore__ inline void RecordWaitCost(uint32_t srcRankId, int64_t systemCycleStart);
     __aicore__ inline void SetIpcFlag(int32_t flagVal = 1);
     __aicore__ inline void CleanUp();
 
@@ -120,6 +122,7 @@ private:
     GlobalTensor<uint32_t> expertToServerGlobalTensor_;
     GlobalTensor<uint64_t> readStatusTensor_;
     GlobalTensor<uint64_t> tokenAddrFlagStructGlobalU64Tensor_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
 
     LocalTensor<int32_t> expertCountTensor_;
     LocalTensor<int16_t> expertIdsI16Tensor_;
@@ -172,6 +175,8 @@ private:
     uint32_t halfWinSize_{0};
     uint32_t serverNum{0};
     uint32_t expertTokenNumsType_{0};
+    bool isRoundScale_{false};
+    bool isEnableDiagnose_{false};
     uint32_t shareMemOffset_{0};
     uint32_t tokenUbSize_{0};
 
@@ -206,8 +211,8 @@ private:
 template <TemplateMC2TypeA2layeredClass>
 __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFunc>::Init(
     GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR expandXOut, GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut,
-    GM_ADDR expertTokenNumsOut, GM_ADDR epRecvCountsOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM,
-    GM_ADDR contextGM0)
+    GM_ADDR expertTokenNumsOut, GM_ADDR epRecvCountsOut, GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM,
+    TPipe *pipe, GM_ADDR tilingGM, GM_ADDR contextGM0)
 {
     tpipe_ = pipe;
     REGISTER_TILING_DEFAULT(MoeDistributeDispatchV2TilingData);
@@ -241,6 +246,11 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
     halfWinSize_ = totalWinSize_ / 2;
     WIN_SIZE = halfWinSize_ - STATUS_SIZE_LAYERED;
     expertTokenNumsType_ = tilingData.moeDistributeDispatchV2Info.expertTokenNumsType;
+    isRoundScale_ = tilingData.moeDistributeDispatchV2Info.isRoundScale;
+    isEnableDiagnose_ = tilingData.moeDistributeDispatchV2Info.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStatsOut);
+    }
     aivId_ = GetBlockIdx();
     expertIdsCnt_ = axisBS_ * axisK_;
     serverNum = worldSize_ / SERVER_RANK_SIZE;
@@ -902,6 +912,9 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
             SyncFunc<AscendC::HardEvent::V_S>();
             float maxVal = maxLt(resValOffset);
             dynamicScale = float(quantMax) / float(maxVal);  // 根据 token绝对值的最大值 计算出动态量化scale值
+            if (isRoundScale_) {
+                dynamicScale = RoundDownToPow2(dynamicScale);
+            }
             SyncFunc<AscendC::HardEvent::S_V>();
             Muls(tokenCastLt[i * axisH_], tokenCastLt[i * axisH_], dynamicScale, axisH_);  // 对token量化
             PipeBarrier<PIPE_V>();
@@ -1006,6 +1019,7 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
     GlobalTensor<uint64_t> flagIpcGt;
     flagIpcGt.SetGlobalBuffer((__gm__ uint64_t *)(shareAddrs[localRankId] + IPC_FLAG_OFFSET) +
                               destRankIdx * B64_PER_BLOCK);
+    int64_t systemCycleStart = isEnableDiagnose_ ? GetSystemCycle() : 0;
     PipeBarrier<PIPE_ALL>();
     do {
         DataCopy(localWait, flagIpcGt, B64_PER_BLOCK);
@@ -1016,6 +1030,26 @@ __aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFu
             break;
         }
     } while (isSync);
+    if (isEnableDiagnose_) {
+        // core aivId_ waits for the rank with local index aivId_ on this server
+        RecordWaitCost(rankId_ / SERVER_RANK_SIZE * SERVER_RANK_SIZE + destRankIdx, systemCycleStart);
+    }
+}
+
+// Adds the time waited for srcRankId to its slot of the stats, every core waits for a different rank
+template <TemplateMC2TypeA2layeredClass>
+__aicore__ inline void MoeDistributeDispatchV2Layered<TemplateMC2TypeA2layeredFunc>::RecordWaitCost(
+    uint32_t srcRankId, int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    LocalTensor<int32_t> costLt = tBuf.GetWithOffset<int32_t>(EXP_TOKEN_COUNT_FLAG_CNT, UB_32B_ALIGN);
+    costLt.SetValue(0, durationTime);
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    DataCopyPad<int32_t>(waitRecvCostStatsGT_[srcRankId], costLt, costCopyOutParams);
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
 }
 
 template <TemplateMC2TypeA2layeredClass>
@@ -50,6 +50,7 @@ public:
     constexpr static uint64_t SCALE_EXPAND_IDX_BUFFER = 44UL;  // scale32B + 3*4expandIdx
     constexpr static uint64_t DOUBLE_DATA_BUFFER = 2UL;
     constexpr static uint64_t MAX_OUT_DTYPE_SIZE = 2UL;
+    constexpr static int64_t CYCLE_TO_TIME = 50;  // cycle num is converted into a fixed base unit of time, set at 50
 
     template <AscendC::HardEvent event>
     __aicore__ inline void SyncFunc()
@@ -63,8 +64,8 @@ public:
     __aicore__ inline MoeDistributeDispatchV2Single(){};
     __aicore__ inline void Init(GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR expandXOut,
                                 GM_ADDR dynamicScalesOut, GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut,
-                                GM_ADDR sendCountsOut, GM_ADDR tpSendCountsOut, GM_ADDR workspaceGM, TPipe *pipe,
-                                GM_ADDR tilingGM);
+                                GM_ADDR sendCountsOut, GM_ADDR tpSendCountsOut, GM_ADDR waitRecvCostStatsOut,
+                                GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM);
     __aicore__ inline void Process();
 
 private:
@@ -81,6 +82,8 @@ private:
     __aicore__ inline void SetStatus();
     __aicore__ inline void BufferInit();
     __aicore__ inline void WaitDispatch();
+    __aicore__ inline void RecordWaitCost(int64_t systemCycleStart);
+    __aicore__ inline void CopyOutWaitCost();
     __aicore__ inline void GetCumSum(LocalTensor<int32_t> &outLocal, uint32_t totalCount);
     __aicore__ inline void AllGatherSetStatusAndWait();
     __aicore__ inline void QuantInit(GM_ADDR scales);
@@ -138,6 +141,7 @@ private:
     GlobalTensor<ExpandXOutType> windowInQuantTensor_;
     GlobalTensor<int32_t> windowInstatusTensor_;
     GlobalTensor<float> windowInstatusFp32Tensor_;
+    GlobalTensor<int32_t> waitRecvCostStatsGT_;
     GlobalTensor<bool> xActiveMaskGMTensor_;
     GlobalTensor<ExpandXOutType> winTpGatherOutGMTensor_;
     GlobalTensor<float> fpWinTpGatherOutGMTensor_;
@@ -153,6 +157,7 @@ private:
     LocalTensor<float> rowMaxTensor_;
     LocalTensor<int32_t> statusTensor_;
     LocalTensor<float> statusFp32Tensor_;
+    LocalTensor<int32_t> waitCostTensor_;
     LocalTensor<float> smoothScalesTensor_;
     LocalTensor<int32_t> dstExpIdTensor_;
     LocalTensor<int32_t> subExpIdTensor_;
@@ -174,6 +179,7 @@ private:
     TBuf<> dstExpBuf_;
     TBuf<> subExpBuf_;
     TBuf<> waitStatusBuf_;
+    TBuf<> waitCostBuf_;
     TBuf<> workLocalBuf_;
     TBuf<> maskBuf_;
     TBuf<> vaildExpertsBuf_;
@@ -238,6 +244,8 @@ private:
     uint64_t sendToMoeExpTokenCnt_{0};
     bool isTokenMaskFlag_ = false;
     bool isExpertMaskFlag_ = false;
+    bool isRoundScale_ = false;
+    bool isEnableDiagnose_ = false;
     float sumTarget_;
     uint64_t totalWinSize_{0};
     uint32_t gatherCount_{0};
@@ -264,7 +272,7 @@ template <TemplateMC2TypeA2SingleClass>
 __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc>::Init(
     GM_ADDR x, GM_ADDR expertIds, GM_ADDR scales, GM_ADDR xActiveMask, GM_ADDR expandXOut, GM_ADDR dynamicScalesOut,
     GM_ADDR expandIdxOut, GM_ADDR expertTokenNumsOut, GM_ADDR sendCountsOut, GM_ADDR tpSendCountsOut,
-    GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
+    GM_ADDR waitRecvCostStatsOut, GM_ADDR workspaceGM, TPipe *pipe, GM_ADDR tilingGM)
 {
     CAM_PRINT("[Init] enter init...\n");
     // return;
@@ -316,6 +324,7 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
     tpRankId_ = tilingData.moeDistributeDispatchV2Info.tpRankId;
     tpGatherRankId_ = ((tpRankId_ == 0) ? 1 : 0);
     isTokenMaskFlag_ = tilingData.moeDistributeDispatchV2Info.isTokenMask;
+    isRoundScale_ = tilingData.moeDistributeDispatchV2Info.isRoundScale;
     isExpertMaskFlag_ = tilingData.moeDistributeDispatchV2Info.isExpertMask;
     axisK_ = tilingData.moeDistributeDispatchV2Info.k;
     aivNum_ = tilingData.moeDistributeDispatchV2Info.aivNum;
@@ -330,6 +339,10 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
     sendCountsOutGM_ = sendCountsOut;  // 无GlobalTensor
     sendTpCountOutGM_ = tpSendCountsOut;
     recvCntWorkspaceGM_ = workspaceGM;
+    isEnableDiagnose_ = tilingData.moeDistributeDispatchV2Info.isEnableDiagnose;
+    if (isEnableDiagnose_) {
+        waitRecvCostStatsGT_.SetGlobalBuffer((__gm__ int32_t *)waitRecvCostStatsOut);
+    }
 
     hOutSize_ = axisH_ * sizeof(ExpandXOutType);
     hOutSizeAlign_ = Ceil(hOutSize_, UB_ALIGN) * UB_ALIGN;  // scale起始放置偏移
@@ -934,6 +947,9 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
 
         SyncFunc<AscendC::HardEvent::V_S>();
         dynamicScale = float(127.0) / floatLocalAbsTemp.GetValue(0);
+        if (isRoundScale_) {
+            dynamicScale = RoundDownToPow2(dynamicScale);
+        }
         SyncFunc<AscendC::HardEvent::S_V>();
         Muls(floatLocalTemp, floatLocalTemp, dynamicScale, axisH_);
         PipeBarrier<PIPE_V>();
@@ -1009,6 +1025,9 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
     tpipe_->InitBuffer(sumContinueBuf_, aivNum_ * sizeof(float));             // 48 * 4B
     tpipe_->InitBuffer(scalarBuf_, UB_ALIGN * 3);                             // 96B
     tpipe_->InitBuffer(xQueue_, BUFFER_NUM, hOutAlignUbSize_);                // 7k*2 + 32 + 12
+    if (isEnableDiagnose_) {
+        tpipe_->InitBuffer(waitCostBuf_, waitStatusBufSize);  // 与状态位一一对应，每个32B
+    }
 }
 
 template <TemplateMC2TypeA2SingleClass>
@@ -1031,6 +1050,13 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
     float compareTarget = sumTarget_ * recStatusNumPerCore_;
     float sumOfFlag = static_cast<float>(-1.0);
     DataCopyParams intriParams{static_cast<uint16_t>(recStatusNumPerCore_), 1, 0, 0};
+    int64_t systemCycleStart = 0;
+    if (isEnableDiagnose_) {
+        waitCostTensor_ = waitCostBuf_.Get<int32_t>();
+        Duplicate<int32_t>(waitCostTensor_, -1, recStatusNumPerCore_ * UB_ALIGN / sizeof(int32_t));
+        SyncFunc<AscendC::HardEvent::V_S>();
+        systemCycleStart = GetSystemCycle();
+    }
     SyncFunc<AscendC::HardEvent::S_V>();
     while (sumOfFlag != compareTarget) {
         DataCopy(statusFp32Tensor_, windowInstatusFp32Tensor_[startStatusIndex_ * stateOffset_ / sizeof(float)],
@@ -1039,6 +1065,12 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
         ReduceSum(statusSumOutTensor, statusFp32Tensor_, gatherMaskOutTensor, mask, recStatusNumPerCore_, 1);
         SyncFunc<AscendC::HardEvent::V_S>();
         sumOfFlag = statusSumOutTensor.GetValue(0);
+        if (isEnableDiagnose_) {
+            RecordWaitCost(systemCycleStart);
+        }
+    }
+    if (isEnableDiagnose_) {
+        CopyOutWaitCost();
     }
     // 清状态
     SyncFunc<AscendC::HardEvent::MTE3_S>();
@@ -1218,6 +1250,36 @@ __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc
     DataCacheCleanAndInvalid<float, CacheLine::SINGLE_CACHE_LINE, DcciDst::CACHELINE_OUT>(tpwindowInstatusFp32Tensor_);
 }
 
+// Keeps the wait time of every status of this core the first time it is seen set
+template <TemplateMC2TypeA2SingleClass>
+__aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc>::RecordWaitCost(
+    int64_t systemCycleStart)
+{
+    int32_t durationTime = static_cast<int32_t>((GetSystemCycle() - systemCycleStart) / CYCLE_TO_TIME);  // us
+    for (uint32_t i = 0; i < recStatusNumPerCore_; i++) {
+        uint32_t offset = i * UB_ALIGN / sizeof(int32_t);
+        if (waitCostTensor_.GetValue(offset) < 0 && statusFp32Tensor_.GetValue(offset) == sumTarget_) {
+            waitCostTensor_.SetValue(offset, durationTime);
+        }
+    }
+    SyncFunc<AscendC::HardEvent::S_MTE2>();  // 下一轮读状态会覆盖statusFp32Tensor_
+}
+
+// Adds the wait time of every status to the slot of its source rank, several cores can add to the same slot
+template <TemplateMC2TypeA2SingleClass>
+__aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc>::CopyOutWaitCost()
+{
+    SyncFunc<AscendC::HardEvent::S_MTE3>();
+    AscendC::SetAtomicAdd<int32_t>();
+    DataCopyExtParams costCopyOutParams = {1U, static_cast<uint32_t>(sizeof(int32_t)), 0U, 0U, 0U};
+    for (uint32_t i = 0; i < recStatusNumPerCore_; i++) {
+        DataCopyPad<int32_t>(waitRecvCostStatsGT_[(startStatusIndex_ + i) % epWorldSize_],
+                             waitCostTensor_[i * UB_ALIGN / sizeof(int32_t)], costCopyOutParams);
+    }
+    AscendC::SetAtomicNone();
+    SyncFunc<AscendC::HardEvent::MTE3_S>();
+}
+
 template <TemplateMC2TypeA2SingleClass>
 __aicore__ inline void MoeDistributeDispatchV2Single<TemplateMC2TypeA2SingleFunc>::AllgatherProcessOut()
 {
@@ -41,9 +41,9 @@ struct MoeDistributeDispatchV2Info {
     bool isQuant;                  // whether quant or not
     bool isTokenMask;              // input active mask 1dims or not
     bool isExpertMask;             // input active mask 2dims or not
-    bool reserved1;                // reserved
+    bool isRoundScale;             // round dynamic quant scales up to powers of two
     bool reserved2;                // reserved
-    bool reserved3;                // reserved
+    bool isEnableDiagnose;         // whether record the wait cost per source rank or not
     uint64_t totalUbSize;          // totalUbSize
     uint64_t totalWinSize;
     uint32_t expertTokenNumsType;  // expert token nums type, support 0: cumsum mode, 1: count mode
@@ -6,6 +6,7 @@
 #include "deep_ep.hpp"
 #include "config.hpp"
 #include "event.hpp"
+#include "../utils/host_profiler.h"
 
 #ifndef TORCH_EXTENSION_NAME
 #define TORCH_EXTENSION_NAME deep_ep_cpp
@@ -23,18 +24,32 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
         .def("get_rdma_buffer_size_hint", &deep_ep::Config::get_rdma_buffer_size_hint);
     m.def("get_low_latency_rdma_size_hint", &deep_ep::get_low_latency_rdma_size_hint);
 
+    // EXEC_NPU_CMD statistics of this module, see torch.ops.npu.sgl_kernel_npu_stats for the sgl_kernel_npu ops
+    m.def("get_host_stats", []() { return host_utils::HostProfiler::Instance().Dump(); });
+    m.def("reset_host_stats", []() { host_utils::HostProfiler::Instance().Reset(); });
+    m.def("enable_host_stats", [](bool enable) { return host_utils::HostProfiler::Instance().Enable(enable); });
+
     pybind11::class_<deep_ep::EventHandle>(m, "EventHandle")
         .def(pybind11::init<>())
         .def("current_stream_wait", &deep_ep::EventHandle::current_stream_wait);
 
+    // opaque, only handed back from get_dispatch_layout to the matching dispatch
+    pybind11::class_<deep_ep::DispatchLayout>(m, "DispatchLayout");
+
+    // opaque, only handed back from dispatch to the matching combine
+    pybind11::class_<deep_ep::DispatchHandle>(m, "DispatchHandle");
+
     pybind11::class_<deep_ep::Buffer>(m, "Buffer")
         .def(pybind11::init<int, int, int64_t, int64_t, bool, std::string>())
+        .def_readwrite("combine_comm_quant", &deep_ep::Buffer::combine_comm_quant)
+        .def_readwrite("is_token_in_rank_bitmap", &deep_ep::Buffer::is_token_in_rank_bitmap)
         .def("is_available", &deep_ep::Buffer::is_available)
         .def("get_num_rdma_ranks", &deep_ep::Buffer::get_num_rdma_ranks)
         .def("get_rdma_rank", &deep_ep::Buffer::get_rdma_rank)
         .def("get_dispatch_layout", &deep_ep::Buffer::get_dispatch_layout)
         .def("get_notify_send_data", &deep_ep::Buffer::get_notify_send_data)
         .def("clean_low_latency_buffer", &deep_ep::Buffer::clean_low_latency_buffer)
+        .def("get_next_low_latency_combine_buffer", &deep_ep::Buffer::get_next_low_latency_combine_buffer)
         .def("intranode_dispatch", &deep_ep::Buffer::intranode_dispatch)
         .def("notify_verify", &deep_ep::Buffer::notify_verify)
         .def("intranode_combine", &deep_ep::Buffer::intranode_combine)
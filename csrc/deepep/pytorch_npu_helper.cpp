@@ -0,0 +1,176 @@
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#include "pytorch_npu_helper.hpp"
+
+thread_local char g_hashBuf[kHashBufSize];
+thread_local int g_hashOffset = 0;
+
+typedef void (*AddTensorAddrToCachedList)(void *addr);
+
+void AddParamToBuf(const at::Tensor &at_tensor)
+{
+    static const auto addTensorAddrToCachedListAddr = GetOpApiFuncAddr("AddTensorAddrToCachedList");
+    AddTensorAddrToCachedList addTensorAddrToCachedListFunc =
+        reinterpret_cast<AddTensorAddrToCachedList>(addTensorAddrToCachedListAddr);
+    if (!at_tensor.defined()) {
+        MEMCPY_TO_BUF(",", 1);
+        return;
+    }
+    // wrapped numbers are copied to a new device tensor on every call, their value is not part of the key
+    if (addTensorAddrToCachedListFunc == nullptr || at_tensor.unsafeGetTensorImpl()->is_wrapped_number()) {
+        g_hashOffset = kHashBufMaxSize;
+        return;
+    }
+    MEMCPY_TO_BUF(at_tensor.sizes().data(), at_tensor.sizes().size() * sizeof(int64_t));
+    auto st = at_tensor.scalar_type();
+    MEMCPY_TO_BUF(&st, sizeof(st));
+    MEMCPY_TO_BUF(",", 1);
+    MEMCPY_TO_BUF(at_tensor.strides().data(), at_tensor.strides().size() * sizeof(int64_t));
+    MEMCPY_TO_BUF(",", 1);
+    auto so = at_tensor.storage_offset();
+    MEMCPY_TO_BUF(&so, sizeof(so));
+    MEMCPY_TO_BUF(",", 1);
+    // the storage shape is part of the aclTensor built by ConvertType
+    int64_t storageLen = static_cast<int64_t>(at_tensor.storage().nbytes() / at_tensor.itemsize());
+    MEMCPY_TO_BUF(&storageLen, sizeof(storageLen));
+    addTensorAddrToCachedListFunc(const_cast<void *>(at_tensor.storage().data()));
+}
+
+void AddParamToBuf(const at::Scalar &at_scalar)
+{
+    at::ScalarType scalar_data_type = at_scalar.type();
+    switch (scalar_data_type) {
+        case at::ScalarType::Double: {
+            double value = at_scalar.toDouble();
+            MEMCPY_TO_BUF(&value, sizeof(double));
+            break;
+        }
+        case at::ScalarType::Long: {
+            int64_t value = at_scalar.toLong();
+            MEMCPY_TO_BUF(&value, sizeof(int64_t));
+            break;
+        }
+        case at::ScalarType::Bool: {
+            bool value = at_scalar.toBool();
+            MEMCPY_TO_BUF(&value, sizeof(bool));
+            break;
+        }
+        case at::ScalarType::ComplexDouble: {
+            auto value = at_scalar.toComplexDouble();
+            MEMCPY_TO_BUF(&value, sizeof(value));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void AddParamToBuf(const at::IntArrayRef &at_array)
+{
+    MEMCPY_TO_BUF(at_array.data(), at_array.size() * sizeof(int64_t));
+    MEMCPY_TO_BUF(",", 1);
+}
+
+void AddParamToBuf(const at::ArrayRef<bool> &at_array)
+{
+    MEMCPY_TO_BUF(at_array.data(), at_array.size() * sizeof(bool));
+    MEMCPY_TO_BUF(",", 1);
+}
+
+void AddParamToBuf(const at::TensorList &at_tensor_list)
+{
+    for (size_t i = 0; i < at_tensor_list.size(); i++) {
+        AddParamToBuf(at_tensor_list[i]);
+    }
+    auto counter = at_tensor_list.size();
+    MEMCPY_TO_BUF(&counter, sizeof(counter));
+}
+
+void AddParamToBuf(const c10::optional<at::Tensor> &opt_tensor)
+{
+    if (opt_tensor.has_value() && opt_tensor.value().defined()) {
+        AddParamToBuf(opt_tensor.value());
+    } else {
+        MEMCPY_TO_BUF(",", 1);
+    }
+}
+
+void AddParamToBuf(const c10::optional<at::IntArrayRef> &opt_array)
+{
+    if (opt_array.has_value()) {
+        AddParamToBuf(opt_array.value());
+    } else {
+        MEMCPY_TO_BUF(",", 1);
+    }
+}
+
+void AddParamToBuf(const c10::optional<at::Scalar> &opt_scalar)
+{
+    if (opt_scalar.has_value()) {
+        AddParamToBuf(opt_scalar.value());
+    } else {
+        MEMCPY_TO_BUF(",", 1);
+    }
+}
+
+void AddParamToBuf(const at::ScalarType scalar_type)
+{
+    MEMCPY_TO_BUF(&scalar_type, sizeof(scalar_type));
+}
+
+void AddParamToBuf(const std::string &s)
+{
+    MEMCPY_TO_BUF(s.c_str(), s.size() + 1);
+}
+
+void AddParamToBuf() {}
+
+uint64_t CalcHashId()
+{
+    if (g_hashOffset == kHashBufMaxSize) {
+        return 0;
+    }
+    uint64_t hashId = std::hash<std::string_view>{}(std::string_view(g_hashBuf, g_hashOffset));
+    // 0 means "no key" for opapi
+    return hashId == 0 ? 1 : hashId;
+}
+
+bool IsExecCacheEnabled()
+{
+    static const bool disabled = [] {
+        const char *env = std::getenv("DEEPEP_DISABLE_ACLNN_CACHE");
+        return env != nullptr && std::string(env) == "1";
+    }();
+    if (disabled) {
+        return false;
+    }
+    // executors captured into a graph keep the addresses of the capture, do not share them with eager launches
+    return c10_npu::currentStreamCaptureStatusMayInitCtx() == c10_npu::CaptureStatus::None;
+}
+
+void *GetStreamWorkspace(uint64_t workspace_size)
+{
+    at::TensorOptions options = at::TensorOptions(torch_npu::utils::get_npu_device_type()).dtype(c10::kByte);
+    // memory allocated while capturing belongs to the graph pool, never keep it beyond the captured op
+    if (c10_npu::currentStreamCaptureStatusMayInitCtx() != c10_npu::CaptureStatus::None) {
+        auto workspace_tensor = at::empty({static_cast<int64_t>(workspace_size)}, options);
+        return const_cast<void *>(workspace_tensor.storage().data());
+    }
+
+    static std::mutex mutex;
+    static std::map<std::pair<int, aclrtStream>, at::Tensor> *workspaces =
+        new std::map<std::pair<int, aclrtStream>, at::Tensor>();
+    auto stream = c10_npu::getCurrentNPUStream();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_pair(static_cast<int>(stream.device_index()), stream.stream(false));
+    at::Tensor &workspace = (*workspaces)[key];
+    if (!workspace.defined() || static_cast<uint64_t>(workspace.numel()) < workspace_size) {
+        // ops of one stream run in order, the old buffer goes back to the caching allocator behind them
+        workspace = at::empty({static_cast<int64_t>(workspace_size)}, options.device(stream.device()));
+    }
+    return const_cast<void *>(workspace.storage().data());
+}
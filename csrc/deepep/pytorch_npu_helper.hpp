@@ -9,17 +9,20 @@
 #include <dlfcn.h>
 #include <torch_npu/csrc/framework/utils/CalcuOpUtil.h>
 #include <torch_npu/csrc/framework/utils/OpAdapter.h>
+#include <cstring>
 #include <iostream>
 #include <functional>
 #include <type_traits>
 #include <vector>
 
 #include "torch_npu/csrc/aten/NPUNativeFunctions.h"
+#include "torch_npu/csrc/core/npu/NPUGraphsUtils.h"
 #include "torch_npu/csrc/core/npu/NPUStream.h"
 #include "torch_npu/csrc/framework/OpCommand.h"
 #include "torch_npu/csrc/framework/interface/EnvVariables.h"
 #include "torch_npu/csrc/framework/utils/CalcuOpUtil.h"
 #include "torch_npu/csrc/framework/utils/OpPreparation.h"
+#include "../utils/host_profiler.h"
 
 #define NPU_NAME_SPACE at_npu::native
 
@@ -84,16 +87,12 @@ constexpr aclDataType kATenScalarTypeToAclDataTypeTable[static_cast<int64_t>(at:
 
 #define GET_OP_API_FUNC(apiName) reinterpret_cast<_##apiName>(GetOpApiFuncAddr(#apiName))
 
-#define MEMCPY_TO_BUF(data_expression, size_expression)                             \
-    if (g_hashOffset + (size_expression) > kHashBufSize) {                          \
-        g_hashOffset = kHashBufMaxSize;                                             \
-        return;                                                                     \
-    }                                                                               \
-    int ret = memcpy_s(g_hashBuf + g_hashOffset, data_expression, size_expression); \
-    if (ret != 0) {                                                                 \
-        ASCEND_LOGW("memcpy_s failed, ret = %d\n", ret);                            \
-        return;                                                                     \
-    }                                                                               \
+#define MEMCPY_TO_BUF(data_expression, size_expression)                      \
+    if (g_hashOffset + (size_expression) > kHashBufSize) {                   \
+        g_hashOffset = kHashBufMaxSize;                                      \
+        return;                                                              \
+    }                                                                        \
+    std::memcpy(g_hashBuf + g_hashOffset, data_expression, size_expression); \
     g_hashOffset += size_expression;
 
 inline const char *GetOpApiLibName(void)
@@ -485,18 +484,6 @@ auto call(Function f, Tuple t)
     return call(f, t, std::make_index_sequence<size>{});
 }
 
-template <std::size_t N>
-void AddParamToBuf(const std::array<bool, N> &value)
-{
-    MEMCPY_TO_BUF(value.data(), value.size() * sizeof(bool));
-}
-
-template <typename T>
-void AddParamToBuf(const T &value)
-{
-    MEMCPY_TO_BUF(&value, sizeof(T));
-}
-
 void AddParamToBuf(const at::Tensor &);
 void AddParamToBuf(const at::Scalar &);
 void AddParamToBuf(const at::IntArrayRef &);
@@ -506,11 +493,29 @@ void AddParamToBuf(const c10::optional<at::Tensor> &);
 void AddParamToBuf(const c10::optional<at::IntArrayRef> &);
 void AddParamToBuf(const c10::optional<at::Scalar> &);
 void AddParamToBuf(const at::ScalarType);
-void AddParamToBuf(const string &);
+void AddParamToBuf(const std::string &);
 void AddParamToBuf();
 
+template <std::size_t N>
+void AddParamToBuf(const std::array<bool, N> &value)
+{
+    MEMCPY_TO_BUF(value.data(), value.size() * sizeof(bool));
+}
+
+template <typename T>
+void AddParamToBuf(const T &value)
+{
+    if constexpr (std::is_convertible_v<const T &, const char *>) {
+        // group names and algorithm names are passed as C strings, hash the content instead of the address
+        const char *str = value;
+        MEMCPY_TO_BUF(str, std::strlen(str) + 1);
+    } else {
+        MEMCPY_TO_BUF(&value, sizeof(T));
+    }
+}
+
 template <typename T, typename... Args>
-void AddParamToBuf(const T &arg, Args &...args)
+void AddParamToBuf(const T &arg, const Args &...args)
 {
     AddParamToBuf(arg);
     AddParamToBuf(args...);
@@ -520,6 +525,75 @@ uint64_t CalcHashId();
 typedef int (*InitHugeMemThreadLocal)(void *, bool);
 typedef void (*UnInitHugeMemThreadLocal)(void *, bool);
 typedef void (*ReleaseHugeMem)(void *, bool);
+typedef aclOpExecutor *(*PTAGetExecCache)(uint64_t, uint64_t *);
+typedef void (*InitPTACacheThreadLocal)();
+typedef void (*SetPTAHashKey)(uint64_t);
+typedef bool (*CanUsePTACache)(const char *);
+
+// Executor cache of opapi: an executor built by aclnnXxxGetWorkspaceSize while a hash key is set is kept by
+// opapi and handed back for the same key, with the tensor addresses collected by AddParamToBuf patched in.
+// Set DEEPEP_DISABLE_ACLNN_CACHE=1 to always rebuild the executor.
+bool IsExecCacheEnabled();
+
+// Workspace of the current stream, grown on demand and reused by every op launched on that stream.
+void *GetStreamWorkspace(uint64_t workspace_size);
+
+template <typename... Ts>
+bool HitExecCache(aclrtStream acl_stream, const char *aclnn_api, void *opApiFuncAddr, const Ts &...args)
+{
+    static const auto ptaGetExecCacheAddr = GetOpApiFuncAddr("PTAGetExecCache");
+    static const auto initPTACacheThreadLocalAddr = GetOpApiFuncAddr("InitPTACacheThreadLocal");
+    static const auto setPTAHashKeyAddr = GetOpApiFuncAddr("SetPTAHashKey");
+    static const auto canUsePTACacheAddr = GetOpApiFuncAddr("CanUsePTACache");
+    PTAGetExecCache ptaGetExecCacheFunc = reinterpret_cast<PTAGetExecCache>(ptaGetExecCacheAddr);
+    InitPTACacheThreadLocal initPTACacheThreadLocalFunc =
+        reinterpret_cast<InitPTACacheThreadLocal>(initPTACacheThreadLocalAddr);
+    SetPTAHashKey setPTAHashKeyFunc = reinterpret_cast<SetPTAHashKey>(setPTAHashKeyAddr);
+    CanUsePTACache canUsePTACacheFunc = reinterpret_cast<CanUsePTACache>(canUsePTACacheAddr);
+    if (initPTACacheThreadLocalFunc == nullptr || setPTAHashKeyFunc == nullptr) {
+        return false;
+    }
+    // reset the key left by the previous op so that a miss below never stores an executor under a stale key
+    initPTACacheThreadLocalFunc();
+    setPTAHashKeyFunc(0);
+    bool canUse = ptaGetExecCacheFunc != nullptr && canUsePTACacheFunc != nullptr && canUsePTACacheFunc(aclnn_api);
+    if (!canUse || !IsExecCacheEnabled()) {
+        return false;
+    }
+
+    g_hashOffset = 0;
+    AddParamToBuf(std::string(aclnn_api));
+    AddParamToBuf(args...);
+    uint64_t hashId = CalcHashId();
+    if (hashId == 0) {
+        return false;
+    }
+    setPTAHashKeyFunc(hashId);
+    uint64_t workspace_size = 0;
+    aclOpExecutor *executor = ptaGetExecCacheFunc(hashId, &workspace_size);
+    if (executor == nullptr) {
+        return false;
+    }
+
+    void *workspace_addr = nullptr;
+    if (workspace_size != 0) {
+        host_utils::HostProfileScope profile_scope(aclnn_api, host_utils::HostStage::WORKSPACE);
+        workspace_addr = GetStreamWorkspace(workspace_size);
+    }
+    auto acl_call = [workspace_addr, workspace_size, acl_stream, executor, opApiFuncAddr, aclnn_api]() -> int {
+        typedef int (*OpApiFunc)(void *, uint64_t, aclOpExecutor *, const aclrtStream);
+        OpApiFunc opApiFunc = reinterpret_cast<OpApiFunc>(opApiFuncAddr);
+        auto api_ret = opApiFunc(workspace_addr, workspace_size, executor, acl_stream);
+        TORCH_CHECK(api_ret == 0, "call ", aclnn_api, " failed, detail:", aclGetRecentErrMsg());
+        return api_ret;
+    };
+    host_utils::HostProfileScope profile_scope(aclnn_api, host_utils::HostStage::LAUNCH);
+    at_npu::native::OpCommand cmd;
+    cmd.Name(aclnn_api);
+    cmd.SetCustomHandler(acl_call);
+    cmd.Run();
+    return true;
+}
 
 #define EXEC_NPU_CMD(aclnn_api, ...)                                                                              \
     do {                                                                                                          \
@@ -532,6 +606,9 @@ typedef void (*ReleaseHugeMem)(void *, bool);
                     #aclnn_api "GetWorkspaceSize", " not in ", GetOpApiLibName(), ", or ", GetOpApiLibName(),     \
                     "not found.");                                                                                \
         auto acl_stream = c10_npu::getCurrentNPUStream().stream(false);                                           \
+        if (HitExecCache(acl_stream, #aclnn_api, opApiFuncAddr, __VA_ARGS__)) {                                   \
+            break;                                                                                                \
+        }                                                                                                         \
         uint64_t workspace_size = 0;                                                                              \
         uint64_t *workspace_size_addr = &workspace_size;                                                          \
         aclOpExecutor *executor = nullptr;                                                                        \
@@ -543,13 +620,16 @@ typedef void (*ReleaseHugeMem)(void *, bool);
         }                                                                                                         \
         auto converted_params = ConvertTypes(__VA_ARGS__, workspace_size_addr, executor_addr);                    \
         static auto getWorkspaceSizeFunc = ConvertToOpApiFunc(converted_params, getWorkspaceSizeFuncAddr);        \
-        auto workspace_status = call(getWorkspaceSizeFunc, converted_params);                                     \
+        int workspace_status = 0;                                                                                 \
+        {                                                                                                         \
+            host_utils::HostProfileScope profile_scope(#aclnn_api, host_utils::HostStage::TILING);                \
+            workspace_status = call(getWorkspaceSizeFunc, converted_params);                                      \
+        }                                                                                                         \
         TORCH_CHECK(workspace_status == 0, "call " #aclnn_api " failed, detail:", aclGetRecentErrMsg());          \
         void *workspace_addr = nullptr;                                                                           \
         if (workspace_size != 0) {                                                                                \
-            at::TensorOptions options = at::TensorOptions(torch_npu::utils::get_npu_device_type());               \
-            auto workspace_tensor = at::empty({static_cast<int64_t>(workspace_size)}, options.dtype(c10::kByte)); \
-            workspace_addr = const_cast<void *>(workspace_tensor.storage().data());                               \
+            host_utils::HostProfileScope profile_scope(#aclnn_api, host_utils::HostStage::WORKSPACE);             \
+            workspace_addr = GetStreamWorkspace(workspace_size);                                                  \
         }                                                                                                         \
         auto acl_call = [converted_params, workspace_addr, workspace_size, acl_stream, executor]() -> int {       \
             typedef int (*OpApiFunc)(void *, uint64_t, aclOpExecutor *, const aclrtStream);                       \
@@ -563,10 +643,13 @@ typedef void (*ReleaseHugeMem)(void *, bool);
             }                                                                                                     \
             return api_ret;                                                                                       \
         };                                                                                                        \
-        at_npu::native::OpCommand cmd;                                                                            \
-        cmd.Name(#aclnn_api);                                                                                     \
-        cmd.SetCustomHandler(acl_call);                                                                           \
-        cmd.Run();                                                                                                \
+        {                                                                                                         \
+            host_utils::HostProfileScope profile_scope(#aclnn_api, host_utils::HostStage::LAUNCH);                \
+            at_npu::native::OpCommand cmd;                                                                        \
+            cmd.Name(#aclnn_api);                                                                                 \
+            cmd.SetCustomHandler(acl_call);                                                                       \
+            cmd.Run();                                                                                            \
+        }                                                                                                         \
         if (unInitMemFunc) {                                                                                      \
             unInitMemFunc(nullptr, false);                                                                        \
         }                                                                                                         \
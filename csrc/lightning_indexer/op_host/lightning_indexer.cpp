@@ -10,12 +10,13 @@
 #include "common_tiling.h"
 #include "lightning_indexer_def.h"
 #include "common.h"
+#include "tiling_cache.h"
+#include "workspace_arena.h"
 #include "aclrtlaunch_lightning_indexer.h"
 
 namespace sglang::LIHost {
 
 using namespace ge_helper;
-constexpr uint32_t MAX_CAPTURE_NUM = 1024;
 constexpr uint32_t MAX_DECODE_BS = 512;
 // npu tensor max size
 constexpr int SIZE = 8;
@@ -24,11 +25,6 @@ constexpr int DIM_1 = 1;
 constexpr int DIM_2 = 2;
 constexpr int DIM_3 = 3;
 
-// namespace scope global parameters
-uint32_t actualCaptureNum = 0;
-static std::unordered_map<uint64_t, uint32_t> captureMap;
-// at::Tensor workspace;
-
 inline at::Tensor ConstructLightningIndexerOutputTensor(const at::Tensor &query, const at::Tensor &key,
                                                         const c10::optional<at::Tensor> &actual_seq_lengths_query,
                                                         int64_t sparse_count, std::string query_layout_str,
@@ -68,8 +64,6 @@ HOST_API at::Tensor lightning_indexer(const at::Tensor &query, const at::Tensor
 {
     using namespace LIHost;
     LightningIndexer indexer("lightning_indexer");
-    auto context = std::make_shared<TilingContext>("lightning_indexer");
-    TORCH_CHECK(context != nullptr, "TilingContext is null");
 
     std::string layoutQuery(indexer.GetAttr(ATTR_QUERY_LAYOUT_INDEX).GetString());
     std::string layoutKey(indexer.GetAttr(ATTR_KEY_LAYOUT_INDEX).GetString());
@@ -111,58 +105,36 @@ HOST_API at::Tensor lightning_indexer(const at::Tensor &query, const at::Tensor
             ? block_table.value()
             : at::empty({1}, at::TensorOptions().dtype(qScalarType).device(query.options().device()));
 
-    indexer.SetToContext(context, qScalarType);
-    context->RegisterTensor(query, true);
-    context->RegisterTensor(key, true);
-    context->RegisterTensor(weights, true);
-    context->RegisterTensor(actual_seq_lengths_query, true);
-    context->RegisterTensor(actual_seq_lengths_key, true);
-    context->RegisterTensor(block_table, true);
-    context->RegisterTensor(sparse_indices, false);
-
-    LITilingInfo liInfo;
-    LIInfoParser LIInfoParser(context.get());
-    TORCH_CHECK(LIInfoParser.ParseAndCheck(liInfo) == ge::GRAPH_SUCCESS, "lightning_indexer ParseAndCheck failed")
-
-    LightningIndexerTiling liTiling(context.get());
-    liTiling.DoTiling(&liInfo);
-    const auto &tilingData = liTiling.GetTilingData();
-
-    uint32_t tilingSize = sizeof(LITilingData);
-    auto blockDim = tilingData.usedCoreNum;
-    auto bs = tilingData.bSize;
-    at::Tensor tilingTensor;
-
-    auto tup =
-        std::make_tuple(tilingData.bSize, tilingData.n2Size, tilingData.gSize, tilingData.s1Size, tilingData.s2Size,
-                        tilingData.blockSize, tilingData.maxBlockNumPerBatch, tilingData.tilingKey);
-    auto hashValue = host_utils::TupleHasher::Hash(tup);
-
-    static auto globalTilingBuffer = at::empty({tilingSize * MAX_CAPTURE_NUM},
-                                               at::TensorOptions().dtype(at::kByte).device(query.options().device()));
-
-    if (captureMap.find(hashValue) != captureMap.end()) {
-        // For decode replay phase and part of prefill phase, get cached tiling data from globalTilingBuffer
-        tilingTensor = at::from_blob(globalTilingBuffer.data_ptr<uint8_t>() + (tilingSize * captureMap[hashValue]),
-                                     tilingSize, at::kByte);
-    } else if (actualCaptureNum >= MAX_CAPTURE_NUM) {
-        // For tiling hash that not exist in capture map and exceeds MAX_CAPTURE_NUM, reload its' tiling data to NPU
-        static auto tilingBuffer =
-            at::empty({tilingSize}, at::TensorOptions().dtype(at::kByte).device(query.options().device()));
-        aclrtMemcpy(tilingBuffer.data_ptr<uint8_t>(), tilingSize, &tilingData, tilingSize, ACL_MEMCPY_HOST_TO_DEVICE);
-        tilingTensor = at::from_blob(tilingBuffer.data_ptr<uint8_t>(), tilingSize, at::kByte);
-    } else {
-        // Captured tiling cached here
-        captureMap[hashValue] = actualCaptureNum;
-        aclrtMemcpy(globalTilingBuffer.data_ptr<uint8_t>() + actualCaptureNum * tilingSize, tilingSize, &tilingData,
-                    tilingSize, ACL_MEMCPY_HOST_TO_DEVICE);
-        actualCaptureNum++;
-        tilingTensor = at::from_blob(globalTilingBuffer.data_ptr<uint8_t>() + (tilingSize * captureMap[hashValue]),
-                                     tilingSize, at::kByte);
-    }
-
-    size_t workspaceSize = context->GetWorkspaceSize();
-    auto workspace = at::empty({workspaceSize}, at::TensorOptions().dtype(at::kByte).device(query.options().device()));
+    TilingCacheKey cacheKey("lightning_indexer", query, key, weights, actual_seq_lengths_query,
+                            actual_seq_lengths_key, block_table, layoutQuery, layoutKey, sparseCount,
+                            sparse_mode.value_or(-1));
+    TilingCacheEntry tiling = TilingCache::Instance().GetOrCreate(cacheKey, [&](TilingCacheEntry &entry) {
+        auto context = std::make_shared<TilingContext>("lightning_indexer");
+        TORCH_CHECK(context != nullptr, "TilingContext is null");
+        indexer.SetToContext(context, qScalarType);
+        context->RegisterTensor(query, true);
+        context->RegisterTensor(key, true);
+        context->RegisterTensor(weights, true);
+        context->RegisterTensor(actual_seq_lengths_query, true);
+        context->RegisterTensor(actual_seq_lengths_key, true);
+        context->RegisterTensor(block_table, true);
+        context->RegisterTensor(sparse_indices, false);
+
+        LITilingInfo liInfo;
+        LIInfoParser LIInfoParser(context.get());
+        TORCH_CHECK(LIInfoParser.ParseAndCheck(liInfo) == ge::GRAPH_SUCCESS, "lightning_indexer ParseAndCheck failed")
+
+        LightningIndexerTiling liTiling(context.get());
+        liTiling.DoTiling(&liInfo);
+        const auto &tilingData = liTiling.GetTilingData();
+        entry.blockDim = tilingData.usedCoreNum;
+        entry.workspaceSize = context->GetWorkspaceSize();
+        return TilingCache::HostBuffer(tilingData);
+    });
+    uint32_t blockDim = tiling.blockDim;
+    at::Tensor tilingTensor = tiling.tiling;
+
+    auto workspace = WorkspaceArena::Instance().Borrow(query.device(), tiling.workspaceSize);
     EXEC_KERNEL_CMD(lightning_indexer, blockDim, query, key, weights, actualSeqLengthsQuery, actualSeqLengthsKey,
                     blockTable, sparse_indices, workspace, tilingTensor);
     return sparse_indices;
@@ -0,0 +1,117 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "defines.h"
+#include "torch_helper.h"
+#include "tiling_cache.h"
+#include "matmul_tuning_db.h"
+#include "../../batch_matmul_transpose/op_host/tiling/tiling_tuning.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+// defined next to the MLA preprocess matmul tiling
+std::vector<host_utils::MatmulTuningValue> GetMlaMatmulTuningCandidates(const host_utils::MatmulTuningKey &key);
+
+constexpr size_t TUNING_KEY_FIELDS = sizeof(host_utils::MatmulTuningKey) / sizeof(uint32_t);
+constexpr size_t TUNING_VALUE_FIELDS = 5;  // m0, n0, k0, swizzleCount, swizzleDirect
+
+static host_utils::MatmulTuningKey ToTuningKey(c10::IntArrayRef key)
+{
+    TORCH_CHECK(key.size() == TUNING_KEY_FIELDS, "matmul tuning key must have ", TUNING_KEY_FIELDS, " fields");
+    host_utils::MatmulTuningKey tuningKey;
+    tuningKey.op = static_cast<uint32_t>(key[0]);
+    tuningKey.coreNum = static_cast<uint32_t>(key[1]);
+    tuningKey.batchSize = static_cast<uint32_t>(key[2]);
+    tuningKey.m = static_cast<uint32_t>(key[3]);
+    tuningKey.k = static_cast<uint32_t>(key[4]);
+    tuningKey.n = static_cast<uint32_t>(key[5]);
+    tuningKey.dtype = static_cast<uint32_t>(key[6]);
+    tuningKey.flags = static_cast<uint32_t>(key[7]);
+    return tuningKey;
+}
+
+HOST_API int64_t matmul_tuning_db_load(c10::string_view path)
+{
+    int64_t recordNum = host_utils::MatmulTuningDb::Instance().Load(std::string(path));
+    // tilings computed before the reload must be looked up again
+    TilingCache::Instance().Clear();
+    return recordNum;
+}
+
+HOST_API int64_t matmul_tuning_db_save(c10::string_view path)
+{
+    int64_t recordNum = host_utils::MatmulTuningDb::Instance().Save(std::string(path));
+    TORCH_CHECK(recordNum >= 0, "failed to write matmul tuning db ", path);
+    return recordNum;
+}
+
+HOST_API std::vector<int64_t> matmul_tuning_trace(bool enable)
+{
+    if (enable) {
+        // cached tilings would hide the shapes of the traced run
+        TilingCache::Instance().Clear();
+    }
+    std::vector<int64_t> keys;
+    for (const auto &key : host_utils::MatmulTuningDb::Instance().Trace(enable)) {
+        keys.insert(keys.end(), {key.op, key.coreNum, key.batchSize, key.m, key.k, key.n, key.dtype, key.flags});
+    }
+    return keys;
+}
+
+HOST_API std::vector<int64_t> matmul_tuning_candidates(c10::IntArrayRef key)
+{
+    host_utils::MatmulTuningKey tuningKey = ToTuningKey(key);
+    std::vector<host_utils::MatmulTuningValue> candidates;
+    switch (static_cast<host_utils::MatmulTuningOp>(tuningKey.op)) {
+        case host_utils::MatmulTuningOp::PP_MATMUL:
+            candidates = pp_matmul::GetPpMatmulTuningCandidates(tuningKey, pp_matmul::HardwareInfo());
+            break;
+        case host_utils::MatmulTuningOp::MLA_PREPROCESS_MM1:
+        case host_utils::MatmulTuningOp::MLA_PREPROCESS_MM2:
+        case host_utils::MatmulTuningOp::MLA_PREPROCESS_MM3:
+            candidates = GetMlaMatmulTuningCandidates(tuningKey);
+            break;
+        default:
+            TORCH_CHECK(false, "unknown matmul tuning op ", tuningKey.op);
+    }
+    std::vector<int64_t> values;
+    values.reserve(candidates.size() * TUNING_VALUE_FIELDS);
+    for (const auto &value : candidates) {
+        values.insert(values.end(), {value.m0, value.n0, value.k0, value.swizzleCount, value.swizzleDirect});
+    }
+    return values;
+}
+
+HOST_API void matmul_tuning_set(c10::IntArrayRef key, c10::IntArrayRef value, double time_us)
+{
+    host_utils::MatmulTuningKey tuningKey = ToTuningKey(key);
+    if (value.empty()) {
+        host_utils::MatmulTuningDb::Instance().Erase(tuningKey);
+    } else {
+        TORCH_CHECK(value.size() == TUNING_VALUE_FIELDS, "matmul tuning value must have ", TUNING_VALUE_FIELDS,
+                    " fields");
+        host_utils::MatmulTuningValue tuningValue;
+        tuningValue.m0 = static_cast<uint32_t>(value[0]);
+        tuningValue.n0 = static_cast<uint32_t>(value[1]);
+        tuningValue.k0 = static_cast<uint32_t>(value[2]);
+        tuningValue.swizzleCount = static_cast<uint32_t>(value[3]);
+        tuningValue.swizzleDirect = static_cast<uint32_t>(value[4]);
+        tuningValue.timeUs = static_cast<float>(time_us);
+        host_utils::MatmulTuningDb::Instance().Set(tuningKey, tuningValue);
+    }
+    TilingCache::Instance().Clear();
+}
+
+}  // namespace npu_kernel
+}  // namespace sglang
@@ -18,6 +18,9 @@
 #include "acl/acl.h"
 #include "defines.h"
 #include "torch_helper.h"
+#include "tiling_cache.h"
+#include "matmul_tuning_db.h"
+#include "workspace_arena.h"
 #include "tiling/platform/platform_ascendc.h"
 #include "tiling/mla_preprocess_tiling.h"
 
@@ -60,9 +63,6 @@ constexpr uint32_t INDEX_WDQKV = 5;
 constexpr uint32_t INDEX_WUQ = 18;
 constexpr uint32_t INDEX_WUK = 20;
 
-constexpr uint32_t MAX_SUPPORT_TOKEN_NUMS = 1024;
-constexpr uint32_t MAX_CACHE_MODE_NUMS = 3;
-
 inline uint32_t CeilDiv(const uint32_t dividend, const uint32_t divisor)
 {
     if (divisor == 0) {
@@ -134,8 +134,10 @@ class PpMatmulTilingApi
 {
 public:
     PpMatmulTilingApi(struct PlatformInfo &platformInfo, uint32_t numBatch, uint32_t m, uint32_t k, uint32_t n,
-                      bool transA, bool transB, bool enDequant, bool deqOnTheFly)
+                      bool transA, bool transB, bool enDequant, bool deqOnTheFly,
+                      host_utils::MatmulTuningOp tuningOp = host_utils::MatmulTuningOp::MLA_PREPROCESS_MM1)
         : platformInfo_(platformInfo),
+          tuningOp_(tuningOp),
           numBatch_(numBatch),
           m_(m),
           k_(k),
@@ -148,8 +150,11 @@ public:
         inDataSize_ = enDequant ? sizeof(uint8_t) : sizeof(uint16_t);
     }
     void GetTilingData(PpMatmulTilingData &tiling);
+    host_utils::MatmulTuningKey GetTuningKey() const;
+    host_utils::MatmulTuningLimits GetTuningLimits();
 
 private:
+    bool ApplyTuning();
     void GetTileSize();
     float GetCost(const uint32_t m0, const uint32_t n0);
     void UpdateTileSize(const uint32_t m0, const uint32_t n0);
@@ -184,6 +189,7 @@ private:
     bool deqOnTheFly_{false};
 
     struct PlatformInfo platformInfo_;
+    host_utils::MatmulTuningOp tuningOp_;
 };
 
 void PpMatmulTilingApi::GetTilingData(PpMatmulTilingData &tiling)
@@ -208,8 +214,62 @@ void PpMatmulTilingApi::GetTilingData(PpMatmulTilingData &tiling)
     tiling.b0matPingPongBufferLen = b0matPingPongBufferLen_;
 }
 
+host_utils::MatmulTuningKey PpMatmulTilingApi::GetTuningKey() const
+{
+    host_utils::MatmulTuningKey key;
+    key.op = static_cast<uint32_t>(tuningOp_);
+    key.coreNum = platformInfo_.coreNumAic;
+    key.batchSize = numBatch_;
+    key.m = m_;
+    key.k = k_;
+    key.n = n_;
+    key.dtype = inDataSize_;
+    key.flags = (transA_ ? host_utils::MATMUL_TUNING_TRANS_A : 0) | (transB_ ? host_utils::MATMUL_TUNING_TRANS_B : 0) |
+                (enDequant_ ? host_utils::MATMUL_TUNING_DEQUANT : 0) |
+                (deqOnTheFly_ ? host_utils::MATMUL_TUNING_DEQ_ON_THE_FLY : 0);
+    return key;
+}
+
+host_utils::MatmulTuningLimits PpMatmulTilingApi::GetTuningLimits()
+{
+    host_utils::MatmulTuningLimits limits;
+    limits.coreNum = platformInfo_.coreNumAic;
+    limits.l0cSize = Min<uint64_t>(platformInfo_.l0cSize, L0C_SIZE);
+    limits.l1AbSize = ComputeL1AbSize() / DIM_2;
+    limits.inDataSize = static_cast<float>(inDataSize_);
+    limits.kAlign = enDequant_ ? CONST_32 : CONST_16;
+    limits.maxM0 = AXES_ALIGN_SIZE;
+    limits.maxN0 = enDequant_ ? CONST_256 : AXES_ALIGN_SIZE;
+    return limits;
+}
+
+bool PpMatmulTilingApi::ApplyTuning()
+{
+    host_utils::MatmulTuningValue tuned;
+    if (!host_utils::MatmulTuningDb::Instance().Find(GetTuningKey(), tuned) ||
+        !host_utils::IsValidMatmulTuningValue(tuned, GetTuningLimits())) {
+        return false;
+    }
+    m0_ = tuned.m0;
+    n0_ = tuned.n0;
+    k0_ = tuned.k0;
+    mLoop_ = CeilDiv(m_, m0_);
+    nLoop_ = CeilDiv(n_, n0_);
+    kLoop_ = CeilDiv(k_, k0_);
+    coreLoop_ = numBatch_ * mLoop_ * nLoop_;
+    blockDim_ = Max(Min(coreLoop_, platformInfo_.coreNumAic), 1U);
+    swizzleCount_ = Min(tuned.swizzleCount, blockDim_);
+    swizzleDirect_ = tuned.swizzleDirect;
+    return true;
+}
+
 void PpMatmulTilingApi::GetTileSize()
 {
+    // an offline tuned tiling of this exact shape wins over the cost model
+    if (ApplyTuning()) {
+        return;
+    }
+
     bool priFlag = !(m_ < n_);
     uint32_t roundBase = pow(2, ceil(log(CeilDiv(priFlag ? n_ : m_, CONST_16)))) * CONST_16;
     uint32_t priAxes = RoundUp(priFlag ? m_ : n_, CONST_16);
@@ -567,7 +627,8 @@ void MlaPreprocessTiling::Init()
                                    false,                   // transA
                                    true,                    // transB
                                    true,                    // enDequant
-                                   deqOnTheFly);            // in bf16.cce?
+                                   deqOnTheFly,             // in bf16.cce?
+                                   host_utils::MatmulTuningOp::MLA_PREPROCESS_MM1);
     mm1TilingApi.GetTilingData(tilingData->mm1);
 
     PpMatmulTilingApi mm2TilingApi(platformInfo,
@@ -578,7 +639,8 @@ void MlaPreprocessTiling::Init()
                                    false,                                 // transA
                                    true,                                  // transB
                                    true,                                  // enDequant
-                                   deqOnTheFly);                          // in bf16.cce?
+                                   deqOnTheFly,                           // in bf16.cce?
+                                   host_utils::MatmulTuningOp::MLA_PREPROCESS_MM2);
     mm2TilingApi.GetTilingData(tilingData->mm2);
 
     PpMatmulTilingApi mm3TilingApi(platformInfo,
@@ -589,7 +651,8 @@ void MlaPreprocessTiling::Init()
                                    false,            // transA
                                    false,            // transB
                                    false,            // enDequant
-                                   deqOnTheFly);     // in bf16.cce?
+                                   deqOnTheFly,      // in bf16.cce?
+                                   host_utils::MatmulTuningOp::MLA_PREPROCESS_MM3);
     mm3TilingApi.GetTilingData(tilingData->mm3);
 
     RmsNormQuantTiling();
@@ -610,6 +673,35 @@ std::unordered_map<c10::string_view, uint16_t> quant_mode_map = {
     {"per_token_quant_symm", 1},
 };
 
+static struct PlatformInfo QueryPlatformInfo()
+{
+    platform_ascendc::PlatformAscendC *platformAscendC = platform_ascendc::PlatformAscendCManager::GetInstance();
+
+    struct PlatformInfo platformInfo;
+    platformInfo.coreNum = platformAscendC->GetCoreNum();
+    platformInfo.coreNumAic = platformAscendC->GetCoreNumAic();
+    platformInfo.coreNumAiv = platformAscendC->GetCoreNumAiv();
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::UB, platformInfo.ubSize);
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L1, platformInfo.l1Size);
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L2, platformInfo.l2Size);
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_A, platformInfo.l0aSize);
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_B, platformInfo.l0bSize);
+    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_C, platformInfo.l0cSize);
+    return platformInfo;
+}
+
+std::vector<host_utils::MatmulTuningValue> GetMlaMatmulTuningCandidates(const host_utils::MatmulTuningKey &key)
+{
+    struct PlatformInfo platformInfo = QueryPlatformInfo();
+    PpMatmulTilingApi api(platformInfo, key.batchSize, key.m, key.k, key.n,
+                          (key.flags & host_utils::MATMUL_TUNING_TRANS_A) != 0,
+                          (key.flags & host_utils::MATMUL_TUNING_TRANS_B) != 0,
+                          (key.flags & host_utils::MATMUL_TUNING_DEQUANT) != 0,
+                          (key.flags & host_utils::MATMUL_TUNING_DEQ_ON_THE_FLY) != 0,
+                          static_cast<host_utils::MatmulTuningOp>(key.op));
+    return host_utils::EnumerateMatmulTuningCandidates(api.GetTuningKey(), api.GetTuningLimits());
+}
+
 template <typename MapType>
 inline int get_op_mode(const MapType &mode_map, c10::optional<c10::string_view> mode_opt, c10::string_view default_mode,
                        const char *mode_name)
@@ -642,58 +734,39 @@ std::tuple<at::Tensor &, at::Tensor &, at::Tensor &, at::Tensor &> mla_preproces
             ? q_nope_scale.value()
             : at::empty({1}, at::TensorOptions().dtype(at::kHalf).device(hiddenState.options().device()));
 
-    platform_ascendc::PlatformAscendC *platformAscendC = platform_ascendc::PlatformAscendCManager::GetInstance();
-
-    struct PlatformInfo platformInfo;
-    platformInfo.coreNum = platformAscendC->GetCoreNum();
-    platformInfo.coreNumAic = platformAscendC->GetCoreNumAic();
-    platformInfo.coreNumAiv = platformAscendC->GetCoreNumAiv();
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::UB, platformInfo.ubSize);
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L1, platformInfo.l1Size);
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L2, platformInfo.l2Size);
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_A, platformInfo.l0aSize);
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_B, platformInfo.l0bSize);
-    platformAscendC->GetCoreMemSize(platform_ascendc::CoreMemType::L0_C, platformInfo.l0cSize);
-
     int32_t N = hiddenState.sizes()[0];
     int32_t headNum = wuk.sizes()[0];
     uint32_t hiddenStateDim = hiddenState.sizes().back();
 
-    OpParam opParam;
-    opParam.hiddenStateDim = hiddenStateDim;
-    opParam.N = N;
-    opParam.headNum = headNum;
-    opParam.cacheMode = static_cast<int32_t>(cacheMode);
-    opParam.quantMode = static_cast<QuantMode>(quantMode);
-    opParam.inDtype = hiddenState.options().dtype();
-
-    MlaTilingData tilingData;
-    MlaPreprocessTiling mlaTiling(platformInfo, opParam, &tilingData);
-
-    mlaTiling.Init();
-    uint32_t blockDim = platformInfo.coreNumAic;
-
-    // workspace
-    uint64_t system_workspace_size = static_cast<uint64_t>(platformAscendC->GetLibApiWorkSpaceSize());
-    uint64_t workspace_size = system_workspace_size + tilingData.userWorkspaceSize;
-    auto options = at::TensorOptions().dtype(at::kByte).device(hiddenState.options().device());
-    auto workspace_tensor = at::empty({static_cast<int64_t>(workspace_size)}, options);
-
-    // tiling
-    int32_t bIndex = N - 1;
-    uint32_t tilingSize = sizeof(MlaTilingData);
-    int32_t tilingOffset = tilingSize * MAX_SUPPORT_TOKEN_NUMS * (opParam.cacheMode - 1) + (tilingSize * bIndex);
-    static auto global_tiling_data =
-        at::empty({tilingSize * MAX_SUPPORT_TOKEN_NUMS * MAX_CACHE_MODE_NUMS},
-                  at::TensorOptions().dtype(at::kByte).device(hiddenState.options().device()));
-    if (bIndex >= 0 && bIndex < MAX_SUPPORT_TOKEN_NUMS) {
-        aclrtMemcpy(global_tiling_data.data_ptr<uint8_t>() + tilingOffset, tilingSize, &tilingData, tilingSize,
-                    ACL_MEMCPY_HOST_TO_DEVICE);
-    } else {
-        // Handle the case where bIndex is out of range
-        TORCH_CHECK(false, "bIndex is out of range: ", bIndex);
-    }
-    at::Tensor tiling = at::from_blob(global_tiling_data.data_ptr<uint8_t>() + tilingOffset, tilingSize, at::kByte);
+    TilingCacheKey key("mla_preprocess", hiddenState.scalar_type(), cacheMode, quantMode, N, headNum, hiddenStateDim);
+    TilingCacheEntry tilingEntry = TilingCache::Instance().GetOrCreate(key, [&](TilingCacheEntry &entry) {
+        platform_ascendc::PlatformAscendC *platformAscendC = platform_ascendc::PlatformAscendCManager::GetInstance();
+        struct PlatformInfo platformInfo = QueryPlatformInfo();
+
+        OpParam opParam;
+        opParam.hiddenStateDim = hiddenStateDim;
+        opParam.N = N;
+        opParam.headNum = headNum;
+        opParam.cacheMode = static_cast<int32_t>(cacheMode);
+        opParam.quantMode = static_cast<QuantMode>(quantMode);
+        opParam.inDtype = hiddenState.options().dtype();
+
+        MlaTilingData *tilingData = nullptr;
+        auto tilingBuffer = TilingCache::AllocHostBuffer(tilingData);
+        MlaPreprocessTiling mlaTiling(platformInfo, opParam, tilingData);
+
+        mlaTiling.Init();
+        entry.blockDim = platformInfo.coreNumAic;
+
+        // workspace
+        uint64_t system_workspace_size = static_cast<uint64_t>(platformAscendC->GetLibApiWorkSpaceSize());
+        entry.workspaceSize = system_workspace_size + tilingData->userWorkspaceSize;
+        return tilingBuffer;
+    });
+    uint32_t blockDim = tilingEntry.blockDim;
+    at::Tensor tiling = tilingEntry.tiling;
+
+    auto workspace_tensor = WorkspaceArena::Instance().Borrow(hiddenState.device(), tilingEntry.workspaceSize);
 
     EXEC_KERNEL_CMD(mla_preprocess, blockDim, hiddenState, gamma0, beta0, quant_scale0, quant_offset0, wdqkv, bias0,
                     gamma1, beta1, quant_scale1, quant_offset1, gamma2, sin, cos, sin, cos, kv_cache, slotmapping, wuq,
@@ -14,6 +14,7 @@
 #include "version.h"
 
 #include "torch_helper.h"
+#include "host_profiler.h"
 #include "sgl_kenel_npu_ops.h"
 
 namespace {
@@ -21,6 +22,11 @@ TORCH_LIBRARY_FRAGMENT(npu, m)
 {
     m.def("sgl_kernel_npu_print_version() -> ()", []() { printf("%s\n", LIB_VERSION_FULL); });
     m.def("sgl_kernel_npu_version() -> str", []() { return std::string("") + LIB_VERSION; });
+    // host hot path statistics as JSON, recorded while enabled with SGL_KERNEL_NPU_HOST_STATS=1 or the enable op
+    m.def("sgl_kernel_npu_stats() -> str", []() { return host_utils::HostProfiler::Instance().Dump(); });
+    m.def("sgl_kernel_npu_stats_reset() -> ()", []() { host_utils::HostProfiler::Instance().Reset(); });
+    m.def("sgl_kernel_npu_stats_enable(bool enable) -> bool",
+          [](bool enable) { return host_utils::HostProfiler::Instance().Enable(enable); });
 
     m.def("helloworld(Tensor x, Tensor y) -> Tensor");
 
@@ -96,6 +102,13 @@ TORCH_LIBRARY_FRAGMENT(npu, m)
         "Tensor? actual_seq_lengths_key=None, Tensor? block_table=None, "
         "str? layout_query=None, str? layout_key=None, "
         "int? sparse_count=None, int? sparse_mode=None) -> Tensor");
+
+    // host only, consulted by the matmul tilings and driven by sgl_kernel_npu.tuning
+    m.def("matmul_tuning_db_load(str path) -> int", &sglang::npu_kernel::matmul_tuning_db_load);
+    m.def("matmul_tuning_db_save(str path) -> int", &sglang::npu_kernel::matmul_tuning_db_save);
+    m.def("matmul_tuning_trace(bool enable) -> int[]", &sglang::npu_kernel::matmul_tuning_trace);
+    m.def("matmul_tuning_candidates(int[] key) -> int[]", &sglang::npu_kernel::matmul_tuning_candidates);
+    m.def("matmul_tuning_set(int[] key, int[] value, float time_us=0.) -> ()", &sglang::npu_kernel::matmul_tuning_set);
 }
 }  // namespace
 
@@ -138,4 +151,18 @@ TORCH_LIBRARY_IMPL(npu, PrivateUse1, m)
 
     m.impl("lightning_indexer", TORCH_FN(sglang::npu_kernel::lightning_indexer));
 }
+
+// host implementations of the memory management ops, so that page allocation can run on the CPU
+TORCH_LIBRARY_IMPL(npu, CPU, m)
+{
+    m.impl("cache_loc_assign", TORCH_FN(sglang::npu_kernel::cache_loc_assign_cpu));
+
+    m.impl("cache_loc_update", TORCH_FN(sglang::npu_kernel::cache_loc_update_cpu));
+
+    m.impl("assign_cache_op", TORCH_FN(sglang::npu_kernel::assign_cache_op_cpu));
+
+    m.impl("alloc_extend", TORCH_FN(sglang::npu_kernel::alloc_extend_cpu));
+
+    m.impl("build_tree_kernel_efficient", TORCH_FN(sglang::npu_kernel::build_tree_efficient_cpu));
+}
 }  // namespace
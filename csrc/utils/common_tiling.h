@@ -13,6 +13,11 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "acl/acl.h"
 #include "common.h"
 #include "tiling/platform/platform_ascendc.h"
 #include "../batch_matmul_transpose/op_host/tiling/tiling_data.h"
@@ -38,6 +43,48 @@ constexpr uint32_t UB_LIMIT_SIZE_910A = 128 * 1024;
 
 enum class PlatformType { ASCEND_310P, ASCEND_910A, ASCEND_910B, ASCEND_910C, PLATFORM_INVALID };
 
+constexpr const char *SOC_VERSION_ENV = "SGL_KERNEL_NPU_SOC_VERSION";
+
+// Static description of one SoC. Core counts and memory sizes are only used when the profile is selected by
+// override, on a device they are queried from the runtime so that partitioned dies report their real size.
+struct SocProfile {
+    const char *socPrefix;
+    PlatformType socType;
+    uint32_t coreNumAic;
+    uint32_t coreNumAiv;
+    uint64_t ubSize;
+    uint64_t l1Size;
+    uint64_t l2Size;
+    uint64_t l0aSize;
+    uint64_t l0bSize;
+    uint64_t l0cSize;
+    uint32_t hbmBandWidth;
+    uint32_t l2BandWidth;
+};
+
+// Looked up by prefix, the first match wins, so more specific names come first.
+inline const SocProfile SOC_PROFILES[] = {
+    {"Ascend910_93", PlatformType::ASCEND_910C, 24, 48, 196608, 524288, 201326592, 65536, 65536, 131072, 1, 5},
+    {"Ascend910B4", PlatformType::ASCEND_910B, 20, 40, 196608, 524288, 100663296, 65536, 65536, 131072, 1, 5},
+    {"Ascend910B3", PlatformType::ASCEND_910B, 20, 40, 196608, 524288, 201326592, 65536, 65536, 131072, 1, 5},
+    {"Ascend910B", PlatformType::ASCEND_910B, 24, 48, 196608, 524288, 201326592, 65536, 65536, 131072, 1, 5},
+    {"Ascend910", PlatformType::ASCEND_910A, 32, 32, 262144, 1048576, 33554432, 65536, 65536, 262144, 1, 3},
+    {"Ascend310P", PlatformType::ASCEND_310P, 8, 8, 262144, 1048576, 16777216, 65536, 65536, 262144, 1, 3},
+};
+
+inline const SocProfile *FindSocProfile(const char *socName)
+{
+    if (socName == nullptr) {
+        return nullptr;
+    }
+    for (const auto &profile : SOC_PROFILES) {
+        if (std::strncmp(socName, profile.socPrefix, std::strlen(profile.socPrefix)) == 0) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
 struct PlatformInfo {
 public:
     static const PlatformInfo &Instance()
@@ -46,6 +93,16 @@ public:
         return platformInfo;
     }
 
+    /**
+     * @brief Force the SoC profile by name (e.g. "Ascend910B3"), must be called before the first Instance().
+     *        The SGL_KERNEL_NPU_SOC_VERSION environment variable has the same effect. With an override neither the
+     *        runtime nor the device is queried, so tilings are reproducible on a CPU host.
+     */
+    static void SetSocOverride(const char *socName)
+    {
+        SocOverride() = socName == nullptr ? "" : socName;
+    }
+
     PlatformType socType;
     uint32_t coreNum;
     uint32_t coreNumAic;
@@ -56,13 +113,31 @@ public:
     uint64_t l0aSize;
     uint64_t l0bSize;
     uint64_t l0cSize;
+    uint32_t hbmBandWidth;
+    uint32_t l2BandWidth;
 
 private:
     PlatformInfo()
     {
+        std::string overrideName = SocOverride();
+        if (overrideName.empty()) {
+            const char *env = std::getenv(SOC_VERSION_ENV);
+            overrideName = env == nullptr ? "" : env;
+        }
+        if (!overrideName.empty()) {
+            const SocProfile *profile = FindSocProfile(overrideName.c_str());
+            if (profile == nullptr) {
+                throw std::invalid_argument("Unsupported soc version override: " + overrideName);
+            }
+            LoadProfile(*profile);
+            return;
+        }
+
+        const char *socName = aclrtGetSocName();
+        const SocProfile *profile = FindSocProfile(socName);
+        // unknown chips keep the 910_93 tuning, which has been the behaviour so far
+        LoadProfile(profile != nullptr ? *profile : SOC_PROFILES[0]);
         auto ascendcPlatform = platform_ascendc::PlatformAscendCManager::GetInstance();
-        // TODO Hard coding set to 910_93xx, parse using aclrtGetSocName is better
-        socType = PlatformType::ASCEND_910C;
         coreNum = ascendcPlatform->GetCoreNum();
         coreNumAic = ascendcPlatform->GetCoreNumAic();
         coreNumAiv = ascendcPlatform->GetCoreNumAiv();
@@ -74,6 +149,28 @@ private:
         ascendcPlatform->GetCoreMemSize(platform_ascendc::CoreMemType::L0_C, l0cSize);
     }
 
+    void LoadProfile(const SocProfile &profile)
+    {
+        socType = profile.socType;
+        coreNum = profile.coreNumAic;
+        coreNumAic = profile.coreNumAic;
+        coreNumAiv = profile.coreNumAiv;
+        ubSize = profile.ubSize;
+        l1Size = profile.l1Size;
+        l2Size = profile.l2Size;
+        l0aSize = profile.l0aSize;
+        l0bSize = profile.l0bSize;
+        l0cSize = profile.l0cSize;
+        hbmBandWidth = profile.hbmBandWidth;
+        l2BandWidth = profile.l2BandWidth;
+    }
+
+    static std::string &SocOverride()
+    {
+        static std::string socOverride;
+        return socOverride;
+    }
+
     PlatformInfo(const PlatformInfo &) = delete;
     PlatformInfo &operator=(const PlatformInfo &) = delete;
     PlatformInfo(PlatformInfo &&) = delete;
@@ -0,0 +1,323 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_HOST_PROFILER_H
+#define SGL_KERNEL_NPU_HOST_PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace host_utils {
+
+constexpr size_t HOST_PROFILER_RING_SIZE = 4096;  // events per thread between two drains, must be a power of two
+constexpr size_t HOST_PROFILER_BUCKET_NUM = 32;   // log2 ns buckets, the last one also takes everything above 2^31ns
+constexpr const char *HOST_PROFILER_ENV = "SGL_KERNEL_NPU_HOST_STATS";
+constexpr const char *HOST_PROFILER_UNKNOWN_OP = "unknown";
+
+enum class HostStage : uint8_t {
+    TILING = 0,         // host tiling computation, aclnn GetWorkspaceSize for EXEC_NPU_CMD
+    TILING_UPLOAD = 1,  // H2D submission of the tiling blob
+    WORKSPACE = 2,      // workspace allocation
+    LAUNCH = 3,         // kernel launch through the task queue
+    NUM = 4,
+};
+
+inline const char *HostStageName(HostStage stage)
+{
+    static const char *names[] = {"tiling", "tiling_upload", "workspace", "launch"};
+    return names[static_cast<size_t>(stage)];
+}
+
+struct HostEvent {
+    const char *op;  // string literal, never copied
+    HostStage stage;
+    uint64_t durationNs;
+};
+
+/**
+ * @brief Single producer single consumer event ring of one host thread. The owning thread pushes without any
+ *        lock, an event that finds the ring full is dropped and counted instead of waiting for the reader.
+ */
+class HostEventRing
+{
+public:
+    void Push(const HostEvent &event)
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= HOST_PROFILER_RING_SIZE) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[head & (HOST_PROFILER_RING_SIZE - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Consumer>
+    void Drain(Consumer &&consumer)
+    {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            consumer(events_[tail & (HOST_PROFILER_RING_SIZE - 1)]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    uint64_t TakeDropped()
+    {
+        return dropped_.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<HostEvent, HOST_PROFILER_RING_SIZE> events_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+/**
+ * @brief Latency histogram of one (op, stage), bucket i counts durations in [2^i, 2^(i+1)) ns.
+ */
+struct HostHistogram {
+    uint64_t count{0};
+    uint64_t totalNs{0};
+    uint64_t maxNs{0};
+    std::array<uint64_t, HOST_PROFILER_BUCKET_NUM> buckets{};
+
+    void Add(uint64_t durationNs)
+    {
+        size_t bucket = 0;
+        for (uint64_t value = durationNs >> 1; value != 0 && bucket + 1 < HOST_PROFILER_BUCKET_NUM; value >>= 1) {
+            ++bucket;
+        }
+        ++buckets[bucket];
+        ++count;
+        totalNs += durationNs;
+        maxNs = std::max(maxNs, durationNs);
+    }
+
+    // upper bound of the bucket holding the given quantile, in ns
+    uint64_t Quantile(double quantile) const
+    {
+        uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < HOST_PROFILER_BUCKET_NUM; ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return std::min(maxNs, (uint64_t(1) << (i + 1)) - 1);
+            }
+        }
+        return maxNs;
+    }
+};
+
+/**
+ * @brief Host hot path instrumentation of the op hosts.
+ *
+ * Disabled by default, it is enabled with SGL_KERNEL_NPU_HOST_STATS=1 or Enable(). A disabled probe costs one
+ * relaxed atomic load. When enabled every probe pushes one event into the ring of its thread, the rings are only
+ * drained and aggregated into per (op, stage) histograms when the statistics are read, so the reader has to poll
+ * often enough for the rings not to overflow, dropped events are reported.
+ *
+ * Workspace allocation does not know its op, it is attributed to the op whose tiling was last looked up on the
+ * same thread (see SetCurrentOp).
+ */
+class HostProfiler
+{
+public:
+    static HostProfiler &Instance()
+    {
+        // intentionally leaked, rings of exiting threads may still be drained during static destruction
+        static HostProfiler *profiler = new HostProfiler();
+        return *profiler;
+    }
+
+    static bool Enabled()
+    {
+        return EnabledFlag().load(std::memory_order_relaxed);
+    }
+
+    static uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    static void SetCurrentOp(const char *op)
+    {
+        CurrentOp() = op;
+    }
+
+    static const char *GetCurrentOp()
+    {
+        const char *op = CurrentOp();
+        return op != nullptr ? op : HOST_PROFILER_UNKNOWN_OP;
+    }
+
+    /**
+     * @brief Turn the probes on or off, returns the previous state.
+     */
+    bool Enable(bool enable)
+    {
+        return EnabledFlag().exchange(enable, std::memory_order_relaxed);
+    }
+
+    void Record(const char *op, HostStage stage, uint64_t durationNs)
+    {
+        LocalRing().Push({op, stage, durationNs});
+    }
+
+    /**
+     * @brief Drop everything recorded so far.
+     */
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DrainLocked();
+        histograms_.clear();
+        dropped_ = 0;
+    }
+
+    /**
+     * @brief Statistics recorded since the last reset as JSON:
+     *        {"enabled": b, "dropped": n, "ops": {op: {stage: {"count", "total_ns", "mean_ns", "p50_ns", "p99_ns",
+     *        "max_ns", "buckets": [...]}}}}.
+     */
+    std::string Dump()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DrainLocked();
+        std::ostringstream os;
+        os << "{\"enabled\": " << (Enabled() ? "true" : "false") << ", \"dropped\": " << dropped_ << ", \"ops\": {";
+        const char *opSep = "";
+        for (const auto &op : histograms_) {
+            os << opSep << "\"" << op.first << "\": {";
+            opSep = ", ";
+            const char *stageSep = "";
+            for (size_t stage = 0; stage < static_cast<size_t>(HostStage::NUM); ++stage) {
+                const HostHistogram &hist = op.second[stage];
+                if (hist.count == 0) {
+                    continue;
+                }
+                os << stageSep << "\"" << HostStageName(static_cast<HostStage>(stage)) << "\": {\"count\": "
+                   << hist.count << ", \"total_ns\": " << hist.totalNs << ", \"mean_ns\": " << hist.totalNs / hist.count
+                   << ", \"p50_ns\": " << hist.Quantile(0.5) << ", \"p99_ns\": " << hist.Quantile(0.99)
+                   << ", \"max_ns\": " << hist.maxNs << ", \"buckets\": [";
+                stageSep = ", ";
+                size_t last = HOST_PROFILER_BUCKET_NUM;
+                while (last > 0 && hist.buckets[last - 1] == 0) {
+                    --last;
+                }
+                for (size_t i = 0; i < last; ++i) {
+                    os << (i == 0 ? "" : ", ") << hist.buckets[i];
+                }
+                os << "]}";
+            }
+            os << "}";
+        }
+        os << "}}";
+        return os.str();
+    }
+
+private:
+    using StageHistograms = std::array<HostHistogram, static_cast<size_t>(HostStage::NUM)>;
+
+    HostProfiler() = default;
+
+    HostProfiler(const HostProfiler &) = delete;
+    HostProfiler &operator=(const HostProfiler &) = delete;
+
+    static std::atomic<bool> &EnabledFlag()
+    {
+        static std::atomic<bool> enabled{[] {
+            const char *env = std::getenv(HOST_PROFILER_ENV);
+            return env != nullptr && std::strcmp(env, "1") == 0;
+        }()};
+        return enabled;
+    }
+
+    static const char *&CurrentOp()
+    {
+        thread_local const char *op = nullptr;
+        return op;
+    }
+
+    HostEventRing &LocalRing()
+    {
+        thread_local std::shared_ptr<HostEventRing> ring = [this] {
+            auto newRing = std::make_shared<HostEventRing>();
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(newRing);
+            return newRing;
+        }();
+        return *ring;
+    }
+
+    void DrainLocked()
+    {
+        for (auto it = rings_.begin(); it != rings_.end();) {
+            (*it)->Drain([this](const HostEvent &event) {
+                histograms_[event.op][static_cast<size_t>(event.stage)].Add(event.durationNs);
+            });
+            dropped_ += (*it)->TakeDropped();
+            // only the registry still holds the ring of an exited thread, it has just been drained for the last time
+            it = it->use_count() == 1 ? rings_.erase(it) : it + 1;
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<HostEventRing>> rings_;
+    std::map<std::string, StageHistograms> histograms_;
+    uint64_t dropped_{0};
+};
+
+/**
+ * @brief Records the lifetime of the scope as one event, does not read the clock while profiling is disabled.
+ */
+class HostProfileScope
+{
+public:
+    HostProfileScope(const char *op, HostStage stage)
+        : op_(op), stage_(stage), startNs_(HostProfiler::Enabled() ? HostProfiler::NowNs() : 0)
+    {
+    }
+
+    ~HostProfileScope()
+    {
+        if (startNs_ != 0) {
+            HostProfiler::Instance().Record(op_, stage_, HostProfiler::NowNs() - startNs_);
+        }
+    }
+
+    HostProfileScope(const HostProfileScope &) = delete;
+    HostProfileScope &operator=(const HostProfileScope &) = delete;
+
+private:
+    const char *op_;
+    HostStage stage_;
+    uint64_t startNs_;
+};
+
+}  // namespace host_utils
+
+#endif  // SGL_KERNEL_NPU_HOST_PROFILER_H
@@ -0,0 +1,353 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_MATMUL_TUNING_DB_H
+#define SGL_KERNEL_NPU_MATMUL_TUNING_DB_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common.h"
+
+namespace host_utils {
+
+constexpr char MATMUL_TUNING_DB_MAGIC[8] = {'S', 'G', 'L', 'M', 'M', 'T', 'D', 'B'};
+constexpr uint32_t MATMUL_TUNING_DB_VERSION = 1;
+constexpr const char *MATMUL_TUNING_DB_ENV = "SGL_KERNEL_NPU_MATMUL_TUNING_DB";
+constexpr uint32_t MATMUL_TUNING_MIN_BLOCK = 16;
+
+enum class MatmulTuningOp : uint32_t {
+    PP_MATMUL = 0,  // pp_matmul::GetPpMatmulTiling, used by batch_matmul_transpose
+    MLA_PREPROCESS_MM1 = 1,
+    MLA_PREPROCESS_MM2 = 2,
+    MLA_PREPROCESS_MM3 = 3,
+};
+
+enum MatmulTuningFlag : uint32_t {
+    MATMUL_TUNING_TRANS_A = 1U << 0,
+    MATMUL_TUNING_TRANS_B = 1U << 1,
+    MATMUL_TUNING_FORMAT_NZ = 1U << 2,
+    MATMUL_TUNING_DEQUANT = 1U << 3,
+    MATMUL_TUNING_DEQ_ON_THE_FLY = 1U << 4,
+};
+
+#pragma pack(push, 1)
+struct MatmulTuningKey {
+    uint32_t op{0};
+    uint32_t coreNum{0};
+    uint32_t batchSize{0};
+    uint32_t m{0};
+    uint32_t k{0};
+    uint32_t n{0};
+    uint32_t dtype{0};
+    uint32_t flags{0};
+
+    bool operator<(const MatmulTuningKey &other) const
+    {
+        return std::tie(op, coreNum, batchSize, m, k, n, dtype, flags) <
+               std::tie(other.op, other.coreNum, other.batchSize, other.m, other.k, other.n, other.dtype, other.flags);
+    }
+
+    bool operator==(const MatmulTuningKey &other) const
+    {
+        return !(*this < other) && !(other < *this);
+    }
+};
+
+struct MatmulTuningValue {
+    uint32_t m0{0};
+    uint32_t n0{0};
+    uint32_t k0{0};
+    uint32_t swizzleCount{1};
+    uint32_t swizzleDirect{0};
+    float timeUs{0};  // measured time of the winner, informational only
+};
+
+struct MatmulTuningRecord {
+    MatmulTuningKey key;
+    MatmulTuningValue value;
+};
+
+struct MatmulTuningDbHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordNum;
+};
+#pragma pack(pop)
+
+/**
+ * @brief Hardware limits a tuned tiling has to respect, filled in by the op that consumes it.
+ */
+struct MatmulTuningLimits {
+    uint32_t coreNum{1};
+    uint64_t l0cSize{0};
+    uint64_t l1AbSize{0};  // L1 bytes of one A + B tile pair, i.e. (m0 + n0) * k0 * inDataSize
+    float inDataSize{2};
+    uint32_t kAlign{16};
+    uint32_t maxM0{256};
+    uint32_t maxN0{256};
+};
+
+inline bool IsValidMatmulTuningValue(const MatmulTuningValue &value, const MatmulTuningLimits &limits)
+{
+    if (value.m0 == 0 || value.n0 == 0 || value.k0 == 0 || value.m0 % MATMUL_TUNING_MIN_BLOCK != 0 ||
+        value.n0 % MATMUL_TUNING_MIN_BLOCK != 0 || value.k0 % limits.kAlign != 0) {
+        return false;
+    }
+    if (value.m0 > limits.maxM0 || value.n0 > limits.maxN0 || value.swizzleDirect > 1 || value.swizzleCount == 0) {
+        return false;
+    }
+    if (static_cast<uint64_t>(value.m0) * value.n0 * sizeof(float) > limits.l0cSize) {
+        return false;
+    }
+    return static_cast<float>(value.m0 + value.n0) * value.k0 * limits.inDataSize <=
+           static_cast<float>(limits.l1AbSize);
+}
+
+/**
+ * @brief All tilings of one shape worth measuring: power of two m0/n0 that fit L0C, the largest k0 that fits L1
+ *        and half of it, and every power of two swizzle count in both directions.
+ */
+inline std::vector<MatmulTuningValue> EnumerateMatmulTuningCandidates(const MatmulTuningKey &key,
+                                                                      const MatmulTuningLimits &limits)
+{
+    std::vector<MatmulTuningValue> candidates;
+    uint32_t mBound = std::min(limits.maxM0, RoundUp<uint32_t>(std::max(key.m, 1U), MATMUL_TUNING_MIN_BLOCK) * 2);
+    uint32_t nBound = std::min(limits.maxN0, RoundUp<uint32_t>(std::max(key.n, 1U), MATMUL_TUNING_MIN_BLOCK) * 2);
+    for (uint32_t m0 = MATMUL_TUNING_MIN_BLOCK; m0 <= mBound; m0 *= 2) {
+        for (uint32_t n0 = MATMUL_TUNING_MIN_BLOCK; n0 <= nBound; n0 *= 2) {
+            if (static_cast<uint64_t>(m0) * n0 * sizeof(float) > limits.l0cSize) {
+                continue;
+            }
+            uint32_t k0Max = static_cast<uint32_t>(static_cast<float>(limits.l1AbSize) / ((m0 + n0) * limits.inDataSize));
+            k0Max = RoundDown<uint32_t>(std::min(k0Max, RoundUp<uint32_t>(key.k, limits.kAlign)), limits.kAlign);
+            if (k0Max == 0) {
+                continue;
+            }
+            uint32_t coreLoop = std::max(key.batchSize, 1U) * CeilDiv(key.m, m0) * CeilDiv(key.n, n0);
+            uint32_t blockDim = std::max(std::min(coreLoop, limits.coreNum), 1U);
+            uint32_t k0Half = RoundDown<uint32_t>(k0Max / 2, limits.kAlign);
+            for (uint32_t k0 : {k0Max, k0Half}) {
+                if (k0 == 0 || (k0 == k0Half && k0Half == k0Max)) {
+                    continue;
+                }
+                for (uint32_t swizzleCount = 1; swizzleCount <= blockDim; swizzleCount *= 2) {
+                    for (uint32_t swizzleDirect = 0; swizzleDirect <= 1; ++swizzleDirect) {
+                        candidates.push_back({m0, n0, k0, swizzleCount, swizzleDirect, 0});
+                    }
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+/**
+ * @brief Persisted best tilings of matmul shapes.
+ *
+ * The file is a header followed by records sorted by key, it is mmap'd read only and searched in place. It is
+ * loaded from SGL_KERNEL_NPU_MATMUL_TUNING_DB on first use or explicitly with Load(). Records set with Set() take
+ * precedence over the file and are written together with it by Save(), the offline tuner uses them to force a
+ * candidate while it is measured, and it learns which shapes a workload tiles by tracing the looked up keys.
+ * Lookups only happen when a tiling is computed, i.e. on a tiling cache miss.
+ */
+class MatmulTuningDb
+{
+public:
+    static MatmulTuningDb &Instance()
+    {
+        // intentionally leaked, the mapping stays valid until the process exits
+        static MatmulTuningDb *db = [] {
+            auto instance = new MatmulTuningDb();
+            if (const char *path = std::getenv(MATMUL_TUNING_DB_ENV)) {
+                instance->Load(path);
+            }
+            return instance;
+        }();
+        return *db;
+    }
+
+    /**
+     * @brief Map the database file, replacing the previously loaded one. Returns the number of records, or -1
+     *        if the file is missing or malformed, in which case no file records are used.
+     */
+    int64_t Load(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Unmap();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "[sgl_kernel_npu] matmul tuning db " << path << " can not be opened" << std::endl;
+            return -1;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MatmulTuningDbHeader)) {
+            close(fd);
+            std::cerr << "[sgl_kernel_npu] matmul tuning db " << path << " is truncated" << std::endl;
+            return -1;
+        }
+        void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            std::cerr << "[sgl_kernel_npu] matmul tuning db " << path << " can not be mapped" << std::endl;
+            return -1;
+        }
+        const auto *header = static_cast<const MatmulTuningDbHeader *>(addr);
+        size_t expected = sizeof(MatmulTuningDbHeader) + static_cast<size_t>(header->recordNum) * sizeof(MatmulTuningRecord);
+        if (std::memcmp(header->magic, MATMUL_TUNING_DB_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != MATMUL_TUNING_DB_VERSION || expected != static_cast<size_t>(st.st_size)) {
+            munmap(addr, static_cast<size_t>(st.st_size));
+            std::cerr << "[sgl_kernel_npu] matmul tuning db " << path << " has an unsupported format" << std::endl;
+            return -1;
+        }
+        mapAddr_ = addr;
+        mapSize_ = static_cast<size_t>(st.st_size);
+        records_ = reinterpret_cast<const MatmulTuningRecord *>(static_cast<const char *>(addr) +
+                                                                sizeof(MatmulTuningDbHeader));
+        recordNum_ = header->recordNum;
+        return static_cast<int64_t>(recordNum_);
+    }
+
+    bool Find(const MatmulTuningKey &key, MatmulTuningValue &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (trace_) {
+            traced_.insert(key);
+        }
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            value = it->second;
+            return true;
+        }
+        const MatmulTuningRecord *end = records_ + recordNum_;
+        const MatmulTuningRecord *rec = std::lower_bound(
+            records_, end, key, [](const MatmulTuningRecord &r, const MatmulTuningKey &k) { return r.key < k; });
+        if (rec == end || !(rec->key == key)) {
+            return false;
+        }
+        std::memcpy(&value, &rec->value, sizeof(MatmulTuningValue));
+        return true;
+    }
+
+    void Set(const MatmulTuningKey &key, const MatmulTuningValue &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_[key] = value;
+    }
+
+    /**
+     * @brief Write the loaded records merged with the ones set in this process. Returns the number of records
+     *        written, or -1 on an I/O error.
+     */
+    int64_t Save(const std::string &path)
+    {
+        std::map<MatmulTuningKey, MatmulTuningValue> merged;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (uint64_t i = 0; i < recordNum_; ++i) {
+                MatmulTuningRecord rec;
+                std::memcpy(&rec, records_ + i, sizeof(rec));
+                merged[rec.key] = rec.value;
+            }
+            for (const auto &kv : pending_) {
+                merged[kv.first] = kv.second;
+            }
+        }
+        std::string tmpPath = path + ".tmp";
+        FILE *fp = std::fopen(tmpPath.c_str(), "wb");
+        if (fp == nullptr) {
+            return -1;
+        }
+        MatmulTuningDbHeader header;
+        std::memcpy(header.magic, MATMUL_TUNING_DB_MAGIC, sizeof(header.magic));
+        header.version = MATMUL_TUNING_DB_VERSION;
+        header.recordNum = static_cast<uint32_t>(merged.size());
+        bool ok = std::fwrite(&header, sizeof(header), 1, fp) == 1;
+        for (const auto &kv : merged) {
+            MatmulTuningRecord rec{kv.first, kv.second};
+            ok = ok && std::fwrite(&rec, sizeof(rec), 1, fp) == 1;
+        }
+        ok = (std::fclose(fp) == 0) && ok;
+        // rename keeps a concurrently mapped old file intact
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return -1;
+        }
+        return static_cast<int64_t>(merged.size());
+    }
+
+    void Erase(const MatmulTuningKey &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.erase(key);
+    }
+
+    void ClearPending()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+    }
+
+    /**
+     * @brief Start or stop recording the keys passed to Find(), returns the keys recorded since the last call.
+     */
+    std::vector<MatmulTuningKey> Trace(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<MatmulTuningKey> traced(traced_.begin(), traced_.end());
+        traced_.clear();
+        trace_ = enable;
+        return traced;
+    }
+
+private:
+    MatmulTuningDb() = default;
+    MatmulTuningDb(const MatmulTuningDb &) = delete;
+    MatmulTuningDb &operator=(const MatmulTuningDb &) = delete;
+
+    void Unmap()
+    {
+        if (mapAddr_ != nullptr) {
+            munmap(mapAddr_, mapSize_);
+        }
+        mapAddr_ = nullptr;
+        mapSize_ = 0;
+        records_ = nullptr;
+        recordNum_ = 0;
+    }
+
+    std::mutex mutex_;
+    void *mapAddr_{nullptr};
+    size_t mapSize_{0};
+    const MatmulTuningRecord *records_{nullptr};
+    uint64_t recordNum_{0};
+    std::map<MatmulTuningKey, MatmulTuningValue> pending_;
+    bool trace_{false};
+    std::set<MatmulTuningKey> traced_;
+};
+
+}  // namespace host_utils
+
+#endif  // SGL_KERNEL_NPU_MATMUL_TUNING_DB_H
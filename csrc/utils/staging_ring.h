@@ -0,0 +1,236 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_STAGING_RING_H
+#define SGL_KERNEL_NPU_STAGING_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "acl/acl.h"
+#include "torch_helper.h"
+#include "torch_npu/csrc/core/npu/NPUGraphsUtils.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr uint32_t STAGING_RING_SLOT_NUM = 64;
+constexpr size_t STAGING_RING_SLOT_SIZE = 4096;
+// bound of the wait for the task queue to record the event of a slot that is about to be reused
+constexpr int64_t STAGING_RING_RECORD_TIMEOUT_MS = 30000;
+
+/**
+ * @brief Pinned host staging ring of one stream, used to upload small host blobs (tiling data) without blocking
+ *        the host thread.
+ *
+ * A blob is copied into the next free slot and sent with aclrtMemcpyAsync on the owning stream. An event recorded
+ * after the copy marks the slot busy, a slot is only overwritten after its event has completed, so the host waits
+ * solely when the whole ring is still in flight.
+ */
+class StagingRing
+{
+public:
+    explicit StagingRing(aclrtStream stream) : stream_(stream), slots_(STAGING_RING_SLOT_NUM)
+    {
+        auto ret = aclrtMallocHost(&hostBase_, STAGING_RING_SLOT_NUM * STAGING_RING_SLOT_SIZE);
+        TORCH_CHECK(ret == ACL_SUCCESS, "aclrtMallocHost for staging ring failed, ret: ", ret);
+        for (auto &slot : slots_) {
+            ret = aclrtCreateEvent(&slot.event);
+            TORCH_CHECK(ret == ACL_SUCCESS, "aclrtCreateEvent for staging ring failed, ret: ", ret);
+        }
+    }
+
+    ~StagingRing()
+    {
+        for (auto &slot : slots_) {
+            if (slot.state->load(std::memory_order_acquire) == SLOT_RECORDED) {
+                aclrtSynchronizeEvent(slot.event);
+            }
+            aclrtDestroyEvent(slot.event);
+        }
+        aclrtFreeHost(hostBase_);
+    }
+
+    StagingRing(const StagingRing &) = delete;
+    StagingRing &operator=(const StagingRing &) = delete;
+
+    /**
+     * @brief Copy size bytes from host to dst asynchronously on the ring's stream.
+     *
+     * The copy is submitted through the task queue so that it stays ordered with the kernels queued before it,
+     * dst may be memory the caching allocator has just handed back from one of them. Uploads to the same ring are
+     * serialized, other rings are not blocked while this one waits for a slot.
+     */
+    void Upload(void *dst, const void *src, size_t size)
+    {
+        TORCH_CHECK(size <= STAGING_RING_SLOT_SIZE, "staging ring upload of ", size, " bytes exceeds slot size");
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot &slot = slots_[next_];
+        size_t slotIndex = next_;
+        Reclaim(slot);
+        next_ = (next_ + 1) % STAGING_RING_SLOT_NUM;
+
+        uint8_t *staging = static_cast<uint8_t *>(hostBase_) + slotIndex * STAGING_RING_SLOT_SIZE;
+        std::memcpy(staging, src, size);
+        slot.state->store(SLOT_QUEUED, std::memory_order_relaxed);
+        auto acl_call = [stream = stream_, event = slot.event, state = slot.state, dst, staging, size]() -> int {
+            // leaving without the event recorded marks the slot failed, so its next Upload does not wait for it
+            SlotStateGuard guard(*state);
+            auto ret = aclrtMemcpyAsync(dst, size, staging, size, ACL_MEMCPY_HOST_TO_DEVICE, stream);
+            TORCH_CHECK(ret == ACL_SUCCESS, "aclrtMemcpyAsync from staging ring failed, ret: ", ret);
+            ret = aclrtRecordEvent(event, stream);
+            TORCH_CHECK(ret == ACL_SUCCESS, "aclrtRecordEvent for staging ring failed, ret: ", ret);
+            guard.Recorded();
+            return 0;
+        };
+        at_npu::native::OpCommand::RunOpApi("TilingUpload", acl_call);
+    }
+
+private:
+    // FREE: no copy uses the slot, QUEUED: the copy waits in the task queue, RECORDED: the event after the copy is
+    // recorded, FAILED: the task queue gave up on the copy or its event
+    enum SlotState : int { SLOT_FREE, SLOT_QUEUED, SLOT_RECORDED, SLOT_FAILED };
+
+    struct Slot {
+        aclrtEvent event{nullptr};
+        std::shared_ptr<std::atomic<int>> state{std::make_shared<std::atomic<int>>(SLOT_FREE)};
+    };
+
+    class SlotStateGuard
+    {
+    public:
+        explicit SlotStateGuard(std::atomic<int> &state) : state_(state) {}
+
+        ~SlotStateGuard()
+        {
+            state_.store(recorded_ ? SLOT_RECORDED : SLOT_FAILED, std::memory_order_release);
+        }
+
+        void Recorded()
+        {
+            recorded_ = true;
+        }
+
+    private:
+        std::atomic<int> &state_;
+        bool recorded_{false};
+    };
+
+    // Waits until the previous copy of the slot no longer reads its staging memory. That copy may still wait in the
+    // task queue, so the wait for its event to be recorded is bounded.
+    void Reclaim(Slot &slot)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(STAGING_RING_RECORD_TIMEOUT_MS);
+        int state = slot.state->load(std::memory_order_acquire);
+        while (state == SLOT_QUEUED && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+            state = slot.state->load(std::memory_order_acquire);
+        }
+        if (state == SLOT_FREE) {
+            return;
+        }
+        TORCH_CHECK(state != SLOT_QUEUED, "staging ring slot was not recorded by the task queue within ",
+                    STAGING_RING_RECORD_TIMEOUT_MS, " ms");
+        if (state == SLOT_FAILED) {
+            // the task queue has already reported the failed op, only make sure its copy no longer reads the slot:
+            // the copy may have been issued before its event failed, so drain the stream before the slot is reused
+            auto ret = aclrtSynchronizeStream(stream_);
+            TORCH_CHECK(ret == ACL_SUCCESS, "aclrtSynchronizeStream for staging ring failed, ret: ", ret);
+            slot.state->store(SLOT_FREE, std::memory_order_relaxed);
+            return;
+        }
+        aclrtEventRecordedStatus status = ACL_EVENT_RECORDED_STATUS_NOT_READY;
+        aclrtQueryEventStatus(slot.event, &status);
+        if (status != ACL_EVENT_RECORDED_STATUS_COMPLETE) {
+            TORCH_CHECK(aclrtSynchronizeEvent(slot.event) == ACL_SUCCESS, "staging ring slot wait failed");
+        }
+        slot.state->store(SLOT_FREE, std::memory_order_relaxed);
+    }
+
+    std::mutex mutex_;
+    aclrtStream stream_;
+    void *hostBase_{nullptr};
+    std::vector<Slot> slots_;
+    uint32_t next_{0};
+};
+
+/**
+ * @brief Uploads host tiling blobs into freshly allocated device tensors through the per-stream staging rings.
+ */
+class TilingUploader
+{
+public:
+    static TilingUploader &Instance()
+    {
+        // intentionally leaked, pinned memory and events must not be released after the NPU runtime is finalized
+        static TilingUploader *uploader = new TilingUploader();
+        return *uploader;
+    }
+
+    at::Tensor Upload(const at::Tensor &hostTiling)
+    {
+        size_t size = hostTiling.nbytes();
+        if (size > STAGING_RING_SLOT_SIZE) {
+            return TorchNpuHelper::CopyTensorHostToDevice(hostTiling);
+        }
+
+        int deviceIndex = 0;
+        c10_npu::GetDevice(&deviceIndex);
+        at::Tensor deviceTiling =
+            at::empty({static_cast<int64_t>(size)},
+                      at::TensorOptions().dtype(at::kByte).device(c10::Device(DEVICE_TYPE, deviceIndex)));
+
+        // a copy captured into a graph would read the staging slot again on every replay, after the slot has
+        // been recycled, so tiling built while capturing is copied synchronously outside of the stream
+        if (c10_npu::currentStreamCaptureStatusMayInitCtx() != c10_npu::CaptureStatus::None) {
+            auto acl_call = [dst = deviceTiling.data_ptr(), hostTiling, size]() -> int {
+                auto ret = aclrtMemcpy(dst, size, hostTiling.data_ptr(), size, ACL_MEMCPY_HOST_TO_DEVICE);
+                TORCH_CHECK(ret == ACL_SUCCESS, "aclrtMemcpy of tiling data failed, ret: ", ret);
+                return 0;
+            };
+            at_npu::native::OpCommand::RunOpApi("TilingUpload", acl_call);
+            return deviceTiling;
+        }
+
+        aclrtStream stream = c10_npu::getCurrentNPUStream().stream(false);
+        GetRing(deviceIndex, stream).Upload(deviceTiling.data_ptr(), hostTiling.data_ptr(), size);
+        return deviceTiling;
+    }
+
+private:
+    TilingUploader() = default;
+
+    // the global lock only guards the map, rings are never removed so the returned one stays valid
+    StagingRing &GetRing(int deviceIndex, aclrtStream stream)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &ring = rings_[std::make_pair(deviceIndex, stream)];
+        if (ring == nullptr) {
+            ring = std::make_unique<StagingRing>(stream);
+        }
+        return *ring;
+    }
+
+    std::mutex mutex_;
+    std::map<std::pair<int, aclrtStream>, std::unique_ptr<StagingRing>> rings_;
+};
+
+}  // namespace npu_kernel
+}  // namespace sglang
+
+#endif  // SGL_KERNEL_NPU_STAGING_RING_H
@@ -0,0 +1,273 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_TILING_CACHE_H
+#define SGL_KERNEL_NPU_TILING_CACHE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <c10/util/SmallVector.h>
+#include "common.h"
+#include "torch_helper.h"
+#include "staging_ring.h"
+#include "host_profiler.h"
+#include "torch_npu/csrc/core/npu/NPUGraphsUtils.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr size_t TILING_CACHE_DEFAULT_CAPACITY = 4096;
+constexpr size_t TILING_CACHE_KEY_INLINE_FIELDS = 32;
+constexpr size_t TILING_CACHE_PADDING_BYTE = 32;
+constexpr const char *TILING_CACHE_CAPACITY_ENV = "SGL_KERNEL_NPU_TILING_CACHE_SIZE";
+
+/**
+ * @brief Launch parameters of one op shape. The tiling blob already lives on the device, blockDim and
+ *        workspaceSize are kept on the host so that a cache hit needs no tiling computation at all.
+ */
+struct TilingCacheEntry {
+    at::Tensor tiling;
+    uint32_t blockDim{0};
+    uint64_t workspaceSize{0};
+};
+
+/**
+ * @brief Cache key built from the op name and every host value the tiling depends on (shapes, dtypes,
+ *        attributes). The op name must be a string literal, it is compared by content but never copied.
+ */
+class TilingCacheKey
+{
+public:
+    template <typename... Args>
+    explicit TilingCacheKey(const char *opName, const Args &...args) : opName_(opName)
+    {
+        int deviceIndex = 0;
+        c10_npu::GetDevice(&deviceIndex);
+        Append(deviceIndex);
+        (Append(args), ...);
+        hash_ = std::hash<c10::string_view>{}(opName_);
+        for (auto field : fields_) {
+            hash_ = host_utils::TupleHasher::Hash(std::make_tuple(hash_, field));
+        }
+    }
+
+    bool operator==(const TilingCacheKey &other) const
+    {
+        return hash_ == other.hash_ && opName_ == other.opName_ && fields_ == other.fields_;
+    }
+
+    size_t Hash() const
+    {
+        return hash_;
+    }
+
+    const char *OpName() const
+    {
+        return opName_.data();
+    }
+
+private:
+    template <typename T>
+    void Append(const T &value)
+    {
+        if constexpr (std::is_enum_v<T>) {
+            fields_.push_back(static_cast<int64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double dValue = static_cast<double>(value);
+            int64_t bits = 0;
+            std::memcpy(&bits, &dValue, sizeof(bits));
+            fields_.push_back(bits);
+        } else if constexpr (std::is_integral_v<T>) {
+            fields_.push_back(static_cast<int64_t>(value));
+        } else if constexpr (std::is_convertible_v<const T &, c10::string_view>) {
+            fields_.push_back(static_cast<int64_t>(std::hash<c10::string_view>{}(c10::string_view(value))));
+        } else if constexpr (std::is_same_v<T, at::Tensor>) {
+            fields_.push_back(static_cast<int64_t>(value.scalar_type()));
+            Append(value.sizes());
+        } else if constexpr (std::is_same_v<T, c10::optional<at::Tensor>>) {
+            fields_.push_back(static_cast<int64_t>(value.has_value()));
+            if (value.has_value()) {
+                Append(value.value());
+            }
+        } else {
+            static_assert(std::is_same_v<T, at::IntArrayRef>, "unsupported tiling cache key field");
+            fields_.push_back(static_cast<int64_t>(value.size()));
+            fields_.append(value.begin(), value.end());
+        }
+    }
+
+    c10::string_view opName_;
+    c10::SmallVector<int64_t, TILING_CACHE_KEY_INLINE_FIELDS> fields_;
+    size_t hash_{0};
+};
+
+struct TilingCacheKeyHasher {
+    size_t operator()(const TilingCacheKey &key) const noexcept
+    {
+        return key.Hash();
+    }
+};
+
+/**
+ * @brief Process wide, LRU bounded cache of device tiling buffers shared by all op hosts.
+ *
+ * On a miss the builder computes the tiling on the host, fills blockDim/workspaceSize of the entry and returns
+ * the tiling blob as a CPU byte tensor, which is uploaded once through the pinned staging ring of the current stream
+ * and kept on the device. On a hit neither the tiling computation nor the H2D copy is repeated. The capacity can be
+ * set with SGL_KERNEL_NPU_TILING_CACHE_SIZE. Entries built or hit while a graph is being captured are pinned: the
+ * graph keeps the raw address of their tiling buffer, so they are never evicted and do not count to the capacity.
+ */
+class TilingCache
+{
+public:
+    static TilingCache &Instance()
+    {
+        // intentionally leaked, device buffers must not be released after the NPU runtime is finalized
+        static TilingCache *cache = new TilingCache();
+        return *cache;
+    }
+
+    template <typename TilingBuilder>
+    TilingCacheEntry GetOrCreate(const TilingCacheKey &key, TilingBuilder &&builder)
+    {
+        if (host_utils::HostProfiler::Enabled()) {
+            host_utils::HostProfiler::SetCurrentOp(key.OpName());
+        }
+        const bool capturing = c10_npu::currentStreamCaptureStatusMayInitCtx() != c10_npu::CaptureStatus::None;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                return Touch(it->second, capturing);
+            }
+        }
+
+        TilingCacheEntry entry;
+        at::Tensor hostTiling;
+        {
+            host_utils::HostProfileScope scope(key.OpName(), host_utils::HostStage::TILING);
+            hostTiling = builder(entry);
+        }
+        {
+            host_utils::HostProfileScope scope(key.OpName(), host_utils::HostStage::TILING_UPLOAD);
+            entry.tiling = TilingUploader::Instance().Upload(hostTiling);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            // another thread has built the same shape meanwhile, keep the first one
+            return Touch(it->second, capturing);
+        }
+        LruList &list = capturing ? pinned_ : lru_;
+        list.push_front(Node{key, entry, capturing});
+        index_.emplace(key, list.begin());
+        while (lru_.size() > capacity_) {
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+        }
+        return entry;
+    }
+
+    /**
+     * @brief Allocate a 32 bytes aligned CPU buffer and construct the tiling struct in place, the padding is zeroed.
+     */
+    template <typename TilingDataType>
+    static at::Tensor AllocHostBuffer(TilingDataType *&tilingData)
+    {
+        int64_t tilingSize = static_cast<int64_t>(
+            host_utils::RoundUp<size_t>(sizeof(TilingDataType), TILING_CACHE_PADDING_BYTE));
+        auto buffer = at::zeros({tilingSize}, at::TensorOptions().dtype(at::kByte).device(at::kCPU));
+        tilingData = new (buffer.data_ptr()) TilingDataType();
+        return buffer;
+    }
+
+    template <typename TilingDataType>
+    static at::Tensor HostBuffer(const TilingDataType &tilingData)
+    {
+        TilingDataType *dst = nullptr;
+        auto buffer = AllocHostBuffer(dst);
+        std::memcpy(dst, &tilingData, sizeof(TilingDataType));
+        return buffer;
+    }
+
+    /**
+     * @brief Forget all entries so that every shape is built again. The tiling buffers of pinned entries stay alive,
+     *        captured graphs may still replay them.
+     */
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &node : pinned_) {
+            retiredPinned_.push_back(std::move(node.entry.tiling));
+        }
+        index_.clear();
+        lru_.clear();
+        pinned_.clear();
+    }
+
+private:
+    TilingCache()
+    {
+        capacity_ = TILING_CACHE_DEFAULT_CAPACITY;
+        if (const char *env = std::getenv(TILING_CACHE_CAPACITY_ENV)) {
+            long value = std::strtol(env, nullptr, 10);
+            if (value > 0) {
+                capacity_ = static_cast<size_t>(value);
+            }
+        }
+    }
+
+    TilingCache(const TilingCache &) = delete;
+    TilingCache &operator=(const TilingCache &) = delete;
+
+    struct Node {
+        TilingCacheKey key;
+        TilingCacheEntry entry;
+        bool captured{false};
+    };
+    using LruList = std::list<Node>;
+
+    // called with mutex_ held, marks the entry recently used and pins it when the hit is being captured
+    TilingCacheEntry Touch(LruList::iterator node, bool capturing)
+    {
+        if (node->captured) {
+            return node->entry;
+        }
+        if (capturing) {
+            node->captured = true;
+            pinned_.splice(pinned_.begin(), lru_, node);
+        } else {
+            lru_.splice(lru_.begin(), lru_, node);
+        }
+        return node->entry;
+    }
+
+    std::mutex mutex_;
+    size_t capacity_;
+    LruList lru_;
+    LruList pinned_;
+    std::vector<at::Tensor> retiredPinned_;
+    std::unordered_map<TilingCacheKey, LruList::iterator, TilingCacheKeyHasher> index_;
+};
+
+}  // namespace npu_kernel
+}  // namespace sglang
+
+#endif  // SGL_KERNEL_NPU_TILING_CACHE_H
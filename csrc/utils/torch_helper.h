@@ -16,6 +16,7 @@
 
 #include "torch_npu/csrc/core/npu/NPUStream.h"
 #include "torch_npu/csrc/framework/OpCommand.h"
+#include "host_profiler.h"
 
 namespace sglang {
 namespace npu_kernel {
@@ -64,20 +65,21 @@ public:
  * @param kernel_name      [in] name of kernel
  * @param blockdim         [in] dim size of block
  */
-#define EXEC_KERNEL_CMD(kernel_name, blockdim, ...)                                            \
-    do {                                                                                       \
-        auto acl_stream = c10_npu::getCurrentNPUStream().stream(false);                        \
-        auto converted_params = sglang::npu_kernel::TorchNpuHelper::ConvertTypes(__VA_ARGS__); \
-        auto acl_call = [acl_stream, blockdim, converted_params]() -> int {                    \
-            std::apply(                                                                        \
-                [&](auto &&...params) {                                                        \
-                    ACLRT_LAUNCH_KERNEL(kernel_name)                                           \
-                    (blockdim, acl_stream, params...);                                         \
-                },                                                                             \
-                converted_params);                                                             \
-            return 0;                                                                          \
-        };                                                                                     \
-        at_npu::native::OpCommand::RunOpApi(#kernel_name, acl_call);                           \
+#define EXEC_KERNEL_CMD(kernel_name, blockdim, ...)                                              \
+    do {                                                                                         \
+        host_utils::HostProfileScope profile_scope(#kernel_name, host_utils::HostStage::LAUNCH); \
+        auto acl_stream = c10_npu::getCurrentNPUStream().stream(false);                          \
+        auto converted_params = sglang::npu_kernel::TorchNpuHelper::ConvertTypes(__VA_ARGS__);   \
+        auto acl_call = [acl_stream, blockdim, converted_params]() -> int {                      \
+            std::apply(                                                                          \
+                [&](auto &&...params) {                                                          \
+                    ACLRT_LAUNCH_KERNEL(kernel_name)                                             \
+                    (blockdim, acl_stream, params...);                                           \
+                },                                                                               \
+                converted_params);                                                               \
+            return 0;                                                                            \
+        };                                                                                       \
+        at_npu::native::OpCommand::RunOpApi(#kernel_name, acl_call);                             \
     } while (false)
 
 #endif  // SGL_KERNEL_NPU_TORCH_NPU_HELPER_H
@@ -0,0 +1,105 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_WORKSPACE_ARENA_H
+#define SGL_KERNEL_NPU_WORKSPACE_ARENA_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "torch_helper.h"
+#include "host_profiler.h"
+#include "torch_npu/csrc/core/npu/NPUGraphsUtils.h"
+
+namespace sglang {
+namespace npu_kernel {
+
+constexpr uint64_t WORKSPACE_ARENA_MIN_CLASS = 64 * 1024;
+
+enum class WorkspaceSlot : uint32_t {
+    KERNEL = 0,  // workspace argument of an EXEC_KERNEL_CMD launch
+    SYNC = 1,    // zero initialized cross core synchronization region
+};
+
+/**
+ * @brief Grow-only device buffers per (device, stream, slot), borrowed by op hosts for their workspace.
+ *
+ * Launches on one stream execute in order, so every op of that stream can reuse the same buffer. A request is
+ * rounded up to a power of two size class (at least 64KB) and the buffer only grows, so steady state launches do
+ * not reach the caching allocator at all. While a graph is being captured the buffer is allocated from the graph
+ * pool for every call instead, an arena buffer released by a later growth must not be referenced by a graph.
+ */
+class WorkspaceArena
+{
+public:
+    static WorkspaceArena &Instance()
+    {
+        // intentionally leaked, device buffers must not be released after the NPU runtime is finalized
+        static WorkspaceArena *arena = new WorkspaceArena();
+        return *arena;
+    }
+
+    /**
+     * @brief Borrow a buffer of at least size bytes on device, the device of the op's inputs, which need not be the
+     *        current one.
+     */
+    at::Tensor Borrow(const c10::Device &device, uint64_t size, WorkspaceSlot slot = WorkspaceSlot::KERNEL)
+    {
+        host_utils::HostProfileScope scope(host_utils::HostProfiler::GetCurrentOp(), host_utils::HostStage::WORKSPACE);
+        auto stream = c10_npu::getCurrentNPUStream(device.index());
+        auto options = at::TensorOptions().dtype(at::kByte).device(device);
+        if (c10_npu::currentStreamCaptureStatusMayInitCtx() != c10_npu::CaptureStatus::None) {
+            return at::empty({static_cast<int64_t>(size)}, options);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = std::make_tuple(static_cast<int>(stream.device_index()), stream.stream(false), slot);
+        at::Tensor &buffer = buffers_[key];
+        if (!buffer.defined() || static_cast<uint64_t>(buffer.numel()) < size) {
+            // the old buffer goes back to the caching allocator behind the ops of this stream that still use it
+            buffer = at::empty({static_cast<int64_t>(SizeClass(size))}, options);
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Borrow a buffer of exactly size bytes and zero it on the device, ordered before the next launch.
+     */
+    at::Tensor BorrowZeroed(const c10::Device &device, uint64_t size, WorkspaceSlot slot = WorkspaceSlot::SYNC)
+    {
+        at::Tensor buffer = Borrow(device, size, slot).narrow(0, 0, static_cast<int64_t>(size));
+        buffer.zero_();
+        return buffer;
+    }
+
+private:
+    WorkspaceArena() = default;
+    WorkspaceArena(const WorkspaceArena &) = delete;
+    WorkspaceArena &operator=(const WorkspaceArena &) = delete;
+
+    static uint64_t SizeClass(uint64_t size)
+    {
+        uint64_t sizeClass = WORKSPACE_ARENA_MIN_CLASS;
+        while (sizeClass < size) {
+            sizeClass <<= 1;
+        }
+        return sizeClass;
+    }
+
+    std::mutex mutex_;
+    std::map<std::tuple<int, aclrtStream, WorkspaceSlot>, at::Tensor> buffers_;
+};
+
+}  // namespace npu_kernel
+}  // namespace sglang
+
+#endif  // SGL_KERNEL_NPU_WORKSPACE_ARENA_H
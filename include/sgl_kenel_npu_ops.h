@@ -46,6 +46,38 @@ void build_tree_efficient(
     const at::Tensor &retrive_next_sibling, int64_t topk, int64_t depth,
     int64_t draft_token_num, int64_t tree_mask_mode);
 
+// CPU implementations of the KV memory management ops, registered for the CPU dispatch key
+at::Tensor cache_loc_assign_cpu(const at::Tensor &req_indices,
+                                const at::Tensor &token_pool,
+                                const at::Tensor &start_offset,
+                                const at::Tensor &end_offset,
+                                const at::Tensor &out_cache_loc);
+
+at::Tensor cache_loc_update_cpu(const at::Tensor &req_indices,
+                                const at::Tensor &token_pool,
+                                const at::Tensor &start_offset,
+                                const at::Tensor &end_offset,
+                                const at::Tensor &out_cache_loc);
+
+bool assign_cache_op_cpu(at::Tensor &dst_tensor, const at::Tensor &src_tensor,
+                         const at::Tensor &dst_start_idx,
+                         const at::Tensor &dst_end_idx,
+                         const at::Tensor &src_start_idx,
+                         const at::Tensor &src_end_idx);
+
+void alloc_extend_cpu(const at::Tensor &pre_lens, const at::Tensor &seq_lens,
+                      const at::Tensor &last_loc, const at::Tensor &free_pages,
+                      int64_t pages_size, at::Tensor &out_indices,
+                      at::Tensor &values);
+
+void build_tree_efficient_cpu(
+    const at::Tensor &parent_list, const at::Tensor &selected_index,
+    const at::Tensor &verified_seq_len, const at::Tensor &tree_mask,
+    const at::Tensor &positions, const at::Tensor &retrive_index,
+    const at::Tensor &retrive_next_token,
+    const at::Tensor &retrive_next_sibling, int64_t topk, int64_t depth,
+    int64_t draft_token_num, int64_t tree_mask_mode);
+
 std::tuple<at::Tensor &, at::Tensor &, at::Tensor &, at::Tensor &>
 mla_preprocess(const at::Tensor &hiddenState, const at::Tensor &gamma0,
                const at::Tensor &beta0, const at::Tensor &wdqkv,
@@ -113,6 +145,17 @@ at::Tensor lightning_indexer(
     c10::optional<c10::string_view> layout_key,
     c10::optional<int64_t> sparse_count, c10::optional<int64_t> sparse_mode);
 
+int64_t matmul_tuning_db_load(c10::string_view path);
+
+int64_t matmul_tuning_db_save(c10::string_view path);
+
+std::vector<int64_t> matmul_tuning_trace(bool enable);
+
+std::vector<int64_t> matmul_tuning_candidates(c10::IntArrayRef key);
+
+void matmul_tuning_set(c10::IntArrayRef key, c10::IntArrayRef value,
+                       double time_us);
+
 } // namespace npu_kernel
 
 } // namespace sglang
@@ -5,7 +5,7 @@ import deep_ep_cpp
 import torch
 import torch.distributed as dist
 import torch_npu
-from deep_ep_cpp import Config, EventHandle
+from deep_ep_cpp import Config, DispatchLayout, EventHandle
 
 from .utils import EventOverlap, log_parameters
 
@@ -40,6 +40,7 @@ class Buffer:
         """
 
         self.rank = group.rank()
+        self.group = group
         self.group_size = group.size()
         self.num_nvl_bytes = num_nvl_bytes
         self.num_rdma_bytes = num_rdma_bytes
@@ -130,7 +131,7 @@ class Buffer:
     @staticmethod
     def capture() -> EventOverlap:
         """
-        Capture a CUDA event on the current stream, i.e. `torch.cuda.current_stream()`.
+        Capture an NPU event on the current stream, i.e. `torch.npu.current_stream()`.
 
         Returns:
             event: the captured event.
@@ -156,8 +157,14 @@ class Buffer:
         previous_event: Optional[EventOverlap] = None,
         async_finish: bool = False,
         allocate_on_comm_stream: bool = False,
+        expert_replica_table: Optional[torch.Tensor] = None,
     ) -> Tuple[
-        torch.Tensor, Optional[torch.Tensor], torch.Tensor, torch.Tensor, EventOverlap
+        torch.Tensor,
+        Optional[torch.Tensor],
+        torch.Tensor,
+        torch.Tensor,
+        DispatchLayout,
+        EventOverlap,
     ]:
         """
         Calculate the layout required for later communication.
@@ -169,13 +176,24 @@ class Buffer:
             previous_event: the event to wait before actually executing the kernel.
             async_finish: the current stream will not wait for the communication kernels to be finished if set.
             allocate_on_comm_stream: control whether all the allocated tensors' ownership to be on the communication stream.
+            expert_replica_table: `[num_logical_experts, 1 + max_replicas]` with `torch.int`, optional. Row `e` holds
+                the replica count of logical expert `e` followed by the physical expert ids of its replicas, at most 8,
+                every id in `[0, num_experts)`. Only its shape and type are checked, entries out of range keep the
+                logical id.
+                With it `topk_idx` holds logical ids, token `t` is routed to replica `t % count` of each of its
+                experts, `num_experts` is the number of physical experts, and the following dispatch and combine use
+                the physical ids (`recv_topk_idx` of the dispatch holds them).
 
         Returns:
             num_tokens_per_rank: `[num_ranks]` with `torch.int`, the number of tokens to be sent to each rank.
             num_tokens_per_rdma_rank: `[num_rdma_ranks]` with `torch.int`, the number of tokens to be sent to each RDMA
                 rank (with the same GPU index), return `None` for intranode settings.
             num_tokens_per_expert: `[num_experts]` with `torch.int`, the number of tokens to be sent to each expert.
-            is_token_in_rank: `[num_tokens, num_ranks]` with `torch.int`, whether a token be sent to a rank.
+            is_token_in_rank: `[num_tokens, num_ranks]` with `torch.int`, whether a token be sent to a rank. With
+                `self.runtime.is_token_in_rank_bitmap` (or `DEEPEP_IS_TOKEN_IN_RANK_BITMAP=1`) it is packed as
+                `[num_tokens, (num_ranks + 31) // 32]`, bit `r % 32` of column `r // 32` is set for rank `r`.
+            layout: an opaque object holding the routing of these tokens, pass it as `layout` to the dispatch of the
+                same tokens. Any number of layouts may be outstanding, e.g. one per micro-batch.
             event: the event after executing the kernel (valid only if `async_finish` is set).
         """
         (
@@ -183,6 +201,7 @@ class Buffer:
             num_tokens_per_rdma_rank,
             num_tokens_per_expert,
             is_token_in_rank,
+            layout,
             event,
         ) = self.runtime.get_dispatch_layout(
             topk_idx,
@@ -190,24 +209,29 @@ class Buffer:
             getattr(previous_event, "event", None),
             async_finish,
             allocate_on_comm_stream,
+            expert_replica_table,
         )
         return (
             num_tokens_per_rank,
             num_tokens_per_rdma_rank,
             num_tokens_per_expert,
             is_token_in_rank,
+            layout,
             EventOverlap(event),
         )
 
     # internal interface, Only use in test
-    def get_notify_send_data(self) -> torch.Tensor:
+    def get_notify_send_data(self, layout: DispatchLayout) -> torch.Tensor:
         """
         Internal interface, we only use it to check the output of get_dispatch_layout.
 
+        Arguments:
+            layout: the layout returned by `get_dispatch_layout`.
+
         Returns:
-            notify_send_data: the member variable of buffer, which usually contains the output of get_dispatch_layout.
+            notify_send_data: the notify send data that `get_dispatch_layout` wrote into `layout`.
         """
-        notify_send_data = self.runtime.get_notify_send_data()
+        notify_send_data = self.runtime.get_notify_send_data(layout)
         return notify_send_data
 
     def clean_low_latency_buffer(
@@ -228,6 +252,58 @@ class Buffer:
             num_max_dispatch_tokens_per_rank, hidden, num_experts
         )
 
+    def get_next_low_latency_combine_buffer(self, handle: object) -> torch.Tensor:
+        """
+        Get the persistent buffer to write the expert outputs of a low-latency dispatch into, then pass it to
+            `low_latency_combine` with `zero_copy=True`.
+
+        Arguments:
+            handle: the communication handle given by the `low_latency_dispatch` function.
+
+        Returns:
+            buffer: a `torch.bfloat16` tensor shaped like the received tokens of that dispatch. It belongs to the
+                buffer and is reused by the low-latency dispatch after the next one.
+        """
+        return self.runtime.get_next_low_latency_combine_buffer(handle[6])
+
+    def get_cost_stats_histograms(
+        self, cost_stats: torch.Tensor, num_bins: int = 10
+    ) -> Tuple[torch.Tensor, torch.Tensor, torch.Tensor]:
+        """
+        Gather the per-peer cost stats of all the ranks and count them into one latency histogram per peer rank, a slow
+            card or link then shows up as the histogram shifted to the high bins. All the ranks must call it.
+
+        Arguments:
+            cost_stats: `[num_ranks]` with `torch.int`, the `dispatch_wait_recv_cost_stats` or `combine_send_cost_stats`
+                recorded by this rank, entry `j` is the time spent on peer `j`.
+            num_bins: the number of bins, shared by all the peers and spanning `[0, max cost]`.
+
+        Returns:
+            cost_matrix: `[num_ranks, num_ranks]` with `torch.int`, row `i` is the `cost_stats` of rank `i`.
+            histograms: `[num_ranks, num_bins]` with `torch.int64` on the CPU, row `j` counts the costs all the ranks
+                recorded for peer `j`.
+            bin_edges: `[num_bins + 1]` with `torch.float` on the CPU, the edges of the bins.
+        """
+        assert cost_stats.dim() == 1 and cost_stats.size(0) == self.group_size
+        cost_matrix = torch.empty(
+            (self.group_size, self.group_size),
+            dtype=cost_stats.dtype,
+            device=cost_stats.device,
+        )
+        dist.all_gather_into_tensor(
+            cost_matrix, cost_stats.contiguous(), group=self.group
+        )
+        peer_costs = cost_matrix.t().float().cpu()
+        max_cost = max(peer_costs.max().item(), 1.0)
+        histograms = torch.stack(
+            [
+                torch.histc(costs, bins=num_bins, min=0, max=max_cost)
+                for costs in peer_costs
+            ]
+        ).long()
+        bin_edges = torch.linspace(0, max_cost, num_bins + 1)
+        return cost_matrix, histograms, bin_edges
+
     # noinspection PyTypeChecker
     @log_parameters(["topk_idx"])
     def dispatch(
@@ -247,11 +323,13 @@ class Buffer:
         async_finish: bool = False,
         allocate_on_comm_stream: bool = False,
         dispatch_wait_recv_cost_stats: Optional[torch.Tensor] = None,
+        cumulative_local_expert_recv_stats: Optional[torch.Tensor] = None,
+        layout: Optional[DispatchLayout] = None,
     ) -> Tuple[
         Union[Tuple[torch.Tensor, torch.Tensor], torch.Tensor],
         Optional[torch.Tensor],
         Optional[torch.Tensor],
-        List[int],
+        Union[List[int], torch.Tensor],
         Tuple,
         EventOverlap,
     ]:
@@ -266,7 +344,10 @@ class Buffer:
                 and type must be `torch.bfloat16`; for the second type, the first element of the tuple must be shaped as
                 `[num_tokens, hidden]` with type `torch.float8_e4m3fn`, the second must be `[num_tokens, hidden // 128]`
                  (requiring divisible) with type `torch.float`.
-            handle: an optional communication handle, if set, the CPU will reuse the layout information to save some time.
+            handle: an optional communication handle, if set, the routing of that earlier dispatch is reused for `x`
+                (which must have the same number of tokens) and the metadata exchange of `notify_dispatch` with its
+                CPU sync is skipped; `num_tokens_per_rank`, `is_token_in_rank`, `num_tokens_per_expert` and `topk_idx`
+                are then ignored, and `topk_weights` defaults to the one of the handle.
             num_tokens_per_rank: `[num_ranks]` with `torch.int`, the number of tokens to be sent to each rank.
             num_tokens_per_rdma_rank: `[num_rdma_ranks]` with `torch.int`, the number of tokens to be sent to each RDMA
                 rank (with the same GPU index), return `None` for intranode settings.
@@ -277,13 +358,19 @@ class Buffer:
             topk_weights: `[num_tokens, num_topk]` with `torch.float`, the expert weights of each token to dispatch.
             expert_alignment: align the number of tokens received by each local expert to this variable.
             num_worst_tokens: the worst number of tokens to receive, if specified, there will be no CPU sync, and it
-                will be CUDA-graph compatible. Please also notice that this flag is for intranode only.
+                will be NPU-graph compatible. The received tensors are sized to this bound, which must be the same on
+                every rank and cover both the number of tokens of any rank and the number of rows received here.
             config: the performance tuning config.
             previous_event: the event to wait before actually executing the kernel.
             async_finish: the current stream will not wait for the communication kernels to be finished if set.
             allocate_on_comm_stream: control whether all the allocated tensors' ownership to be on the communication stream.
             dispatch_wait_recv_cost_stats: `[num_ranks]` with `torch.int`, record the time it takes for the dispatch phase
-                to receive all tokens from each slave rank in the current rank.
+                to receive all tokens from each slave rank in the current rank. Internode, it is the wait for the peer
+                in this server and for the rank with the same local index in every other server. See
+                `get_cost_stats_histograms` to find a slow rank from it.
+            cumulative_local_expert_recv_stats: `[num_local_experts]` with `torch.int`, the number of tokens each local
+                expert receives is added to it on the device, for EP load balance monitoring.
+            layout: the layout that `get_dispatch_layout` returned for these tokens, required unless `handle` is set.
 
         Returns:
             recv_x: received tokens, the first element is a `torch.Tensor` shaped as `[received_token_count, hidden]` with
@@ -292,9 +379,10 @@ class Buffer:
             recv_topk_idx: received expert indices.
             recv_topk_weights: received expert weights.
             num_recv_tokens_per_expert_list: Python list shaped `[num_local_experts]`, the received token count by
-                each local expert, aligned to the input `expert_alignment`. If `num_worst_tokens` is specified, the list
-                will be empty.
-            handle: the returned communication handle.
+                each local expert, aligned to the input `expert_alignment`. If `num_worst_tokens` is specified, it is
+                the same counts as a `torch.int64` tensor on the device instead, so that no CPU sync is needed.
+            handle: the returned communication handle, it also carries the routing state the matching `combine` needs, so
+                dispatches and combines of several micro-batches can interleave on one buffer.
             event: the event after executing the kernel (valid only if `async_finish` is set).
         """
         # Default config
@@ -312,10 +400,14 @@ class Buffer:
                 topk_idx,
                 topk_weights,
                 expert_alignment,
+                num_worst_tokens,
                 config,
                 previous_event,
                 async_finish,
                 allocate_on_comm_stream,
+                dispatch_wait_recv_cost_stats,
+                cumulative_local_expert_recv_stats,
+                layout,
             )
 
         # Launch the kernel with cached or non-cached mode
@@ -325,65 +417,79 @@ class Buffer:
         use_quant = os.getenv("DEEP_NORMAL_MODE_USE_INT8_QUANT") == "1"
 
         if handle is not None:
-            raise NotImplementedError(
-                "Optional communication handle is not supported yet."
-            )
+            # Cached mode, reuse the routing and the notify results of the handle
+            is_token_in_rank, topk_idx = handle[4], handle[6]
+            cached_dispatch_handle = handle[8]
+            topk_weights = handle[7] if topk_weights is None else topk_weights
+            num_tokens_per_rank, num_tokens_per_expert, layout = None, None, None
         else:
             assert (
                 num_tokens_per_rank is not None
                 and is_token_in_rank is not None
                 and num_tokens_per_expert is not None
+                and layout is not None
             )
+            cached_dispatch_handle = None
+        (
+            recv_x,
+            recv_x_scales,
+            recv_topk_idx,
+            recv_topk_weights,
+            num_recv_tokens_per_expert_list,
+            rank_prefix_matrix,
+            channel_prefix_matrix,
+            recv_channel_prefix_matrix,
+            recv_src_idx,
+            send_head,
+            num_recv_tokens_per_expert,
+            dispatch_handle,
+            event,
+        ) = self.runtime.intranode_dispatch(
+            x,
+            x_scales,
+            topk_idx,
+            topk_weights,
+            num_tokens_per_rank,
+            is_token_in_rank,
+            num_tokens_per_expert,
+            0,
+            None,
+            None,
+            cached_dispatch_handle,
+            layout,
+            dispatch_wait_recv_cost_stats,
+            cumulative_local_expert_recv_stats,
+            expert_alignment,
+            num_worst_tokens,
+            config,
+            getattr(previous_event, "event", None),
+            async_finish,
+            allocate_on_comm_stream,
+            use_quant,
+        )
+        handle = (
+            rank_prefix_matrix,
+            channel_prefix_matrix,
+            recv_channel_prefix_matrix,
+            recv_src_idx,
+            is_token_in_rank,
+            send_head,
+            topk_idx,
+            topk_weights,
+            dispatch_handle,
+        )
+        return (
+            (recv_x, recv_x_scales) if use_quant else recv_x,
+            recv_topk_idx,
+            recv_topk_weights,
             (
-                recv_x,
-                recv_x_scales,
-                recv_topk_idx,
-                recv_topk_weights,
-                num_recv_tokens_per_expert_list,
-                rank_prefix_matrix,
-                channel_prefix_matrix,
-                recv_channel_prefix_matrix,
-                recv_src_idx,
-                send_head,
-                event,
-            ) = self.runtime.intranode_dispatch(
-                x,
-                x_scales,
-                topk_idx,
-                topk_weights,
-                num_tokens_per_rank,
-                is_token_in_rank,
-                num_tokens_per_expert,
-                0,
-                None,
-                None,
-                dispatch_wait_recv_cost_stats,
-                expert_alignment,
-                num_worst_tokens,
-                config,
-                getattr(previous_event, "event", None),
-                async_finish,
-                allocate_on_comm_stream,
-                use_quant,
-            )
-            handle = (
-                rank_prefix_matrix,
-                channel_prefix_matrix,
-                recv_channel_prefix_matrix,
-                recv_src_idx,
-                is_token_in_rank,
-                send_head,
-                topk_idx,
-                topk_weights,
-            )
-            return (
-                (recv_x, recv_x_scales) if use_quant else recv_x,
-                recv_topk_idx,
-                recv_topk_weights,
-                num_recv_tokens_per_expert_list,
-                handle,
-                EventOverlap(event),
-            )
+                num_recv_tokens_per_expert
+                if num_recv_tokens_per_expert is not None
+                else num_recv_tokens_per_expert_list
+            ),
+            handle,
+            EventOverlap(event),
+        )
 
         # noinspection PyTypeChecker
 
@@ -405,6 +511,7 @@ class Buffer:
         async_finish: bool = False,
         allocate_on_comm_stream: bool = False,
         dispatch_wait_recv_cost_stats: Optional[torch.Tensor] = None,
+        layout: Optional[DispatchLayout] = None,
     ) -> Tuple[
         torch.Tensor,
         torch.Tensor,
@@ -433,6 +540,7 @@ class Buffer:
                 num_tokens_per_rank is not None
                 and is_token_in_rank is not None
                 and num_tokens_per_expert is not None
+                and layout is not None
             )
             (
                 recv_data,
@@ -455,6 +563,7 @@ class Buffer:
                 0,
                 None,
                 None,
+                layout,
                 dispatch_wait_recv_cost_stats,
                 expert_alignment,
                 num_worst_tokens,
@@ -495,6 +604,8 @@ class Buffer:
         Intranode kernels require all the ranks should be visible via HCCS.
         Internode kernels require the ranks in a node should be visible via HCCS, while the ranks with the same GPU
             index should be visible via RDMA.
+        Setting `self.runtime.combine_comm_quant` (or `DEEPEP_NORMAL_COMBINE_COMM_QUANT=1`) makes the intranode kernel
+            send each token as per-token int8 and dequantize it on the receiver before the weighted sum.
 
         Arguments:
             x: `[num_tokens, hidden]` with `torch.bfloat16`, the tokens to send for reducing to its original ranks.
@@ -504,8 +615,9 @@ class Buffer:
             previous_event: the event to wait before actually executing the kernel.
             async_finish: the current stream will not wait for the communication kernels to be finished if set.
             allocate_on_comm_stream: control whether all the allocated tensors' ownership to be on the communication stream.
-            combine_send_cost_stats: `[num_ranks]`: record the time when the current rank sends all tokens to other ranks
-                in the combine phase.
+            combine_send_cost_stats: `[num_ranks]` with `torch.int`, record the time when the current rank sends all
+                tokens to other ranks in the combine phase. Internode, it is the wait for the peer in this server
+                and for the rank with the same local index in every other server. See `get_cost_stats_histograms`.
 
         Returns:
             recv_x: the reduced token from its dispatched ranks.
@@ -523,6 +635,7 @@ class Buffer:
                 previous_event,
                 async_finish,
                 allocate_on_comm_stream,
+                combine_send_cost_stats,
             )
 
         # NOTES: the second `_` is for the sending side, so we should use the third one
@@ -535,11 +648,21 @@ class Buffer:
             send_head,
             topk_idx,
             topk_weights_ori,
+            dispatch_handle,
         ) = handle
 
         # Launch the kernel
         recv_x, recv_topk_weights, event = self.runtime.intranode_combine(
-            x, topk_idx, topk_weights_ori, src_idx, send_head, combine_send_cost_stats
+            x,
+            topk_idx,
+            topk_weights_ori,
+            src_idx,
+            send_head,
+            combine_send_cost_stats,
+            dispatch_handle,
+            getattr(previous_event, "event", None),
+            async_finish,
+            allocate_on_comm_stream,
         )
         return recv_x, recv_topk_weights, EventOverlap(event)
 
@@ -554,15 +677,19 @@ class Buffer:
         topk_idx: Optional[torch.Tensor] = None,
         topk_weights: Optional[torch.Tensor] = None,
         expert_alignment: int = 1,
+        num_worst_tokens: int = 0,
         config: Optional[Config] = None,
         previous_event: Optional[EventOverlap] = None,
         async_finish: bool = False,
         allocate_on_comm_stream: bool = False,
+        dispatch_wait_recv_cost_stats: Optional[torch.Tensor] = None,
+        cumulative_local_expert_recv_stats: Optional[torch.Tensor] = None,
+        layout: Optional[DispatchLayout] = None,
     ) -> Tuple[
         Union[Tuple[torch.Tensor, torch.Tensor], torch.Tensor],
         Optional[torch.Tensor],
         Optional[torch.Tensor],
-        List[int],
+        Union[List[int], torch.Tensor],
         Tuple,
         EventOverlap,
     ]:
@@ -581,6 +708,7 @@ class Buffer:
                 num_tokens_per_rank is not None
                 and is_token_in_rank is not None
                 and num_tokens_per_expert is not None
+                and layout is not None
             )
             (
                 recv_x,
@@ -594,6 +722,8 @@ class Buffer:
                 offset_outer,
                 count_outer,
                 expand_scales,
+                num_recv_tokens_per_expert,
+                dispatch_handle,
                 event,
             ) = self.runtime.internode_dispatch(
                 x,
@@ -604,6 +734,10 @@ class Buffer:
                 num_tokens_per_rdma_rank,
                 is_token_in_rank,
                 num_tokens_per_expert,
+                layout,
+                dispatch_wait_recv_cost_stats,
+                cumulative_local_expert_recv_stats,
+                num_worst_tokens,
                 config,
                 getattr(previous_event, "event", None),
                 async_finish,
@@ -620,12 +754,17 @@ class Buffer:
                 offset_outer,  # token_server_idx
                 count_outer,
                 expand_scales,
+                dispatch_handle,
             )
             return (
                 (recv_x, recv_x_scales) if use_quant else recv_x,
                 recv_topk_idx,
                 recv_topk_weights,
-                num_recv_tokens_per_expert_list,
+                (
+                    num_recv_tokens_per_expert
+                    if num_worst_tokens > 0
+                    else num_recv_tokens_per_expert_list
+                ),
                 handle,
                 EventOverlap(event),
             )
@@ -640,6 +779,7 @@ class Buffer:
         previous_event: Optional[EventOverlap] = None,
         async_finish: bool = False,
         allocate_on_comm_stream: bool = False,
+        combine_send_cost_stats: Optional[torch.Tensor] = None,
     ) -> Tuple[torch.Tensor, Optional[torch.Tensor], EventOverlap]:
         """
         Internode combine implementation, for more details, please refer to the `combine` docs.
@@ -655,6 +795,7 @@ class Buffer:
             offset_outer,
             count_outer,
             expand_scales,
+            dispatch_handle,
         ) = handle
 
         # Launch the kernel
@@ -668,6 +809,11 @@ class Buffer:
             offset_outer,
             count_outer,
             expand_scales,
+            combine_send_cost_stats,
+            dispatch_handle,
+            getattr(previous_event, "event", None),
+            async_finish,
+            allocate_on_comm_stream,
         )
         return recv_x, recv_topk_weights, EventOverlap(event)
 
@@ -680,6 +826,7 @@ class Buffer:
         num_max_dispatch_tokens_per_rank: int,
         num_experts: int,
         cumulative_local_expert_recv_stats: Optional[torch.Tensor] = None,
+        dispatch_wait_recv_cost_stats: Optional[torch.Tensor] = None,
         use_fp8: bool = True,
         round_scale: bool = False,
         use_ue8m0: bool = False,
@@ -699,15 +846,21 @@ class Buffer:
             num_max_dispatch_tokens_per_rank: the maximum number of tokens to dispatch, all the ranks must hold the same value.
             num_experts: the number of all experts.
             cumulative_local_expert_recv_stats: a cumulative expert count tensor for statistics, which should have shape
-                `[num_local_experts]` and be typed as `torch.int`. This is useful for online service EP load balance
+                `[num_local_experts]` and be typed as `torch.int`. The number of tokens each local expert receives is
+                added to it on the device, without a host copy. This is useful for online service EP load balance
                 monitoring.
+            dispatch_wait_recv_cost_stats: `[num_ranks]` with `torch.int`, the time in us the current rank waits for
+                the tokens of each rank in the dispatch phase is added to it. See `get_cost_stats_histograms`.
             use_fp8: whether to enable FP8 casting, with this, the received data will be a tuple of FP8 tensor and scaling factors.
-            round_scale: whether round the scaling factors into power of 2.
-            use_ue8m0: whether use UE8M0 as scaling factor format (available only with `round_scale=True`).
+            round_scale: whether round the scaling factors up to powers of 2 (available only with `use_fp8=True`), so
+                that dequantization is an exact exponent shift.
+            use_ue8m0: whether use UE8M0 as scaling factor format (available only with `round_scale=True`), i.e. each
+                scale is returned as its biased exponent.
             async_finish: the current stream will not wait for the communication kernels to be finished if set.
-            return_recv_hook: return a receiving hook if set. If set, the kernel will just do the RDMA request issues,
-                but **without actually receiving the data**. You must call the received hook to make sure the data's arrival.
-                If you do not set this flag, the kernel will ensure the data's arrival.
+            return_recv_hook: return a receiving hook if set. If set, the kernel is launched on the communication
+                stream and the current stream is **not** ordered after it, so unrelated work can run in the meantime.
+                You must call the received hook on the stream that uses the outputs to make sure the data's arrival.
+                If you do not set this flag, the kernel will ensure the data's arrival. Cannot be used with `async_finish`.
 
         Returns:
             recv_x: a tensor or tuple with received tokens for each expert.
@@ -715,13 +868,15 @@ class Buffer:
                 `[num_local_experts, num_max_dispatch_tokens_per_rank * num_ranks, hidden]` with `torch.float8_e4m3fn`.
                 The second tensor is the corresponding scales for the first element with shape
                 `[num_local_experts, num_max_dispatch_tokens_per_rank * num_ranks, hidden // 128]` with `torch.float`,
-                if `use_ue8m0=False`. With `use_ue8m0=True`, the second one is packed and shaped as
-                `[num_local_experts, num_max_dispatch_tokens_per_rank * num_ranks, hidden // 512]` with type `torch.int`.
+                if `use_ue8m0=False`. With `use_ue8m0=True`, the second one holds the biased exponents of the scales
+                with type `torch.uint8`, a scale being `2 ** (exponent - 127)`.
                 Notice that, the last-two-dimension of the scaling tensors are in column-major for TMA compatibility.
                 With `use_fp8=False`, the result would be a tensor shaped as
                 `[num_local_experts, num_max_dispatch_tokens_per_rank * num_ranks, hidden]` with `torch.bfloat16`.
                 Moreover, not all tokens are valid, only some of the `num_max_dispatch_tokens_per_rank * num_ranks` are,
                 as we do not synchronize CPU received count with GPU (also not incompatible with CUDA graph if synced).
+                The received tensors, the counts and the handle come from two sets of persistent tensors used in turn,
+                so they stay valid until the low-latency dispatch after the next one.
             recv_count: a tensor shaped `[num_local_experts]` with type `torch.int`, indicating how many tokens each
                 expert receives. As mentioned before, not all tokens are valid in `recv_x`.
             handle: the communication handle to be used in the `low_latency_combine` function.
@@ -735,12 +890,14 @@ class Buffer:
             packed_recv_count,
             packed_recv_src_info,
             packed_recv_layout_range,
+            dispatch_handle,
             event,
             hook,
         ) = self.runtime.low_latency_dispatch(
             x,
             topk_ids,
             cumulative_local_expert_recv_stats,
+            dispatch_wait_recv_cost_stats,
             num_max_dispatch_tokens_per_rank,
             num_experts,
             use_fp8,
@@ -756,6 +913,7 @@ class Buffer:
             x.size(1),
             num_experts,
             packed_recv_count,
+            dispatch_handle,
         )
         tensors_to_record = (
             x,
@@ -766,6 +924,7 @@ class Buffer:
             packed_recv_src_info,
             packed_recv_layout_range,
             cumulative_local_expert_recv_stats,
+            dispatch_wait_recv_cost_stats,
         )
         return (
             (packed_recv_x, packed_recv_x_scales) if use_fp8 else packed_recv_x,
@@ -786,6 +945,7 @@ class Buffer:
         async_finish: bool = False,
         return_recv_hook: bool = False,
         out: Optional[torch.Tensor] = None,
+        combine_send_cost_stats: Optional[torch.Tensor] = None,
     ) -> Tuple[torch.Tensor, EventOverlap, Callable]:
         """
         A low-latency implementation for combine.
@@ -799,13 +959,18 @@ class Buffer:
             topk_weights: `[num_combined_tokens, num_topk]` with `torch.float`, the expert weights selected by the dispatched
                 tokens. The received tokens will be reduced with the weights in this tensor.
             handle: the communication handle given by the `dispatch` function.
-            zero_copy: whether the tensor is already copied into the RDMA buffer, should be cooperative
-                with `get_next_low_latency_combine_buffer`.
+            zero_copy: whether `x` is the buffer from `get_next_low_latency_combine_buffer`, the combine reads
+                it in place either way, so this only checks that.
             async_finish: the current stream will not wait for the communication kernels to be finished if set.
-            return_recv_hook: return a receiving hook if set. If set, the kernel will just do the RDMA request issues,
-                but **without actually receiving the data**. You must call the received hook to make sure the data's arrival.
-                If you do not set this flag, the kernel will ensure the data's arrival.
+            return_recv_hook: return a receiving hook if set. If set, the kernel is launched on the communication
+                stream and the current stream is **not** ordered after it, so unrelated work can run in the meantime.
+                You must call the received hook on the stream that uses the outputs to make sure the data's arrival.
+                If you do not set this flag, the kernel will ensure the data's arrival. Cannot be used with `async_finish`.
             out: the in-place output tensor, if set, the kernel will write the result to this tensor and return it directly.
+                It must be contiguous and shaped `[num_combined_tokens, hidden]` with the type of `x`.
+            combine_send_cost_stats: `[num_ranks]` with `torch.int`, the per-rank time in us of the combine phase is
+                added to it: on A3 and on a single A2 server the time spent sending to each rank, otherwise the time
+                spent waiting for the tokens of each rank. See `get_cost_stats_histograms`.
 
         Returns:
             combined_x: the reduced token tensor, with shape `[num_combined_tokens, hidden]` and type `torch.bfloat16`.
@@ -820,6 +985,7 @@ class Buffer:
             hidden,
             num_experts,
             packed_recv_count,
+            dispatch_handle,
         ) = handle
         combined_x, event, hook = self.runtime.low_latency_combine(
             x,
@@ -827,6 +993,8 @@ class Buffer:
             topk_weights,
             src_info,
             layout_range,
+            combine_send_cost_stats,
+            dispatch_handle,
             num_max_dispatch_tokens_per_rank,
             num_experts,
             packed_recv_count,
@@ -842,6 +1010,7 @@ class Buffer:
             src_info,
             layout_range,
             combined_x,
+            combine_send_cost_stats,
         )
         return (
             combined_x,
@@ -861,6 +1030,7 @@ class Buffer:
         num_max_dispatch_tokens_per_rank: int,
         num_experts: int,
         quant_mode: int = 1,
+        combine_wait_recv_cost_stats: Optional[torch.Tensor] = None,
     ) -> Tuple[torch.Tensor, torch.Tensor]:
         """
         A fused low-latency implementation for MoE expert forward and combination.
@@ -883,6 +1053,8 @@ class Buffer:
             num_max_dispatch_tokens_per_rank: the maximum number of tokens to dispatch, all the ranks must hold the same value.
             num_experts: the number of experts.
             quant_mode: int type, optional number, displays the quantization model. Supported values: 1 means int8 (default)
+            combine_wait_recv_cost_stats: `[num_ranks]` with `torch.int`, the time in us the current rank waits for
+                the tokens of each rank in the combine stage is added to it. See `get_cost_stats_histograms`.
 
         Notes:
             - The first dimension of `topk_idx` defines the batch size `bs`.
@@ -911,6 +1083,7 @@ class Buffer:
             num_max_dispatch_tokens_per_rank,
             num_experts,
             quant_mode,
+            combine_wait_recv_cost_stats,
         )
 
         return output, ep_recv_count
@@ -2,7 +2,7 @@ import functools
 import inspect
 import logging
 import os
-from typing import Optional, Tuple
+from typing import Any, Optional, Tuple
 
 import torch
 import torch_npu
@@ -10,6 +10,13 @@ from deep_ep_cpp import Config, EventHandle
 
 
 class EventOverlap:
+    """
+    A wrapper class to manage NPU events, also for better overlapping convenience.
+
+    Attributes:
+        event: the NPU event captured.
+        extra_tensors: an easier way to simulate PyTorch tensor `record_stream`, may be useful with NPU graph.
+    """
 
     def __init__(
         self,
@@ -20,17 +27,38 @@ class EventOverlap:
         Initialize the class.
 
         Arguments:
-            event: the CUDA event captured.
-            extra_tensors: an easier way to simulate PyTorch tensor `record_stream`, may be useful with CUDA graph.
+            event: the NPU event captured.
+            extra_tensors: an easier way to simulate PyTorch tensor `record_stream`, may be useful with NPU graph.
         """
         self.event = event
 
         # NOTES: we use extra tensors to achieve stream recording, otherwise,
-        # stream recording will be incompatible with CUDA graph.
+        # stream recording will be incompatible with NPU graph.
         self.extra_tensors = extra_tensors
 
     def current_stream_wait(self) -> None:
-        pass
+        """
+        The current stream `torch.npu.current_stream()` waits for the event to be finished.
+        Does nothing for the result of a synchronous call, which has no event.
+        """
+        if self.event is not None:
+            self.event.current_stream_wait()
+
+    def __enter__(self) -> Any:
+        """
+        Utility for overlapping and NPU graph capturing.
+
+        Returns:
+            self: the overlapped work runs inside the `with` block, on the current stream.
+        """
+        return self
+
+    def __exit__(self, exc_type: Any, exc_val: Any, exc_tb: Any) -> None:
+        """
+        Utility for overlapping and NPU graph capturing, the current stream waits for the event when leaving the block.
+        """
+        if self.event is not None:
+            self.event.current_stream_wait()
 
 
 logger = logging.getLogger()
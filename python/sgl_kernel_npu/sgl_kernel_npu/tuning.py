@@ -0,0 +1,84 @@
+from typing import Callable, Dict, List, Optional, Tuple
+
+import torch
+
+KEY_FIELDS = 8  # op, core_num, batch_size, m, k, n, dtype, flags
+VALUE_FIELDS = 5  # m0, n0, k0, swizzle_count, swizzle_direct
+
+
+def load_db(path: str) -> int:
+    """
+    Map a matmul tuning database. The database given by SGL_KERNEL_NPU_MATMUL_TUNING_DB is loaded automatically.
+
+    Returns:
+        number of records, or -1 if the file is missing or malformed.
+    """
+    return torch.ops.npu.matmul_tuning_db_load(path)
+
+
+def _split(flat: List[int], fields: int) -> List[Tuple[int, ...]]:
+    return [tuple(flat[i : i + fields]) for i in range(0, len(flat), fields)]
+
+
+def _time_us(workload: Callable[[], None], warmup: int, iters: int) -> float:
+    for _ in range(warmup):
+        workload()
+    start = torch.npu.Event(enable_timing=True)
+    end = torch.npu.Event(enable_timing=True)
+    start.record()
+    for _ in range(iters):
+        workload()
+    end.record()
+    end.synchronize()
+    return start.elapsed_time(end) * 1000.0 / iters
+
+
+def tune(
+    workload: Callable[[], None],
+    db_path: str,
+    warmup: int = 5,
+    iters: int = 20,
+    max_candidates: Optional[int] = None,
+) -> Dict[Tuple[int, ...], Tuple[Tuple[int, ...], float]]:
+    """
+    Sweep the matmul tilings of every shape the workload tiles and persist the fastest ones.
+
+    The workload is run once to trace the keys looked up by batch_matmul_transpose and mla_preprocess, then it is
+    timed once per candidate tiling of each key with that candidate forced. A tiling is only kept if it beats the
+    heuristic one. The winners are merged into db_path, which can be used afterwards through
+    SGL_KERNEL_NPU_MATMUL_TUNING_DB or load_db.
+
+    Args:
+        workload: runs the ops to tune with fixed shapes, e.g. one decode step
+        db_path: database file to update, it is created if it does not exist
+        warmup: untimed runs before each measurement
+        iters: timed runs of each measurement
+        max_candidates: only measure the first candidates of each key
+
+    Returns:
+        the tuned tiling and its time in us of each key.
+    """
+    torch.ops.npu.matmul_tuning_trace(True)
+    workload()
+    torch.npu.synchronize()
+    keys = _split(torch.ops.npu.matmul_tuning_trace(False), KEY_FIELDS)
+
+    results = {}
+    for key in keys:
+        # measure the heuristic first, a tuned record must do better to be kept
+        torch.ops.npu.matmul_tuning_set(list(key), [])
+        best_value, best_time = None, _time_us(workload, warmup, iters)
+        candidates = _split(torch.ops.npu.matmul_tuning_candidates(list(key)), VALUE_FIELDS)
+        for value in candidates[:max_candidates]:
+            torch.ops.npu.matmul_tuning_set(list(key), list(value))
+            elapsed = _time_us(workload, warmup, iters)
+            if elapsed < best_time:
+                best_value, best_time = value, elapsed
+        if best_value is None:
+            torch.ops.npu.matmul_tuning_set(list(key), [])
+        else:
+            torch.ops.npu.matmul_tuning_set(list(key), list(best_value), best_time)
+            results[key] = (best_value, best_time)
+
+    torch.ops.npu.matmul_tuning_db_save(db_path)
+    return results
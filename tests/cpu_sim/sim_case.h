@@ -0,0 +1,238 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SGL_KERNEL_NPU_SIM_CASE_H
+#define SGL_KERNEL_NPU_SIM_CASE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef ASCENDC_CPU_DEBUG
+#include "tikicpulib.h"
+#else
+#include "acl/acl.h"
+#endif
+
+namespace sim {
+
+constexpr size_t SIM_GM_ALIGN = 32;
+
+#ifdef ASCENDC_CPU_DEBUG
+// every simulated core runs the kernel function in its own process, the GM buffers are shared between them
+#define SIM_RUN_KERNEL(kernel, blockDim, simCase, ...) ICPU_RUN_KF(kernel, blockDim, __VA_ARGS__)
+#else
+#define SIM_RUN_KERNEL(kernel, blockDim, simCase, ...)                          \
+    do {                                                                        \
+        ACLRT_LAUNCH_KERNEL(kernel)(blockDim, (simCase).Stream(), __VA_ARGS__); \
+        sim::CheckAcl(aclrtSynchronizeStream((simCase).Stream()), #kernel);     \
+    } while (0)
+
+inline void CheckAcl(aclError ret, const char *what)
+{
+    if (ret != ACL_SUCCESS) {
+        throw std::runtime_error(std::string(what) + " failed with acl error " + std::to_string(ret));
+    }
+}
+#endif
+
+/**
+ * @brief One kernel invocation read from a case directory.
+ *
+ * Every GM argument <name> is the raw content of <dir>/<name>.bin, written by the caller in the layout the op host
+ * would pass to the kernel. Outputs are loaded the same way, so in place kernels see the initial content, and are
+ * written back to their file by Finish(). Scalar parameters come from the command line as key=value.
+ *
+ * In CPU debug mode the buffers are AscendC::GmAlloc memory, in simulator mode they are device memory of the
+ * instruction simulator and are copied from and to the files around the launch.
+ */
+class SimCase
+{
+public:
+    SimCase(std::string dir, std::map<std::string, std::string> params)
+        : dir_(std::move(dir)), params_(std::move(params))
+    {
+#ifndef ASCENDC_CPU_DEBUG
+        CheckAcl(aclrtCreateStream(&stream_), "aclrtCreateStream");
+#endif
+    }
+
+    ~SimCase()
+    {
+        for (auto &buffer : buffers_) {
+#ifdef ASCENDC_CPU_DEBUG
+            AscendC::GmFree(buffer.second.gm);
+#else
+            aclrtFree(buffer.second.gm);
+#endif
+        }
+#ifndef ASCENDC_CPU_DEBUG
+        aclrtDestroyStream(stream_);
+#endif
+    }
+
+    SimCase(const SimCase &) = delete;
+    SimCase &operator=(const SimCase &) = delete;
+
+    uint8_t *Input(const std::string &name)
+    {
+        return Load(name, false);
+    }
+
+    uint8_t *Output(const std::string &name)
+    {
+        return Load(name, true);
+    }
+
+    /**
+     * @brief Zeroed GM buffer that is not backed by a file (workspace, sync flags).
+     */
+    uint8_t *Scratch(const std::string &name, size_t size)
+    {
+        return Place(name, std::vector<uint8_t>(size, 0), false);
+    }
+
+    template <typename TilingDataType>
+    uint8_t *Tiling(const TilingDataType &tilingData)
+    {
+        std::vector<uint8_t> content(sizeof(TilingDataType), 0);
+        std::memcpy(content.data(), &tilingData, sizeof(TilingDataType));
+        return Place("tiling", std::move(content), false);
+    }
+
+    size_t Bytes(const std::string &name) const
+    {
+        return buffers_.at(name).host.size();
+    }
+
+    int64_t Param(const std::string &key) const
+    {
+        auto it = params_.find(key);
+        if (it == params_.end()) {
+            throw std::invalid_argument("missing parameter " + key);
+        }
+        return std::stoll(it->second);
+    }
+
+    int64_t Param(const std::string &key, int64_t defaultValue) const
+    {
+        return params_.count(key) != 0 ? Param(key) : defaultValue;
+    }
+
+    double FloatParam(const std::string &key, double defaultValue) const
+    {
+        auto it = params_.find(key);
+        return it != params_.end() ? std::stod(it->second) : defaultValue;
+    }
+
+    std::string StringParam(const std::string &key, const std::string &defaultValue) const
+    {
+        auto it = params_.find(key);
+        return it != params_.end() ? it->second : defaultValue;
+    }
+
+    /**
+     * @brief Write every output back to its file, must be called after the kernel has finished.
+     */
+    void Finish()
+    {
+        for (auto &buffer : buffers_) {
+            if (!buffer.second.output) {
+                continue;
+            }
+            Buffer &out = buffer.second;
+#ifdef ASCENDC_CPU_DEBUG
+            std::memcpy(out.host.data(), out.gm, out.host.size());
+#else
+            CheckAcl(aclrtMemcpy(out.host.data(), out.host.size(), out.gm, out.host.size(), ACL_MEMCPY_DEVICE_TO_HOST),
+                     "aclrtMemcpy");
+#endif
+            std::ofstream file(FilePath(buffer.first), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(out.host.data()), static_cast<std::streamsize>(out.host.size()));
+            if (!file) {
+                throw std::runtime_error("cannot write " + FilePath(buffer.first));
+            }
+        }
+    }
+
+#ifndef ASCENDC_CPU_DEBUG
+    aclrtStream Stream() const
+    {
+        return stream_;
+    }
+#endif
+
+private:
+    struct Buffer {
+        std::vector<uint8_t> host;
+        uint8_t *gm{nullptr};
+        bool output{false};
+    };
+
+    std::string FilePath(const std::string &name) const
+    {
+        return dir_ + "/" + name + ".bin";
+    }
+
+    uint8_t *Load(const std::string &name, bool output)
+    {
+        std::ifstream file(FilePath(name), std::ios::binary);
+        if (!file) {
+            throw std::invalid_argument("cannot read " + FilePath(name));
+        }
+        std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return Place(name, std::move(content), output);
+    }
+
+    uint8_t *Place(const std::string &name, std::vector<uint8_t> content, bool output)
+    {
+        if (buffers_.count(name) != 0) {
+            throw std::invalid_argument("buffer " + name + " is passed twice");
+        }
+        // never allocate 0 bytes, empty tensors are still passed as valid addresses
+        size_t size = ((content.size() + SIM_GM_ALIGN - 1) / SIM_GM_ALIGN + 1) * SIM_GM_ALIGN;
+        Buffer buffer;
+#ifdef ASCENDC_CPU_DEBUG
+        buffer.gm = static_cast<uint8_t *>(AscendC::GmAlloc(size));
+        std::memset(buffer.gm, 0, size);
+        std::memcpy(buffer.gm, content.data(), content.size());
+#else
+        void *gm = nullptr;
+        CheckAcl(aclrtMalloc(&gm, size, ACL_MEM_MALLOC_HUGE_FIRST), "aclrtMalloc");
+        buffer.gm = static_cast<uint8_t *>(gm);
+        CheckAcl(aclrtMemset(gm, size, 0, size), "aclrtMemset");
+        if (!content.empty()) {
+            CheckAcl(aclrtMemcpy(gm, size, content.data(), content.size(), ACL_MEMCPY_HOST_TO_DEVICE), "aclrtMemcpy");
+        }
+#endif
+        buffer.host = std::move(content);
+        buffer.output = output;
+        uint8_t *gmAddr = buffer.gm;
+        buffers_.emplace(name, std::move(buffer));
+        return gmAddr;
+    }
+
+    std::string dir_;
+    std::map<std::string, std::string> params_;
+    std::map<std::string, Buffer> buffers_;
+#ifndef ASCENDC_CPU_DEBUG
+    aclrtStream stream_{nullptr};
+#endif
+};
+
+}  // namespace sim
+
+#endif  // SGL_KERNEL_NPU_SIM_CASE_H
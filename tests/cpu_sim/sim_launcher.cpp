@@ -0,0 +1,491 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs one kernel of csrc on a case directory without an NPU:
+//     sgl_kernel_npu_sim <kernel> <case_dir> [key=value ...]
+// The tilings are computed the same way as in the op hosts, with the core count and UB size of the SoC profile the
+// launcher was built for (SGL_KERNEL_NPU_SOC_VERSION overrides it, aiv_num=<n> overrides the core count).
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "common.h"
+#include "common_tiling.h"
+#include "sim_case.h"
+#include "alloc_extend/op_host/alloc_extend_tiling.h"
+#include "assign_cache_op/op_host/tiling_data.h"
+#include "build_tree/op_host/build_tree_tiling.h"
+#include "cache_location_assign/op_host/tiling/cache_loc_assign.h"
+
+#ifdef ASCENDC_CPU_DEBUG
+#include "dispatch_layout_tiling.h"
+
+extern "C" __global__ __aicore__ void alloc_extend(GM_ADDR pre_lens_in, GM_ADDR seq_lens_in, GM_ADDR last_loc_in,
+                                                   GM_ADDR free_pages_in, GM_ADDR out_indices_in, GM_ADDR values_in,
+                                                   GM_ADDR workspace_in, GM_ADDR tiling_gm_in);
+extern "C" __global__ __aicore__ void cache_loc_assign(GM_ADDR reqPoolIndices, GM_ADDR tokenPool, GM_ADDR startOffset,
+                                                       GM_ADDR endOffset, GM_ADDR outCacheLoc, GM_ADDR tilingGM,
+                                                       uint32_t assignMode);
+extern "C" __global__ __aicore__ void assign_cache_op(GM_ADDR dstPtr, GM_ADDR srcPtr, GM_ADDR dstStartIdxPtr,
+                                                      GM_ADDR dstEndIdxPtr, GM_ADDR srcStartIdxPtr,
+                                                      GM_ADDR srcEndIdxPtr, GM_ADDR sync, GM_ADDR tilingPtr);
+extern "C" __global__ __aicore__ void build_tree_efficient(GM_ADDR parent_list, GM_ADDR selected_index,
+                                                           GM_ADDR verified_seq_len, GM_ADDR tree_mask,
+                                                           GM_ADDR positions, GM_ADDR retrive_index,
+                                                           GM_ADDR retrive_next_token, GM_ADDR retrive_next_sibling,
+                                                           GM_ADDR workspace_in, GM_ADDR tiling_in);
+extern "C" __global__ __aicore__ void dispatch_layout(GM_ADDR topkIdx, GM_ADDR expertReplicaTable,
+                                                      GM_ADDR numTokensPerRank, GM_ADDR numTokensPerExpert,
+                                                      GM_ADDR isTokenInRank, GM_ADDR notifySendData,
+                                                      GM_ADDR sendTokenIdxSmall, GM_ADDR physicalTopkIdx,
+                                                      GM_ADDR workspace, GM_ADDR tiling);
+
+#define SIM_LORA_SHRINK_DECLARE(NAME)                                                                            \
+    extern "C" __global__ __aicore__ void NAME(GM_ADDR x, GM_ADDR weight, GM_ADDR indices, uint32_t indicesSize, \
+                                               GM_ADDR y, uint32_t batchSize, uint32_t numTokensPerCore,         \
+                                               uint32_t inputHiddenDim, uint32_t maxLoRARank, float scale)
+#define SIM_LORA_EXPAND_DECLARE(NAME)                                                                            \
+    extern "C" __global__ __aicore__ void NAME(GM_ADDR x, GM_ADDR weight, GM_ADDR indices, uint32_t indicesSize, \
+                                               GM_ADDR yIn, GM_ADDR yOut, uint32_t batchSize,                    \
+                                               uint32_t numTokensPerCore, uint32_t maxLoRARank,                  \
+                                               uint32_t outputHiddenDim, uint32_t sliceOffset, uint32_t outputFullDim)
+#define SIM_SGMV_SHRINK_DECLARE(NAME)                                                                         \
+    extern "C" __global__ __aicore__ void NAME(GM_ADDR x, GM_ADDR weight, GM_ADDR loraIndices,                \
+                                               uint32_t loraIndicesSize, GM_ADDR seqLen, uint32_t seqLenSize, \
+                                               GM_ADDR y, uint32_t batchSize, uint32_t numTokensPerCore,      \
+                                               uint32_t inputHiddenDim, uint32_t maxLoRARank, float scale)
+#define SIM_SGMV_EXPAND_DECLARE(NAME)                                                                         \
+    extern "C" __global__ __aicore__ void NAME(GM_ADDR x, GM_ADDR weight, GM_ADDR loraIndices,                \
+                                               uint32_t loraIndicesSize, GM_ADDR seqLen, uint32_t seqLenSize, \
+                                               GM_ADDR yIn, GM_ADDR yOut, uint32_t batchSize,                 \
+                                               uint32_t numTokensPerCore, uint32_t maxLoRARank,               \
+                                               uint32_t outputHiddenDim, uint32_t sliceOffset, uint32_t outputFullDim)
+
+SIM_LORA_SHRINK_DECLARE(bgmv_shrink_half);
+SIM_LORA_SHRINK_DECLARE(bgmv_shrink_bfloat16_t);
+SIM_LORA_EXPAND_DECLARE(bgmv_expand_half);
+SIM_LORA_EXPAND_DECLARE(bgmv_expand_bfloat16_t);
+SIM_SGMV_SHRINK_DECLARE(sgmv_shrink_half);
+SIM_SGMV_SHRINK_DECLARE(sgmv_shrink_bfloat16_t);
+SIM_SGMV_EXPAND_DECLARE(sgmv_expand_half);
+SIM_SGMV_EXPAND_DECLARE(sgmv_expand_bfloat16_t);
+#else
+#include "aclrtlaunch_alloc_extend.h"
+#include "aclrtlaunch_assign_cache_op.h"
+#include "aclrtlaunch_build_tree_efficient.h"
+#include "aclrtlaunch_cache_loc_assign.h"
+#include "aclrtlaunch_bgmv_expand_bfloat16_t.h"
+#include "aclrtlaunch_bgmv_expand_half.h"
+#include "aclrtlaunch_bgmv_shrink_bfloat16_t.h"
+#include "aclrtlaunch_bgmv_shrink_half.h"
+#include "aclrtlaunch_sgmv_expand_bfloat16_t.h"
+#include "aclrtlaunch_sgmv_expand_half.h"
+#include "aclrtlaunch_sgmv_shrink_bfloat16_t.h"
+#include "aclrtlaunch_sgmv_shrink_half.h"
+#endif
+
+namespace {
+
+using sim::SimCase;
+
+constexpr uint64_t SIM_LIB_API_WORKSPACE_SIZE = 16 * 1024 * 1024;  // GetLibApiWorkSpaceSize of the 910 series
+constexpr uint32_t SIM_CACHE_LOC_MAX_STEP = 5;                      // MAX_STEP of cache_loc_assign
+constexpr uint32_t SIM_DISPATCH_LAYOUT_WORKSPACE_SIZE = 18 * 1024 * 1024;
+constexpr uint32_t SIM_DISPATCH_LAYOUT_TILING_KEY = 23;
+constexpr uint32_t SIM_DISPATCH_LAYOUT_TILING_KEY_A2 = 123;
+
+struct SimPlatform {
+    host_utils::PlatformType socType;
+    uint32_t aivNum;
+    uint64_t ubSize;
+};
+
+using SimRunner = void (*)(SimCase &, const SimPlatform &);
+
+void RunAllocExtend(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *preLens = simCase.Input("pre_lens");
+    uint8_t *seqLens = simCase.Input("seq_lens");
+    uint8_t *lastLoc = simCase.Input("last_loc");
+    uint8_t *freePages = simCase.Input("free_pages");
+    uint8_t *outIndices = simCase.Output("out_indices");
+    uint8_t *values = simCase.Output("values");
+    int32_t batchSize = static_cast<int32_t>(simCase.Bytes("pre_lens") / sizeof(int64_t));
+
+    // see get_tiling in alloc_extend_tiling.cpp
+    uint32_t blockDim = static_cast<uint32_t>(std::min(static_cast<int32_t>(platform.aivNum), batchSize));
+    sglang::npu_kernel::AllocExtendTilingData tilingData{};
+    tilingData.batch_size = batchSize;
+    tilingData.page_size = static_cast<int32_t>(simCase.Param("page_size"));
+    tilingData.used_core_num = static_cast<int32_t>(blockDim);
+    tilingData.total_extend_tokens = static_cast<int64_t>(simCase.Bytes("out_indices") / sizeof(int64_t));
+    uint8_t *workspace = simCase.Scratch("workspace", SIM_LIB_API_WORKSPACE_SIZE);
+    uint8_t *tiling = simCase.Tiling(tilingData);
+
+    SIM_RUN_KERNEL(alloc_extend, blockDim, simCase, preLens, seqLens, lastLoc, freePages, outIndices, values,
+                   workspace, tiling);
+}
+
+void RunCacheLocAssign(SimCase &simCase, const SimPlatform &platform, bool isUpdate)
+{
+    uint8_t *reqPoolIndices = simCase.Input("req_pool_indices");
+    uint8_t *tokenPool = isUpdate ? simCase.Input("token_pool") : simCase.Output("token_pool");
+    uint8_t *startOffset = simCase.Input("start_offset");
+    uint8_t *endOffset = simCase.Input("end_offset");
+    uint8_t *outCacheLoc = isUpdate ? simCase.Output("out_cache_loc") : simCase.Input("out_cache_loc");
+    uint64_t batchSize = simCase.Bytes("start_offset") / sizeof(int64_t);
+    uint64_t rowSize = static_cast<uint64_t>(simCase.Param("row_size"));
+    uint64_t poolSize = simCase.Bytes("token_pool") / sizeof(int32_t) / rowSize;
+    bool int32Indices = simCase.Bytes("req_pool_indices") == batchSize * sizeof(int32_t);
+
+    // see getTiling in cache_loc_assign.cpp
+    uint32_t blockDim = isUpdate ? 1 : platform.aivNum;
+    AssignCacheTillingData tilingData;
+    tilingData.vcoreNum = blockDim;
+    tilingData.poolSize = poolSize;
+    tilingData.batchSize = batchSize;
+    tilingData.rowNumNoTail = batchSize / blockDim;
+    tilingData.tailNum = batchSize % blockDim;
+    tilingData.rowSize = rowSize;
+    tilingData.key = int32Indices ? 1 : 2;
+    tilingData.reqInxBufferCount =
+        int32Indices ? host_utils::alinInt32Count(batchSize) : host_utils::alinInt64Count(batchSize);
+    tilingData.reqInxBufferSize = tilingData.reqInxBufferCount * (int32Indices ? sizeof(int32_t) : sizeof(int64_t));
+    tilingData.tokenCountAlignInt32 = host_utils::alinInt32Count(SIM_CACHE_LOC_MAX_STEP);
+    tilingData.tokenColAlignInt32 = tilingData.tokenCountAlignInt32 * sizeof(int32_t);
+    tilingData.offsetCountAlignInt64 = host_utils::alinInt64Count(batchSize);
+    tilingData.offsetColAlignInt64 = tilingData.offsetCountAlignInt64 * sizeof(int64_t);
+    tilingData.cacheLocSize = batchSize * SIM_CACHE_LOC_MAX_STEP;
+    tilingData.cacheLocCountAlignInt32 = host_utils::alinInt32Count(tilingData.cacheLocSize);
+    tilingData.cacheLocAlignInt32 = tilingData.cacheLocCountAlignInt32 * sizeof(int32_t);
+    uint64_t ubBufferSizeToUse = tilingData.tokenColAlignInt32 + 3 * tilingData.offsetColAlignInt64 +
+                                 3 * batchSize * sizeof(int32_t) + tilingData.cacheLocAlignInt32;
+    if (ubBufferSizeToUse > platform.ubSize) {
+        throw std::invalid_argument("Batch size is too large, buffer is not enough to do calculate");
+    }
+    uint8_t *tiling = simCase.Tiling(tilingData);
+
+    uint32_t assignMode = isUpdate ? 1 : 0;
+    SIM_RUN_KERNEL(cache_loc_assign, blockDim, simCase, reqPoolIndices, tokenPool, startOffset, endOffset,
+                   outCacheLoc, tiling, assignMode);
+}
+
+void RunCacheLocAssignToPool(SimCase &simCase, const SimPlatform &platform)
+{
+    RunCacheLocAssign(simCase, platform, false);
+}
+
+void RunCacheLocUpdate(SimCase &simCase, const SimPlatform &platform)
+{
+    RunCacheLocAssign(simCase, platform, true);
+}
+
+void RunAssignCacheOp(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *dst = simCase.Output("dst");
+    uint8_t *src = simCase.Input("src");
+    uint8_t *dstStart = simCase.Input("dst_start");
+    uint8_t *dstEnd = simCase.Input("dst_end");
+    uint8_t *srcStart = simCase.Input("src_start");
+    uint8_t *srcEnd = simCase.Input("src_end");
+    uint32_t batchSize = static_cast<uint32_t>(simCase.Bytes("dst_start") / sizeof(int64_t));
+    uint32_t rowSize = static_cast<uint32_t>(simCase.Param("row_size"));
+
+    // see assign_cache_op in assign_cache.cpp
+    uint32_t blockDim = platform.aivNum;
+    uint32_t syncWorkspaceSize = blockDim * 32 + blockDim * 32 + 32;
+    custom_assign::CustomAssignTilingData tilingData = {
+        .batchSize = batchSize,
+        .tokenPoolLength = rowSize,
+        .typeBytes = static_cast<uint32_t>(simCase.Bytes("dst") / (static_cast<uint64_t>(batchSize) * rowSize)),
+        .syncWorkspaceSize = syncWorkspaceSize,
+        .ubSize = static_cast<uint32_t>(platform.ubSize)};
+    uint8_t *sync = simCase.Scratch("sync", syncWorkspaceSize);
+    uint8_t *tiling = simCase.Tiling(tilingData);
+
+    SIM_RUN_KERNEL(assign_cache_op, blockDim, simCase, dst, src, dstStart, dstEnd, srcStart, srcEnd, sync, tiling);
+}
+
+void RunBuildTree(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *parentList = simCase.Input("parent_list");
+    uint8_t *selectedIndex = simCase.Input("selected_index");
+    uint8_t *verifiedSeqLen = simCase.Input("verified_seq_len");
+    uint8_t *treeMask = simCase.Output("tree_mask");
+    uint8_t *positions = simCase.Output("positions");
+    uint8_t *retriveIndex = simCase.Output("retrive_index");
+    uint8_t *retriveNextToken = simCase.Output("retrive_next_token");
+    uint8_t *retriveNextSibling = simCase.Output("retrive_next_sibling");
+    int32_t batchSize = static_cast<int32_t>(simCase.Bytes("verified_seq_len") / sizeof(int64_t));
+
+    // see get_tiling in build_tree.cpp
+    int32_t blockDim = std::min(static_cast<int32_t>(platform.aivNum), batchSize);
+    sglang::npu_kernel::BuildTreeTilingData tilingData{};
+    tilingData.batch_size = batchSize;
+    tilingData.mask_size = static_cast<int32_t>(simCase.Bytes("tree_mask"));
+    tilingData.topk = simCase.Param("topk");
+    tilingData.depth = simCase.Param("depth");
+    tilingData.draft_token_num = simCase.Param("draft_token_num");
+    tilingData.tree_mask_mode = simCase.Param("tree_mask_mode", sglang::npu_kernel::FULL_MASK);
+    if (tilingData.tree_mask_mode == sglang::npu_kernel::QLEN_ONLY_BITPACKING) {
+        throw std::invalid_argument("QLEN_ONLY_BITPACKING is not implemented by the kernel");
+    }
+    int32_t numBigCore = batchSize % blockDim;
+    tilingData.big_core_num = numBigCore == 0 ? blockDim : numBigCore;
+    tilingData.big_core_tile_num = (batchSize + blockDim - 1) / blockDim;
+    tilingData.small_core_tile_num = batchSize / blockDim;
+    uint8_t *workspace = simCase.Scratch("workspace", SIM_LIB_API_WORKSPACE_SIZE);
+    uint8_t *tiling = simCase.Tiling(tilingData);
+
+    SIM_RUN_KERNEL(build_tree_efficient, static_cast<uint32_t>(blockDim), simCase, parentList, selectedIndex,
+                   verifiedSeqLen, treeMask, positions, retriveIndex, retriveNextToken, retriveNextSibling, workspace,
+                   tiling);
+}
+
+// see the *_impl functions of lora/op_host, the batch is split evenly over all vector cores
+struct LoraLaunch {
+    uint32_t batchSize;
+    uint32_t numTokensPerCore;
+    uint32_t blockDim;
+    bool bf16;
+};
+
+LoraLaunch GetLoraLaunch(const SimCase &simCase, const SimPlatform &platform, uint32_t batchSize)
+{
+    LoraLaunch launch;
+    launch.batchSize = batchSize;
+    launch.numTokensPerCore = (batchSize + platform.aivNum - 1) / platform.aivNum;
+    if (launch.numTokensPerCore == 0) {
+        throw std::invalid_argument("num_tokens_per_core should not be 0");
+    }
+    launch.blockDim = (batchSize + launch.numTokensPerCore - 1) / launch.numTokensPerCore;
+    launch.bf16 = simCase.StringParam("dtype", "half") == "bf16";
+    return launch;
+}
+
+void RunBgmvShrink(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *x = simCase.Input("x");
+    uint8_t *weight = simCase.Input("weight");
+    uint8_t *indices = simCase.Input("indices");
+    uint8_t *y = simCase.Output("y");
+    uint32_t indicesSize = static_cast<uint32_t>(simCase.Bytes("indices") / sizeof(int64_t));
+    uint32_t hiddenIn = static_cast<uint32_t>(simCase.Param("hidden_in"));
+    uint32_t rank = static_cast<uint32_t>(simCase.Param("rank"));
+    float scale = static_cast<float>(simCase.FloatParam("scale", 1.0));
+    LoraLaunch launch = GetLoraLaunch(simCase, platform, indicesSize);
+    if (launch.bf16) {
+        SIM_RUN_KERNEL(bgmv_shrink_bfloat16_t, launch.blockDim, simCase, x, weight, indices, indicesSize, y,
+                       launch.batchSize, launch.numTokensPerCore, hiddenIn, rank, scale);
+    } else {
+        SIM_RUN_KERNEL(bgmv_shrink_half, launch.blockDim, simCase, x, weight, indices, indicesSize, y,
+                       launch.batchSize, launch.numTokensPerCore, hiddenIn, rank, scale);
+    }
+}
+
+void RunBgmvExpand(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *x = simCase.Input("x");
+    uint8_t *weight = simCase.Input("weight");
+    uint8_t *indices = simCase.Input("indices");
+    uint8_t *y = simCase.Output("y");
+    uint32_t indicesSize = static_cast<uint32_t>(simCase.Bytes("indices") / sizeof(int64_t));
+    uint32_t rank = static_cast<uint32_t>(simCase.Param("rank"));
+    uint32_t sliceOffset = static_cast<uint32_t>(simCase.Param("slice_offset", 0));
+    uint32_t sliceSize = static_cast<uint32_t>(simCase.Param("slice_size"));
+    uint32_t hiddenOut = static_cast<uint32_t>(simCase.Param("hidden_out", sliceSize));
+    LoraLaunch launch = GetLoraLaunch(simCase, platform, indicesSize);
+    // y is updated in place, the op host passes the same tensor as yIn and yOut
+    if (launch.bf16) {
+        SIM_RUN_KERNEL(bgmv_expand_bfloat16_t, launch.blockDim, simCase, x, weight, indices, indicesSize, y, y,
+                       launch.batchSize, launch.numTokensPerCore, rank, sliceSize, sliceOffset, hiddenOut);
+    } else {
+        SIM_RUN_KERNEL(bgmv_expand_half, launch.blockDim, simCase, x, weight, indices, indicesSize, y, y,
+                       launch.batchSize, launch.numTokensPerCore, rank, sliceSize, sliceOffset, hiddenOut);
+    }
+}
+
+void RunSgmvShrink(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *x = simCase.Input("x");
+    uint8_t *weight = simCase.Input("weight");
+    uint8_t *loraIndices = simCase.Input("lora_indices");
+    uint8_t *seqLen = simCase.Input("seq_len");
+    uint8_t *y = simCase.Output("y");
+    uint32_t loraIndicesSize = static_cast<uint32_t>(simCase.Bytes("lora_indices") / sizeof(int64_t));
+    uint32_t seqLenSize = static_cast<uint32_t>(simCase.Bytes("seq_len") / sizeof(int64_t));
+    uint32_t hiddenIn = static_cast<uint32_t>(simCase.Param("hidden_in"));
+    uint32_t rank = static_cast<uint32_t>(simCase.Param("rank"));
+    float scale = static_cast<float>(simCase.FloatParam("scale", 1.0));
+    // x is [num_tokens, hidden_in] of half or bf16
+    uint32_t numTokens = static_cast<uint32_t>(simCase.Bytes("x") / sizeof(uint16_t) / hiddenIn);
+    LoraLaunch launch = GetLoraLaunch(simCase, platform, numTokens);
+    if (launch.bf16) {
+        SIM_RUN_KERNEL(sgmv_shrink_bfloat16_t, launch.blockDim, simCase, x, weight, loraIndices, loraIndicesSize,
+                       seqLen, seqLenSize, y, launch.batchSize, launch.numTokensPerCore, hiddenIn, rank, scale);
+    } else {
+        SIM_RUN_KERNEL(sgmv_shrink_half, launch.blockDim, simCase, x, weight, loraIndices, loraIndicesSize, seqLen,
+                       seqLenSize, y, launch.batchSize, launch.numTokensPerCore, hiddenIn, rank, scale);
+    }
+}
+
+void RunSgmvExpand(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *x = simCase.Input("x");
+    uint8_t *weight = simCase.Input("weight");
+    uint8_t *loraIndices = simCase.Input("lora_indices");
+    uint8_t *seqLen = simCase.Input("seq_len");
+    uint8_t *y = simCase.Output("y");
+    uint32_t loraIndicesSize = static_cast<uint32_t>(simCase.Bytes("lora_indices") / sizeof(int64_t));
+    uint32_t seqLenSize = static_cast<uint32_t>(simCase.Bytes("seq_len") / sizeof(int64_t));
+    uint32_t rank = static_cast<uint32_t>(simCase.Param("rank"));
+    uint32_t sliceOffset = static_cast<uint32_t>(simCase.Param("slice_offset", 0));
+    uint32_t sliceSize = static_cast<uint32_t>(simCase.Param("slice_size"));
+    uint32_t hiddenOut = static_cast<uint32_t>(simCase.Param("hidden_out", sliceSize));
+    // x is [num_tokens, rank] of float
+    uint32_t numTokens = static_cast<uint32_t>(simCase.Bytes("x") / sizeof(float) / rank);
+    LoraLaunch launch = GetLoraLaunch(simCase, platform, numTokens);
+    if (launch.bf16) {
+        SIM_RUN_KERNEL(sgmv_expand_bfloat16_t, launch.blockDim, simCase, x, weight, loraIndices, loraIndicesSize,
+                       seqLen, seqLenSize, y, y, launch.batchSize, launch.numTokensPerCore, rank, sliceSize,
+                       sliceOffset, hiddenOut);
+    } else {
+        SIM_RUN_KERNEL(sgmv_expand_half, launch.blockDim, simCase, x, weight, loraIndices, loraIndicesSize, seqLen,
+                       seqLenSize, y, y, launch.batchSize, launch.numTokensPerCore, rank, sliceSize, sliceOffset,
+                       hiddenOut);
+    }
+}
+
+#ifdef ASCENDC_CPU_DEBUG
+void RunDispatchLayout(SimCase &simCase, const SimPlatform &platform)
+{
+    uint8_t *topkIdx = simCase.Input("topk_idx");
+    uint8_t *numTokensPerRank = simCase.Output("num_tokens_per_rank");
+    uint8_t *numTokensPerExpert = simCase.Output("num_tokens_per_expert");
+    uint8_t *isTokenInRank = simCase.Output("is_token_in_rank");
+    uint8_t *notifySendData = simCase.Output("notify_send_data");
+    uint8_t *sendTokenIdxSmall = simCase.Output("send_token_idx_small");
+    uint32_t numTopk = static_cast<uint32_t>(simCase.Param("num_topk"));
+
+    // see DispatchLayoutTilingFuncImpl in deepep/ops/op_host/dispatch_layout_tiling.cc
+    DispatchLayoutTilingData tilingData{};
+    tilingData.dispatchLayoutInfo.numTokens =
+        static_cast<uint32_t>(simCase.Bytes("topk_idx") / sizeof(int64_t) / numTopk);
+    tilingData.dispatchLayoutInfo.numRanks = static_cast<uint32_t>(simCase.Param("num_ranks"));
+    tilingData.dispatchLayoutInfo.numExperts = static_cast<uint32_t>(simCase.Param("num_experts"));
+    tilingData.dispatchLayoutInfo.numTopk = numTopk;
+    tilingData.dispatchLayoutInfo.localRankSize = static_cast<uint32_t>(simCase.Param("local_rank_size", 8));
+    tilingData.dispatchLayoutInfo.perRoundTokens = static_cast<uint32_t>(simCase.Param("per_round_tokens"));
+    tilingData.dispatchLayoutInfo.isTokenInRankBitmap =
+        static_cast<uint32_t>(simCase.Param("is_token_in_rank_bitmap", 0));
+    tilingData.dispatchLayoutInfo.totalUbSize = platform.ubSize;
+    uint8_t *workspace = simCase.Scratch("workspace", SIM_DISPATCH_LAYOUT_WORKSPACE_SIZE);
+    uint8_t *tiling = simCase.Tiling(tilingData);
+    // numLogicalExperts stays 0, topk_idx holds physical expert ids and the replica buffers are not touched
+    uint8_t *expertReplicaTable = simCase.Scratch("expert_replica_table", sizeof(int32_t));
+    uint8_t *physicalTopkIdx = simCase.Scratch("physical_topk_idx", sizeof(int64_t));
+
+    ICPU_SET_TILING_KEY(platform.socType == host_utils::PlatformType::ASCEND_910B ? SIM_DISPATCH_LAYOUT_TILING_KEY_A2
+                                                                                  : SIM_DISPATCH_LAYOUT_TILING_KEY);
+    SIM_RUN_KERNEL(dispatch_layout, platform.aivNum, simCase, topkIdx, expertReplicaTable, numTokensPerRank,
+                   numTokensPerExpert, isTokenInRank, notifySendData, sendTokenIdxSmall, physicalTopkIdx, workspace,
+                   tiling);
+}
+#endif
+
+const std::map<std::string, SimRunner> &SimKernels()
+{
+    static const std::map<std::string, SimRunner> kernels = {
+        {"alloc_extend", RunAllocExtend},
+        {"cache_loc_assign", RunCacheLocAssignToPool},
+        {"cache_loc_update", RunCacheLocUpdate},
+        {"assign_cache_op", RunAssignCacheOp},
+        {"build_tree_efficient", RunBuildTree},
+        {"bgmv_shrink", RunBgmvShrink},
+        {"bgmv_expand", RunBgmvExpand},
+        {"sgmv_shrink", RunSgmvShrink},
+        {"sgmv_expand", RunSgmvExpand},
+#ifdef ASCENDC_CPU_DEBUG
+        // built by the deepep custom op package, only available in CPU debug mode
+        {"dispatch_layout", RunDispatchLayout},
+#endif
+    };
+    return kernels;
+}
+
+SimPlatform GetSimPlatform(const std::map<std::string, std::string> &params)
+{
+    const char *socName = std::getenv(host_utils::SOC_VERSION_ENV);
+    const host_utils::SocProfile *profile = host_utils::FindSocProfile(socName != nullptr ? socName : SIM_SOC_VERSION);
+    if (profile == nullptr) {
+        throw std::invalid_argument(std::string("unknown SoC ") + (socName != nullptr ? socName : SIM_SOC_VERSION));
+    }
+    SimPlatform platform{profile->socType, profile->coreNumAiv, profile->ubSize};
+    auto it = params.find("aiv_num");
+    if (it != params.end()) {
+        platform.aivNum = static_cast<uint32_t>(std::stoul(it->second));
+    }
+    return platform;
+}
+
+int Usage(const char *argv0)
+{
+    std::cerr << "usage: " << argv0 << " <kernel> <case_dir> [key=value ...]\nkernels:";
+    for (const auto &kernel : SimKernels()) {
+        std::cerr << " " << kernel.first;
+    }
+    std::cerr << std::endl;
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3 || SimKernels().count(argv[1]) == 0) {
+        return Usage(argv[0]);
+    }
+    std::map<std::string, std::string> params;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t sep = arg.find('=');
+        if (sep == std::string::npos) {
+            return Usage(argv[0]);
+        }
+        params[arg.substr(0, sep)] = arg.substr(sep + 1);
+    }
+
+    try {
+#ifdef ASCENDC_CPU_DEBUG
+        AscendC::SetKernelMode(KernelMode::AIV_MODE);
+#else
+        sim::CheckAcl(aclInit(nullptr), "aclInit");
+        sim::CheckAcl(aclrtSetDevice(0), "aclrtSetDevice");
+#endif
+        SimPlatform platform = GetSimPlatform(params);
+        {
+            SimCase simCase(argv[2], params);
+            SimKernels().at(argv[1])(simCase, platform);
+            simCase.Finish();
+        }
+#ifndef ASCENDC_CPU_DEBUG
+        aclrtResetDevice(0);
+        aclFinalize();
+#endif
+    } catch (const std::exception &e) {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
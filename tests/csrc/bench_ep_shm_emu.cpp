@@ -0,0 +1,85 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "ep_emu_protocols.h"
+#include "ep_shm_world.h"
+
+namespace {
+
+constexpr int32_t MAGIC = 7;
+constexpr int32_t BARRIER_STEPS = 4;
+
+void SetSyncCounters(benchmark::State &state, const ep_emu::WorldReport &report, double rounds)
+{
+    state.counters["gm_loads_per_round"] = static_cast<double>(report.MaxGmLoads()) / rounds;
+    state.counters["rank_ms"] = report.MaxElapsedMs();
+    if (!report.AllPassed()) {
+        state.SkipWithError("a rank failed or hung");
+    }
+}
+
+// flag polls and wall time of one outer flag barrier, args are ranks and blocks per rank
+void BM_OuterFlagBarrier(benchmark::State &state)
+{
+    ep_emu::WorldOptions options;
+    options.numRanks = static_cast<int>(state.range(0));
+    options.blockNum = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        ep_emu::WorldReport report = ep_emu::RunWorld(options, nullptr, [](ep_emu::RankContext &ctx) {
+            return ep_emu::OuterFlagBarrier(ctx, MAGIC, BARRIER_STEPS);
+        });
+        SetSyncCounters(state, report, BARRIER_STEPS);
+    }
+}
+BENCHMARK(BM_OuterFlagBarrier)
+    ->Args({8, 2})
+    ->Args({16, 2})
+    ->Args({32, 2})
+    ->Args({64, 2})
+    ->Args({16, 8})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+
+// flag polls and wall time of the notify_dispatch style count exchange, args are ranks and blocks per rank
+void BM_ExchangeSlices(benchmark::State &state)
+{
+    constexpr uint32_t sliceInts = 8;
+    ep_emu::WorldOptions options;
+    options.numRanks = static_cast<int>(state.range(0));
+    options.blockNum = static_cast<int>(state.range(1));
+    auto setup = [](ep_emu::RankContext &ctx) {
+        ctx.state = std::make_shared<std::vector<int32_t>>(2 * ctx.rankSize * sliceInts, ctx.rank);
+    };
+    auto body = [](ep_emu::RankContext &ctx) {
+        std::vector<int32_t> &buf = ctx.State<std::vector<int32_t>>();
+        ep_emu::ExchangeSlices(ctx, MAGIC, reinterpret_cast<uint8_t *>(buf.data()), sliceInts * sizeof(int32_t),
+                               reinterpret_cast<uint8_t *>(buf.data() + ctx.rankSize * sliceInts));
+        return true;
+    };
+    for (auto _ : state) {
+        SetSyncCounters(state, ep_emu::RunWorld(options, setup, body), 1.0);
+    }
+}
+BENCHMARK(BM_ExchangeSlices)
+    ->Args({8, 2})
+    ->Args({32, 2})
+    ->Args({64, 2})
+    ->Args({64, 8})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
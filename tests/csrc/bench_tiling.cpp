@@ -0,0 +1,84 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "host_profiler.h"
+#include "common_tiling.h"
+#include "tiling_data.h"
+
+namespace {
+
+using namespace pp_matmul;
+
+// per call host latency of the matmul tiling, args are batch, m, k, n
+void BM_GetPpMatmulTiling(benchmark::State &state)
+{
+    MatMulInfo mmInfo;
+    mmInfo.batchSize = static_cast<uint32_t>(state.range(0));
+    mmInfo.m = static_cast<uint32_t>(state.range(1));
+    mmInfo.k = static_cast<uint32_t>(state.range(2));
+    mmInfo.n = static_cast<uint32_t>(state.range(3));
+    mmInfo.transB = true;
+    mmInfo.inDtype = 2.0f;
+    mmInfo.outDtype = 2.0f;
+    HardwareInfo hwInfo;
+    for (auto _ : state) {
+        PpMatmulTilingData tiling;
+        uint32_t blockDim = 0;
+        GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+        benchmark::DoNotOptimize(tiling);
+        benchmark::DoNotOptimize(blockDim);
+    }
+}
+BENCHMARK(BM_GetPpMatmulTiling)
+    ->Args({1, 1, 7168, 2112})
+    ->Args({1, 128, 1536, 3072})
+    ->Args({128, 32, 128, 512})
+    ->Args({16, 4096, 7168, 7168});
+
+void BM_Swizzl(benchmark::State &state)
+{
+    PpMatmulTilingData tiling;
+    tiling.SetBaseShape(1, 4096, 7168, 7168);
+    tiling.opShape.m0 = 128;
+    tiling.opShape.n0 = 256;
+    tiling.blockDim = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(host_utils::Swizzl(tiling));
+    }
+}
+BENCHMARK(BM_Swizzl)->Arg(1)->Arg(24)->Arg(48);
+
+// cost of one probe around the hot path, arg 0 disabled and 1 enabled
+void BM_HostProfileScope(benchmark::State &state)
+{
+    bool enable = state.range(0) != 0;
+    bool wasEnabled = host_utils::HostProfiler::Instance().Enable(enable);
+    uint64_t iterations = 0;
+    for (auto _ : state) {
+        {
+            host_utils::HostProfileScope scope("bench", host_utils::HostStage::LAUNCH);
+            benchmark::DoNotOptimize(scope);
+        }
+        // keep the ring from overflowing, the reader is a separate thread in practice
+        if (enable && (++iterations % host_utils::HOST_PROFILER_RING_SIZE) == 0) {
+            host_utils::HostProfiler::Instance().Reset();
+        }
+    }
+    host_utils::HostProfiler::Instance().Enable(wasEnabled);
+    host_utils::HostProfiler::Instance().Reset();
+}
+BENCHMARK(BM_HostProfileScope)->Arg(0)->Arg(1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The flag handshakes of the deepep kernels written against sync_collectives.h, for the emulated world of
+// ep_shm_world.h. They run on every block of every rank and use the IPC window layout of comm_args.h.
+
+#ifndef SGL_KERNEL_NPU_EP_EMU_PROTOCOLS_H
+#define SGL_KERNEL_NPU_EP_EMU_PROTOCOLS_H
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "sync_collectives.h"
+#include "ep_shm_world.h"
+
+namespace ep_emu {
+
+// Full barrier across all blocks of all ranks on the outer flags, repeated for the events 1..steps. Before each
+// event a block stores the event into the data area of its window, after it the value of the next rank must have
+// caught up, which only holds when no block leaves the barrier early.
+inline bool OuterFlagBarrier(const RankContext &ctx, int32_t magic, int32_t steps, int delayRank = -1,
+                             int delayUs = 0)
+{
+    TPipe pipe;
+    TBuf<QuePosition::VECCALC> flagBuf;
+    pipe.InitBuffer(flagBuf, UB_FLAG_SIZE);
+    SyncCollectives sync;
+    sync.Init(ctx.rank, ctx.rankSize, ctx.ShareAddrs(), flagBuf);
+
+    int64_t slot = IPC_DATA_OFFSET / sizeof(int64_t) + GetBlockIdx() * FLAG_UNIT_INT_NUM;
+    GlobalTensor<int64_t> own;
+    own.SetGlobalBuffer((__gm__ int64_t *)ctx.ShareAddrs()[ctx.rank]);
+    GlobalTensor<int64_t> next;
+    next.SetGlobalBuffer((__gm__ int64_t *)ctx.ShareAddrs()[(ctx.rank + 1) % ctx.rankSize]);
+    for (int32_t step = 1; step <= steps; ++step) {
+        if (ctx.rank == delayRank) {
+            usleep(delayUs);
+        }
+        own.SetValue(slot, step);
+        sync.SetOuterFlag(magic, step);
+        sync.WaitAllRankOuterFlag(magic, step);
+        if (next.GetValue(slot) < step) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// All-to-all of per peer slices in the way notify_dispatch shares its counts: a rank stages the slice for peer p in
+// its own window at IPC_DATA_OFFSET + p * slot, raises flag `rank` in the window of p, waits for the flags of the
+// peers and then reads slice `rank` out of their windows. The blocks split the peers like InputToShareSlice and
+// ShareToShareSlice. send and recv are rank private GM holding rankSize slices of sliceBytes each.
+inline void ExchangeSlices(const RankContext &ctx, int32_t magic, __gm__ uint8_t *send, uint32_t sliceBytes,
+                           __gm__ uint8_t *recv)
+{
+    int64_t perCore = Ceil(ctx.rankSize, GetBlockNum());
+    int64_t copyOffset = GetBlockIdx() * perCore;
+    int64_t copyLen = std::min<int64_t>(perCore, ctx.rankSize - copyOffset);
+    if (copyLen <= 0) {
+        return;
+    }
+    uint32_t slotBytes = Ceil(sliceBytes, UB_ALIGN_SIZE) * UB_ALIGN_SIZE;
+
+    TPipe pipe;
+    TBuf<QuePosition::VECCALC> flagBuf;
+    TBuf<QuePosition::VECCALC> dataBuf;
+    pipe.InitBuffer(flagBuf, UB_FLAG_SIZE);
+    pipe.InitBuffer(dataBuf, slotBytes);
+    SyncCollectives sync;
+    sync.Init(ctx.rank, ctx.rankSize, ctx.ShareAddrs(), flagBuf);
+
+    LocalTensor<uint8_t> data = dataBuf.Get<uint8_t>();
+    const DataCopyExtParams copyParams{1U, sliceBytes, 0U, 0U, 0U};
+    const DataCopyPadExtParams<uint8_t> padParams{false, 0U, 0U, 0U};
+    GlobalTensor<uint8_t> src;
+    GlobalTensor<uint8_t> dst;
+    for (int64_t p = copyOffset; p < copyOffset + copyLen; ++p) {
+        src.SetGlobalBuffer(send + p * sliceBytes);
+        dst.SetGlobalBuffer(ctx.ShareAddrs()[ctx.rank] + IPC_DATA_OFFSET + p * slotBytes);
+        DataCopyPad(data, src, copyParams, padParams);
+        AscendC::SetFlag<HardEvent::MTE2_MTE3>(EVENT_ID0);
+        AscendC::WaitFlag<HardEvent::MTE2_MTE3>(EVENT_ID0);
+        DataCopyPad(dst, data, copyParams);
+        AscendC::SetFlag<HardEvent::MTE3_MTE2>(EVENT_ID0);
+        AscendC::WaitFlag<HardEvent::MTE3_MTE2>(EVENT_ID0);
+    }
+    for (int64_t p = copyOffset; p < copyOffset + copyLen; ++p) {
+        sync.SetSyncFlag(magic, 1, ctx.rank, p);
+    }
+
+    sync.WaitSyncFlag(magic, 1, copyOffset, ctx.rank, copyLen);
+    for (int64_t p = copyOffset; p < copyOffset + copyLen; ++p) {
+        src.SetGlobalBuffer(ctx.ShareAddrs()[p] + IPC_DATA_OFFSET + ctx.rank * slotBytes);
+        dst.SetGlobalBuffer(recv + p * sliceBytes);
+        DataCopyPad(data, src, copyParams, padParams);
+        AscendC::SetFlag<HardEvent::MTE2_MTE3>(EVENT_ID0);
+        AscendC::WaitFlag<HardEvent::MTE2_MTE3>(EVENT_ID0);
+        DataCopyPad(dst, data, copyParams);
+        AscendC::SetFlag<HardEvent::MTE3_MTE2>(EVENT_ID0);
+        AscendC::WaitFlag<HardEvent::MTE3_MTE2>(EVENT_ID0);
+    }
+}
+
+}  // namespace ep_emu
+
+#endif  // SGL_KERNEL_NPU_EP_EMU_PROTOCOLS_H
@@ -0,0 +1,217 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ep_shm_world.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace ep_emu {
+namespace {
+
+// unique per world so that a killed run of the test never collides with the next one
+std::string WindowPrefix()
+{
+    static std::atomic<uint32_t> worldId{0};
+    return "/sgl_kernel_npu_ep_" + std::to_string(getpid()) + "_" + std::to_string(worldId.fetch_add(1)) + "_";
+}
+
+GM_ADDR MapWindow(const std::string &name, size_t bytes)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void *addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return addr == MAP_FAILED ? nullptr : static_cast<GM_ADDR>(addr);
+}
+
+// body of a forked rank, never returns
+[[noreturn]] void RunRank(int rank, const WorldOptions &options, const std::vector<std::string> &names,
+                          const RankSetup &setup, const BlockBody &body, RankReport *report)
+{
+    auto start = std::chrono::steady_clock::now();
+    RankContext ctx;
+    ctx.rank = rank;
+    ctx.rankSize = options.numRanks;
+    ctx.args = std::make_unique<Moe::CommArgs>();
+    ctx.args->rank = rank;
+    ctx.args->localRank = rank;
+    ctx.args->rankSize = options.numRanks;
+    ctx.args->localRankSize = options.numRanks;
+    ctx.peerMems.assign(options.numRanks, nullptr);
+    ctx.args->peerMems = ctx.peerMems.data();
+    for (int r = 0; r < options.numRanks; ++r) {
+        ctx.args->peerMems[r] = MapWindow(names[r], options.windowBytes);
+        if (ctx.args->peerMems[r] == nullptr) {
+            std::fprintf(stderr, "rank %d: failed to map the window of rank %d\n", rank, r);
+            _exit(1);
+        }
+    }
+
+    std::atomic<bool> passed{true};
+    std::atomic<uint64_t> gmLoads{0};
+    try {
+        if (setup) {
+            setup(ctx);
+        }
+        AscendC::HostEmu::BlockBarrier barrier(options.blockNum);
+        std::vector<std::thread> blocks;
+        for (int b = 0; b < options.blockNum; ++b) {
+            blocks.emplace_back([&, b] {
+                AscendC::HostEmu::BindBlock(b, options.blockNum, &barrier);
+                try {
+                    if (!body(ctx)) {
+                        passed = false;
+                    }
+                } catch (const std::exception &e) {
+                    std::fprintf(stderr, "rank %d block %d: %s\n", rank, b, e.what());
+                    passed = false;
+                }
+                gmLoads += AscendC::HostEmu::Ctx().gmLoads;
+            });
+        }
+        for (auto &block : blocks) {
+            block.join();
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "rank %d: %s\n", rank, e.what());
+        passed = false;
+    }
+
+    report->gmLoads = gmLoads.load();
+    report->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    report->passed = passed.load();
+    report->finished = true;
+    std::fflush(stderr);
+    _exit(passed ? 0 : 1);
+}
+
+}  // namespace
+
+bool WorldReport::AllPassed() const
+{
+    return hungRanks.empty() && std::all_of(ranks.begin(), ranks.end(), [](const RankReport &r) { return r.passed; });
+}
+
+uint64_t WorldReport::MaxGmLoads() const
+{
+    uint64_t maxLoads = 0;
+    for (const auto &r : ranks) {
+        maxLoads = std::max(maxLoads, r.gmLoads);
+    }
+    return maxLoads;
+}
+
+double WorldReport::MaxElapsedMs() const
+{
+    double maxMs = 0.0;
+    for (const auto &r : ranks) {
+        maxMs = std::max(maxMs, r.elapsedMs);
+    }
+    return maxMs;
+}
+
+WorldReport RunWorld(const WorldOptions &options, const RankSetup &setup, const BlockBody &body)
+{
+    if (options.numRanks <= 0 || options.blockNum <= 0 ||
+        options.windowBytes <= static_cast<size_t>(Moe::IPC_DATA_OFFSET)) {
+        throw std::invalid_argument("invalid emulated world options");
+    }
+
+    std::string prefix = WindowPrefix();
+    std::vector<std::string> names;
+    for (int r = 0; r < options.numRanks; ++r) {
+        names.push_back(prefix + std::to_string(r));
+        int fd = shm_open(names.back().c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(options.windowBytes)) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            for (const auto &name : names) {
+                shm_unlink(name.c_str());
+            }
+            throw std::runtime_error("failed to create the shared memory window " + names.back());
+        }
+        close(fd);
+    }
+
+    size_t reportBytes = sizeof(RankReport) * options.numRanks;
+    void *shared = mmap(nullptr, reportBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        for (const auto &name : names) {
+            shm_unlink(name.c_str());
+        }
+        throw std::runtime_error("failed to map the rank reports");
+    }
+    auto *reports = static_cast<RankReport *>(shared);
+    for (int r = 0; r < options.numRanks; ++r) {
+        new (&reports[r]) RankReport();
+    }
+
+    std::fflush(stdout);
+    std::fflush(stderr);
+    std::vector<pid_t> pids(options.numRanks, -1);
+    for (int r = 0; r < options.numRanks; ++r) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            RunRank(r, options, names, setup, body, &reports[r]);
+        }
+        pids[r] = pid;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeoutMs);
+    int running = static_cast<int>(std::count_if(pids.begin(), pids.end(), [](pid_t pid) { return pid > 0; }));
+    while (running > 0 && std::chrono::steady_clock::now() < deadline) {
+        int status = 0;
+        pid_t done = waitpid(-1, &status, WNOHANG);
+        if (done > 0) {
+            auto it = std::find(pids.begin(), pids.end(), done);
+            if (it != pids.end()) {
+                *it = -1;
+                --running;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    WorldReport result;
+    for (int r = 0; r < options.numRanks; ++r) {
+        if (pids[r] > 0) {
+            kill(pids[r], SIGKILL);
+            waitpid(pids[r], nullptr, 0);
+            result.hungRanks.push_back(r);
+        }
+        result.ranks.push_back(reports[r]);
+    }
+    munmap(shared, reportBytes);
+    for (const auto &name : names) {
+        shm_unlink(name.c_str());
+    }
+    return result;
+}
+
+}  // namespace ep_emu
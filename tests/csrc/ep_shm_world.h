@@ -0,0 +1,83 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host emulation of a deepep EP world. Every rank is a forked process, every AIV block of a rank is a thread of it,
+// and the IPC window of every rank is a POSIX shared memory object mapped by all ranks, so the flag handshakes of
+// sync_collectives.h run unmodified across N local processes. The parent is a watchdog, a rank still running when
+// the timeout expires is killed and reported as hung, which reproduces a stuck handshake without a cluster.
+
+#ifndef SGL_KERNEL_NPU_EP_SHM_WORLD_H
+#define SGL_KERNEL_NPU_EP_SHM_WORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "comm_args.h"
+
+namespace ep_emu {
+
+struct WorldOptions {
+    int numRanks{8};
+    int blockNum{2};
+    // bytes of each IPC window, the first Moe::IPC_DATA_OFFSET bytes are the flag area
+    size_t windowBytes{static_cast<size_t>(Moe::IPC_DATA_OFFSET) + 1024 * 1024};
+    int timeoutMs{30000};
+};
+
+// What a rank process sees, args.peerMems points at peerMems, the mapped window of every rank like on device
+struct RankContext {
+    int rank{0};
+    int rankSize{0};
+    std::unique_ptr<Moe::CommArgs> args;
+    std::vector<GM_ADDR> peerMems;
+    std::shared_ptr<void> state;
+
+    GM_ADDR *ShareAddrs() const
+    {
+        return args->peerMems;
+    }
+
+    template <typename T>
+    T &State() const
+    {
+        return *static_cast<T *>(state.get());
+    }
+};
+
+struct RankReport {
+    bool finished{false};
+    bool passed{false};
+    // GM to UB copies issued by all blocks of the rank, the busy wait polls dominate it
+    uint64_t gmLoads{0};
+    double elapsedMs{0.0};
+};
+
+struct WorldReport {
+    std::vector<RankReport> ranks;
+    std::vector<int> hungRanks;
+
+    bool AllPassed() const;
+    uint64_t MaxGmLoads() const;
+    double MaxElapsedMs() const;
+};
+
+// runs once per rank before its blocks start, typically to allocate the rank private GM into ctx.state
+using RankSetup = std::function<void(RankContext &ctx)>;
+// runs on every block thread of every rank, returns false when the rank observed a wrong result
+using BlockBody = std::function<bool(RankContext &ctx)>;
+
+WorldReport RunWorld(const WorldOptions &options, const RankSetup &setup, const BlockBody &body);
+
+}  // namespace ep_emu
+
+#endif  // SGL_KERNEL_NPU_EP_SHM_WORLD_H
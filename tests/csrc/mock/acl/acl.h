@@ -0,0 +1,23 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CPU stand-in for the parts of acl/acl.h used by host tiling code, backed by the mocked platform description.
+
+#ifndef SGL_KERNEL_NPU_MOCK_ACL_H
+#define SGL_KERNEL_NPU_MOCK_ACL_H
+
+#include "tiling/platform/platform_ascendc.h"
+
+inline const char *aclrtGetSocName()
+{
+    return platform_ascendc::MockPlatform::Desc().socName;
+}
+
+#endif  // SGL_KERNEL_NPU_MOCK_ACL_H
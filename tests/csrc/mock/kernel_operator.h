@@ -0,0 +1,613 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CPU stand-in for the subset of the AscendC kernel API used by the deepep communication kernels
+// (sync_collectives.h, data_copy.h, dispatch_layout.h). Every AIV block is a host thread and GM is plain process
+// memory, shared memory when it is an IPC window. GM accesses are word sized atomics with acquire/release order so
+// that a flag written after its payload is observed after it by a peer process, like the MTE queues on device.
+// Each GM to UB copy yields the CPU, a spinning flag wait must not starve the rank it waits on when the machine has
+// fewer cores than the simulated world has blocks.
+
+#ifndef SGL_KERNEL_NPU_MOCK_KERNEL_OPERATOR_H
+#define SGL_KERNEL_NPU_MOCK_KERNEL_OPERATOR_H
+
+#include <sched.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define __aicore__
+#define __gm__
+#define __ubuf__
+
+using GM_ADDR = uint8_t *;
+
+enum pipe_t : uint8_t { PIPE_S = 0, PIPE_V, PIPE_M, PIPE_MTE1, PIPE_MTE2, PIPE_MTE3, PIPE_ALL };
+
+enum event_t : int32_t {
+    EVENT_ID0 = 0,
+    EVENT_ID1,
+    EVENT_ID2,
+    EVENT_ID3,
+    EVENT_ID4,
+    EVENT_ID5,
+    EVENT_ID6,
+    EVENT_ID7,
+};
+
+namespace AscendC {
+
+enum class TPosition : uint8_t { GM, A1, A2, B1, B2, C1, C2, CO1, CO2, VECIN, VECOUT, VECCALC, LCM, SPM, TSCM, MAX };
+using QuePosition = TPosition;
+
+enum class HardEvent : uint8_t {
+    MTE2_MTE1,
+    MTE1_MTE2,
+    MTE2_V,
+    V_MTE2,
+    MTE3_V,
+    V_MTE3,
+    MTE2_S,
+    S_MTE2,
+    MTE3_S,
+    S_MTE3,
+    MTE2_MTE3,
+    MTE3_MTE2,
+    V_S,
+    S_V,
+    MAX,
+};
+
+enum class CacheLine : uint8_t { SINGLE_CACHE_LINE = 0, ENTIRE_DATA_CACHE };
+enum class DcciDst : uint8_t { CACHELINE_ALL = 0, CACHELINE_UB, CACHELINE_OUT, CACHELINE_ATOMIC };
+
+class TPipe;
+
+namespace HostEmu {
+
+constexpr uint32_t BLOCK_SIZE = 32;
+constexpr uint32_t UB_SIZE = 192 * 1024;
+
+// Generation barrier standing in for the cross-core SyncAll of one card
+class BlockBarrier
+{
+public:
+    explicit BlockBarrier(uint32_t count) : count_(count) {}
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t generation = generation_;
+        if (++arrived_ == count_) {
+            arrived_ = 0;
+            ++generation_;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [this, generation] { return generation_ != generation; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint32_t count_;
+    uint32_t arrived_{0};
+    uint64_t generation_{0};
+};
+
+using AtomicOp = void (*)(uint8_t *dst, const uint8_t *src, uint32_t bytes);
+
+// State of the AIV block run by the calling thread
+struct BlockContext {
+    int64_t blockIdx{0};
+    int64_t blockNum{1};
+    BlockBarrier *barrier{nullptr};
+    TPipe *pipe{nullptr};
+    AtomicOp atomicOp{nullptr};
+    uint64_t gmLoads{0};
+    std::vector<uint8_t> ub;
+};
+
+inline BlockContext &Ctx()
+{
+    static thread_local BlockContext ctx;
+    return ctx;
+}
+
+// Binds the calling thread to block blockIdx of a card with blockNum blocks, barrier is shared by its blocks
+inline void BindBlock(int64_t blockIdx, int64_t blockNum, BlockBarrier *barrier)
+{
+    BlockContext &ctx = Ctx();
+    ctx.blockIdx = blockIdx;
+    ctx.blockNum = blockNum;
+    ctx.barrier = barrier;
+    ctx.atomicOp = nullptr;
+    ctx.gmLoads = 0;
+    ctx.ub.assign(UB_SIZE, 0);
+}
+
+template <typename W>
+inline void CopyWords(uint8_t *dst, const uint8_t *src, uint32_t bytes, int loadOrder, int storeOrder)
+{
+    for (uint32_t i = 0; i < bytes; i += sizeof(W)) {
+        W v;
+        __atomic_load(reinterpret_cast<const W *>(src + i), &v, loadOrder);
+        __atomic_store(reinterpret_cast<W *>(dst + i), &v, storeOrder);
+    }
+}
+
+// Word granular copy, an aligned 8 byte flag is never observed half written
+inline void CopyAtomic(uint8_t *dst, const uint8_t *src, uint32_t bytes, int loadOrder, int storeOrder)
+{
+    uintptr_t align = reinterpret_cast<uintptr_t>(dst) | reinterpret_cast<uintptr_t>(src) | bytes;
+    if (align % sizeof(uint64_t) == 0) {
+        CopyWords<uint64_t>(dst, src, bytes, loadOrder, storeOrder);
+    } else if (align % sizeof(uint32_t) == 0) {
+        CopyWords<uint32_t>(dst, src, bytes, loadOrder, storeOrder);
+    } else {
+        CopyWords<uint8_t>(dst, src, bytes, loadOrder, storeOrder);
+    }
+}
+
+inline void GmRead(uint8_t *ub, const uint8_t *gm, uint32_t bytes)
+{
+    CopyAtomic(ub, gm, bytes, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    ++Ctx().gmLoads;
+    sched_yield();
+}
+
+inline void GmWrite(uint8_t *gm, const uint8_t *ub, uint32_t bytes)
+{
+    AtomicOp op = Ctx().atomicOp;
+    if (op != nullptr) {
+        op(gm, ub, bytes);
+        return;
+    }
+    CopyAtomic(gm, ub, bytes, __ATOMIC_RELAXED, __ATOMIC_RELEASE);
+}
+
+template <typename T, typename F>
+inline void AtomicUpdate(uint8_t *dst, const uint8_t *src, uint32_t bytes, F f)
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "atomic GM accumulation is limited to 8 byte elements");
+    for (uint32_t i = 0; i + sizeof(T) <= bytes; i += sizeof(T)) {
+        T *target = reinterpret_cast<T *>(dst + i);
+        T value;
+        std::memcpy(&value, src + i, sizeof(T));
+        T expected;
+        __atomic_load(target, &expected, __ATOMIC_RELAXED);
+        T desired = f(expected, value);
+        while (!__atomic_compare_exchange(target, &expected, &desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            desired = f(expected, value);
+        }
+    }
+}
+
+template <typename T>
+inline void AtomicAdd(uint8_t *dst, const uint8_t *src, uint32_t bytes)
+{
+    AtomicUpdate<T>(dst, src, bytes, [](T a, T b) { return static_cast<T>(a + b); });
+}
+
+template <typename T>
+inline void AtomicMax(uint8_t *dst, const uint8_t *src, uint32_t bytes)
+{
+    AtomicUpdate<T>(dst, src, bytes, [](T a, T b) { return a < b ? b : a; });
+}
+
+template <typename T>
+inline void AtomicMin(uint8_t *dst, const uint8_t *src, uint32_t bytes)
+{
+    AtomicUpdate<T>(dst, src, bytes, [](T a, T b) { return b < a ? b : a; });
+}
+
+inline void CheckBlockAligned(uint32_t bytes, const char *api)
+{
+    if (bytes % BLOCK_SIZE != 0) {
+        throw std::runtime_error(std::string(api) + " length " + std::to_string(bytes) + " is not 32B aligned");
+    }
+}
+
+}  // namespace HostEmu
+
+struct TBuffAddr {
+    uint32_t dataLen{0};
+    uint8_t logicPos{0};
+    uint64_t bufferAddr{0};
+};
+
+template <typename T>
+class LocalTensor
+{
+public:
+    TBuffAddr address_;
+
+    void SetAddr(const TBuffAddr &addr)
+    {
+        address_ = addr;
+    }
+
+    T *GetPhyAddr() const
+    {
+        return reinterpret_cast<T *>(address_.bufferAddr);
+    }
+
+    uint32_t GetSize() const
+    {
+        return address_.dataLen / sizeof(T);
+    }
+
+    T GetValue(uint32_t index) const
+    {
+        return GetPhyAddr()[index];
+    }
+
+    void SetValue(uint32_t index, T value) const
+    {
+        GetPhyAddr()[index] = value;
+    }
+
+    T &operator()(uint32_t index) const
+    {
+        return GetPhyAddr()[index];
+    }
+
+    LocalTensor operator[](uint32_t offset) const
+    {
+        LocalTensor sub = *this;
+        sub.address_.bufferAddr += offset * sizeof(T);
+        sub.address_.dataLen = offset * sizeof(T) < address_.dataLen ? address_.dataLen - offset * sizeof(T) : 0;
+        return sub;
+    }
+
+    template <typename U>
+    LocalTensor<U> ReinterpretCast() const
+    {
+        LocalTensor<U> cast;
+        cast.address_ = address_;
+        return cast;
+    }
+};
+
+template <typename T>
+class GlobalTensor
+{
+public:
+    void SetGlobalBuffer(__gm__ T *buffer, uint64_t bufferSize = 0)
+    {
+        buffer_ = buffer;
+        bufferSize_ = bufferSize;
+    }
+
+    __gm__ T *GetPhyAddr() const
+    {
+        return buffer_;
+    }
+
+    __gm__ T *GetPhyAddr(uint64_t offset) const
+    {
+        return buffer_ + offset;
+    }
+
+    uint64_t GetSize() const
+    {
+        return bufferSize_;
+    }
+
+    T GetValue(uint64_t offset) const
+    {
+        T value;
+        HostEmu::GmRead(reinterpret_cast<uint8_t *>(&value), reinterpret_cast<const uint8_t *>(buffer_ + offset),
+                        sizeof(T));
+        return value;
+    }
+
+    void SetValue(uint64_t offset, T value) const
+    {
+        HostEmu::GmWrite(reinterpret_cast<uint8_t *>(buffer_ + offset), reinterpret_cast<const uint8_t *>(&value),
+                         sizeof(T));
+    }
+
+    T &operator()(uint64_t offset) const
+    {
+        return buffer_[offset];
+    }
+
+    GlobalTensor operator[](uint64_t offset) const
+    {
+        GlobalTensor sub;
+        sub.SetGlobalBuffer(buffer_ + offset, bufferSize_ > offset ? bufferSize_ - offset : 0);
+        return sub;
+    }
+
+private:
+    __gm__ T *buffer_{nullptr};
+    uint64_t bufferSize_{0};
+};
+
+template <TPosition pos = TPosition::VECCALC>
+class TBuf
+{
+public:
+    void Bind(uint8_t *addr, uint32_t len)
+    {
+        addr_ = addr;
+        len_ = len;
+    }
+
+    template <typename T>
+    LocalTensor<T> Get() const
+    {
+        return GetWithOffset<T>(len_ / sizeof(T), 0);
+    }
+
+    template <typename T>
+    LocalTensor<T> Get(uint32_t len) const
+    {
+        return GetWithOffset<T>(len, 0);
+    }
+
+    // bounds checked, an overrun of the buffer reserved by InitBuffer throws instead of corrupting its neighbours
+    template <typename T>
+    LocalTensor<T> GetWithOffset(uint32_t size, uint32_t bufOffset) const
+    {
+        if (addr_ == nullptr || bufOffset + size * sizeof(T) > len_) {
+            throw std::runtime_error("TBuf access of " + std::to_string(size * sizeof(T)) + " bytes at offset " +
+                                     std::to_string(bufOffset) + " exceeds its " + std::to_string(len_) + " bytes");
+        }
+        LocalTensor<T> tensor;
+        tensor.address_.logicPos = static_cast<uint8_t>(pos);
+        tensor.address_.bufferAddr = reinterpret_cast<uint64_t>(addr_ + bufOffset);
+        tensor.address_.dataLen = size * sizeof(T);
+        return tensor;
+    }
+
+    template <typename T>
+    LocalTensor<T> AllocTensor() const
+    {
+        return Get<T>();
+    }
+
+    template <typename T>
+    void FreeTensor(LocalTensor<T> &)
+    {}
+
+private:
+    uint8_t *addr_{nullptr};
+    uint32_t len_{0};
+};
+
+// Bump allocator over the UB of the calling block, the newest pipe of a thread is the one GetTPipePtr returns
+class TPipe
+{
+public:
+    TPipe()
+    {
+        HostEmu::Ctx().pipe = this;
+    }
+
+    ~TPipe()
+    {
+        if (HostEmu::Ctx().pipe == this) {
+            HostEmu::Ctx().pipe = nullptr;
+        }
+    }
+
+    TPipe(const TPipe &) = delete;
+    TPipe &operator=(const TPipe &) = delete;
+
+    template <TPosition pos>
+    void InitBuffer(TBuf<pos> &buf, uint32_t len)
+    {
+        std::vector<uint8_t> &ub = HostEmu::Ctx().ub;
+        uint32_t alignedLen = (len + HostEmu::BLOCK_SIZE - 1) / HostEmu::BLOCK_SIZE * HostEmu::BLOCK_SIZE;
+        if (used_ + alignedLen > ub.size()) {
+            throw std::runtime_error("UB overflow, " + std::to_string(used_ + alignedLen) + " of " +
+                                     std::to_string(ub.size()) + " bytes requested");
+        }
+        buf.Bind(ub.data() + used_, alignedLen);
+        used_ += alignedLen;
+    }
+
+    void Reset()
+    {
+        used_ = 0;
+    }
+
+    int32_t FetchEventID(HardEvent)
+    {
+        return EVENT_ID0;
+    }
+
+    void Destroy() {}
+
+private:
+    uint32_t used_{0};
+};
+
+inline int64_t GetBlockIdx()
+{
+    return HostEmu::Ctx().blockIdx;
+}
+
+inline int64_t GetBlockNum()
+{
+    return HostEmu::Ctx().blockNum;
+}
+
+template <bool isAIVOnly = true>
+inline void SyncAll()
+{
+    if (HostEmu::Ctx().barrier != nullptr) {
+        HostEmu::Ctx().barrier->Wait();
+    }
+}
+
+// pipes of one block are in order on the host, the flags only need to keep the compiler from reordering GM accesses
+template <HardEvent event>
+inline void SetFlag(int32_t)
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+template <HardEvent event>
+inline void WaitFlag(int32_t)
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+template <pipe_t pipe>
+inline void PipeBarrier()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+inline void pipe_barrier(pipe_t)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+template <typename T, CacheLine entireType = CacheLine::SINGLE_CACHE_LINE, DcciDst dcciDst = DcciDst::CACHELINE_OUT>
+inline void DataCacheCleanAndInvalid(const GlobalTensor<T> &)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+template <typename T>
+inline void SetAtomicAdd()
+{
+    HostEmu::Ctx().atomicOp = &HostEmu::AtomicAdd<T>;
+}
+
+template <typename T>
+inline void SetAtomicMax()
+{
+    HostEmu::Ctx().atomicOp = &HostEmu::AtomicMax<T>;
+}
+
+template <typename T>
+inline void SetAtomicMin()
+{
+    HostEmu::Ctx().atomicOp = &HostEmu::AtomicMin<T>;
+}
+
+inline void SetAtomicNone()
+{
+    HostEmu::Ctx().atomicOp = nullptr;
+}
+
+struct DataCopyExtParams {
+    DataCopyExtParams() = default;
+    DataCopyExtParams(uint16_t count, uint32_t len, uint32_t srcStrideIn, uint32_t dstStrideIn, uint32_t rsvIn)
+        : blockCount(count), blockLen(len), srcStride(srcStrideIn), dstStride(dstStrideIn), rsv(rsvIn)
+    {}
+
+    uint16_t blockCount{1};
+    uint32_t blockLen{0};
+    uint32_t srcStride{0};
+    uint32_t dstStride{0};
+    uint32_t rsv{0};
+};
+
+template <typename T>
+struct DataCopyPadExtParams {
+    bool isPad{false};
+    uint8_t leftPadding{0};
+    uint8_t rightPadding{0};
+    T paddingValue{0};
+};
+
+template <typename T>
+inline void DataCopy(const GlobalTensor<T> &dst, const LocalTensor<T> &src, uint32_t count)
+{
+    HostEmu::CheckBlockAligned(count * sizeof(T), "DataCopy");
+    HostEmu::GmWrite(reinterpret_cast<uint8_t *>(dst.GetPhyAddr()), reinterpret_cast<uint8_t *>(src.GetPhyAddr()),
+                     count * sizeof(T));
+}
+
+template <typename T>
+inline void DataCopy(const LocalTensor<T> &dst, const GlobalTensor<T> &src, uint32_t count)
+{
+    HostEmu::CheckBlockAligned(count * sizeof(T), "DataCopy");
+    HostEmu::GmRead(reinterpret_cast<uint8_t *>(dst.GetPhyAddr()), reinterpret_cast<uint8_t *>(src.GetPhyAddr()),
+                    count * sizeof(T));
+}
+
+template <typename T>
+inline void DataCopy(const LocalTensor<T> &dst, const LocalTensor<T> &src, uint32_t count)
+{
+    std::memmove(dst.GetPhyAddr(), src.GetPhyAddr(), count * sizeof(T));
+}
+
+// GM side strides are in bytes and UB side strides in 32B blocks, every UB block starts 32B aligned
+template <typename T>
+inline void DataCopyPad(const GlobalTensor<T> &dst, const LocalTensor<T> &src, const DataCopyExtParams &params)
+{
+    uint8_t *gm = reinterpret_cast<uint8_t *>(dst.GetPhyAddr());
+    uint8_t *ub = reinterpret_cast<uint8_t *>(src.GetPhyAddr());
+    uint32_t ubBlockLen = (params.blockLen + HostEmu::BLOCK_SIZE - 1) / HostEmu::BLOCK_SIZE * HostEmu::BLOCK_SIZE;
+    for (uint16_t i = 0; i < params.blockCount; ++i) {
+        HostEmu::GmWrite(gm, ub, params.blockLen);
+        gm += params.blockLen + params.dstStride;
+        ub += ubBlockLen + params.srcStride * HostEmu::BLOCK_SIZE;
+    }
+}
+
+template <typename T>
+inline void DataCopyPad(const LocalTensor<T> &dst, const GlobalTensor<T> &src, const DataCopyExtParams &params,
+                        const DataCopyPadExtParams<T> &padParams)
+{
+    uint8_t *ub = reinterpret_cast<uint8_t *>(dst.GetPhyAddr());
+    uint8_t *gm = reinterpret_cast<uint8_t *>(src.GetPhyAddr());
+    uint32_t ubBlockLen = (params.blockLen + HostEmu::BLOCK_SIZE - 1) / HostEmu::BLOCK_SIZE * HostEmu::BLOCK_SIZE;
+    for (uint16_t i = 0; i < params.blockCount; ++i) {
+        HostEmu::GmRead(ub, gm, params.blockLen);
+        if (padParams.isPad) {
+            T *tail = reinterpret_cast<T *>(ub + params.blockLen);
+            for (uint32_t j = 0; j < (ubBlockLen - params.blockLen) / sizeof(T); ++j) {
+                tail[j] = padParams.paddingValue;
+            }
+        }
+        gm += params.blockLen + params.srcStride;
+        ub += ubBlockLen + params.dstStride * HostEmu::BLOCK_SIZE;
+    }
+}
+
+template <typename T>
+inline void Duplicate(const LocalTensor<T> &dst, const T &scalar, int32_t count)
+{
+    T *data = dst.GetPhyAddr();
+    for (int32_t i = 0; i < count; ++i) {
+        data[i] = scalar;
+    }
+}
+
+template <typename T, typename U>
+inline constexpr auto Ceil(T num, U div) -> decltype(num + div)
+{
+    return (num + div - 1) / div;
+}
+
+}  // namespace AscendC
+
+// the kernels call it unqualified from namespaces that do not import AscendC
+inline AscendC::TPipe *GetTPipePtr()
+{
+    return AscendC::HostEmu::Ctx().pipe;
+}
+
+#endif  // SGL_KERNEL_NPU_MOCK_KERNEL_OPERATOR_H
@@ -0,0 +1,27 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CPU stand-in for the CANN kernel_tiling header, only the HCCL tiling blocks embedded in the deepep tiling data
+// structs are needed. The host emulation never initialises HCCL so their content is opaque.
+
+#ifndef SGL_KERNEL_NPU_MOCK_KERNEL_TILING_H
+#define SGL_KERNEL_NPU_MOCK_KERNEL_TILING_H
+
+#include <cstdint>
+
+struct Mc2InitTiling {
+    uint8_t reserved[64];
+};
+
+struct Mc2CcTiling {
+    uint8_t reserved[280];
+};
+
+#endif  // SGL_KERNEL_NPU_MOCK_KERNEL_TILING_H
@@ -0,0 +1,121 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CPU stand-in for the CANN platform_ascendc header, it shadows the real one on the include path of the host
+// tests so that tiling code can run without an NPU. The description defaults to an Ascend 910C die and can be
+// replaced with MockPlatform::Set before the first tiling call.
+
+#ifndef SGL_KERNEL_NPU_MOCK_PLATFORM_ASCENDC_H
+#define SGL_KERNEL_NPU_MOCK_PLATFORM_ASCENDC_H
+
+#include <cstdint>
+
+namespace platform_ascendc {
+
+enum class CoreMemType { L0_A = 0, L0_B = 1, L0_C = 2, L1 = 3, L2 = 4, UB = 5, HBM = 6, RESERVED };
+
+struct MockPlatformDesc {
+    const char *socName{"Ascend910_9392"};
+    uint32_t coreNum{24};
+    uint32_t coreNumAic{24};
+    uint32_t coreNumAiv{48};
+    uint64_t ubSize{196608};
+    uint64_t l1Size{524288};
+    uint64_t l2Size{201326592};
+    uint64_t l0aSize{65536};
+    uint64_t l0bSize{65536};
+    uint64_t l0cSize{131072};
+    uint64_t hbmSize{68719476736};
+    uint32_t libApiWorkSpaceSize{16 * 1024 * 1024};
+};
+
+class MockPlatform
+{
+public:
+    static MockPlatformDesc &Desc()
+    {
+        static MockPlatformDesc desc;
+        return desc;
+    }
+
+    static void Set(const MockPlatformDesc &desc)
+    {
+        Desc() = desc;
+    }
+};
+
+class PlatformAscendC
+{
+public:
+    uint32_t GetCoreNum() const
+    {
+        return MockPlatform::Desc().coreNum;
+    }
+
+    uint32_t GetCoreNumAic() const
+    {
+        return MockPlatform::Desc().coreNumAic;
+    }
+
+    uint32_t GetCoreNumAiv() const
+    {
+        return MockPlatform::Desc().coreNumAiv;
+    }
+
+    void GetCoreMemSize(const CoreMemType &memType, uint64_t &size) const
+    {
+        const MockPlatformDesc &desc = MockPlatform::Desc();
+        switch (memType) {
+            case CoreMemType::L0_A:
+                size = desc.l0aSize;
+                break;
+            case CoreMemType::L0_B:
+                size = desc.l0bSize;
+                break;
+            case CoreMemType::L0_C:
+                size = desc.l0cSize;
+                break;
+            case CoreMemType::L1:
+                size = desc.l1Size;
+                break;
+            case CoreMemType::L2:
+                size = desc.l2Size;
+                break;
+            case CoreMemType::UB:
+                size = desc.ubSize;
+                break;
+            case CoreMemType::HBM:
+                size = desc.hbmSize;
+                break;
+            default:
+                size = 0;
+                break;
+        }
+    }
+
+    uint32_t GetLibApiWorkSpaceSize() const
+    {
+        return MockPlatform::Desc().libApiWorkSpaceSize;
+    }
+};
+
+class PlatformAscendCManager
+{
+public:
+    static PlatformAscendC *GetInstance()
+    {
+        static PlatformAscendC platform;
+        return &platform;
+    }
+};
+
+}  // namespace platform_ascendc
+
+#endif  // SGL_KERNEL_NPU_MOCK_PLATFORM_ASCENDC_H
@@ -0,0 +1,392 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "dispatch_layout.h"
+#include "ep_emu_protocols.h"
+#include "ep_shm_world.h"
+
+namespace {
+
+using ep_emu::RankContext;
+using ep_emu::RunWorld;
+using ep_emu::WorldOptions;
+using ep_emu::WorldReport;
+
+constexpr int32_t MAGIC = 7;
+constexpr uint32_t LOCAL_EXPERTS = 8;
+// slack behind every rank private buffer, the kernels read and clear in whole 32B blocks
+constexpr size_t GM_SLACK = 64;
+
+void Record(const char *name, const WorldReport &report)
+{
+    testing::Test::RecordProperty(std::string(name) + "_gm_loads_max", static_cast<int>(report.MaxGmLoads()));
+    testing::Test::RecordProperty(std::string(name) + "_elapsed_ms_max", static_cast<int>(report.MaxElapsedMs()));
+}
+
+void ExpectAllPassed(const WorldReport &report)
+{
+    EXPECT_TRUE(report.hungRanks.empty()) << report.hungRanks.size() << " ranks hung, first is rank "
+                                          << report.hungRanks.front();
+    for (size_t r = 0; r < report.ranks.size(); ++r) {
+        EXPECT_TRUE(report.ranks[r].passed) << "rank " << r;
+    }
+}
+
+TEST(EpShmEmu, FlagAreaFitsIpcWindow)
+{
+    // the inner and outer flag segments of every core, and one sync flag per peer rank, live before the data
+    static_assert(2 * MAX_CORE_NUM * SYNC_UNIT_SIZE <= IPC_DATA_OFFSET, "core flags overflow the flag area");
+    static_assert(CAM_MAX_RANK_SIZE * SYNC_UNIT_SIZE <= IPC_DATA_OFFSET, "rank flags overflow the flag area");
+    // a block waits on the flags of all ranks it is responsible for out of its UB flag buffer
+    EXPECT_LE(64 * SYNC_UNIT_SIZE, UB_FLAG_SIZE);
+}
+
+TEST(EpShmEmu, CommArgsHeaderIsIndependentOfRankSize)
+{
+    // the header used to embed a 384 x 384 int64 matrix, about 1.2 MB per launch
+    EXPECT_LT(sizeof(CommArgs), 1024u);
+}
+
+class OuterFlagBarrierTest : public testing::TestWithParam<int> {};
+
+TEST_P(OuterFlagBarrierTest, AllRanksLeaveTogether)
+{
+    WorldOptions options;
+    options.numRanks = GetParam();
+    options.blockNum = 2;
+    WorldReport report =
+        RunWorld(options, nullptr, [](RankContext &ctx) { return ep_emu::OuterFlagBarrier(ctx, MAGIC, 3); });
+    ExpectAllPassed(report);
+    Record("barrier", report);
+}
+
+INSTANTIATE_TEST_SUITE_P(Ranks, OuterFlagBarrierTest, testing::Values(8, 16, 32, 64));
+
+struct ExchangeState {
+    std::vector<int32_t> send;
+    std::vector<int32_t> recv;
+};
+
+int32_t SliceValue(int src, int dst, uint32_t i)
+{
+    return src * 100000 + dst * 100 + static_cast<int32_t>(i);
+}
+
+class ExchangeSlicesTest : public testing::TestWithParam<int> {};
+
+TEST_P(ExchangeSlicesTest, EveryRankGetsItsSlices)
+{
+    WorldOptions options;
+    options.numRanks = GetParam();
+    options.blockNum = 2;
+    auto setup = [](RankContext &ctx) {
+        auto state = std::make_shared<ExchangeState>();
+        state->send.resize(ctx.rankSize * LOCAL_EXPERTS);
+        state->recv.assign(ctx.rankSize * LOCAL_EXPERTS, -1);
+        for (int dst = 0; dst < ctx.rankSize; ++dst) {
+            for (uint32_t i = 0; i < LOCAL_EXPERTS; ++i) {
+                state->send[dst * LOCAL_EXPERTS + i] = SliceValue(ctx.rank, dst, i);
+            }
+        }
+        ctx.state = state;
+    };
+    auto body = [](RankContext &ctx) {
+        ExchangeState &state = ctx.State<ExchangeState>();
+        ep_emu::ExchangeSlices(ctx, MAGIC, reinterpret_cast<uint8_t *>(state.send.data()),
+                               LOCAL_EXPERTS * sizeof(int32_t), reinterpret_cast<uint8_t *>(state.recv.data()));
+        SyncAll<true>();
+        if (GetBlockIdx() != 0) {
+            return true;
+        }
+        for (int src = 0; src < ctx.rankSize; ++src) {
+            for (uint32_t i = 0; i < LOCAL_EXPERTS; ++i) {
+                if (state.recv[src * LOCAL_EXPERTS + i] != SliceValue(src, ctx.rank, i)) {
+                    std::fprintf(stderr, "rank %d: slice of rank %d is wrong at %u\n", ctx.rank, src, i);
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    WorldReport report = RunWorld(options, setup, body);
+    ExpectAllPassed(report);
+    Record("exchange", report);
+}
+
+INSTANTIATE_TEST_SUITE_P(Ranks, ExchangeSlicesTest, testing::Values(8, 64));
+
+struct LayoutCase {
+    int numRanks;
+    uint32_t numTokens;
+    uint32_t perRoundTokens;
+    bool bitmap{false};
+    int blockNum{2};
+    // physical replicas of every logical expert, above 1 the layout maps the logical topk of the rank itself
+    uint32_t replicas{1};
+};
+
+constexpr uint32_t LAYOUT_TOPK = 4;
+constexpr uint32_t LAYOUT_EXPERTS_PER_RANK = 2;
+
+// topk of a rank is a pure function of the rank, so every process can rebuild the routing of its peers
+std::vector<int64_t> MakeTopk(int rank, uint32_t numTokens, uint32_t numExperts)
+{
+    std::mt19937 gen(1234 + rank);
+    std::vector<int64_t> topk;
+    std::vector<int64_t> experts(numExperts);
+    for (uint32_t t = 0; t < numTokens; ++t) {
+        for (uint32_t e = 0; e < numExperts; ++e) {
+            experts[e] = e;
+        }
+        std::shuffle(experts.begin(), experts.end(), gen);
+        topk.insert(topk.end(), experts.begin(), experts.begin() + LAYOUT_TOPK);
+    }
+    return topk;
+}
+
+// logical expert e has the physical replicas e + k * numLogicalExperts, rows are the count then the replica ids
+std::vector<int32_t> MakeReplicaTable(uint32_t numLogicalExperts, uint32_t replicas)
+{
+    std::vector<int32_t> table;
+    for (uint32_t e = 0; e < numLogicalExperts; ++e) {
+        table.push_back(static_cast<int32_t>(replicas));
+        for (uint32_t k = 0; k < replicas; ++k) {
+            table.push_back(static_cast<int32_t>(e + k * numLogicalExperts));
+        }
+    }
+    return table;
+}
+
+// physical topk the layout of a rank routes by, token t takes replica t % replicas of each of its logical experts
+std::vector<int64_t> PhysicalTopk(int rank, const LayoutCase &param, uint32_t numExperts)
+{
+    uint32_t numLogicalExperts = numExperts / param.replicas;
+    std::vector<int64_t> topk = MakeTopk(rank, param.numTokens, numLogicalExperts);
+    for (uint32_t t = 0; t < param.numTokens; ++t) {
+        for (uint32_t k = 0; k < LAYOUT_TOPK; ++k) {
+            topk[t * LAYOUT_TOPK + k] += (t % param.replicas) * numLogicalExperts;
+        }
+    }
+    return topk;
+}
+
+struct LayoutRef {
+    std::vector<int32_t> numTokensPerRank;
+    std::vector<int32_t> numTokensPerExpert;
+    std::vector<int32_t> isTokenInRank;
+    std::vector<int32_t> sendTokenIdx;
+};
+
+// columns of is_token_in_rank, one int32 per rank or one bit per rank in bitmap mode
+uint32_t TokenInRankCols(const LayoutCase &param)
+{
+    return param.bitmap ? (param.numRanks + IS_TOKEN_IN_RANK_BITS_PER_WORD - 1) / IS_TOKEN_IN_RANK_BITS_PER_WORD
+                        : param.numRanks;
+}
+
+LayoutRef ReferenceLayout(const std::vector<int64_t> &topk, const LayoutCase &param, uint32_t numExperts)
+{
+    uint32_t rounds = (param.numTokens + param.perRoundTokens - 1) / param.perRoundTokens;
+    LayoutRef ref;
+    ref.numTokensPerRank.assign(param.numRanks, 0);
+    ref.numTokensPerExpert.assign(rounds * numExperts, 0);
+    ref.isTokenInRank.assign(param.numTokens * TokenInRankCols(param), 0);
+    ref.sendTokenIdx.assign(param.numTokens * LAYOUT_TOPK, 0);
+    for (uint32_t t = 0; t < param.numTokens; ++t) {
+        std::vector<bool> seen(param.numRanks, false);
+        int32_t *perExpert = &ref.numTokensPerExpert[(t / param.perRoundTokens) * numExperts];
+        for (uint32_t k = 0; k < LAYOUT_TOPK; ++k) {
+            int64_t expert = topk[t * LAYOUT_TOPK + k];
+            int rank = static_cast<int>(expert / LAYOUT_EXPERTS_PER_RANK);
+            ref.sendTokenIdx[t * LAYOUT_TOPK + k] = perExpert[expert]++;
+            if (seen[rank]) {
+                continue;
+            }
+            seen[rank] = true;
+            ++ref.numTokensPerRank[rank];
+            if (param.bitmap) {
+                uint32_t word = t * TokenInRankCols(param) + rank / IS_TOKEN_IN_RANK_BITS_PER_WORD;
+                ref.isTokenInRank[word] |= static_cast<int32_t>(1U << (rank % IS_TOKEN_IN_RANK_BITS_PER_WORD));
+            } else {
+                ref.isTokenInRank[t * param.numRanks + rank] = 1;
+            }
+        }
+    }
+    return ref;
+}
+
+struct LayoutState {
+    LayoutCase param;
+    uint32_t numExperts;
+    DispatchLayoutTilingData tiling;
+    std::vector<int64_t> topk;
+    std::vector<int32_t> replicaTable;
+    std::vector<int64_t> physicalTopk;
+    std::vector<uint8_t> numTokensPerRank;
+    std::vector<uint8_t> numTokensPerExpert;
+    std::vector<uint8_t> isTokenInRank;
+    std::vector<uint8_t> notifySendData;
+    std::vector<uint8_t> sendTokenIdxSmall;
+    std::vector<int32_t> recvCounts;
+};
+
+template <typename T>
+bool Same(const std::vector<uint8_t> &actual, const std::vector<T> &expected, int rank, const char *what)
+{
+    if (std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(T)) != 0) {
+        std::fprintf(stderr, "rank %d: %s differs from the reference\n", rank, what);
+        return false;
+    }
+    return true;
+}
+
+class DispatchLayoutTest : public testing::TestWithParam<LayoutCase> {};
+
+// dispatch_layout runs on every rank, then the first round counts of its local experts are shared the way
+// notify_dispatch does and checked against the routing of the sending rank
+TEST_P(DispatchLayoutTest, LayoutThenNotifyMatchReference)
+{
+    WorldOptions options;
+    options.numRanks = GetParam().numRanks;
+    options.blockNum = GetParam().blockNum;
+    auto setup = [param = GetParam(), blockNum = options.blockNum](RankContext &ctx) {
+        auto state = std::make_shared<LayoutState>();
+        state->param = param;
+        state->numExperts = param.numRanks * LAYOUT_EXPERTS_PER_RANK;
+        uint32_t rounds = (param.numTokens + param.perRoundTokens - 1) / param.perRoundTokens;
+        std::memset(&state->tiling, 0, sizeof(state->tiling));
+        DispatchLayoutInfo &info = state->tiling.dispatchLayoutInfo;
+        info.numTokens = param.numTokens;
+        info.numRanks = param.numRanks;
+        info.numExperts = state->numExperts;
+        info.numTopk = LAYOUT_TOPK;
+        info.localRankSize = param.numRanks;
+        info.perRoundTokens = param.perRoundTokens;
+        info.isTokenInRankBitmap = param.bitmap ? 1 : 0;
+        info.totalUbSize = AscendC::HostEmu::UB_SIZE;
+        uint32_t numLogicalExperts = state->numExperts / param.replicas;
+        if (param.replicas > 1) {
+            info.numLogicalExperts = numLogicalExperts;
+            info.replicaTableCols = 1 + param.replicas;
+        }
+        state->topk = MakeTopk(ctx.rank, param.numTokens, numLogicalExperts);
+        state->topk.resize(state->topk.size() + GM_SLACK / sizeof(int64_t));
+        state->replicaTable = MakeReplicaTable(numLogicalExperts, param.replicas);
+        state->replicaTable.resize(state->replicaTable.size() + GM_SLACK / sizeof(int32_t));
+        state->physicalTopk.assign(param.numTokens * LAYOUT_TOPK + GM_SLACK / sizeof(int64_t), -1);
+        state->numTokensPerRank.assign(param.numRanks * sizeof(int32_t) + GM_SLACK, 0);
+        state->numTokensPerExpert.assign(rounds * state->numExperts * sizeof(int32_t) + GM_SLACK, 0);
+        state->isTokenInRank.assign(param.numTokens * TokenInRankCols(param) * sizeof(int32_t) + GM_SLACK, 0);
+        state->notifySendData.assign(blockNum * state->numExperts * sizeof(int32_t) + GM_SLACK, 0);
+        state->sendTokenIdxSmall.assign(param.numTokens * LAYOUT_TOPK * sizeof(int32_t) + GM_SLACK, 0);
+        state->recvCounts.assign(param.numRanks * LAYOUT_EXPERTS_PER_RANK, -1);
+        ctx.state = state;
+    };
+    auto body = [](RankContext &ctx) {
+        LayoutState &state = ctx.State<LayoutState>();
+        {
+            TPipe pipe;
+            MoeDispatchLayout::DispatchLayout<int32_t> op;
+            op.Init(reinterpret_cast<GM_ADDR>(state.topk.data()), reinterpret_cast<GM_ADDR>(state.replicaTable.data()),
+                    state.numTokensPerRank.data(), state.numTokensPerExpert.data(), state.isTokenInRank.data(),
+                    state.notifySendData.data(), state.sendTokenIdxSmall.data(),
+                    reinterpret_cast<GM_ADDR>(state.physicalTopk.data()), nullptr, &pipe, &state.tiling);
+            op.Process();
+        }
+        SyncAll<true>();
+        ep_emu::ExchangeSlices(ctx, MAGIC, state.numTokensPerExpert.data(), LAYOUT_EXPERTS_PER_RANK * sizeof(int32_t),
+                               reinterpret_cast<uint8_t *>(state.recvCounts.data()));
+        SyncAll<true>();
+        if (GetBlockIdx() != 0) {
+            return true;
+        }
+
+        std::vector<int64_t> physicalTopk = PhysicalTopk(ctx.rank, state.param, state.numExperts);
+        LayoutRef ref = ReferenceLayout(physicalTopk, state.param, state.numExperts);
+        bool ok = Same(state.numTokensPerRank, ref.numTokensPerRank, ctx.rank, "num_tokens_per_rank") &&
+                  Same(state.numTokensPerExpert, ref.numTokensPerExpert, ctx.rank, "num_tokens_per_expert") &&
+                  Same(state.isTokenInRank, ref.isTokenInRank, ctx.rank, "is_token_in_rank") &&
+                  Same(state.sendTokenIdxSmall, ref.sendTokenIdx, ctx.rank, "send_token_idx_small");
+        if (ok && state.param.replicas > 1 &&
+            !std::equal(physicalTopk.begin(), physicalTopk.end(), state.physicalTopk.begin())) {
+            std::fprintf(stderr, "rank %d: physical_topk_idx differs from the reference\n", ctx.rank);
+            ok = false;
+        }
+        for (int src = 0; ok && src < ctx.rankSize; ++src) {
+            LayoutRef srcRef = ReferenceLayout(PhysicalTopk(src, state.param, state.numExperts), state.param,
+                                               state.numExperts);
+            for (uint32_t i = 0; i < LAYOUT_EXPERTS_PER_RANK; ++i) {
+                int32_t expected = srcRef.numTokensPerExpert[ctx.rank * LAYOUT_EXPERTS_PER_RANK + i];
+                if (state.recvCounts[src * LAYOUT_EXPERTS_PER_RANK + i] != expected) {
+                    std::fprintf(stderr, "rank %d: count of local expert %u from rank %d is wrong\n", ctx.rank, i, src);
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    };
+    WorldReport report = RunWorld(options, setup, body);
+    ExpectAllPassed(report);
+    Record("layout", report);
+}
+
+INSTANTIATE_TEST_SUITE_P(Ranks, DispatchLayoutTest,
+                         testing::Values(LayoutCase{8, 48, 48}, LayoutCase{8, 48, 16}, LayoutCase{64, 64, 64},
+                                         LayoutCase{8, 48, 16, true}, LayoutCase{64, 64, 64, true},
+                                         LayoutCase{8, 8192, 8192, false, 16}, LayoutCase{8, 45, 15, false, 3, 2},
+                                         LayoutCase{64, 63, 63, true, 3, 2}));
+
+TEST(EpShmEmu, SlowPeerDelaysEveryRank)
+{
+    constexpr int delayUs = 20000;
+    constexpr int32_t steps = 3;
+    WorldOptions options;
+    options.numRanks = 16;
+    options.blockNum = 2;
+    WorldReport report = RunWorld(options, nullptr, [](RankContext &ctx) {
+        return ep_emu::OuterFlagBarrier(ctx, MAGIC, steps, 3, delayUs);
+    });
+    ExpectAllPassed(report);
+    // a rank forked late may miss part of the first delay, every later one starts after all ranks reached step 1
+    for (size_t r = 0; r < report.ranks.size(); ++r) {
+        EXPECT_GE(report.ranks[r].elapsedMs, (steps - 1) * delayUs / 1000.0)
+            << "rank " << r << " left the barrier early";
+    }
+    Record("slow_peer", report);
+}
+
+TEST(EpShmEmu, HungPeerIsReported)
+{
+    constexpr int deadRank = 5;
+    WorldOptions options;
+    options.numRanks = 8;
+    options.blockNum = 2;
+    options.timeoutMs = 1500;
+    WorldReport report = RunWorld(options, nullptr, [](RankContext &ctx) {
+        // the dead rank never raises its outer flag, every other rank spins on it until the watchdog fires
+        return ctx.rank == deadRank || ep_emu::OuterFlagBarrier(ctx, MAGIC, 1);
+    });
+    std::vector<int> expected = {0, 1, 2, 3, 4, 6, 7};
+    EXPECT_EQ(report.hungRanks, expected);
+    EXPECT_TRUE(report.ranks[deadRank].finished);
+    EXPECT_FALSE(report.ranks[0].finished);
+    EXPECT_FALSE(report.AllPassed());
+}
+
+}  // namespace
@@ -0,0 +1,119 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "host_profiler.h"
+
+namespace {
+
+using host_utils::HostHistogram;
+using host_utils::HostProfiler;
+using host_utils::HostProfileScope;
+using host_utils::HostStage;
+
+class HostProfilerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        wasEnabled_ = HostProfiler::Instance().Enable(false);
+        HostProfiler::Instance().Reset();
+    }
+
+    void TearDown() override
+    {
+        HostProfiler::Instance().Enable(wasEnabled_);
+        HostProfiler::Instance().Reset();
+    }
+
+    bool wasEnabled_{false};
+};
+
+TEST(HostHistogram, Buckets)
+{
+    HostHistogram hist;
+    for (uint64_t ns : {0ULL, 1ULL, 2ULL, 3ULL, 1000ULL, 1ULL << 40}) {
+        hist.Add(ns);
+    }
+    EXPECT_EQ(hist.count, 6u);
+    EXPECT_EQ(hist.buckets[0], 2u);  // 0 and 1
+    EXPECT_EQ(hist.buckets[1], 2u);  // 2 and 3
+    EXPECT_EQ(hist.buckets[9], 1u);  // 512 <= 1000 < 1024
+    EXPECT_EQ(hist.buckets[host_utils::HOST_PROFILER_BUCKET_NUM - 1], 1u);
+    EXPECT_EQ(hist.maxNs, 1ULL << 40);
+    EXPECT_EQ(hist.Quantile(0.5), 3u);
+    EXPECT_EQ(hist.Quantile(1.0), 1ULL << 40);
+}
+
+TEST_F(HostProfilerTest, DisabledRecordsNothing)
+{
+    {
+        HostProfileScope scope("disabled_op", HostStage::TILING);
+    }
+    EXPECT_EQ(HostProfiler::Instance().Dump().find("disabled_op"), std::string::npos);
+}
+
+TEST_F(HostProfilerTest, AggregatesPerOpAndStage)
+{
+    HostProfiler::Instance().Enable(true);
+    for (int i = 0; i < 3; ++i) {
+        HostProfileScope scope("op_a", HostStage::TILING);
+    }
+    {
+        HostProfileScope scope("op_a", HostStage::LAUNCH);
+    }
+    HostProfiler::Instance().Record("op_b", HostStage::WORKSPACE, 100);
+    std::string stats = HostProfiler::Instance().Dump();
+    EXPECT_NE(stats.find("\"enabled\": true"), std::string::npos);
+    EXPECT_NE(stats.find("\"op_a\": {\"tiling\": {\"count\": 3"), std::string::npos);
+    EXPECT_NE(stats.find("\"launch\": {\"count\": 1"), std::string::npos);
+    EXPECT_NE(stats.find("\"op_b\": {\"workspace\": {\"count\": 1, \"total_ns\": 100"), std::string::npos);
+
+    HostProfiler::Instance().Reset();
+    EXPECT_EQ(HostProfiler::Instance().Dump().find("op_a"), std::string::npos);
+}
+
+TEST_F(HostProfilerTest, CollectsExitedThreadsAndCountsDrops)
+{
+    HostProfiler::Instance().Enable(true);
+    constexpr size_t threadNum = 4;
+    constexpr size_t eventNum = host_utils::HOST_PROFILER_RING_SIZE + 10;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadNum; ++t) {
+        threads.emplace_back([] {
+            for (size_t i = 0; i < eventNum; ++i) {
+                HostProfiler::Instance().Record("threaded_op", HostStage::LAUNCH, 1);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::string stats = HostProfiler::Instance().Dump();
+    std::string count = "\"count\": " + std::to_string(threadNum * host_utils::HOST_PROFILER_RING_SIZE);
+    EXPECT_NE(stats.find(count), std::string::npos);
+    EXPECT_NE(stats.find("\"dropped\": " + std::to_string(threadNum * 10)), std::string::npos);
+}
+
+TEST_F(HostProfilerTest, WorkspaceFollowsCurrentOp)
+{
+    HostProfiler::SetCurrentOp(nullptr);
+    EXPECT_STREQ(HostProfiler::GetCurrentOp(), host_utils::HOST_PROFILER_UNKNOWN_OP);
+    HostProfiler::SetCurrentOp("mla_preprocess");
+    EXPECT_STREQ(HostProfiler::GetCurrentOp(), "mla_preprocess");
+    HostProfiler::SetCurrentOp(nullptr);
+}
+
+}  // namespace
@@ -0,0 +1,155 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "matmul_tuning_db.h"
+#include "tiling_data.h"
+#include "tiling_tuning.h"
+
+namespace {
+
+using namespace pp_matmul;
+using host_utils::MatmulTuningDb;
+using host_utils::MatmulTuningKey;
+using host_utils::MatmulTuningValue;
+
+MatMulInfo MakeBmtInfo(uint32_t batchSize, uint32_t m, uint32_t k, uint32_t n)
+{
+    MatMulInfo mmInfo;
+    mmInfo.batchSize = batchSize;
+    mmInfo.m = m;
+    mmInfo.k = k;
+    mmInfo.n = n;
+    mmInfo.dtypeA = TensorDType::TENSOR_DTYPE_BF16;
+    mmInfo.dtypeB = TensorDType::TENSOR_DTYPE_BF16;
+    mmInfo.dtypeC = TensorDType::TENSOR_DTYPE_BF16;
+    mmInfo.mmType = MatMul::MatMulType::MATMUL_EIN_SUM;
+    mmInfo.inDtype = 2.0f;
+    mmInfo.outDtype = 2.0f;
+    return mmInfo;
+}
+
+std::string TempDbPath(const char *name)
+{
+    return ::testing::TempDir() + name;
+}
+
+class MatmulTuningDbTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        MatmulTuningDb::Instance().ClearPending();
+        MatmulTuningDb::Instance().Load("/nonexistent/matmul_tuning.db");
+    }
+};
+
+TEST_F(MatmulTuningDbTest, SaveLoadRoundTrip)
+{
+    HardwareInfo hwInfo;
+    auto &db = MatmulTuningDb::Instance();
+    std::string path = TempDbPath("roundtrip.db");
+    for (uint32_t m : {1u, 16u, 128u, 4096u}) {
+        db.Set(GetPpMatmulTuningKey(MakeBmtInfo(16, m, 512, 128), hwInfo), {m % 256 + 16, 128, 256, 2, 1, 1.5f});
+    }
+    ASSERT_EQ(db.Save(path), 4);
+    db.ClearPending();
+    ASSERT_EQ(db.Load(path), 4);
+
+    MatmulTuningValue value;
+    ASSERT_TRUE(db.Find(GetPpMatmulTuningKey(MakeBmtInfo(16, 128, 512, 128), hwInfo), value));
+    EXPECT_EQ(value.m0, 144u);
+    EXPECT_EQ(value.k0, 256u);
+    EXPECT_EQ(value.swizzleDirect, 1u);
+    EXPECT_FLOAT_EQ(value.timeUs, 1.5f);
+    EXPECT_FALSE(db.Find(GetPpMatmulTuningKey(MakeBmtInfo(16, 64, 512, 128), hwInfo), value));
+    std::remove(path.c_str());
+}
+
+TEST_F(MatmulTuningDbTest, RejectsMalformedFile)
+{
+    std::string path = TempDbPath("malformed.db");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "SGLMMTDB but truncated";
+    }
+    EXPECT_EQ(MatmulTuningDb::Instance().Load(path), -1);
+    std::remove(path.c_str());
+}
+
+TEST_F(MatmulTuningDbTest, TunedTilingOverridesHeuristic)
+{
+    HardwareInfo hwInfo;
+    MatMulInfo mmInfo = MakeBmtInfo(16, 128, 512, 128);
+    MatmulTuningValue tuned{32, 64, 128, 4, 1, 0};
+    MatmulTuningDb::Instance().Set(GetPpMatmulTuningKey(mmInfo, hwInfo), tuned);
+
+    PpMatmulTilingData tiling;
+    uint32_t blockDim = 0;
+    GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+    EXPECT_EQ(tiling.opShape.m0, 32u);
+    EXPECT_EQ(tiling.opShape.n0, 64u);
+    EXPECT_EQ(tiling.opShape.k0, 128u);
+    EXPECT_EQ(tiling.mLoop, 4u);
+    EXPECT_EQ(tiling.nLoop, 2u);
+    EXPECT_EQ(tiling.kLoop, 4u);
+    EXPECT_EQ(tiling.coreLoop, 128u);
+    EXPECT_EQ(blockDim, hwInfo.coreNum);
+    EXPECT_EQ(tiling.swizzlCount, 4u);
+    EXPECT_EQ(tiling.swizzlDirect, 1u);
+}
+
+TEST_F(MatmulTuningDbTest, InvalidTuningFallsBackToHeuristic)
+{
+    HardwareInfo hwInfo;
+    MatMulInfo mmInfo = MakeBmtInfo(16, 128, 512, 128);
+    PpMatmulTilingData expected;
+    uint32_t expectedBlockDim = 0;
+    GetPpMatmulTiling(mmInfo, hwInfo, expectedBlockDim, expected);
+
+    // the fp32 accumulator of a 256x512 tile does not fit L0C
+    MatmulTuningDb::Instance().Set(GetPpMatmulTuningKey(mmInfo, hwInfo), {256, 512, 64, 1, 0, 0});
+    PpMatmulTilingData tiling;
+    uint32_t blockDim = 0;
+    GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+    EXPECT_EQ(blockDim, expectedBlockDim);
+    EXPECT_EQ(0, std::memcmp(&tiling, &expected, sizeof(PpMatmulTilingData)));
+}
+
+TEST_F(MatmulTuningDbTest, TraceAndCandidates)
+{
+    HardwareInfo hwInfo;
+    MatMulInfo mmInfo = MakeBmtInfo(4, 33, 7168, 512);
+    auto &db = MatmulTuningDb::Instance();
+    db.Trace(true);
+    PpMatmulTilingData tiling;
+    uint32_t blockDim = 0;
+    GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+    auto traced = db.Trace(false);
+    ASSERT_EQ(traced.size(), 1u);
+    EXPECT_TRUE(traced[0] == GetPpMatmulTuningKey(mmInfo, hwInfo));
+
+    auto candidates = GetPpMatmulTuningCandidates(traced[0], hwInfo);
+    ASSERT_FALSE(candidates.empty());
+    for (const auto &value : candidates) {
+        PpMatmulTilingData candidate;
+        candidate.SetBaseShape(mmInfo.batchSize, mmInfo.m, mmInfo.k, mmInfo.n);
+        ASSERT_TRUE(ApplyPpMatmulTuning(mmInfo, hwInfo, value, blockDim, candidate));
+        EXPECT_LE(static_cast<uint64_t>(value.m0) * value.n0 * sizeof(float), hwInfo.l0cSize);
+        EXPECT_LE(candidate.swizzlCount, candidate.blockDim);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "common.h"
+#include "common_tiling.h"
+#include "tiling_data.h"
+
+namespace {
+
+using namespace pp_matmul;
+using host_utils::CeilDiv;
+
+struct SweepCase {
+    uint32_t batchSize;
+    uint32_t m;
+    uint32_t k;
+    uint32_t n;
+};
+
+MatMulInfo MakeMatMulInfo(const SweepCase &c, bool isInt8, bool transB)
+{
+    MatMulInfo mmInfo;
+    mmInfo.batchSize = c.batchSize;
+    mmInfo.m = c.m;
+    mmInfo.k = c.k;
+    mmInfo.n = c.n;
+    mmInfo.transA = false;
+    mmInfo.transB = transB;
+    mmInfo.isInt8 = isInt8;
+    mmInfo.inDtype = isInt8 ? 1.0f : 2.0f;
+    mmInfo.outDtype = 2.0f;
+    if (isInt8) {
+        mmInfo.mmType = MatMul::MatMulType::MATMUL_DEQUANT;
+        mmInfo.quantMode = MatMul::QuantMode::PER_TOKEN_SYMM;
+    }
+    return mmInfo;
+}
+
+std::vector<SweepCase> BuildSweep()
+{
+    std::vector<SweepCase> cases;
+    const uint32_t batches[] = {1, 4, 16, 128};
+    const uint32_t ms[] = {1, 7, 16, 33, 128, 512, 1024, 4096};
+    const uint32_t ks[] = {16, 128, 512, 1536, 7168};
+    const uint32_t ns[] = {16, 64, 128, 512, 2112, 7168};
+    for (auto b : batches) {
+        for (auto m : ms) {
+            for (auto k : ks) {
+                for (auto n : ns) {
+                    cases.push_back({b, m, k, n});
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+void CheckInvariants(const MatMulInfo &mmInfo, const HardwareInfo &hwInfo, uint32_t blockDim,
+                     const PpMatmulTilingData &tiling)
+{
+    const OpShape &shape = tiling.opShape;
+    SCOPED_TRACE(::testing::Message() << "batch=" << mmInfo.batchSize << " m=" << mmInfo.m << " k=" << mmInfo.k
+                                      << " n=" << mmInfo.n << " int8=" << mmInfo.isInt8
+                                      << " transB=" << mmInfo.transB);
+
+    ASSERT_GT(shape.m0, 0u);
+    ASSERT_GT(shape.n0, 0u);
+    ASSERT_GT(shape.k0, 0u);
+    EXPECT_EQ(blockDim, tiling.blockDim);
+    EXPECT_GE(blockDim, 1u);
+    EXPECT_LE(blockDim, hwInfo.coreNum);
+    EXPECT_LE(blockDim, tiling.coreLoop);
+
+    // base blocks are cube aligned and the fp32 accumulator tile fits L0C
+    EXPECT_EQ(shape.m0 % host_utils::BLOCK_SIZE, 0u);
+    EXPECT_EQ(shape.n0 % host_utils::BLOCK_SIZE, 0u);
+    EXPECT_LE(static_cast<uint64_t>(shape.m0) * shape.n0 * sizeof(float), hwInfo.l0cSize);
+
+    // k0 keeps the cube k alignment and the A/B ping-pong tiles fit their L1 half
+    uint32_t kAlign = mmInfo.isInt8 ? host_utils::BLOCK_SIZE_INT8_K : host_utils::BLOCK_SIZE;
+    EXPECT_EQ(shape.k0 % kAlign, 0u);
+    EXPECT_LE((shape.m0 + shape.n0) * shape.k0 * mmInfo.inDtype,
+              static_cast<float>(host_utils::L1AB_PINGPONG_BUFFER_LEN));
+
+    EXPECT_EQ(tiling.mLoop, CeilDiv(shape.m, shape.m0));
+    EXPECT_EQ(tiling.nLoop, CeilDiv(shape.n, shape.n0));
+    EXPECT_EQ(tiling.kLoop, CeilDiv(shape.k, shape.k0));
+    EXPECT_GE(tiling.swizzlCount, 1u);
+    EXPECT_LE(tiling.swizzlCount, blockDim);
+    EXPECT_LE(tiling.swizzlDirect, 1u);
+}
+
+class PpMatmulTilingSweep : public ::testing::TestWithParam<std::tuple<bool, bool>>
+{};
+
+TEST_P(PpMatmulTilingSweep, Invariants)
+{
+    bool isInt8 = std::get<0>(GetParam());
+    bool transB = std::get<1>(GetParam());
+    HardwareInfo hwInfo;
+    for (const auto &c : BuildSweep()) {
+        MatMulInfo mmInfo = MakeMatMulInfo(c, isInt8, transB);
+        PpMatmulTilingData tiling;
+        uint32_t blockDim = 0;
+        GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+        CheckInvariants(mmInfo, hwInfo, blockDim, tiling);
+        if (HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(DtypeAndLayout, PpMatmulTilingSweep,
+                         ::testing::Combine(::testing::Bool(), ::testing::Bool()));
+
+TEST(PpMatmulTiling, BlockDimBoundedByCoreNum)
+{
+    // tiling takes the core count from HardwareInfo, a smaller die must never get more blocks than cores
+    for (uint32_t coreNum : {1u, 8u, 20u, 24u}) {
+        HardwareInfo hwInfo;
+        hwInfo.coreNum = coreNum;
+        for (const auto &c : BuildSweep()) {
+            MatMulInfo mmInfo = MakeMatMulInfo(c, false, true);
+            PpMatmulTilingData tiling;
+            uint32_t blockDim = 0;
+            GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+            ASSERT_GE(blockDim, 1u);
+            ASSERT_LE(blockDim, coreNum) << "m=" << c.m << " k=" << c.k << " n=" << c.n;
+        }
+    }
+}
+
+TEST(PpMatmulTiling, Deterministic)
+{
+    HardwareInfo hwInfo;
+    MatMulInfo mmInfo = MakeMatMulInfo({16, 128, 512, 128}, false, false);
+    PpMatmulTilingData first;
+    PpMatmulTilingData second;
+    uint32_t firstBlockDim = 0;
+    uint32_t secondBlockDim = 0;
+    GetPpMatmulTiling(mmInfo, hwInfo, firstBlockDim, first);
+    GetPpMatmulTiling(mmInfo, hwInfo, secondBlockDim, second);
+    EXPECT_EQ(firstBlockDim, secondBlockDim);
+    EXPECT_EQ(0, std::memcmp(&first, &second, sizeof(PpMatmulTilingData)));
+}
+
+TEST(Swizzl, CountWithinBlockDim)
+{
+    for (uint32_t blockDim : {1u, 3u, 24u}) {
+        for (const auto &c : BuildSweep()) {
+            PpMatmulTilingData tiling;
+            tiling.SetBaseShape(c.batchSize, c.m, c.k, c.n);
+            tiling.opShape.m0 = 128;
+            tiling.opShape.n0 = 256;
+            tiling.blockDim = blockDim;
+            uint32_t direct = host_utils::Swizzl(tiling);
+            ASSERT_EQ(direct, tiling.swizzlDirect);
+            ASSERT_GE(tiling.swizzlCount, 1u);
+            ASSERT_LE(tiling.swizzlCount, blockDim);
+        }
+    }
+}
+
+}  // namespace
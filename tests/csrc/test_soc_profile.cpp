@@ -0,0 +1,79 @@
+// Licensed under the BSD 3-Clause License  (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include "common_tiling.h"
+#include "tiling_data.h"
+
+namespace {
+
+using host_utils::FindSocProfile;
+using host_utils::PlatformType;
+
+TEST(SocProfile, LookupByPrefix)
+{
+    ASSERT_NE(FindSocProfile("Ascend910_9392"), nullptr);
+    EXPECT_EQ(FindSocProfile("Ascend910_9392")->socType, PlatformType::ASCEND_910C);
+    EXPECT_EQ(FindSocProfile("Ascend910B1")->socType, PlatformType::ASCEND_910B);
+    EXPECT_EQ(FindSocProfile("Ascend910B3")->coreNumAic, 20u);
+    EXPECT_EQ(FindSocProfile("Ascend910B4")->l2Size, 100663296u);
+    EXPECT_EQ(FindSocProfile("Ascend910PremiumA")->socType, PlatformType::ASCEND_910A);
+    EXPECT_EQ(FindSocProfile("Ascend310P3")->socType, PlatformType::ASCEND_310P);
+    EXPECT_EQ(FindSocProfile("Ascend310B1"), nullptr);
+    EXPECT_EQ(FindSocProfile(nullptr), nullptr);
+}
+
+TEST(SocProfile, PlatformInfoFollowsSocName)
+{
+    // the mocked runtime reports a 910_93 die, sizes still come from the platform query
+    const auto &platform = host_utils::PlatformInfo::Instance();
+    EXPECT_EQ(platform.socType, PlatformType::ASCEND_910C);
+    EXPECT_EQ(platform.coreNumAic, platform_ascendc::MockPlatform::Desc().coreNumAic);
+    EXPECT_EQ(platform.l0cSize, platform_ascendc::MockPlatform::Desc().l0cSize);
+
+    pp_matmul::HardwareInfo hwInfo;
+    EXPECT_EQ(hwInfo.hbmBandWidth, platform.hbmBandWidth);
+    EXPECT_EQ(hwInfo.l2BandWidth, platform.l2BandWidth);
+}
+
+TEST(SocProfile, TilingRespectsEveryProfile)
+{
+    for (const auto &profile : host_utils::SOC_PROFILES) {
+        pp_matmul::HardwareInfo hwInfo;
+        hwInfo.coreNum = profile.coreNumAic;
+        hwInfo.l2Size = static_cast<uint32_t>(profile.l2Size);
+        hwInfo.l1Size = static_cast<uint32_t>(profile.l1Size);
+        hwInfo.l0aSize = static_cast<uint32_t>(profile.l0aSize);
+        hwInfo.l0bSize = static_cast<uint32_t>(profile.l0bSize);
+        hwInfo.l0cSize = static_cast<uint32_t>(profile.l0cSize);
+        hwInfo.hbmBandWidth = profile.hbmBandWidth;
+        hwInfo.l2BandWidth = profile.l2BandWidth;
+
+        pp_matmul::MatMulInfo mmInfo;
+        mmInfo.batchSize = 1;
+        mmInfo.m = 128;
+        mmInfo.k = 7168;
+        mmInfo.n = 2112;
+        mmInfo.transB = true;
+        mmInfo.inDtype = 2.0f;
+        mmInfo.outDtype = 2.0f;
+        pp_matmul::PpMatmulTilingData tiling;
+        uint32_t blockDim = 0;
+        pp_matmul::GetPpMatmulTiling(mmInfo, hwInfo, blockDim, tiling);
+        EXPECT_GE(blockDim, 1u) << profile.socPrefix;
+        EXPECT_LE(blockDim, profile.coreNumAic) << profile.socPrefix;
+        EXPECT_LE(static_cast<uint64_t>(tiling.opShape.m0) * tiling.opShape.n0 * sizeof(float), profile.l0cSize)
+            << profile.socPrefix;
+    }
+}
+
+}  // namespace
@@ -25,6 +25,7 @@ def normal_test(
         _,
         num_tokens_per_expert,
         is_token_in_rank,
+        layout,
         _,
     ) = buffer.get_dispatch_layout(topk_idx, num_experts)
 
@@ -35,6 +36,7 @@ def normal_test(
         "x": x,
         "num_tokens_per_rank": num_tokens_per_rank,
         "is_token_in_rank": is_token_in_rank,
+        "layout": layout,
         "num_tokens_per_expert": num_tokens_per_expert,
         "config": config,
         "topk_idx": topk_idx,
@@ -58,6 +60,7 @@ def normal_test(
         _,
         _,
         topk_weights_recv,
+        _,
     ) = handle
     recv_x = per_token_cast_back(*recv_x) if isinstance(recv_x, tuple) else recv_x
     combine_args = {
@@ -441,6 +441,9 @@ def test(
     )
 
     # ----- Fused -----
+    combine_wait_recv_cost_stats = torch.zeros(
+        (num_ranks,), dtype=torch.int, device="npu"
+    )
     fused_output, fused_ep_recv_count = buffer.fused_deep_moe(
         x,
         topk_idx_dropped,
@@ -452,7 +455,9 @@ def test(
         num_tokens,
         num_experts,
         0,
+        combine_wait_recv_cost_stats=combine_wait_recv_cost_stats,
     )
+    assert (combine_wait_recv_cost_stats >= 0).all()
 
     # ----- Compare Outputs -----
     max_diff = torch.max(torch.abs(fused_output - baseline_output)).item()
@@ -274,6 +274,7 @@ def test_main(
             _,
             ref_num_tokens_per_expert,
             ref_is_token_in_rank,
+            ref_layout,
             _,
         ) = return_values
         try:
@@ -287,7 +288,7 @@ def test_main(
                 ref_is_token_in_rank, is_token_in_rank
             ), f"Assertion is_token_in_rank failed on rank {rank}: Expected {is_token_in_rank}, Actual {ref_is_token_in_rank}"
             if enable_a2_test:
-                notify_send_data = buffer.get_notify_send_data()
+                notify_send_data = buffer.get_notify_send_data(ref_layout)
                 check_layout_a2_data(notify_send_data)
         except AssertionError as e:
             print(e)
@@ -320,6 +321,7 @@ def test_main(
                 "x": current_x,
                 "num_tokens_per_rank": num_tokens_per_rank,
                 "is_token_in_rank": is_token_in_rank,
+                "layout": ref_layout,
                 "num_tokens_per_expert": num_tokens_per_expert,
                 "config": config,
                 "topk_idx": topk_idx,
@@ -374,6 +376,11 @@ def test_main(
                     f"[Diagnose {title}] abnormal_rows {res['abnormal_rows']}, "
                     f"abnormal_cols {res['abnormal_cols']}, abnormal_points {res['abnormal_points']}"
                 )
+            cost_matrix, histograms, bin_edges = buffer.get_cost_stats_histograms(stats)
+            if rank == 0:
+                assert torch.equal(cost_matrix.cpu(), stats_mat.cpu())
+                print(f"[Diagnose {title}] histograms per peer rank, edges {bin_edges}")
+                print(histograms)
 
     def test_correctness():
         for current_x in filter(lambda elem: elem is not None, (x_pure_rand, x)):
@@ -387,6 +394,7 @@ def test_main(
                 "x": current_x,
                 "num_tokens_per_rank": num_tokens_per_rank,
                 "is_token_in_rank": is_token_in_rank,
+                "layout": ref_layout,
                 "num_tokens_per_expert": num_tokens_per_expert,
                 "config": config,
                 "topk_idx": topk_idx,
@@ -453,6 +461,7 @@ def test_main(
             "x": x,
             "num_tokens_per_rank": num_tokens_per_rank,
             "is_token_in_rank": is_token_in_rank,
+            "layout": ref_layout,
             "num_tokens_per_expert": num_tokens_per_expert,
             "config": config,
             "topk_idx": topk_idx,
@@ -485,6 +494,7 @@ def test_main(
                 "config": config,
                 "num_tokens_per_rank": num_tokens_per_rank,
                 "is_token_in_rank": is_token_in_rank,
+                "layout": ref_layout,
                 "num_tokens_per_expert": num_tokens_per_expert,
                 "topk_idx": topk_idx,
                 "topk_weights": topk_weights,
@@ -177,6 +177,7 @@ def test_main(
         _,
         ref_num_tokens_per_expert,
         ref_is_token_in_rank,
+        ref_layout,
         _,
     ) = return_values
 
@@ -190,6 +191,45 @@ def test_main(
         ref_is_token_in_rank, is_token_in_rank
     ), f"Assertion is_token_in_rank failed on rank {rank}: Expected {is_token_in_rank}, Actual {ref_is_token_in_rank}"
 
+    # Bit-packed layout, bit r % 32 of column r // 32 marks rank r
+    bitmap = buffer.runtime.is_token_in_rank_bitmap
+    buffer.runtime.is_token_in_rank_bitmap = True
+    packed_is_token_in_rank = buffer.get_dispatch_layout(topk_idx, num_experts)[3]
+    buffer.runtime.is_token_in_rank_bitmap = bitmap
+    assert packed_is_token_in_rank.size(1) == (num_ranks + 31) // 32
+    shifts = torch.arange(32, dtype=torch.int, device="npu")
+    unpacked_is_token_in_rank = (
+        (packed_is_token_in_rank.unsqueeze(-1) >> shifts) & 1
+    ).view(num_tokens, -1)[:, :num_ranks]
+    assert torch.equal(
+        unpacked_is_token_in_rank, is_token_in_rank
+    ), f"Assertion packed is_token_in_rank failed on rank {rank}"
+
+    # Redundant experts, logical expert e has the replicas e and e + num_experts // 2,
+    # token t takes replica t % 2
+    num_logical_experts = num_experts // 2
+    logical_topk_idx = topk_idx % num_logical_experts
+    replica_ids = torch.arange(num_logical_experts, dtype=torch.int, device="npu")
+    expert_replica_table = torch.stack(
+        [
+            torch.full_like(replica_ids, 2),
+            replica_ids,
+            replica_ids + num_logical_experts,
+        ],
+        dim=1,
+    )
+    token_replica = torch.arange(num_tokens, device="npu") % 2
+    physical_topk_idx = (
+        logical_topk_idx + token_replica.view(-1, 1) * num_logical_experts
+    )
+    replica_num_tokens_per_expert = buffer.get_dispatch_layout(
+        logical_topk_idx, num_experts, expert_replica_table=expert_replica_table
+    )[2]
+    assert torch.equal(
+        replica_num_tokens_per_expert.view(round_val, num_experts).sum(0),
+        torch.bincount(physical_topk_idx.view(-1), minlength=num_experts).to(torch.int),
+    ), f"Assertion replica num_tokens_per_expert failed on rank {rank}"
+
     # Config
     buffer_size = 256
     config = deep_ep.Config(24, 8, buffer_size)
@@ -227,6 +267,7 @@ def test_main(
                 "x": current_x,
                 "num_tokens_per_rank": ref_num_tokens_per_rank,
                 "is_token_in_rank": ref_is_token_in_rank,
+                "layout": ref_layout,
                 "num_tokens_per_expert": ref_num_tokens_per_expert,
                 "config": config,
                 "topk_idx": topk_idx,
@@ -281,6 +322,11 @@ def test_main(
                     f"[Diagnose {title}] abnormal_rows {res['abnormal_rows']}, "
                     f"abnormal_cols {res['abnormal_cols']}, abnormal_points {res['abnormal_points']}"
                 )
+            cost_matrix, histograms, bin_edges = buffer.get_cost_stats_histograms(stats)
+            if rank == 0:
+                assert torch.equal(cost_matrix.cpu(), stats_mat.cpu())
+                print(f"[Diagnose {title}] histograms per peer rank, edges {bin_edges}")
+                print(histograms)
 
     for current_x in filter(lambda elem: elem is not None, (x_pure_rand, x)):
         if local_rank == 0:
@@ -292,6 +338,7 @@ def test_main(
             "x": current_x,
             "num_tokens_per_rank": ref_num_tokens_per_rank,
             "is_token_in_rank": ref_is_token_in_rank,
+            "layout": ref_layout,
             "num_tokens_per_expert": ref_num_tokens_per_expert,
             "config": config,
             "topk_idx": topk_idx,
@@ -348,6 +395,139 @@ def test_main(
         )
         assert diff < 5e-5
 
+        # Same round trip on the communication stream, overlapped with work on the compute stream
+        async_args = {"async_finish": True, "allocate_on_comm_stream": True}
+        async_recv_x, _, _, _, async_handle, event = buffer.dispatch(
+            **dispatch_args, previous_event=buffer.capture(), **async_args
+        )
+        overlapped = torch.matmul(x_pure_rand, x_pure_rand.T)
+        event.current_stream_wait()
+        async_recv_x = (
+            per_token_cast_back(*async_recv_x)
+            if isinstance(async_recv_x, tuple)
+            else async_recv_x
+        )
+        assert calc_diff(async_recv_x.float(), recv_x.float()) < 5e-5
+        async_combined_x, _, event = buffer.combine(
+            x=async_recv_x,
+            handle=async_handle,
+            config=config,
+            topk_weights=async_handle[7],
+            previous_event=buffer.capture(),
+            **async_args,
+        )
+        with event:
+            overlapped = overlapped + 1
+        assert calc_diff(async_combined_x.float(), check_x) < 5e-5
+
+        # Worst case layout, no host sync and the counts stay on device
+        num_worst_tokens = num_tokens * num_ranks * num_topk
+        worst_recv_x, _, _, worst_num_recv_tokens_per_expert, worst_handle, _ = (
+            buffer.dispatch(**dispatch_args, num_worst_tokens=num_worst_tokens)
+        )
+        worst_recv_x = (
+            per_token_cast_back(*worst_recv_x)
+            if isinstance(worst_recv_x, tuple)
+            else worst_recv_x
+        )
+        assert worst_recv_x.size(0) == num_worst_tokens
+        assert (
+            worst_num_recv_tokens_per_expert.tolist() == recv_num_tokens_per_expert_list
+        )
+        num_valid_rows = recv_x.size(0)
+        assert (
+            calc_diff(worst_recv_x[:num_valid_rows].float(), recv_x.float()) < 5e-5
+        )
+        worst_combined_x, _, _ = buffer.combine(
+            x=worst_recv_x,
+            handle=worst_handle,
+            config=config,
+            topk_weights=worst_handle[7],
+        )
+        assert calc_diff(worst_combined_x.float(), check_x) < 5e-5
+
+        # Two micro-batches interleaved on one buffer: dispatch A, B, then combine A, B.
+        # A layout stays valid however many layouts are computed after it.
+        half = num_tokens // 2
+        mb_topk_idx = topk_idx[:half].contiguous()
+        (
+            mb_num_tokens_per_rank,
+            _,
+            mb_num_tokens_per_expert,
+            mb_is_token_in_rank,
+            mb_layout,
+            _,
+        ) = buffer.get_dispatch_layout(mb_topk_idx, num_experts)
+        for _ in range(4):
+            buffer.get_dispatch_layout(topk_idx, num_experts)
+        mb_dispatch_args = {
+            **dispatch_args,
+            "x": current_x[:half].contiguous(),
+            "num_tokens_per_rank": mb_num_tokens_per_rank,
+            "is_token_in_rank": mb_is_token_in_rank.clone(),
+            "layout": mb_layout,
+            "num_tokens_per_expert": mb_num_tokens_per_expert,
+            "topk_idx": mb_topk_idx,
+            "topk_weights": dispatch_args["topk_weights"][:half].contiguous(),
+        }
+        a_recv_x, _, _, _, a_handle, _ = buffer.dispatch(**dispatch_args)
+        b_recv_x, _, _, _, b_handle, _ = buffer.dispatch(**mb_dispatch_args)
+        for mb_recv_x, mb_handle, mb_ref_x in (
+            (a_recv_x, a_handle, check_x),
+            (b_recv_x, b_handle, check_x[:half]),
+        ):
+            mb_recv_x = (
+                per_token_cast_back(*mb_recv_x)
+                if isinstance(mb_recv_x, tuple)
+                else mb_recv_x
+            )
+            mb_combined_x, _, _ = buffer.combine(
+                x=mb_recv_x,
+                handle=mb_handle,
+                config=config,
+                topk_weights=mb_handle[7],
+            )
+            assert calc_diff(mb_combined_x.float(), mb_ref_x) < 5e-5
+
+        # Cached mode, the same routing again without the notify_dispatch exchange
+        cached_recv_x, _, _, cached_num_recv_tokens_per_expert, cached_handle, _ = (
+            buffer.dispatch(x=current_x, handle=handle, config=config)
+        )
+        cached_recv_x = (
+            per_token_cast_back(*cached_recv_x)
+            if isinstance(cached_recv_x, tuple)
+            else cached_recv_x
+        )
+        assert cached_num_recv_tokens_per_expert == recv_num_tokens_per_expert_list
+        assert calc_diff(cached_recv_x.float(), recv_x.float()) < 5e-5
+        cached_combined_x, _, _ = buffer.combine(
+            x=cached_recv_x,
+            handle=cached_handle,
+            config=config,
+            topk_weights=cached_handle[7],
+        )
+        assert calc_diff(cached_combined_x.float(), check_x) < 5e-5
+
+        # Int8 communication-quantized combine, the receiver dequantizes before the weighted sum
+        comm_quant = buffer.runtime.combine_comm_quant
+        buffer.runtime.combine_comm_quant = True
+        quant_combined_x, _, _ = buffer.combine(**combine_args)
+        buffer.runtime.combine_comm_quant = comm_quant
+        assert calc_diff(quant_combined_x.float(), check_x) < 1e-3
+
+        # Load statistics accumulate on the device, also for a cached dispatch
+        recv_stats = torch.zeros(
+            (num_experts // num_ranks,), dtype=torch.int, device="npu"
+        )
+        buffer.dispatch(**dispatch_args, cumulative_local_expert_recv_stats=recv_stats)
+        buffer.dispatch(
+            x=current_x,
+            handle=handle,
+            config=config,
+            cumulative_local_expert_recv_stats=recv_stats,
+        )
+        assert recv_stats.tolist() == (local_expert_token * 2).tolist()
+
         # For later tuning
         dispatch_bf16_recv_bytes = recv_x.numel() * 2
         combine_bf16_send_bytes = dispatch_bf16_recv_bytes
@@ -372,6 +552,7 @@ def test_main(
             "config": config,
             "num_tokens_per_rank": ref_num_tokens_per_rank,
             "is_token_in_rank": ref_is_token_in_rank,
+            "layout": ref_layout,
             "num_tokens_per_expert": ref_num_tokens_per_expert,
             "topk_idx": topk_idx,
             "topk_weights": topk_weights,
@@ -389,6 +570,7 @@ def test_main(
         "x": x,
         "num_tokens_per_rank": ref_num_tokens_per_rank,
         "is_token_in_rank": ref_is_token_in_rank,
+        "layout": ref_layout,
         "num_tokens_per_expert": ref_num_tokens_per_expert,
         "config": config,
         "topk_idx": topk_idx,
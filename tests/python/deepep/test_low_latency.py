@@ -74,6 +74,10 @@ def test(
     cumulative_local_expert_recv_stats = torch.zeros(
         (num_local_experts,), dtype=torch.int, device="npu"
     )
+    dispatch_wait_recv_cost_stats = torch.zeros(
+        (num_ranks,), dtype=torch.int, device="npu"
+    )
+    combine_send_cost_stats = torch.zeros((num_ranks,), dtype=torch.int, device="npu")
     for dispatch_use_fp8 in (True, False):
         packed_recv_x, packed_recv_count, handle, event, hook = (
             buffer.low_latency_dispatch(
@@ -85,6 +89,7 @@ def test(
                 round_scale=False,
                 use_ue8m0=False,
                 cumulative_local_expert_recv_stats=cumulative_local_expert_recv_stats,
+                dispatch_wait_recv_cost_stats=dispatch_wait_recv_cost_stats,
                 async_finish=not return_recv_hook,
                 return_recv_hook=return_recv_hook,
             )
@@ -153,6 +158,7 @@ def test(
             hidden,
             num_experts,
             packed_recv_count,
+            _,
         ) = handle
 
         out = torch.empty((num_tokens, hidden), dtype=torch.bfloat16, device="npu")
@@ -165,6 +171,7 @@ def test(
             zero_copy=False,
             return_recv_hook=return_recv_hook,
             out=out,
+            combine_send_cost_stats=combine_send_cost_stats,
         )
 
         if do_check:
@@ -179,8 +186,70 @@ def test(
                 assert diff < 1e-5, f"Error: {diff=}"
             hash_value ^= hash_tensor(combined_x)
 
+            # Same combine from the persistent buffer of this dispatch
+            combine_buffer = buffer.get_next_low_latency_combine_buffer(handle)
+            combine_buffer.copy_(simulated_gemm_x)
+            zero_copy_x, _, _ = buffer.low_latency_combine(
+                combine_buffer, topk_idx, topk_weights, handle, zero_copy=True
+            )
+            assert calc_diff(zero_copy_x, combined_x) < 1e-5
+
+            # Same round trip received through the hooks, other work runs in between
+            _, _, hook_handle, _, hook = buffer.low_latency_dispatch(
+                x,
+                topk_idx,
+                num_tokens,
+                num_experts,
+                use_fp8=dispatch_use_fp8,
+                return_recv_hook=True,
+            )
+            overlapped = torch.matmul(topk_weights, topk_weights.T)
+            hook()
+            hook_combined_x, _, hook = buffer.low_latency_combine(
+                simulated_gemm_x,
+                topk_idx,
+                topk_weights,
+                hook_handle,
+                return_recv_hook=True,
+            )
+            overlapped = overlapped + 1
+            hook()
+            assert calc_diff(hook_combined_x, combined_x) < 1e-5
+
+            # Same round trip with power-of-two scales received as UE8M0 exponents
+            if dispatch_use_fp8:
+                ue8m0_recv_x, _, ue8m0_handle, _, _ = buffer.low_latency_dispatch(
+                    x,
+                    topk_idx,
+                    num_tokens,
+                    num_experts,
+                    use_fp8=True,
+                    round_scale=True,
+                    use_ue8m0=True,
+                )
+                assert ue8m0_recv_x[1].dtype == torch.uint8
+                ue8m0_combined_x, _, _ = buffer.low_latency_combine(
+                    per_token_cast_back(*ue8m0_recv_x),
+                    topk_idx,
+                    topk_weights,
+                    ue8m0_handle,
+                )
+                assert calc_diff(ue8m0_combined_x, combined_x) < 1e-4
+
             print(f"rank {rank} PASSED")
 
+    # Both checked dispatches added what each local expert received to the statistics
+    if do_check:
+        torch.npu.synchronize()
+        local_expert_ids = (
+            torch.arange(num_local_experts, device="npu") + rank * num_local_experts
+        )
+        ref_stats = (all_topk_idx.view(-1, 1) == local_expert_ids).sum(dim=0) * 2
+        assert cumulative_local_expert_recv_stats.tolist() == ref_stats.tolist()
+        # the per-rank costs only ever accumulate
+        assert (dispatch_wait_recv_cost_stats >= 0).all()
+        assert (combine_send_cost_stats >= 0).all()
+
     # noinspection PyShadowingNames
     def test_func(zero_copy: bool, return_recv_hook: bool):
         recv_x, recv_count, handle, event, hook = buffer.low_latency_dispatch(
@@ -201,6 +270,8 @@ def test(
             zero_copy=zero_copy,
             return_recv_hook=return_recv_hook,
         )
+        if return_recv_hook:
+            hook()
 
     # Calculate bandwidth
     num_fp8_bytes, num_bf16_bytes = (hidden + hidden // 128 * 4 + 16), hidden * 2
@@ -68,6 +68,7 @@ def low_latency_test(
         hidden,
         _,
         _,
+        _,
     ) = handle
 
     out = torch.empty((num_tokens, hidden), dtype=torch.bfloat16, device="npu")
@@ -202,6 +202,7 @@ def test_compare(local_rank: int, num_local_ranks: int, args: argparse.Namespace
             x,
             num_tokens_per_rank=layout[0],
             is_token_in_rank=layout[3],
+            layout=layout[4],
             num_tokens_per_expert=layout[2],
             config=dep_conf,
             topk_idx=topk_idx,
@@ -213,6 +214,7 @@ def test_compare(local_rank: int, num_local_ranks: int, args: argparse.Namespace
         x,
         num_tokens_per_rank=layout_cache[0],
         is_token_in_rank=layout_cache[3],
+        layout=layout_cache[4],
         num_tokens_per_expert=layout_cache[2],
         config=dep_conf,
         topk_idx=topk_idx,
@@ -0,0 +1,447 @@
+# Checks the kernels built by tests/cpu_sim against the python natives, no NPU needed:
+#   cmake -S tests/cpu_sim -B build_cpu_sim && cmake --build build_cpu_sim
+#   SGL_KERNEL_NPU_SIM=build_cpu_sim/sgl_kernel_npu_sim python3 test_cpu_sim.py
+
+import importlib.util
+import os
+import pathlib
+import random
+import subprocess
+import tempfile
+import unittest
+
+import torch
+from utils import reference_sgmv_expand, reference_sgmv_shrink
+
+SIM_LAUNCHER = os.environ.get("SGL_KERNEL_NPU_SIM")
+
+# load speculative.py by path, importing the sgl_kernel_npu package would need torch_npu
+_SPECULATIVE_PATH = (
+    pathlib.Path(__file__).parents[3]
+    / "python/sgl_kernel_npu/sgl_kernel_npu/speculative.py"
+)
+_spec = importlib.util.spec_from_file_location("speculative", _SPECULATIVE_PATH)
+speculative = importlib.util.module_from_spec(_spec)
+_spec.loader.exec_module(speculative)
+
+
+def run_sim(kernel, tensors, **params):
+    """Run one kernel of the launcher, outputs are copied back into their tensors."""
+    with tempfile.TemporaryDirectory() as case_dir:
+        for name, tensor in tensors.items():
+            raw = tensor.contiguous().view(-1).view(torch.uint8)
+            pathlib.Path(case_dir, name + ".bin").write_bytes(raw.numpy().tobytes())
+        args = [f"{key}={value}" for key, value in params.items()]
+        subprocess.run([SIM_LAUNCHER, kernel, case_dir] + args, check=True)
+        for name, tensor in tensors.items():
+            raw = bytearray(pathlib.Path(case_dir, name + ".bin").read_bytes())
+            if raw:
+                tensor.copy_(
+                    torch.frombuffer(raw, dtype=tensor.dtype).view(tensor.shape)
+                )
+
+
+def alloc_extend_golden(pre_lens, seq_lens, last_loc, free_pages, page_size):
+    out_indices = []
+    page_idx = 0
+    page = 0
+    for pre_len, seq_len, loc in zip(
+        pre_lens.tolist(), seq_lens.tolist(), last_loc.tolist()
+    ):
+        first_new_pos = (pre_len + page_size - 1) // page_size * page_size
+        for pos in range(pre_len, seq_len):
+            if pos < first_new_pos:
+                out_indices.append(loc + 1 + pos - pre_len)
+                continue
+            if pos % page_size == 0:
+                page = free_pages[page_idx].item()
+                page_idx += 1
+            out_indices.append(page * page_size + pos % page_size)
+    return torch.tensor(out_indices, dtype=torch.int64), page_idx
+
+
+def random_draft_tree(bs, topk, depth, draft_token_num):
+    """parent_list and selected_index of a valid tree, parents are always selected."""
+    parent_list = torch.empty(bs, topk * (depth - 1) + 1, dtype=torch.int64)
+    selected_index = torch.empty(bs, draft_token_num - 1, dtype=torch.int64)
+    num_candidates = topk + (depth - 1) * topk * topk
+    for bid in range(bs):
+        parents = [-1] + list(range(topk))
+        for step in range(1, depth - 1):
+            start = topk + (step - 1) * topk * topk
+            parents += sorted(random.sample(range(start, start + topk * topk), topk))
+        selected = set()
+        while len(selected) < draft_token_num - 1:
+            frontier = [
+                idx
+                for idx in range(num_candidates)
+                if idx not in selected
+                and (idx < topk or parents[idx // topk] in selected)
+            ]
+            selected.add(random.choice(frontier))
+        parent_list[bid] = torch.tensor(parents)
+        selected_index[bid] = torch.tensor(sorted(selected))
+    return parent_list, selected_index
+
+
+def ancestor_mask(parent_list, selected_index, topk, draft_token_num):
+    """[bs, draft, draft] mask of each draft token over its ancestors and itself."""
+    bs = parent_list.size(0)
+    mask = torch.zeros(bs, draft_token_num, draft_token_num, dtype=torch.bool)
+    mask[:, :, 0] = True
+    for bid in range(bs):
+        selected = selected_index[bid].tolist()
+        for tid in range(1, draft_token_num):
+            cur = tid - 1
+            while True:
+                mask[bid, tid, 1 + cur] = True
+                parent_tb_idx = selected[cur] // topk
+                if parent_tb_idx == 0:
+                    break
+                cur = selected.index(int(parent_list[bid, parent_tb_idx]))
+    return mask
+
+
+@unittest.skipIf(SIM_LAUNCHER is None, "SGL_KERNEL_NPU_SIM is not set")
+class TestCpuSim(unittest.TestCase):
+    def setUp(self):
+        torch.manual_seed(0)
+        random.seed(0)
+
+    def test_alloc_extend(self):
+        for page_size in [1, 16, 128]:
+            bs = 16
+            pre_lens = torch.randint(0, 1000, (bs,), dtype=torch.int64)
+            seq_lens = pre_lens + torch.randint(0, 300, (bs,), dtype=torch.int64)
+            last_loc = (
+                torch.randint(0, 1000, (bs,), dtype=torch.int64) * page_size
+                + (pre_lens - 1) % page_size
+            )
+            free_pages = torch.randperm(10000, dtype=torch.int64)[:2000]
+            golden, num_pages = alloc_extend_golden(
+                pre_lens, seq_lens, last_loc, free_pages, page_size
+            )
+            out_indices = torch.zeros_like(golden)
+            values = torch.zeros(1, dtype=torch.int64)
+            run_sim(
+                "alloc_extend",
+                dict(
+                    pre_lens=pre_lens,
+                    seq_lens=seq_lens,
+                    last_loc=last_loc,
+                    free_pages=free_pages,
+                    out_indices=out_indices,
+                    values=values,
+                ),
+                page_size=page_size,
+            )
+            self.assertTrue(torch.equal(out_indices, golden))
+            self.assertEqual(values.item(), num_pages)
+
+    def test_cache_loc_assign_and_update(self):
+        for req_dtype in [torch.int32, torch.int64]:
+            bs, pool_size, row_size = 32, 64, 256
+            req_pool_indices = torch.randperm(pool_size)[:bs].to(req_dtype)
+            start_offset = torch.randint(0, row_size - 5, (bs,), dtype=torch.int64)
+            end_offset = start_offset + torch.randint(1, 6, (bs,), dtype=torch.int64)
+            total = int((end_offset - start_offset).sum())
+            token_pool = torch.randint(
+                0, 1 << 20, (pool_size, row_size), dtype=torch.int32
+            )
+            out_cache_loc = torch.randint(0, 1 << 20, (total,), dtype=torch.int32)
+
+            golden_pool = token_pool.clone()
+            offset = 0
+            for i in range(bs):
+                row, start, end = (
+                    int(req_pool_indices[i]),
+                    int(start_offset[i]),
+                    int(end_offset[i]),
+                )
+                golden_pool[row, start:end] = out_cache_loc[
+                    offset : offset + end - start
+                ]
+                offset += end - start
+
+            inputs = dict(
+                req_pool_indices=req_pool_indices,
+                token_pool=token_pool,
+                start_offset=start_offset,
+                end_offset=end_offset,
+                out_cache_loc=out_cache_loc,
+            )
+            run_sim("cache_loc_assign", inputs, row_size=row_size)
+            self.assertTrue(torch.equal(token_pool, golden_pool))
+
+            golden_loc = out_cache_loc.clone()
+            out_cache_loc.zero_()
+            run_sim("cache_loc_update", inputs, row_size=row_size)
+            self.assertTrue(torch.equal(out_cache_loc, golden_loc))
+
+    def test_assign_cache_op(self):
+        bs, row_size, gap = 24, 512, 5
+        for dtype in [torch.int8, torch.int16, torch.int32, torch.int64]:
+            dst_start = torch.randint(0, row_size - gap, (bs,), dtype=torch.int64)
+            dst_end = dst_start + gap
+            src_end = torch.cumsum(dst_end - dst_start, dim=0)
+            src_start = src_end - gap
+            dst = torch.randint(0, 100, (bs, row_size), dtype=dtype)
+            src = torch.randint(0, 100, (bs * gap,), dtype=dtype)
+
+            golden = dst.clone()
+            for i in range(bs):
+                golden[i, dst_start[i] : dst_end[i]] = src[src_start[i] : src_end[i]]
+            run_sim(
+                "assign_cache_op",
+                dict(
+                    dst=dst,
+                    src=src,
+                    dst_start=dst_start,
+                    dst_end=dst_end,
+                    src_start=src_start,
+                    src_end=src_end,
+                ),
+                row_size=row_size,
+            )
+            self.assertTrue(torch.equal(dst, golden))
+
+    def test_build_tree_efficient(self):
+        for tree_mask_mode in [
+            speculative.TreeMaskMode.FULL_MASK,
+            speculative.TreeMaskMode.QLEN_ONLY,
+        ]:
+            bs, topk, depth, draft_token_num = 6, 4, 4, 8
+            parent_list, selected_index = random_draft_tree(
+                bs, topk, depth, draft_token_num
+            )
+            verified_seq_len = torch.randint(1, 64, (bs,), dtype=torch.int64)
+            if tree_mask_mode == speculative.TreeMaskMode.FULL_MASK:
+                mask_size = (
+                    int(verified_seq_len.sum()) * draft_token_num
+                    + draft_token_num * draft_token_num * bs
+                )
+            else:
+                mask_size = draft_token_num * draft_token_num * bs
+
+            def new_outputs(fill):
+                return dict(
+                    tree_mask=torch.full((mask_size,), fill, dtype=torch.bool),
+                    positions=torch.zeros(bs * draft_token_num, dtype=torch.int64),
+                    retrive_index=torch.full((bs, draft_token_num), -1),
+                    retrive_next_token=torch.full((bs, draft_token_num), -1),
+                    retrive_next_sibling=torch.full((bs, draft_token_num), -1),
+                )
+
+            golden = new_outputs(False)
+            (
+                golden["positions"],
+                golden["retrive_index"],
+                golden["retrive_next_token"],
+                golden["retrive_next_sibling"],
+                golden["tree_mask"],
+            ) = speculative.build_tree_efficient_native(
+                parent_list,
+                selected_index,
+                verified_seq_len,
+                golden["tree_mask"],
+                golden["retrive_index"],
+                golden["retrive_next_token"],
+                golden["retrive_next_sibling"],
+                topk,
+                draft_token_num,
+                tree_mask_mode,
+                bs,
+            )
+            # the native marks all draft columns, keep its rows and expect the ancestors
+            rows = golden["tree_mask"].nonzero().flatten()
+            golden["tree_mask"] = torch.ones(mask_size, dtype=torch.bool)
+            golden["tree_mask"][rows] = ancestor_mask(
+                parent_list, selected_index, topk, draft_token_num
+            ).flatten()
+
+            actual = new_outputs(True)
+            run_sim(
+                "build_tree_efficient",
+                dict(
+                    parent_list=parent_list,
+                    selected_index=selected_index,
+                    verified_seq_len=verified_seq_len,
+                    **actual,
+                ),
+                topk=topk,
+                depth=depth,
+                draft_token_num=draft_token_num,
+                tree_mask_mode=int(tree_mask_mode),
+            )
+            for name in golden:
+                self.assertTrue(torch.equal(actual[name], golden[name]), name)
+
+    def test_bgmv(self):
+        bs, hidden, rank, num_loras, scale = 16, 1024, 16, 3, 0.5
+        for dtype, name in [(torch.float16, "half"), (torch.bfloat16, "bf16")]:
+            indices = torch.randint(0, num_loras, (bs,), dtype=torch.int64)
+            x = torch.randn(bs, hidden, dtype=dtype)
+            lora_a = torch.randn(num_loras, rank, hidden, dtype=dtype) / hidden
+            y = torch.zeros(bs, rank, dtype=torch.float32)
+            run_sim(
+                "bgmv_shrink",
+                dict(x=x, weight=lora_a, indices=indices, y=y),
+                hidden_in=hidden,
+                rank=rank,
+                scale=scale,
+                dtype=name,
+            )
+            golden = scale * torch.einsum(
+                "bh,brh->br", x.float(), lora_a[indices].float()
+            )
+            torch.testing.assert_close(y, golden, rtol=1e-2, atol=1e-2)
+
+            lora_b = torch.randn(num_loras, hidden, rank, dtype=dtype)
+            base = torch.randn(bs, 2 * hidden, dtype=dtype)
+            out = base.clone()
+            run_sim(
+                "bgmv_expand",
+                dict(x=y, weight=lora_b, indices=indices, y=out),
+                rank=rank,
+                slice_offset=hidden,
+                slice_size=hidden,
+                hidden_out=2 * hidden,
+                dtype=name,
+            )
+            golden = base.float()
+            golden[:, hidden:] += torch.einsum("br,bhr->bh", y, lora_b[indices].float())
+            torch.testing.assert_close(out.float(), golden, rtol=2e-2, atol=2e-2)
+
+    def test_sgmv(self):
+        hidden, rank, num_loras, scale = 1024, 16, 3, 0.5
+        seq_len = torch.tensor([3, 1, 7, 5], dtype=torch.int64)
+        lora_indices = torch.tensor([2, 0, 1, 2], dtype=torch.int64)
+        num_tokens = int(seq_len.sum())
+        lora_ranks = torch.full((num_loras,), rank, dtype=torch.int32)
+        for dtype, name in [(torch.float16, "half"), (torch.bfloat16, "bf16")]:
+            x = torch.randn(num_tokens, hidden, dtype=dtype)
+            lora_a = torch.randn(num_loras, rank, hidden, dtype=dtype) / hidden
+            y = torch.zeros(num_tokens, rank, dtype=torch.float32)
+            run_sim(
+                "sgmv_shrink",
+                dict(
+                    x=x,
+                    weight=lora_a,
+                    lora_indices=lora_indices,
+                    seq_len=seq_len,
+                    y=y,
+                ),
+                hidden_in=hidden,
+                rank=rank,
+                scale=scale,
+                dtype=name,
+            )
+            golden = reference_sgmv_shrink(
+                x.float(),
+                lora_a.float(),
+                lora_indices,
+                seq_len,
+                lora_ranks,
+                torch.full((num_loras,), scale),
+            )
+            torch.testing.assert_close(y, golden, rtol=1e-2, atol=1e-2)
+
+            lora_b = torch.randn(num_loras, hidden, rank, dtype=dtype)
+            base = torch.randn(num_tokens, hidden, dtype=dtype)
+            out = base.clone()
+            run_sim(
+                "sgmv_expand",
+                dict(
+                    x=y,
+                    weight=lora_b,
+                    lora_indices=lora_indices,
+                    seq_len=seq_len,
+                    y=out,
+                ),
+                rank=rank,
+                slice_size=hidden,
+                dtype=name,
+            )
+            golden = reference_sgmv_expand(
+                y,
+                lora_b.float(),
+                lora_indices,
+                seq_len,
+                lora_ranks,
+                torch.tensor([0, hidden]),
+                base.float(),
+            )
+            torch.testing.assert_close(out.float(), golden, rtol=2e-2, atol=2e-2)
+
+    def test_dispatch_layout(self):
+        num_tokens, num_topk, num_ranks, num_experts = 96, 8, 16, 64
+        per_round_tokens, max_batch_size = 64, 4096
+        num_rounds = (num_tokens + per_round_tokens - 1) // per_round_tokens
+        server_num = num_ranks // 8
+        topk_idx = torch.stack(
+            [torch.randperm(num_experts)[:num_topk] for _ in range(num_tokens)]
+        ).to(torch.int64)
+        rank_idx = topk_idx // (num_experts // num_ranks)
+        is_token_in_rank = torch.zeros(num_tokens, num_ranks, dtype=torch.int32)
+        is_token_in_rank.scatter_(1, rank_idx, 1)
+        for bitmap in (0, 1):
+            with self.subTest(bitmap=bitmap):
+                cols = (num_ranks + 31) // 32 if bitmap else num_ranks
+                outputs = dict(
+                    num_tokens_per_rank=torch.zeros(num_ranks, dtype=torch.int32),
+                    num_tokens_per_expert=torch.zeros(
+                        num_rounds, num_experts, dtype=torch.int32
+                    ),
+                    is_token_in_rank=torch.zeros(
+                        num_tokens, cols, dtype=torch.int32
+                    ),
+                    notify_send_data=torch.zeros(
+                        num_experts * (1 + max_batch_size)
+                        + server_num
+                        + max_batch_size * (1 + 2 * server_num + num_experts),
+                        dtype=torch.int32,
+                    ),
+                    send_token_idx_small=torch.zeros(
+                        num_tokens, num_topk, dtype=torch.int32
+                    ),
+                )
+                run_sim(
+                    "dispatch_layout",
+                    dict(topk_idx=topk_idx, **outputs),
+                    num_topk=num_topk,
+                    num_ranks=num_ranks,
+                    num_experts=num_experts,
+                    per_round_tokens=per_round_tokens,
+                    is_token_in_rank_bitmap=bitmap,
+                )
+
+                actual = outputs["is_token_in_rank"]
+                if bitmap:
+                    # bit r % 32 of column r // 32 marks rank r
+                    shifts = torch.arange(32, dtype=torch.int32)
+                    actual = ((actual.unsqueeze(-1) >> shifts) & 1).view(
+                        num_tokens, -1
+                    )[:, :num_ranks]
+                self.assertTrue(torch.equal(actual, is_token_in_rank))
+                self.assertTrue(
+                    torch.equal(
+                        outputs["num_tokens_per_rank"],
+                        is_token_in_rank.sum(0, dtype=torch.int32),
+                    )
+                )
+                for r in range(num_rounds):
+                    round_idx = topk_idx[
+                        r * per_round_tokens : (r + 1) * per_round_tokens
+                    ]
+                    golden = torch.bincount(
+                        round_idx.view(-1), minlength=num_experts
+                    )
+                    self.assertTrue(
+                        torch.equal(
+                            outputs["num_tokens_per_expert"][r], golden.to(torch.int32)
+                        )
+                    )
+
+
+if __name__ == "__main__":
+    unittest.main()
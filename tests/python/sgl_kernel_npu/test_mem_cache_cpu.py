@@ -0,0 +1,211 @@
+import random
+import unittest
+
+import sgl_kernel_npu
+import torch
+from sgl_kernel_npu.speculative import TreeMaskMode, build_tree_efficient_native
+
+
+def alloc_extend_golden(pre_lens, seq_lens, last_loc, free_pages, page_size):
+    out_indices = []
+    page_idx = 0
+    page = 0
+    for pre_len, seq_len, loc in zip(pre_lens.tolist(), seq_lens.tolist(), last_loc.tolist()):
+        first_new_pos = (pre_len + page_size - 1) // page_size * page_size
+        for pos in range(pre_len, seq_len):
+            if pos < first_new_pos:
+                # continue the partially filled last page
+                out_indices.append(loc + 1 + pos - pre_len)
+                continue
+            if pos % page_size == 0:
+                page = free_pages[page_idx].item()
+                page_idx += 1
+            out_indices.append(page * page_size + pos % page_size)
+    return torch.tensor(out_indices, dtype=torch.int64), page_idx
+
+
+def random_draft_tree(bs, topk, depth, draft_token_num):
+    """parent_list and selected_index of a valid tree, parents are always selected."""
+    parent_list = torch.empty(bs, topk * (depth - 1) + 1, dtype=torch.int64)
+    selected_index = torch.empty(bs, draft_token_num - 1, dtype=torch.int64)
+    num_candidates = topk + (depth - 1) * topk * topk
+    for bid in range(bs):
+        parents = [-1] + list(range(topk))
+        for step in range(1, depth - 1):
+            start = topk + (step - 1) * topk * topk
+            parents += sorted(random.sample(range(start, start + topk * topk), topk))
+        selected = set()
+        while len(selected) < draft_token_num - 1:
+            frontier = [
+                idx
+                for idx in range(num_candidates)
+                if idx not in selected and (idx < topk or parents[idx // topk] in selected)
+            ]
+            selected.add(random.choice(frontier))
+        parent_list[bid] = torch.tensor(parents)
+        selected_index[bid] = torch.tensor(sorted(selected))
+    return parent_list, selected_index
+
+
+def ancestor_mask(parent_list, selected_index, topk, draft_token_num):
+    """[bs, draft, draft] mask of each draft token over itself, its ancestors and the verified token."""
+    bs = parent_list.size(0)
+    mask = torch.zeros(bs, draft_token_num, draft_token_num, dtype=torch.bool)
+    mask[:, :, 0] = True
+    for bid in range(bs):
+        selected = selected_index[bid].tolist()
+        for tid in range(1, draft_token_num):
+            cur = tid - 1
+            while True:
+                mask[bid, tid, 1 + cur] = True
+                parent_tb_idx = selected[cur] // topk
+                if parent_tb_idx == 0:
+                    break
+                cur = selected.index(int(parent_list[bid, parent_tb_idx]))
+    return mask
+
+
+class TestMemCacheCpu(unittest.TestCase):
+    def setUp(self):
+        torch.manual_seed(0)
+        random.seed(0)
+
+    def test_alloc_extend(self):
+        for page_size in [1, 16, 128]:
+            bs = 64
+            pre_lens = torch.randint(0, 1000, (bs,), dtype=torch.int64)
+            seq_lens = pre_lens + torch.randint(0, 300, (bs,), dtype=torch.int64)
+            last_loc = torch.randint(0, 10000, (bs,), dtype=torch.int64) * page_size + (pre_lens - 1) % page_size
+            free_pages = torch.randperm(100000, dtype=torch.int64)[:10000]
+            golden, num_pages = alloc_extend_golden(pre_lens, seq_lens, last_loc, free_pages, page_size)
+
+            out_indices = torch.empty_like(golden)
+            values = torch.empty(1, dtype=torch.int64)
+            torch.ops.npu.alloc_extend(pre_lens, seq_lens, last_loc, free_pages, page_size, out_indices, values)
+            self.assertTrue(torch.equal(out_indices, golden))
+            self.assertEqual(values.item(), num_pages)
+
+    def test_cache_loc_assign_and_update(self):
+        for req_dtype in [torch.int32, torch.int64]:
+            bs, pool_size, row_size = 32, 64, 512
+            req_pool_indices = torch.randperm(pool_size)[:bs].to(req_dtype)
+            start_offset = torch.randint(0, row_size - 8, (bs,), dtype=torch.int64)
+            end_offset = start_offset + torch.randint(0, 8, (bs,), dtype=torch.int64)
+            total = int((end_offset - start_offset).sum())
+            token_pool = torch.randint(0, 1 << 20, (pool_size, row_size), dtype=torch.int32)
+            out_cache_loc = torch.randint(0, 1 << 20, (total,), dtype=torch.int32)
+
+            golden_pool = token_pool.clone()
+            golden_loc = torch.empty_like(out_cache_loc)
+            offset = 0
+            for i in range(bs):
+                row, start, end = int(req_pool_indices[i]), int(start_offset[i]), int(end_offset[i])
+                golden_pool[row, start:end] = out_cache_loc[offset : offset + end - start]
+                golden_loc[offset : offset + end - start] = golden_pool[row, start:end]
+                offset += end - start
+
+            torch.ops.npu.cache_loc_assign(req_pool_indices, token_pool, start_offset, end_offset, out_cache_loc)
+            self.assertTrue(torch.equal(token_pool, golden_pool))
+            updated = torch.zeros_like(out_cache_loc)
+            torch.ops.npu.cache_loc_update(req_pool_indices, token_pool, start_offset, end_offset, updated)
+            self.assertTrue(torch.equal(updated, golden_loc))
+
+    def test_assign_cache_op(self):
+        bs, seq_len, gap = 48, 1024, 5
+        for dtype in [torch.int8, torch.int16, torch.int32, torch.int64]:
+            start_offset = torch.randint(0, seq_len - gap - 1, (bs,), dtype=torch.int64)
+            end_offset = start_offset + gap
+            token_pool = torch.randint(0, 32, (bs, seq_len), dtype=dtype)
+            out_cache_loc = torch.randint(0, 32, (bs * gap,), dtype=dtype)
+            src_end = torch.cumsum(end_offset - start_offset, dim=0)
+            src_start = src_end - (end_offset - start_offset)
+
+            golden = token_pool.clone()
+            for i in range(bs):
+                golden[i, start_offset[i] : end_offset[i]] = out_cache_loc[src_start[i] : src_end[i]]
+            self.assertTrue(
+                torch.ops.npu.assign_cache_op(token_pool, out_cache_loc, start_offset, end_offset, src_start, src_end)
+            )
+            self.assertTrue(torch.equal(token_pool, golden))
+
+    def test_build_tree_kernel_efficient(self):
+        bs, topk, depth, draft_token_num = 6, 4, 4, 8
+        for tree_mask_mode in [TreeMaskMode.FULL_MASK, TreeMaskMode.QLEN_ONLY]:
+            parent_list, selected_index = random_draft_tree(bs, topk, depth, draft_token_num)
+            verified_seq_len = torch.randint(1, 64, (bs,), dtype=torch.int64)
+            if tree_mask_mode == TreeMaskMode.FULL_MASK:
+                mask_size = int(verified_seq_len.sum()) * draft_token_num + draft_token_num * draft_token_num * bs
+            else:
+                mask_size = draft_token_num * draft_token_num * bs
+
+            def new_outputs(fill):
+                return dict(
+                    tree_mask=torch.full((mask_size,), fill, dtype=torch.bool),
+                    positions=torch.zeros(bs * draft_token_num, dtype=torch.int64),
+                    retrive_index=torch.full((bs, draft_token_num), -1, dtype=torch.int64),
+                    retrive_next_token=torch.full((bs, draft_token_num), -1, dtype=torch.int64),
+                    retrive_next_sibling=torch.full((bs, draft_token_num), -1, dtype=torch.int64),
+                )
+
+            golden = new_outputs(False)
+            (
+                golden["positions"],
+                golden["retrive_index"],
+                golden["retrive_next_token"],
+                golden["retrive_next_sibling"],
+                golden["tree_mask"],
+            ) = build_tree_efficient_native(
+                parent_list,
+                selected_index,
+                verified_seq_len,
+                golden["tree_mask"],
+                golden["retrive_index"],
+                golden["retrive_next_token"],
+                golden["retrive_next_sibling"],
+                topk,
+                draft_token_num,
+                tree_mask_mode,
+                bs,
+            )
+            # the native marks every draft column of a row, take the rows it writes and fill them with the ancestors
+            rows = golden["tree_mask"].nonzero().flatten()
+            self.assertEqual(rows.numel(), bs * draft_token_num * draft_token_num)
+            golden["tree_mask"] = torch.ones(mask_size, dtype=torch.bool)
+            golden["tree_mask"][rows] = ancestor_mask(parent_list, selected_index, topk, draft_token_num).flatten()
+
+            actual = new_outputs(True)
+            torch.ops.npu.build_tree_kernel_efficient(
+                parent_list,
+                selected_index,
+                verified_seq_len,
+                actual["tree_mask"],
+                actual["positions"],
+                actual["retrive_index"],
+                actual["retrive_next_token"],
+                actual["retrive_next_sibling"],
+                topk,
+                depth,
+                draft_token_num,
+                int(tree_mask_mode),
+            )
+            for name in golden:
+                self.assertTrue(torch.equal(actual[name], golden[name]), f"{tree_mask_mode.name} {name}")
+
+        with self.assertRaises(RuntimeError):
+            torch.ops.npu.build_tree_kernel_efficient(
+                parent_list,
+                selected_index,
+                verified_seq_len,
+                actual["tree_mask"],
+                actual["positions"],
+                actual["retrive_index"],
+                actual["retrive_next_token"],
+                actual["retrive_next_sibling"],
+                topk,
+                depth,
+                draft_token_num,
+                int(TreeMaskMode.QLEN_ONLY_BITPACKING),
+            )
+
+if __name__ == "__main__":
+    unittest.main()